@@ -159,6 +159,8 @@ namespace wpp
 	private:
 		void init_message_events();
 		void cleanup();
+		INT_PTR on_control_async_ready(HWND hWnd, WPARAM wParam, LPARAM lParam);
+		INT_PTR on_control_draw_item(HWND hWnd, WPARAM wParam, LPARAM lParam);
 		bool handle_scroll_message(scroll_orientation orientation, WPARAM wParam, LPARAM lParam);
 
 	protected:
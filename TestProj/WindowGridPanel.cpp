@@ -1,5 +1,7 @@
 #include "WindowGridPanel.hpp"
 
+namespace ui = layout::ui;
+
 constexpr auto DEFAULT_WINDOW_WIDTH = 1200;
 constexpr auto DEFAULT_WINDOW_HEIGHT = 780;
 
@@ -22,18 +24,10 @@ namespace {
         return _T("Events processed: ") + to_tstring(counter);
     }
 
-    void add_inventory_item_row(const control_ptr<list_view>& list_view,
-                                int row,
-                                LPCTSTR sku,
-                                LPCTSTR product,
-                                LPCTSTR category,
-                                LPCTSTR stock,
-                                LPCTSTR price) {
-        list_view->add_item(row, 0, sku);
-        list_view->add_item(row, 1, product);
-        list_view->add_item(row, 2, category);
-        list_view->add_item(row, 3, stock);
-        list_view->add_item(row, 4, price);
+    tstring make_sku(size_t index) {
+        TCHAR sku[16];
+        _stprintf_s(sku, _T("GN-%05zu"), index);
+        return sku;
     }
 }
 
@@ -44,6 +38,7 @@ WindowGridPanel::WindowGridPanel(LPCTSTR window_title, int x, int y, HINSTANCE i
 }
 
 LRESULT WindowGridPanel::on_create(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+    auto start = std::chrono::steady_clock::now();
     center_window();
     auto main_grid = create_main_grid(hWnd);
 
@@ -74,15 +69,22 @@ LRESULT WindowGridPanel::on_create(HWND hWnd, WPARAM wParam, LPARAM lParam) {
     arrange_main_grid(main_grid);
 
     root_panel() = main_grid;
+    set_layout_statistics(m_LayoutStatistics);
 
-    return window::on_create(hWnd, wParam, lParam);
+    LRESULT result = window::on_create(hWnd, wParam, lParam);
+    m_StartupTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    update_status();
+    return result;
 }
 
 LRESULT WindowGridPanel::on_size(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+    auto start = std::chrono::steady_clock::now();
     LRESULT result = window::on_size(hWnd, wParam, lParam);
     if (m_TabControl) {
         m_TabControl->fit_selected_page_to_display_rect();
     }
+    m_LastResizeTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    update_status();
     return result;
 }
 
@@ -217,6 +219,17 @@ std::shared_ptr<layout::grid_panel> WindowGridPanel::create_inventory_panel(HWND
     auto toolbar = std::make_shared<layout::stack_panel>(layout::orientation::horizontal, hWnd);
     toolbar->set_spacing(8);
     auto btn_sync = create_button(_T("Sync"), 70, 26);
+    btn_sync->on_click([this](WPARAM, LPARAM) {
+        // Owner-data list: appending rows costs one item count update, however many rows arrive
+        auto start = std::chrono::steady_clock::now();
+        size_t first = m_Inventory.size();
+        m_Inventory.reserve(first + 100000);
+        for (size_t i = first; i < first + 100000; ++i)
+            m_Inventory.push_back({ make_sku(i), _T("Generated item ") + to_tstring(i), _T("Bulk"), to_tstring(i % 500), _T("$") + to_tstring(10 + i % 90) });
+        m_ListViewOne->source_changed();
+        m_LastSyncTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        update_status();
+    });
     auto btn_export = create_button(_T("Export"), 70, 26);
     auto btn_refresh = create_button(_T("Refresh"), 70, 26);
     btn_refresh->on_click([this](WPARAM, LPARAM) {
@@ -228,17 +241,28 @@ std::shared_ptr<layout::grid_panel> WindowGridPanel::create_inventory_panel(HWND
     inventory_grid->add_panel(toolbar);
     inventory_grid->set_grid_position(toolbar, 0, 1);
 
-    m_ListViewOne = create_list_view(620, 250);
+    m_ListViewOne = create_list_view(620, 250, LVS_REPORT | LVS_OWNERDATA | WS_CHILD | WS_VISIBLE);
     m_ListViewOne->add_column(_T("SKU"), 90);
     m_ListViewOne->add_column(_T("Product"), 170);
     m_ListViewOne->add_column(_T("Category"), 120);
     m_ListViewOne->add_column(_T("Stock"), 80);
     m_ListViewOne->add_column(_T("Price"), 90);
 
-    add_inventory_item_row(m_ListViewOne, 0, _T("LT-100"), _T("Laptop Pro 14"), _T("Computers"), _T("42"), _T("$1299"));
-    add_inventory_item_row(m_ListViewOne, 1, _T("MN-210"), _T("32in Monitor"), _T("Displays"), _T("18"), _T("$399"));
-    add_inventory_item_row(m_ListViewOne, 2, _T("KB-451"), _T("Mechanical Keyboard"), _T("Accessories"), _T("76"), _T("$119"));
-    add_inventory_item_row(m_ListViewOne, 3, _T("MS-307"), _T("Wireless Mouse"), _T("Accessories"), _T("134"), _T("$39"));
+    m_Inventory = {
+        { _T("LT-100"), _T("Laptop Pro 14"), _T("Computers"), _T("42"), _T("$1299") },
+        { _T("MN-210"), _T("32in Monitor"), _T("Displays"), _T("18"), _T("$399") },
+        { _T("KB-451"), _T("Mechanical Keyboard"), _T("Accessories"), _T("76"), _T("$119") },
+        { _T("MS-307"), _T("Wireless Mouse"), _T("Accessories"), _T("134"), _T("$39") },
+    };
+
+    // The control holds no strings; cells are read from m_Inventory as they are painted
+    auto source = std::make_shared<model::vector_list_source<inventory_item, TCHAR>>(m_Inventory);
+    source->add_column([](const inventory_item& item) { return tstring_view(item.sku); })
+        .add_column([](const inventory_item& item) { return tstring_view(item.product); })
+        .add_column([](const inventory_item& item) { return tstring_view(item.category); })
+        .add_column([](const inventory_item& item) { return tstring_view(item.stock); })
+        .add_column([](const inventory_item& item) { return tstring_view(item.price); });
+    m_ListViewOne->set_data_source(source);
 
     inventory_grid->add(m_ListViewOne, 1, 0, 1, 2);
     return inventory_grid;
@@ -307,30 +331,41 @@ std::shared_ptr<layout::grid_panel> WindowGridPanel::create_showcase_panel(HWND
     m_TabControl->add_item(_T("Metrics"));
     m_TabControl->add_item(_T("Settings"));
 
-    auto overview = create_rich_edit(_T("Overview\r\n\r\n")
-                                     _T("This tab demonstrates managed controls that are attached to tab pages."),
-                                     260,
-                                     115);
-
-    auto metrics = create_list_view(260, 115);
-    metrics->add_column(_T("Metric"), 140);
-    metrics->add_column(_T("Value"), 100);
-    metrics->add_item(0, 0, _T("Events processed"));
-    metrics->add_item(0, 1, to_tstring(m_counter).c_str());
-    metrics->add_item(1, 0, _T("Inventory items"));
-    metrics->add_item(1, 1, _T("4"));
-    metrics->add_item(2, 0, _T("Pipeline health"));
-    metrics->add_item(2, 1, _T("82%"));
-    metrics->auto_size_columns();
-
-    auto settings = create_list_box(260, 115);
-    settings->add(_T("Auto refresh: enabled"));
-    settings->add(_T("Telemetry: basic"));
-    settings->add(_T("Theme: system"));
-
-    m_TabControl->add_page_control(0, overview->get_handle());
-    m_TabControl->add_page_control(1, metrics->get_handle());
-    m_TabControl->add_page_control(2, settings->get_handle());
+    // Pages are created the first time their tab is selected; the release callbacks drop them again under memory pressure
+    m_TabControl->set_page_factory(0, [this]() {
+        auto overview = create_rich_edit(_T("Overview\r\n\r\n")
+                                         _T("This tab demonstrates managed controls that are attached to tab pages."),
+                                         260,
+                                         115);
+        HWND handle = overview->get_handle();
+        return tab_control::page_content{ { handle }, nullptr, [this, handle]() { destroy_control(handle); } };
+    });
+
+    m_TabControl->set_page_factory(1, [this]() {
+        auto metrics = create_list_view(260, 115);
+        metrics->add_column(_T("Metric"), 140);
+        metrics->add_column(_T("Value"), 100);
+        metrics->add_item(0, 0, _T("Events processed"));
+        metrics->add_item(0, 1, to_tstring(m_counter).c_str());
+        metrics->add_item(1, 0, _T("Inventory items"));
+        metrics->add_item(1, 1, _T("4"));
+        metrics->add_item(2, 0, _T("Pipeline health"));
+        metrics->add_item(2, 1, _T("82%"));
+        metrics->auto_size_columns();
+        HWND handle = metrics->get_handle();
+        return tab_control::page_content{ { handle }, nullptr, [this, handle]() { destroy_control(handle); } };
+    });
+
+    m_TabControl->set_page_factory(2, [this]() {
+        auto settings = create_list_box(260, 115);
+        settings->add(_T("Auto refresh: enabled"));
+        settings->add(_T("Telemetry: basic"));
+        settings->add(_T("Theme: system"));
+        HWND handle = settings->get_handle();
+        return tab_control::page_content{ { handle }, nullptr, [this, handle]() { destroy_control(handle); } };
+    });
+
+    m_TabControl->set_page_unload_policy(1);
     m_TabControl->on_selection_change([this](LPNMHDR) {
         m_TabControl->sync_managed_pages();
     });
@@ -369,23 +404,43 @@ std::shared_ptr<layout::grid_panel> WindowGridPanel::create_showcase_panel(HWND
 }
 
 std::shared_ptr<layout::stack_panel> WindowGridPanel::create_footer_panel(HWND hWnd) {
-    auto footer = std::make_shared<layout::stack_panel>(layout::orientation::horizontal, hWnd);
-    footer->set_spacing(12);
-    footer->set_padding(5);
-
-    auto status = create_static_control(_T("Ready | Grid layout demo powered by WindowsPlusPlus"), 460, 24);
-    footer->add(status);
-
-    auto link = create_link_control(_T("<a href=\"https://github.com/Timboy67678/WindowsPlusPlus\">GitHub</a>"), 140, 24);
-    link->on_click([this](LPNMHDR nm) {
+    // Fixed shape, so it is declared once as a compile-time tree; building it reserves the exact storage up front
+    static constexpr auto footer_layout = ui::stack(layout::orientation::horizontal,
+        ui::static_text(_T("Ready | Grid layout demo powered by WindowsPlusPlus"), 900, 24)
+            .bind(&WindowGridPanel::m_FooterStatus),
+        ui::link(_T("<a href=\"https://github.com/Timboy67678/WindowsPlusPlus\">GitHub</a>"), 140, 24)
+            .bind(&WindowGridPanel::m_FooterLink))
+        .spacing(12).padding(5);
+
+    auto footer = ui::build(footer_layout, *this);
+    m_FooterLink->on_click([this](LPNMHDR nm) {
         auto item = reinterpret_cast<PNMLINK>(nm)->item;
         ShellExecuteW(NULL, L"open", item.szUrl, NULL, NULL, SW_SHOWNORMAL);
     });
-    footer->add(link);
 
     return footer;
 }
 
+// Startup, resize and sync costs, with the layout and tab page counters behind them
+void WindowGridPanel::update_status() {
+    if (!m_FooterStatus) {
+        return;
+    }
+
+    tstring status = _T("Startup ") + to_tstring(m_StartupTime.count()) + _T(" us | Resize ") + to_tstring(m_LastResizeTime.count())
+        + _T(" us | Layout passes ") + to_tstring(m_LayoutStatistics->measure_passes.load(std::memory_order_relaxed))
+        + _T(", window moves ") + to_tstring(m_LayoutStatistics->window_commits.load(std::memory_order_relaxed));
+    if (m_TabControl) {
+        const auto& pages = m_TabControl->get_page_statistics();
+        status += _T(" | Pages ") + to_tstring(pages.realized_pages) + _T(" realized, last page layout ")
+            + to_tstring(pages.last_layout_us) + _T(" us");
+    }
+    if (m_LastSyncTime.count() > 0) {
+        status += _T(" | Sync 100k rows ") + to_tstring(m_LastSyncTime.count() / 1000) + _T(" ms");
+    }
+    m_FooterStatus->set_text(status);
+}
+
 void WindowGridPanel::arrange_main_grid(const std::shared_ptr<layout::grid_panel>& main_grid) {
     RECT client_rect = get_client_rect();
     main_grid->measure(client_rect.right - client_rect.left, client_rect.bottom - client_rect.top);
@@ -12,6 +12,14 @@ protected:
     message_handler on_size;
 
 private:
+    struct inventory_item {
+        tstring sku;
+        tstring product;
+        tstring category;
+        tstring stock;
+        tstring price;
+    };
+
     std::shared_ptr<layout::grid_panel> create_main_grid(HWND hWnd);
     std::shared_ptr<layout::grid_panel> create_header_panel(HWND hWnd, const std::shared_ptr<layout::grid_panel>& main_grid);
     std::shared_ptr<layout::grid_panel> create_form_panel(HWND hWnd);
@@ -20,6 +28,7 @@ private:
     std::shared_ptr<layout::grid_panel> create_showcase_panel(HWND hWnd);
     std::shared_ptr<layout::stack_panel> create_footer_panel(HWND hWnd);
     void arrange_main_grid(const std::shared_ptr<layout::grid_panel>& main_grid);
+    void update_status();
 
     // Control references for demo
     control_ptr<button> m_IncrementBtn;
@@ -29,6 +38,16 @@ private:
     control_ptr<edit_text> m_EditOne;
     control_ptr<edit_text> m_EditTwo;
     control_ptr<edit_text> m_EditThree;
+    control_ptr<sys_link> m_FooterLink;
+    control_ptr<static_control> m_FooterStatus;
+
+    std::vector<inventory_item> m_Inventory;
 
     int m_counter = 0;
+
+    // Measured costs shown in the footer
+    std::shared_ptr<layout::layout_statistics> m_LayoutStatistics = std::make_shared<layout::layout_statistics>();
+    std::chrono::microseconds m_StartupTime{};
+    std::chrono::microseconds m_LastResizeTime{};
+    std::chrono::microseconds m_LastSyncTime{};
 };
@@ -15,6 +15,7 @@
 #include <tchar.h>
 
 #include <string>
+#include <chrono>
 #include <functional>
 #include <thread>
 
@@ -23,6 +24,7 @@
 #include "..\winplusplus.hpp"
 #include "..\dialog.hpp"
 #include "..\window.hpp"
+#include "..\ui_builder.hpp"
 
 using namespace wpp;
 
@@ -0,0 +1,33 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::uint64_t> g_count{ 0 };
+    std::atomic<std::uint64_t> g_bytes{ 0 };
+
+    void* counted_allocate(std::size_t size) {
+        g_count.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (void* block = std::malloc(size ? size : 1))
+            return block;
+        throw std::bad_alloc();
+    }
+}
+
+namespace wpp::bench
+{
+    allocation_counts allocations() {
+        return { g_count.load(std::memory_order_relaxed), g_bytes.load(std::memory_order_relaxed) };
+    }
+}
+
+void* operator new(std::size_t size) { return counted_allocate(size); }
+void* operator new[](std::size_t size) { return counted_allocate(size); }
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
@@ -0,0 +1,23 @@
+#ifndef WPP_BENCHMARKS_ALLOC_COUNTER_HPP
+#define WPP_BENCHMARKS_ALLOC_COUNTER_HPP
+
+// Process-wide count of heap allocations made through operator new, for allocations-per-pass figures.
+// Benchmarks that include this header link alloc_counter.cpp, which replaces the global operator new.
+
+#include <cstdint>
+
+namespace wpp::bench
+{
+    struct allocation_counts {
+        std::uint64_t count = 0;
+        std::uint64_t bytes = 0;
+
+        allocation_counts operator-(const allocation_counts& earlier) const {
+            return { count - earlier.count, bytes - earlier.bytes };
+        }
+    };
+
+    allocation_counts allocations();
+}
+
+#endif // WPP_BENCHMARKS_ALLOC_COUNTER_HPP
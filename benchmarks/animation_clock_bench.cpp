@@ -0,0 +1,96 @@
+// Animation clock benchmark: many animated values spread over a number of windows, ticked at 60 Hz on a
+// virtual clock. Every value defers a layout commit on its window, which the clock coalesces to one commit per
+// window per frame. A second case cancels and restarts a share of the animations every frame, as hover
+// effects do when the mouse sweeps over a list.
+
+#include "bench.hpp"
+#include "graphics/animation_clock.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::graphics;
+
+namespace
+{
+    constexpr std::uint64_t frame_us = 16'667;
+
+    struct window_stub {
+        std::uint64_t layouts = 0;
+    };
+
+    struct scene {
+        animation_clock clock;
+        std::vector<window_stub> windows;
+        std::vector<double> values;
+        std::vector<animation_clock::animation_id> ids;
+        std::mt19937 random{ 7 };
+
+        scene(std::size_t animations, std::size_t window_count) : windows(window_count), values(animations), ids(animations) {}
+
+        void start(std::size_t index, std::uint64_t now) {
+            window_stub* window = &windows[index % windows.size()];
+            animation_spec spec;
+            spec.from = 0.0;
+            spec.to = 100.0;
+            spec.duration = 200'000 + random() % 600'000;
+            spec.repeat = -1;
+            spec.alternate = true;
+            spec.owner = window;
+            spec.apply = [this, index, window](double value) {
+                values[index] = value;
+                clock.defer(window, [window] { window->layouts++; });
+            };
+            ids[index] = clock.start(std::move(spec), now);
+        }
+    };
+
+    void run(const char* name, std::size_t animations, std::size_t windows, int frames, double churn) {
+        scene s(animations, windows);
+        for (std::size_t i = 0; i < animations; ++i)
+            s.start(i, 0);
+
+        std::size_t restarts = static_cast<std::size_t>(animations * churn);
+        std::uniform_int_distribution<std::size_t> pick(0, animations - 1);
+        std::uint64_t churn_ns = 0;
+        auto start = bench::clock::now();
+        for (int frame = 1; frame <= frames; ++frame) {
+            std::uint64_t now = frame * frame_us;
+            if (restarts) {
+                auto churn_start = bench::clock::now();
+                for (std::size_t r = 0; r < restarts; ++r) {
+                    std::size_t index = pick(s.random);
+                    s.clock.cancel(s.ids[index]);
+                    s.start(index, now);
+                }
+                churn_ns += bench::elapsed_ns(churn_start);
+            }
+            s.clock.tick(now);
+        }
+        std::uint64_t elapsed = bench::elapsed_ns(start);
+        bench::keep(s.values);
+
+        const auto& stats = s.clock.get_statistics();
+        bench::result("animation_clock", name)
+            .add("animations", static_cast<std::uint64_t>(animations))
+            .add("windows", static_cast<std::uint64_t>(windows))
+            .add("frames", frames)
+            .add("ns_per_frame", static_cast<double>(elapsed) / frames)
+            .add("ns_per_update", static_cast<double>(elapsed - churn_ns) / stats.updates)
+            .add("churn_ns_per_frame", static_cast<double>(churn_ns) / frames)
+            .add("commits_per_frame", static_cast<double>(stats.commits) / frames)
+            .add("coalesced_per_frame", static_cast<double>(stats.coalesced) / frames)
+            .add("frame_budget_share", static_cast<double>(elapsed) / frames / (frame_us * 1000.0));
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const std::size_t animations = options.quick ? 1'000 : 10'000;
+    const int frames = options.quick ? 30 : 600;
+
+    run("steady", animations, 100, frames, 0.0);
+    run("churn_10_percent", animations, 100, frames, 0.1);
+    return 0;
+}
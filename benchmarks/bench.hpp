@@ -0,0 +1,96 @@
+#ifndef WPP_BENCHMARKS_BENCH_HPP
+#define WPP_BENCHMARKS_BENCH_HPP
+
+// Shared benchmark plumbing: command line options, a monotonic timer and a result line printed as one JSON
+// object per line, so runs can be collected with any line-oriented tool and compared across commits.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace wpp::bench
+{
+    struct options {
+        bool quick = false;         // small sizes and few repetitions, for smoke runs under ctest
+    };
+
+    inline options parse_options(int argc, char** argv) {
+        options result;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--quick") == 0)
+                result.quick = true;
+        }
+        return result;
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    inline std::uint64_t elapsed_ns(clock::time_point start) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+    }
+
+    inline const void* volatile keep_sink = nullptr;
+
+    // Keeps the optimizer from discarding a computed value
+    template<typename T>
+    inline void keep(const T& value) {
+        keep_sink = &value;
+    }
+
+    // {"benchmark":"...","case":"...",...} on one line; fields are printed in the order they are added
+    class result {
+    public:
+        result(std::string_view benchmark, std::string_view name) {
+            m_line += "{\"benchmark\":\"";
+            m_line += benchmark;
+            m_line += "\",\"case\":\"";
+            m_line += name;
+            m_line += '"';
+        }
+
+        ~result() {
+            m_line += '}';
+            std::puts(m_line.c_str());
+            std::fflush(stdout);
+        }
+
+        result(const result&) = delete;
+        result& operator=(const result&) = delete;
+
+        result& add(std::string_view key, std::uint64_t value) { return field(key, std::to_string(value)); }
+        result& add(std::string_view key, std::int64_t value) { return field(key, std::to_string(value)); }
+        result& add(std::string_view key, int value) { return field(key, std::to_string(value)); }
+        result& add(std::string_view key, unsigned value) { return field(key, std::to_string(value)); }
+
+        result& add(std::string_view key, double value) {
+            char buffer[64];
+            std::snprintf(buffer, sizeof buffer, "%.3f", value);
+            return field(key, buffer);
+        }
+
+        result& add(std::string_view key, std::string_view value) {
+            std::string quoted = "\"";
+            quoted += value;
+            quoted += '"';
+            return field(key, quoted);
+        }
+
+        result& add(std::string_view key, const char* value) { return add(key, std::string_view(value)); }
+
+    private:
+        result& field(std::string_view key, std::string_view value) {
+            m_line += ",\"";
+            m_line += key;
+            m_line += "\":";
+            m_line += value;
+            return *this;
+        }
+
+        std::string m_line;
+    };
+}
+
+#endif // WPP_BENCHMARKS_BENCH_HPP
@@ -0,0 +1,128 @@
+// Bulk insert benchmark: filling a list with 100k named records. The control is stood in for by a string
+// store laid out like a list box's (one text heap plus an item table), so the figures isolate what the
+// wrapper does per fill: the old path copies the records' names into a vector of strings and appends one by
+// one into storage that regrows; the bulk path projects each name on the fly, totals the text first and
+// reserves the store once (as LB_INITSTORAGE does). Each case reports time, allocations and store regrowths.
+
+#include "alloc_counter.hpp"
+#include "bench.hpp"
+#include "model/bulk_insert.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::model;
+
+namespace
+{
+    struct record {
+        std::string name;
+        std::uint64_t id = 0;
+    };
+
+    // Texts copied into one heap with an offset per item, as the control keeps them
+    class string_store {
+    public:
+        void init_storage(std::size_t items, std::size_t bytes) {
+            m_offsets.reserve(m_offsets.size() + items);
+            m_text.reserve(m_text.size() + bytes);
+        }
+
+        int add(const char* text) {
+            std::size_t capacity = m_text.capacity();
+            m_offsets.push_back(m_text.size());
+            m_text.append(text, std::char_traits<char>::length(text) + 1);
+            m_regrowths += m_text.capacity() != capacity ? 1 : 0;
+            return static_cast<int>(m_offsets.size() - 1);
+        }
+
+        std::size_t size() const { return m_offsets.size(); }
+        std::size_t bytes() const { return m_text.size(); }
+        std::uint64_t regrowths() const { return m_regrowths; }
+
+    private:
+        std::vector<std::size_t> m_offsets;
+        std::string m_text;
+        std::uint64_t m_regrowths = 0;
+    };
+
+    // list_box::add_range without the messages
+    template<typename Range, typename TextFn>
+    bulk_insert_result bulk_add(string_store& store, const Range& items, TextFn text_of) {
+        auto start = bench::clock::now();
+        bulk_insert_result result;
+        result.requested = static_cast<std::size_t>(std::ranges::distance(items));
+        result.text_bytes = total_text_bytes<char>(items, text_of);
+        store.init_storage(result.requested, result.text_bytes);
+        terminated_text<char> text;
+        for (const auto& item : items) {
+            result.last_index = store.add(text(text_of(item)));
+            result.inserted++;
+        }
+        result.elapsed = bench::clock::now() - start;
+        return result;
+    }
+
+    void report(const char* name, const bulk_insert_result& result, const bench::allocation_counts& allocations, const string_store& store) {
+        bench::result("bulk_insert", name)
+            .add("items", static_cast<std::uint64_t>(result.inserted))
+            .add("complete", result.complete() && store.size() == result.requested ? "yes" : "no")
+            .add("text_bytes", static_cast<std::uint64_t>(store.bytes()))
+            .add("ns", static_cast<std::uint64_t>(result.elapsed.count()))
+            .add("items_per_second", result.items_per_second())
+            .add("allocs", allocations.count)
+            .add("alloc_bytes", allocations.bytes)
+            .add("regrowths", store.regrowths());
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const std::size_t count = options.quick ? 5000 : 100000;
+
+    // Names long enough to defeat the small string optimization, as symbol and file names do
+    std::vector<record> records;
+    records.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        records.push_back({ "namespace::module_" + std::to_string(i % 97) + "::function_" + std::to_string(i), i });
+
+    {
+        string_store store;
+        auto before = bench::allocations();
+        auto start = bench::clock::now();
+        std::vector<std::string> names;
+        for (const record& r : records)
+            names.push_back(r.name);
+        bulk_insert_result result;
+        result.requested = names.size();
+        for (const std::string& name : names) {
+            result.last_index = store.add(name.c_str());
+            result.inserted++;
+        }
+        result.elapsed = bench::clock::now() - start;
+        report("copy_then_add", result, bench::allocations() - before, store);
+    }
+
+    {
+        string_store store;
+        auto before = bench::allocations();
+        auto result = bulk_add(store, records, [](const record& r) { return std::string_view(r.name); });
+        report("projected", result, bench::allocations() - before, store);
+    }
+
+    {
+        std::vector<std::string_view> views;
+        views.reserve(count);
+        for (const record& r : records)
+            views.push_back(r.name);
+        string_store store;
+        auto before = bench::allocations();
+        auto result = bulk_add(store, std::span<const std::string_view>(views), as_text{});
+        report("span_of_views", result, bench::allocations() - before, store);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Constraint solver benchmark: a constraint panel of form-like rows whose slots chain left to right, with the
+// last slot of every row pinned to the content width, so every resize reaches every row. A resize sweep is
+// solved incrementally through the edit variables, which is what constraint_panel does; building the system
+// from scratch, the cost every resize would pay without the kept tableau, is reported for comparison.
+
+#include "bench.hpp"
+#include "layout/constraint_solver.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::layout::constraints;
+
+namespace
+{
+    struct form {
+        std::unique_ptr<constraint_system> system;
+        int slots = 0;
+    };
+
+    form build(int rows, int columns) {
+        form result{ std::make_unique<constraint_system>() };
+        auto& system = *result.system;
+        auto& s = system.get_solver();
+        for (int row = 0; row < rows; ++row) {
+            int left_neighbour = -1;
+            for (int column = 0; column < columns; ++column) {
+                int index = system.add_slot();
+                const auto& slot = system.get_slot(index);
+                if (left_neighbour < 0) {
+                    s.add_constraint(slot.left == 0.0);
+                } else {
+                    const auto& left = system.get_slot(left_neighbour);
+                    s.add_constraint(slot.left == left.left + left.width + expression(4.0));
+                }
+                // Rows sit on a fixed pitch and the slots of a row align with its first one
+                if (column > 0)
+                    s.add_constraint(slot.top == system.get_slot(left_neighbour).top);
+                else
+                    s.add_constraint(slot.top == static_cast<double>(row * 26));
+                if (column == columns - 1)
+                    s.add_constraint((slot.left + slot.width == expression(system.content_width())) | strength::strong);
+                system.sync_slot_size(index, 60 + column * 7 % 40, 22, 20, 16, 400, 40);
+                left_neighbour = index;
+            }
+        }
+        result.slots = rows * columns;
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    // 81 constraints per row of 8 slots: about 5,000 constraints at full size
+    const int rows = options.quick ? 10 : 62;
+    const int columns = 8;
+    const int sizes = options.quick ? 10 : 200;
+
+    auto start = bench::clock::now();
+    form panel = build(rows, columns);
+    std::uint64_t build_ns = bench::elapsed_ns(start);
+    size_t constraints = panel.system->get_solver().constraint_count();
+
+    start = bench::clock::now();
+    for (int step = 0; step < sizes; ++step)
+        panel.system->resize(600 + step * 4, 400 + step);
+    std::uint64_t resolve_ns = bench::elapsed_ns(start);
+
+    double resolve = static_cast<double>(resolve_ns) / sizes;
+    double rebuild = static_cast<double>(build_ns);
+    bench::result("constraint_solver", "resize_sweep")
+        .add("slots", panel.slots)
+        .add("constraints", static_cast<std::uint64_t>(constraints))
+        .add("build_ns", build_ns)
+        .add("resolve_ns", resolve)
+        .add("speedup", resolve > 0 ? rebuild / resolve : 0.0);
+    return 0;
+}
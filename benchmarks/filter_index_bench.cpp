@@ -0,0 +1,130 @@
+// Filter index benchmark: type-to-filter over a 1M-row table with a file-name column (trigram indexed) and a
+// folder column (scanned). Times the index build, then each keystroke of a query typed one character at a
+// time and pasted whole, in "contains" and "starts with" modes, against folding and searching every row's strings per
+// keystroke as a plain loop over a vector of rows would.
+
+#include "bench.hpp"
+#include "model/filter_index.hpp"
+
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::model;
+
+namespace
+{
+    const char* strategy_name(basic_filter_index<char>::strategy s) {
+        using strategy = basic_filter_index<char>::strategy;
+        switch (s) {
+        case strategy::all: return "all";
+        case strategy::unchanged: return "unchanged";
+        case strategy::index: return "index";
+        case strategy::scan: return "scan";
+        default: return "narrow";
+        }
+    }
+
+    std::string random_word(std::mt19937& random, int min_length, int max_length) {
+        std::string word;
+        for (int i = 0, length = min_length + static_cast<int>(random() % (max_length - min_length + 1)); i < length; ++i)
+            word.push_back(static_cast<char>((random() % 4 ? 'a' : 'A') + random() % 26));
+        return word;
+    }
+
+    std::size_t brute_force(const std::vector<std::string>& names, const std::vector<std::string>& folders,
+                            const std::string& query, match_mode mode) {
+        std::string folded;
+        std::size_t count = 0;
+        auto matches = [&](const std::string& text) {
+            folded.assign(text);
+            for (char& c : folded)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return mode == match_mode::prefix ? folded.starts_with(query) : folded.find(query) != std::string::npos;
+        };
+        for (std::size_t row = 0; row < names.size(); ++row)
+            count += matches(names[row]) || matches(folders[row]) ? 1 : 0;
+        return count;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const std::size_t rows = options.quick ? 50'000 : 1'000'000;
+
+    std::mt19937 random(23);
+    std::vector<std::string> names(rows), folders(rows);
+    auto table = std::make_shared<basic_column_model<char>>();
+    table->add_column(column_type::text);
+    table->add_column(column_type::text);
+    table->reserve(rows);
+    for (std::size_t row = 0; row < rows; ++row) {
+        names[row] = random_word(random, 4, 10) + "_" + random_word(random, 3, 8) + ".txt";
+        folders[row] = random_word(random, 3, 6) + "/" + random_word(random, 3, 6);
+        table->append_row({ std::string_view(names[row]), std::string_view(folders[row]) });
+    }
+
+    thread_pool pool;
+    basic_filter_index<char> filter(table);
+    filter.add_column(0);
+    filter.add_column(1, false);
+    auto start = bench::clock::now();
+    filter.rebuild(&pool);
+    std::uint64_t rebuild_ns = bench::elapsed_ns(start);
+    bench::result("filter_index", "rebuild")
+        .add("rows", static_cast<std::uint64_t>(rows))
+        .add("threads", pool.size())
+        .add("rebuild_ns", rebuild_ns);
+
+    // The query a user would type, taken from a real row so it ends with a few matches
+    std::string typed = names[rows / 2].substr(1, 6);
+    for (char& c : typed)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    bool matches = true;
+    for (match_mode mode : { match_mode::contains, match_mode::prefix }) {
+        std::string query = mode == match_mode::prefix ? names[rows / 2].substr(0, 6) : typed;
+        for (char& c : query)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+        filter.clear_filter();
+        for (std::size_t length = 1; length <= query.size(); ++length) {
+            std::string prefix = query.substr(0, length);
+            start = bench::clock::now();
+            std::size_t count = filter.filter(prefix, mode, &pool);
+            std::uint64_t filter_ns = bench::elapsed_ns(start);
+
+            start = bench::clock::now();
+            std::size_t brute_count = brute_force(names, folders, prefix, mode);
+            std::uint64_t brute_ns = bench::elapsed_ns(start);
+            matches &= count == brute_count;
+
+            bench::result("filter_index", mode == match_mode::prefix ? "prefix_keystroke" : "contains_keystroke")
+                .add("rows", static_cast<std::uint64_t>(rows))
+                .add("query_length", static_cast<std::uint64_t>(length))
+                .add("matches", static_cast<std::uint64_t>(count))
+                .add("strategy", strategy_name(filter.get_statistics().last))
+                .add("candidates", static_cast<std::uint64_t>(filter.get_statistics().candidates))
+                .add("filter_ns", filter_ns)
+                .add("brute_force_ns", brute_ns)
+                .add("same_result", count == brute_count ? "yes" : "no");
+        }
+
+        // The whole query pasted at once: answered from the index (or a scan of the unindexed column)
+        filter.clear_filter();
+        start = bench::clock::now();
+        std::size_t count = filter.filter(query, mode, &pool);
+        std::uint64_t filter_ns = bench::elapsed_ns(start);
+        matches &= count == brute_force(names, folders, query, mode);
+        bench::result("filter_index", mode == match_mode::prefix ? "prefix_pasted" : "contains_pasted")
+            .add("rows", static_cast<std::uint64_t>(rows))
+            .add("query_length", static_cast<std::uint64_t>(query.size()))
+            .add("matches", static_cast<std::uint64_t>(count))
+            .add("strategy", strategy_name(filter.get_statistics().last))
+            .add("candidates", static_cast<std::uint64_t>(filter.get_statistics().candidates))
+            .add("filter_ns", filter_ns);
+    }
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// Keyed diff benchmark: a 100k-item list refreshed from a new snapshot of its data, as a list box reconcile
+// does. Each case times the snapshot (keys and content hashes) and the diff, and counts the edits the list
+// would receive against the clear-and-refill it replaces (remove every item, add every item).
+
+#include "bench.hpp"
+#include "model/keyed_diff.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::model;
+
+namespace
+{
+    struct item {
+        std::uint64_t key;
+        std::string text;
+    };
+
+    struct scenario {
+        const char* name;
+        void (*edit)(std::vector<item>& items, std::mt19937& random);
+    };
+
+    std::uint64_t next_key = 1u << 30;
+
+    void edit_few(std::vector<item>& items, std::mt19937& random) {
+        // A refresh of a live list: 1% retitled, 100 removed, 100 added, 50 moved
+        for (std::size_t i = 0; i < items.size() / 100; ++i)
+            items[random() % items.size()].text += " (edited)";
+        for (int i = 0; i < 100; ++i)
+            items.erase(items.begin() + static_cast<std::ptrdiff_t>(random() % items.size()));
+        for (int i = 0; i < 100; ++i)
+            items.insert(items.begin() + static_cast<std::ptrdiff_t>(random() % items.size()), { next_key++, "new item" });
+        for (int i = 0; i < 50; ++i) {
+            std::size_t from = random() % items.size(), to = random() % items.size();
+            item moved = std::move(items[from]);
+            items.erase(items.begin() + static_cast<std::ptrdiff_t>(from));
+            items.insert(items.begin() + static_cast<std::ptrdiff_t>(to), std::move(moved));
+        }
+    }
+
+    void append_page(std::vector<item>& items, std::mt19937&) {
+        for (int i = 0; i < 1000; ++i)
+            items.push_back({ next_key++, "appended item" });
+    }
+
+    void reverse(std::vector<item>& items, std::mt19937&) { std::reverse(items.begin(), items.end()); }
+
+    void shuffle(std::vector<item>& items, std::mt19937& random) { std::shuffle(items.begin(), items.end(), random); }
+
+    keyed_snapshot snapshot(const std::vector<item>& items) {
+        return make_snapshot(items, [](const item& i) { return i.key; }, [](const item& i) { return content_hash(std::string_view(i.text)); });
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const std::size_t count = options.quick ? 10'000 : 100'000;
+    const int repeats = options.quick ? 2 : 10;
+
+    std::mt19937 random(31);
+    std::vector<item> original(count);
+    for (std::size_t i = 0; i < count; ++i)
+        original[i] = { i, "item " + std::to_string(i) };
+    keyed_snapshot before = snapshot(original);
+
+    const scenario scenarios[] = {
+        { "few_edits", edit_few },
+        { "append_page", append_page },
+        { "reverse", reverse },
+        { "shuffle", shuffle },
+    };
+
+    for (const auto& test : scenarios) {
+        std::vector<item> changed = original;
+        test.edit(changed, random);
+
+        std::uint64_t snapshot_ns = 0, diff_ns = 0;
+        keyed_diff diff;
+        for (int i = 0; i < repeats; ++i) {
+            auto start = bench::clock::now();
+            keyed_snapshot after = snapshot(changed);
+            snapshot_ns += bench::elapsed_ns(start);
+
+            start = bench::clock::now();
+            diff = diff_keyed<std::uint64_t>(before.keys, after.keys, before.content, after.content);
+            diff_ns += bench::elapsed_ns(start);
+        }
+
+        std::size_t edits = diff.removed.size() + diff.inserted.size() + diff.updated.size();
+        bench::result("keyed_diff", test.name)
+            .add("old_items", static_cast<std::uint64_t>(original.size()))
+            .add("new_items", static_cast<std::uint64_t>(changed.size()))
+            .add("snapshot_ns", snapshot_ns / repeats)
+            .add("diff_ns", diff_ns / repeats)
+            .add("removed", static_cast<std::uint64_t>(diff.removed.size()))
+            .add("inserted", static_cast<std::uint64_t>(diff.inserted.size()))
+            .add("updated", static_cast<std::uint64_t>(diff.updated.size()))
+            .add("moved", static_cast<std::uint64_t>(diff.moved))
+            .add("edits", static_cast<std::uint64_t>(edits))
+            .add("refill_edits", static_cast<std::uint64_t>(original.size() + changed.size()));
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Layout benchmark suite. Synthetic panel trees (wide grids, deep nesting, an application window, a forest of
+// forms) go through the full resize path over a stub window backend: capture a snapshot of the tree, measure,
+// arrange, and commit the changed rectangles. A sweep of sizes like a drag-resize is replayed per tree, and
+// each case reports time, heap allocations and commits per pass.
+
+#include "alloc_counter.hpp"
+#include "bench.hpp"
+#include "stub_backend.hpp"
+#include "synthetic_trees.hpp"
+#include "thread_pool.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::layout;
+
+namespace
+{
+    struct tree_case {
+        std::string name;
+        std::function<int(layout_tree&)> build;     // returns the number of leaves
+    };
+
+    // Sizes a drag-resize passes through: growing, then shrinking, with the height following the width
+    std::vector<sizing_t> resize_sweep(int steps) {
+        std::vector<sizing_t> sizes;
+        sizes.reserve(static_cast<size_t>(steps));
+        for (int step = 0; step < steps; ++step) {
+            int phase = step < steps / 2 ? step : steps - step;
+            int width = 640 + phase * 2560 / (steps > 1 ? steps : 1);
+            sizes.push_back({ width, 400 + width / 3 });
+        }
+        return sizes;
+    }
+
+    void run_case(const tree_case& test, thread_pool* pool, const std::vector<sizing_t>& sizes) {
+        layout_tree prototype;
+        int leaves = test.build(prototype);
+        bench::stub_backend backend(leaves);
+        layout_engine engine(pool);
+
+        // Warm up at the first size so the backend starts from a committed layout, as a shown window does
+        {
+            layout_tree snapshot = prototype;
+            engine.layout(snapshot, 0, 0, 0, sizes.front().width, sizes.front().height);
+            backend.commit(snapshot);
+        }
+        std::uint64_t commits_before = backend.commits();
+        std::uint64_t area_before = backend.damage_area();
+
+        std::uint64_t capture_ns = 0, measure_ns = 0, arrange_ns = 0, commit_ns = 0;
+        bench::allocation_counts capture_allocations, layout_allocations;
+        for (const auto& size : sizes) {
+            auto before = bench::allocations();
+            auto start = bench::clock::now();
+            layout_tree snapshot = prototype;     // what panel::capture_layout hands to the engine
+            capture_ns += bench::elapsed_ns(start);
+            auto captured = bench::allocations();
+            capture_allocations.count += (captured - before).count;
+            capture_allocations.bytes += (captured - before).bytes;
+
+            start = bench::clock::now();
+            engine.measure(snapshot, 0, size.width, size.height);
+            measure_ns += bench::elapsed_ns(start);
+            start = bench::clock::now();
+            engine.arrange(snapshot, 0, { 0, 0, size.width, size.height });
+            arrange_ns += bench::elapsed_ns(start);
+            auto laid_out = bench::allocations();
+            layout_allocations.count += (laid_out - captured).count;
+            layout_allocations.bytes += (laid_out - captured).bytes;
+
+            start = bench::clock::now();
+            backend.commit(snapshot);
+            commit_ns += bench::elapsed_ns(start);
+        }
+
+        double passes = static_cast<double>(sizes.size());
+        bench::result("layout", test.name)
+            .add("threads", pool ? pool->size() : 0u)
+            .add("nodes", static_cast<std::uint64_t>(prototype.size()))
+            .add("leaves", leaves)
+            .add("passes", static_cast<std::uint64_t>(sizes.size()))
+            .add("capture_ns", capture_ns / passes)
+            .add("measure_ns", measure_ns / passes)
+            .add("arrange_ns", arrange_ns / passes)
+            .add("commit_ns", commit_ns / passes)
+            .add("ns_per_pass", (capture_ns + measure_ns + arrange_ns + commit_ns) / passes)
+            .add("capture_allocs", capture_allocations.count / passes)
+            .add("layout_allocs", layout_allocations.count / passes)
+            .add("layout_alloc_bytes", layout_allocations.bytes / passes)
+            .add("commits", (backend.commits() - commits_before) / passes)
+            .add("commits_fraction", (backend.commits() - commits_before) / passes / leaves)
+            .add("damage_area", (backend.damage_area() - area_before) / passes);
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const int scale = options.quick ? 1 : 4;
+
+    std::vector<tree_case> cases = {
+        { "wide_grid", [&](layout_tree& tree) { return bench::build_wide_grid(tree, 25 * scale, 20); } },
+        { "deep_nesting", [&](layout_tree& tree) { return bench::build_deep_nesting(tree, 50 * scale); } },
+        { "application", [&](layout_tree& tree) { return bench::build_application(tree, 12 * scale, 12); } },
+        { "forest", [&](layout_tree& tree) { return bench::build_forest(tree, 8 * scale, 24); } },
+    };
+    auto sizes = resize_sweep(options.quick ? 10 : 200);
+
+    for (const auto& test : cases)
+        run_case(test, nullptr, sizes);
+
+    thread_pool pool;
+    for (const auto& test : cases)
+        run_case(test, &pool, sizes);
+    return 0;
+}
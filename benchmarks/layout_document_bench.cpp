@@ -0,0 +1,133 @@
+// Layout document benchmark: the startup path of a window built from a declarative layout of about 2,000
+// elements. Times parsing the text form and serializing it (done once, at build time), then opening the
+// binary form in place and instantiating it (done at every startup) with a builder that only records what a
+// window would create, and counts the allocations each step makes.
+
+#include "alloc_counter.hpp"
+#include "bench.hpp"
+#include "layout/layout_document.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::layout;
+
+namespace
+{
+    // A dock root with a toolbar, and a grid of `panes` form panels of `fields` label/field rows each
+    std::string generate_layout(int panes, int fields) {
+        std::string text = "dock name=root padding=8 {\n";
+        text += "    stack name=toolbar dock=top orientation=horizontal spacing=4 {\n";
+        for (int i = 0; i < 12; ++i)
+            text += "        button name=tool" + std::to_string(i) + " text=\"Tool " + std::to_string(i) + "\" width=72 height=24\n";
+        text += "    }\n";
+
+        int columns = 4;
+        int rows = (panes + columns - 1) / columns;
+        text += "    grid name=content dock=fill spacing=8 rows=";
+        for (int row = 0; row < rows; ++row)
+            text += row ? ",auto" : "auto";
+        text += " columns=*,*,*,* {\n";
+        for (int pane = 0; pane < panes; ++pane) {
+            text += "        grid row=" + std::to_string(pane / columns) + " column=" + std::to_string(pane % columns)
+                + " column_spacing=8 row_spacing=4 columns=auto,* {\n";
+            for (int field = 0; field < fields; ++field) {
+                std::string id = std::to_string(pane) + "_" + std::to_string(field);
+                text += "            static text=\"Field " + id + "\" row=" + std::to_string(field) + " column=0\n";
+                text += "            edit name=field" + id + " row=" + std::to_string(field) + " column=1 height=22\n";
+            }
+            text += "        }\n";
+        }
+        text += "    }\n}\n";
+        return text;
+    }
+
+    // Stands in for the window's builder: one slot per element, as the real one keeps its panels and controls
+    struct counting_builder : layout_builder {
+        std::vector<const layout_record*> elements;
+        std::size_t named = 0;
+        std::size_t text_bytes = 0;
+
+        void reserve(std::size_t count) override {
+            elements.clear();
+            elements.reserve(count);
+        }
+
+        bool create(std::size_t, const layout_record& record, const layout_view& view) override {
+            elements.push_back(&record);
+            named += view.string(record.name).empty() ? 0 : 1;
+            text_bytes += view.string(record.text).size();
+            if (record.kind == element_kind::grid)
+                text_bytes += view.rows(record).size() + view.columns(record).size();
+            return true;
+        }
+
+        bool attach(std::size_t parent, std::size_t index, const layout_record&, const layout_view&) override {
+            return parent < index;
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const int panes = 40;
+    const int fields = 24;
+    const int repeats = options.quick ? 5 : 200;
+
+    std::string text = generate_layout(panes, fields);
+
+    layout_document document;
+    std::string error;
+    auto start = bench::clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        if (!layout_document::parse(text, document, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+    std::uint64_t parse_ns = bench::elapsed_ns(start) / repeats;
+
+    std::vector<std::uint8_t> blob;
+    start = bench::clock::now();
+    for (int i = 0; i < repeats; ++i)
+        blob = document.serialize();
+    std::uint64_t serialize_ns = bench::elapsed_ns(start) / repeats;
+
+    layout_view view;
+    counting_builder builder;
+    builder.reserve(document.nodes.size());
+    bool loaded = true;
+    std::uint64_t open_ns = 0, instantiate_ns = 0;
+    bench::allocation_counts open_allocs, instantiate_allocs;
+    for (int i = 0; i < repeats; ++i) {
+        auto before = bench::allocations();
+        start = bench::clock::now();
+        loaded &= layout_view::open(blob.data(), blob.size(), view, &error);
+        open_ns += bench::elapsed_ns(start);
+        auto opened = bench::allocations();
+
+        start = bench::clock::now();
+        loaded &= instantiate(view, builder);
+        instantiate_ns += bench::elapsed_ns(start);
+        auto instantiated = bench::allocations();
+
+        open_allocs = opened - before;
+        instantiate_allocs = instantiated - opened;
+    }
+    bench::keep(builder.text_bytes);
+    loaded &= builder.elements.size() == document.nodes.size();
+
+    bench::result("layout_document", "startup_load")
+        .add("elements", static_cast<std::uint64_t>(document.nodes.size()))
+        .add("text_bytes", static_cast<std::uint64_t>(text.size()))
+        .add("blob_bytes", static_cast<std::uint64_t>(blob.size()))
+        .add("parse_ns", static_cast<std::uint64_t>(parse_ns))
+        .add("serialize_ns", static_cast<std::uint64_t>(serialize_ns))
+        .add("open_ns", static_cast<double>(open_ns) / repeats)
+        .add("instantiate_ns", static_cast<double>(instantiate_ns) / repeats)
+        .add("open_allocs", static_cast<std::uint64_t>(open_allocs.count))
+        .add("instantiate_allocs", static_cast<std::uint64_t>(instantiate_allocs.count))
+        .add("loaded", loaded ? "yes" : "no");
+    return loaded ? 0 : 1;
+}
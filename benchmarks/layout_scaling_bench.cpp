@@ -0,0 +1,72 @@
+// Scaling of the parallel layout engine across pool sizes. A forest of independent form subtrees is laid out
+// at a sweep of window sizes, first without a pool (the sequential baseline), then on pools of 1 to 16
+// workers; speedup is relative to the baseline. Results are checked against the baseline's rectangles.
+
+#include "bench.hpp"
+#include "synthetic_trees.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdio>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::layout;
+
+namespace
+{
+    std::uint64_t sweep(const layout_engine& engine, layout_tree& tree, int steps) {
+        auto start = bench::clock::now();
+        for (int step = 0; step < steps; ++step) {
+            int width = 800 + (step * 37) % 1200;
+            engine.layout(tree, 0, 0, 0, width, width * 10 / 16);
+        }
+        return bench::elapsed_ns(start) / static_cast<std::uint64_t>(steps);
+    }
+
+    bool matches(const layout_tree& a, const layout_tree& b) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a.nodes()[i].bounds != b.nodes()[i].bounds)
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const int columns = options.quick ? 8 : 64;
+    const int fields = options.quick ? 16 : 64;
+    const int steps = options.quick ? 5 : 50;
+    const std::vector<unsigned> pool_sizes = options.quick ? std::vector<unsigned>{ 1, 2 } : std::vector<unsigned>{ 1, 2, 4, 8, 16 };
+
+    layout_tree baseline_tree;
+    bench::build_forest(baseline_tree, columns, fields);
+    layout_engine sequential;
+    sequential.layout(baseline_tree, 0, 0, 0, 1024, 640); // warm up
+    std::uint64_t baseline_ns = sweep(sequential, baseline_tree, steps);
+    bench::result("layout_scaling", "sequential")
+        .add("nodes", static_cast<std::uint64_t>(baseline_tree.size()))
+        .add("threads", 0)
+        .add("ns_per_layout", baseline_ns)
+        .add("speedup", 1.0);
+
+    bool all_match = true;
+    for (unsigned threads : pool_sizes) {
+        thread_pool pool(threads);
+        layout_tree tree;
+        bench::build_forest(tree, columns, fields);
+        layout_engine parallel(&pool);
+        parallel.layout(tree, 0, 0, 0, 1024, 640);
+        std::uint64_t ns = sweep(parallel, tree, steps);
+        bool same = matches(tree, baseline_tree);
+        all_match = all_match && same;
+        bench::result("layout_scaling", "pool")
+            .add("nodes", static_cast<std::uint64_t>(tree.size()))
+            .add("threads", threads)
+            .add("hardware_threads", std::thread::hardware_concurrency())
+            .add("ns_per_layout", ns)
+            .add("speedup", ns ? static_cast<double>(baseline_ns) / static_cast<double>(ns) : 0.0)
+            .add("matches_sequential", same ? "yes" : "no");
+    }
+    return all_match ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// Spatial index benchmark: a canvas of many children that keep moving (as in a drag or an animation) while
+// the window hit-tests the mouse and collects the children under damaged areas. Compares the uniform grid
+// against the linear scan over every child it replaces.
+
+#include "bench.hpp"
+#include "layout/spatial_index.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::layout;
+
+namespace
+{
+    bool intersects(const rect_t& a, const rect_t& b) {
+        return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    rect_t random_rect(std::mt19937& random, int extent) {
+        std::uniform_int_distribution<int> position(0, extent), size(8, 120);
+        return { position(random), position(random), size(random), size(random) };
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const int children = options.quick ? 5'000 : 100'000;
+    const int moves = options.quick ? 5'000 : 200'000;
+    const int queries = options.quick ? 200 : 2'000;
+    // Keep the density of a real canvas as the child count grows
+    const int extent = static_cast<int>(40.0 * std::sqrt(static_cast<double>(children)));
+
+    std::mt19937 random(11);
+    std::vector<rect_t> bounds(children);
+    for (auto& b : bounds)
+        b = random_rect(random, extent);
+
+    spatial_grid grid(128);
+    auto start = bench::clock::now();
+    for (int id = 0; id < children; ++id)
+        grid.insert(id, bounds[id]);
+    std::uint64_t insert_ns = bench::elapsed_ns(start);
+
+    // Small moves, like a drag
+    std::uniform_int_distribution<int> pick(0, children - 1), nudge(-16, 16);
+    start = bench::clock::now();
+    for (int move = 0; move < moves; ++move) {
+        int id = pick(random);
+        bounds[id].x += nudge(random);
+        bounds[id].y += nudge(random);
+        grid.update(id, bounds[id]);
+    }
+    std::uint64_t move_ns = bench::elapsed_ns(start);
+
+    std::vector<rect_t> areas(queries);
+    for (auto& area : areas)
+        area = { pick(random) % extent, pick(random) % extent, 200, 150 };
+
+    std::vector<int> hits;
+    std::uint64_t grid_hits = 0;
+    start = bench::clock::now();
+    for (const auto& area : areas) {
+        hits.clear();
+        grid.query_rect(area, hits);
+        grid_hits += hits.size();
+    }
+    std::uint64_t grid_query_ns = bench::elapsed_ns(start);
+
+    std::uint64_t scan_hits = 0;
+    start = bench::clock::now();
+    for (const auto& area : areas) {
+        for (const auto& b : bounds)
+            scan_hits += intersects(b, area) ? 1 : 0;
+    }
+    std::uint64_t scan_query_ns = bench::elapsed_ns(start);
+
+    std::uint64_t point_hits = 0;
+    start = bench::clock::now();
+    for (const auto& area : areas) {
+        hits.clear();
+        grid.query_point(area.x, area.y, hits);
+        point_hits += hits.size();
+    }
+    std::uint64_t point_ns = bench::elapsed_ns(start);
+    bench::keep(point_hits);
+
+    bench::result("spatial_index", "moving_canvas")
+        .add("children", children)
+        .add("insert_ns", static_cast<double>(insert_ns) / children)
+        .add("move_ns", static_cast<double>(move_ns) / moves)
+        .add("query_rect_ns", static_cast<double>(grid_query_ns) / queries)
+        .add("scan_rect_ns", static_cast<double>(scan_query_ns) / queries)
+        .add("query_point_ns", static_cast<double>(point_ns) / queries)
+        .add("hits_per_query", static_cast<double>(grid_hits) / queries)
+        .add("matches_scan", grid_hits == scan_hits ? "yes" : "no");
+    return grid_hits == scan_hits ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#ifndef WPP_BENCHMARKS_STUB_BACKEND_HPP
+#define WPP_BENCHMARKS_STUB_BACKEND_HPP
+
+// Stand-in for the window side of layout. Panels move each control with SetWindowPos (DeferWindowPos) only
+// when its rectangle changed since the last commit; the stub keeps the last committed rectangle per leaf
+// target and counts the moves a real commit would have made, with the area they would have repainted.
+
+#include "layout/layout_engine.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace wpp::bench
+{
+    class stub_backend {
+    public:
+        explicit stub_backend(int targets) : m_committed(static_cast<size_t>(targets), layout::rect_t{ 0, 0, 0, 0 }) {}
+
+        // Apply a laid-out tree; returns the number of controls moved or resized
+        std::uint64_t commit(const layout::layout_tree& tree) {
+            std::uint64_t moved = 0;
+            for (const auto& node : tree.nodes()) {
+                if (node.target < 0 || static_cast<size_t>(node.target) >= m_committed.size())
+                    continue;
+                auto& committed = m_committed[node.target];
+                if (committed == node.bounds)
+                    continue;
+                // Old and new positions both need repainting
+                m_damage_area += area(committed) + area(node.bounds);
+                committed = node.bounds;
+                moved++;
+            }
+            m_commits += moved;
+            return moved;
+        }
+
+        std::uint64_t commits() const { return m_commits; }
+        std::uint64_t damage_area() const { return m_damage_area; }
+
+    private:
+        static std::uint64_t area(const layout::rect_t& rect) {
+            return rect.width > 0 && rect.height > 0 ? static_cast<std::uint64_t>(rect.width) * static_cast<std::uint64_t>(rect.height) : 0;
+        }
+
+        std::vector<layout::rect_t> m_committed;
+        std::uint64_t m_commits = 0;
+        std::uint64_t m_damage_area = 0;
+    };
+}
+
+#endif // WPP_BENCHMARKS_STUB_BACKEND_HPP
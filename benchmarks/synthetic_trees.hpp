@@ -0,0 +1,212 @@
+#ifndef WPP_BENCHMARKS_SYNTHETIC_TREES_HPP
+#define WPP_BENCHMARKS_SYNTHETIC_TREES_HPP
+
+// Parameterized layout trees for benchmarks and tests, built directly as layout_tree snapshots (the form
+// panels capture into), so no window or control is involved. Leaves stand for controls: their preferred size
+// is what a control would report, and `target` numbers them in creation order like a commit list would.
+// Every builder is deterministic for a given seed.
+
+#include "layout/layout_engine.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace wpp::bench
+{
+    using layout::grid_length;
+    using layout::layout_tree;
+    using layout::node_kind;
+
+    class tree_builder {
+    public:
+        explicit tree_builder(layout_tree& tree, std::uint32_t seed = 1) : m_tree(tree), m_random(seed) {}
+
+        int leaves() const { return m_leaves; }
+
+        int uniform(int low, int high) { return std::uniform_int_distribution<int>(low, high)(m_random); }
+
+        // A control-like leaf with a random content size; some have min/max bounds or non-stretch alignment
+        int leaf(int parent) {
+            int node = m_tree.add_node(node_kind::leaf, parent);
+            auto& n = m_tree[node];
+            n.preferred = { uniform(20, 200), uniform(16, 40) };
+            if (uniform(0, 7) == 0)
+                n.min_size = { 40, 16 };
+            if (uniform(0, 9) == 0)
+                n.max_size = { 300, 60 };
+            if (uniform(0, 3) == 0)
+                n.cell_alignment = { static_cast<layout::alignment>(uniform(0, 3)), layout::alignment::center };
+            n.margin = { 2, 2, 2, 2 };
+            n.target = m_leaves++;
+            return node;
+        }
+
+        // Track definitions mixing star, auto and pixel sizes
+        std::vector<grid_length> tracks(int count) {
+            std::vector<grid_length> result;
+            result.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                switch (uniform(0, 2)) {
+                case 0: result.push_back(grid_length::star(uniform(1, 3))); break;
+                case 1: result.push_back(grid_length::auto_size()); break;
+                default: result.push_back(grid_length::pixels(uniform(24, 120))); break;
+                }
+            }
+            return result;
+        }
+
+        int grid(int parent, int rows, int columns) {
+            int node = m_tree.add_node(node_kind::grid, parent);
+            m_tree.set_row_definitions(node, tracks(rows));
+            m_tree.set_column_definitions(node, tracks(columns));
+            m_tree[node].padding = { 4, 4, 4, 4 };
+            m_tree[node].row_spacing = 4;
+            m_tree[node].column_spacing = 4;
+            return node;
+        }
+
+        int stack(int parent, layout::orientation orientation) {
+            int node = m_tree.add_node(node_kind::stack, parent);
+            m_tree[node].stack_orientation = orientation;
+            m_tree[node].row_spacing = 3;
+            return node;
+        }
+
+        int dock(int parent) {
+            int node = m_tree.add_node(node_kind::dock, parent);
+            m_tree[node].last_child_fill = true;
+            return node;
+        }
+
+        // Place `node` in a grid cell, sometimes spanning into the next row or column
+        void place(int node, int row, int column, int rows, int columns) {
+            auto& cell = m_tree[node].cell;
+            cell.row = row;
+            cell.column = column;
+            if (column + 1 < columns && uniform(0, 5) == 0)
+                cell.column_span = 2;
+            if (row + 1 < rows && uniform(0, 9) == 0)
+                cell.row_span = 2;
+        }
+
+        // A label/field form: one row per field, labels auto-sized, fields star-sized
+        int form(int parent, int fields) {
+            int node = m_tree.add_node(node_kind::grid, parent);
+            m_tree.set_row_definitions(node, std::vector<grid_length>(fields, grid_length::auto_size()));
+            m_tree.set_column_definitions(node, { grid_length::auto_size(), grid_length::star() });
+            m_tree[node].row_spacing = 4;
+            m_tree[node].column_spacing = 8;
+            for (int row = 0; row < fields; ++row) {
+                int label = leaf(node);
+                m_tree[label].cell = { row, 0, 1, 1 };
+                int field = leaf(node);
+                m_tree[field].cell = { row, 1, 1, 1 };
+            }
+            return node;
+        }
+
+    private:
+        layout_tree& m_tree;
+        std::mt19937 m_random;
+        int m_leaves = 0;
+    };
+
+    // A rows x columns grid of leaves with mixed track types and spans
+    inline int build_wide_grid(layout_tree& tree, int rows, int columns, std::uint32_t seed = 1) {
+        tree.clear();
+        tree_builder build(tree, seed);
+        int root = build.grid(-1, rows, columns);
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column)
+                build.place(build.leaf(root), row, column, rows, columns);
+        }
+        tree.finalize();
+        return build.leaves();
+    }
+
+    // Panels nested `depth` levels deep, cycling grid, stack and dock, each level with a few leaves beside
+    // the next level
+    inline int build_deep_nesting(layout_tree& tree, int depth, std::uint32_t seed = 1) {
+        tree.clear();
+        tree_builder build(tree, seed);
+        int parent = -1;
+        for (int level = 0; level < depth; ++level) {
+            int node = 0;
+            switch (level % 3) {
+            case 0:
+                node = build.grid(parent, 2, 2);
+                break;
+            case 1:
+                node = build.stack(parent, level % 2 ? layout::orientation::vertical : layout::orientation::horizontal);
+                break;
+            default:
+                node = build.dock(parent);
+                break;
+            }
+            if (parent >= 0 && tree[parent].kind == node_kind::grid)
+                tree[node].cell = { 1, 1, 1, 1 };
+            for (int i = 0; i < 3; ++i) {
+                int child = build.leaf(node);
+                tree[child].cell = { i / 2, i % 2, 1, 1 };
+                tree[child].dock = static_cast<layout::dock_position>(i);
+            }
+            parent = node;
+        }
+        build.leaf(parent);
+        tree.finalize();
+        return build.leaves();
+    }
+
+    // An application window: dock root with a toolbar stack on top, a navigation stack on the left, a status
+    // stack at the bottom and a content grid of `panes` form panels with `fields` rows each
+    inline int build_application(layout_tree& tree, int panes, int fields, std::uint32_t seed = 1) {
+        tree.clear();
+        tree_builder build(tree, seed);
+        int root = build.dock(-1);
+
+        int toolbar = build.stack(root, layout::orientation::horizontal);
+        tree[toolbar].dock = layout::dock_position::top;
+        for (int i = 0; i < 12; ++i)
+            build.leaf(toolbar);
+
+        int navigation = build.stack(root, layout::orientation::vertical);
+        tree[navigation].dock = layout::dock_position::left;
+        for (int i = 0; i < 20; ++i)
+            build.leaf(navigation);
+
+        int status = build.stack(root, layout::orientation::horizontal);
+        tree[status].dock = layout::dock_position::bottom;
+        for (int i = 0; i < 4; ++i)
+            build.leaf(status);
+
+        int columns = 4;
+        int rows = (panes + columns - 1) / columns;
+        int content = build.grid(root, rows, columns);
+        tree[content].dock = layout::dock_position::fill;
+        for (int pane = 0; pane < panes; ++pane) {
+            int form = build.form(content, fields);
+            tree[form].cell = { pane / columns, pane % columns, 1, 1 };
+        }
+        tree.finalize();
+        return build.leaves();
+    }
+
+    // `columns` independent form subtrees side by side under a star grid: the shape parallel layout forks on
+    inline int build_forest(layout_tree& tree, int columns, int fields, std::uint32_t seed = 1) {
+        tree.clear();
+        tree_builder build(tree, seed);
+        int root = tree.add_node(node_kind::grid, -1);
+        tree.set_column_definitions(root, std::vector<grid_length>(columns, grid_length::star()));
+        for (int column = 0; column < columns; ++column) {
+            int pane = build.stack(root, layout::orientation::vertical);
+            tree[pane].cell = { 0, column, 1, 1 };
+            for (int i = 0; i < 4; ++i)
+                build.form(pane, fields / 4 + 1);
+        }
+        tree.finalize();
+        return build.leaves();
+    }
+}
+
+#endif // WPP_BENCHMARKS_SYNTHETIC_TREES_HPP
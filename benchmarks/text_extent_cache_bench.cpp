@@ -0,0 +1,151 @@
+// Text measurement benchmark: a form re-measures its labels on every layout pass (language switch, DPI change,
+// fit_to_text over many controls). The measurer is a stub with the cost shape of GDI: a fixed price per call
+// for selecting the font into a DC and a per-character price for GetTextExtentPoint32. Measuring each string
+// directly is compared with the cache, string by string and in batches.
+
+#include "bench.hpp"
+#include "graphics/text_extent_cache.hpp"
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::graphics;
+
+namespace
+{
+    using cache_type = basic_text_extent_cache<char>;
+
+    // Busy work standing in for GDI calls; returns a value so it cannot be optimized away
+    std::uint32_t spin(int iterations, std::uint32_t seed) {
+        for (int i = 0; i < iterations; ++i)
+            seed = seed * 1664525u + 1013904223u;
+        return seed;
+    }
+
+    struct stub_gdi {
+        int select_cost = 400;      // iterations per call (font selection, DC setup)
+        int char_cost = 4;          // iterations per character
+        std::uint64_t calls = 0;
+        std::uint32_t sink = 1;
+
+        void measure(const std::vector<std::string_view>& texts, std::vector<text_extent>& extents) {
+            calls++;
+            sink = spin(select_cost, sink);
+            for (std::size_t i = 0; i < texts.size(); ++i) {
+                sink = spin(char_cost * static_cast<int>(texts[i].size()), sink);
+                extents[i] = { static_cast<int>(texts[i].size()) * 7, 16 };
+            }
+        }
+    };
+
+    std::vector<std::string> vocabulary(std::size_t count, std::mt19937& random) {
+        std::uniform_int_distribution<int> length(3, 24), letter('a', 'z');
+        std::vector<std::string> words(count);
+        for (auto& word : words) {
+            word.resize(static_cast<std::size_t>(length(random)));
+            for (char& c : word)
+                c = static_cast<char>(letter(random));
+        }
+        return words;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const std::size_t labels = options.quick ? 1'000 : 10'000;
+    const std::size_t distinct = labels / 5;
+    const int passes = options.quick ? 3 : 20;
+
+    std::mt19937 random(3);
+    auto words = vocabulary(distinct, random);
+    std::vector<std::string_view> texts(labels);
+    std::uniform_int_distribution<std::size_t> pick(0, distinct - 1);
+    for (auto& text : texts)
+        text = words[pick(random)];
+
+    // Uncached: one measurer call per string, every pass
+    {
+        stub_gdi gdi;
+        std::vector<std::string_view> one(1);
+        std::vector<text_extent> extent(1);
+        auto start = bench::clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (auto text : texts) {
+                one[0] = text;
+                gdi.measure(one, extent);
+            }
+        }
+        std::uint64_t elapsed = bench::elapsed_ns(start);
+        bench::keep(gdi.sink);
+        bench::result("text_extent_cache", "uncached")
+            .add("labels", static_cast<std::uint64_t>(labels))
+            .add("passes", passes)
+            .add("ns_per_string", static_cast<double>(elapsed) / (labels * passes))
+            .add("measurer_calls", gdi.calls);
+    }
+
+    // Cached, one string per call (fit_to_text on each control)
+    {
+        stub_gdi gdi;
+        cache_type cache([&gdi](cache_type::font_id, unsigned int, const std::vector<std::string_view>& batch,
+                                std::vector<text_extent>& extents) { gdi.measure(batch, extents); });
+        auto start = bench::clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (auto text : texts)
+                bench::keep(cache.measure(1, 96, text));
+        }
+        std::uint64_t elapsed = bench::elapsed_ns(start);
+        auto stats = cache.get_statistics();
+        bench::result("text_extent_cache", "cached_single")
+            .add("labels", static_cast<std::uint64_t>(labels))
+            .add("passes", passes)
+            .add("ns_per_string", static_cast<double>(elapsed) / (labels * passes))
+            .add("measurer_calls", gdi.calls)
+            .add("hit_rate", static_cast<double>(stats.hits) / (stats.hits + stats.misses))
+            .add("entries", static_cast<std::uint64_t>(stats.entries));
+    }
+
+    // Cached and batched (fit_to_text over a vector of controls)
+    {
+        stub_gdi gdi;
+        cache_type cache([&gdi](cache_type::font_id, unsigned int, const std::vector<std::string_view>& batch,
+                                std::vector<text_extent>& extents) { gdi.measure(batch, extents); });
+        std::vector<text_extent> extents;
+        auto start = bench::clock::now();
+        for (int pass = 0; pass < passes; ++pass)
+            cache.measure(1, 96, texts, extents);
+        std::uint64_t elapsed = bench::elapsed_ns(start);
+        auto stats = cache.get_statistics();
+        bench::result("text_extent_cache", "cached_batch")
+            .add("labels", static_cast<std::uint64_t>(labels))
+            .add("passes", passes)
+            .add("ns_per_string", static_cast<double>(elapsed) / (labels * passes))
+            .add("measurer_calls", gdi.calls)
+            .add("hit_rate", static_cast<double>(stats.hits) / (stats.hits + stats.misses))
+            .add("entries", static_cast<std::uint64_t>(stats.entries));
+    }
+
+    // A cache too small for the working set: every pass evicts what the next one needs
+    {
+        stub_gdi gdi;
+        cache_type cache([&gdi](cache_type::font_id, unsigned int, const std::vector<std::string_view>& batch,
+                                std::vector<text_extent>& extents) { gdi.measure(batch, extents); }, distinct / 2);
+        std::vector<text_extent> extents;
+        auto start = bench::clock::now();
+        for (int pass = 0; pass < passes; ++pass)
+            cache.measure(1, 96, texts, extents);
+        std::uint64_t elapsed = bench::elapsed_ns(start);
+        auto stats = cache.get_statistics();
+        bench::result("text_extent_cache", "cached_batch_undersized")
+            .add("labels", static_cast<std::uint64_t>(labels))
+            .add("passes", passes)
+            .add("ns_per_string", static_cast<double>(elapsed) / (labels * passes))
+            .add("measurer_calls", gdi.calls)
+            .add("hit_rate", static_cast<double>(stats.hits) / (stats.hits + stats.misses))
+            .add("evictions", stats.evictions);
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Tree diff benchmark: a 100k-node hierarchy (10 x 100 x 100) refreshed from a new snapshot, as a tree view
+// reconcile does. Times building the snapshot and the diff, and reports how many children were compared by
+// key against the total, with every node expanded and with only the top level expanded.
+
+#include "bench.hpp"
+#include "model/tree_diff.hpp"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::model;
+
+namespace
+{
+    using snapshot = basic_tree_snapshot<char>;
+    using node_id = snapshot::node_id;
+
+    enum class change {
+        none,
+        rename_leaf,        // one file renamed deep in the tree
+        add_folder,         // one second-level folder added with 100 files
+        reorder_top         // the top level reversed
+    };
+
+    snapshot build(int top, int middle, int leaves, change edit) {
+        snapshot tree;
+        tree.reserve(static_cast<std::size_t>(top) * middle * leaves + top * middle + top + 100);
+        std::string text;
+        for (int t = 0; t < top; ++t) {
+            int first = edit == change::reorder_top ? top - 1 - t : t;
+            std::uint64_t top_key = static_cast<std::uint64_t>(first + 1) << 40;
+            node_id top_node = tree.add(snapshot::root, top_key, "volume " + std::to_string(first));
+            int folders = middle + (edit == change::add_folder && first == top / 2 ? 1 : 0);
+            for (int m = 0; m < folders; ++m) {
+                std::uint64_t folder_key = top_key | (static_cast<std::uint64_t>(m + 1) << 20);
+                node_id folder = tree.add(top_node, folder_key, "folder " + std::to_string(m));
+                for (int l = 0; l < leaves; ++l) {
+                    text = "file " + std::to_string(l) + ".dat";
+                    if (edit == change::rename_leaf && first == top - 1 && m == middle - 1 && l == leaves / 2)
+                        text += " (renamed)";
+                    tree.add(folder, folder_key | static_cast<std::uint64_t>(l + 1), text);
+                }
+            }
+        }
+        return tree;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const int top = 10, middle = options.quick ? 20 : 100, leaves = options.quick ? 20 : 100;
+    const int repeats = options.quick ? 2 : 10;
+
+    auto start = bench::clock::now();
+    snapshot old = build(top, middle, leaves, change::none);
+    std::uint64_t build_ns = bench::elapsed_ns(start);
+    old.subtree_hashes();
+
+    // Only the top level is expanded: its children were inserted, nothing deeper was
+    std::unordered_set<node_id> top_level;
+    for (node_id node = old.first_child(snapshot::root); node != snapshot::npos; node = old.next_sibling(node))
+        top_level.insert(node);
+
+    const std::pair<const char*, change> cases[] = {
+        { "unchanged", change::none },
+        { "rename_leaf", change::rename_leaf },
+        { "add_folder", change::add_folder },
+        { "reorder_top", change::reorder_top },
+    };
+    for (const auto& [name, edit] : cases) {
+        snapshot next = build(top, middle, leaves, edit);
+        for (bool expanded : { true, false }) {
+            auto descend = [&](node_id node) { return expanded || node == snapshot::root || top_level.count(node) != 0; };
+            std::uint64_t diff_ns = 0;
+            tree_diff diff;
+            for (int i = 0; i < repeats; ++i) {
+                snapshot fresh = next;      // hashes are computed per snapshot, as for each refresh
+                start = bench::clock::now();
+                diff = diff_trees(old, fresh, descend);
+                diff_ns += bench::elapsed_ns(start);
+            }
+
+            bench::result("tree_diff", name)
+                .add("nodes", static_cast<std::uint64_t>(next.size() - 1))
+                .add("expanded", expanded ? "all" : "top")
+                .add("snapshot_build_ns", build_ns)
+                .add("diff_ns", diff_ns / repeats)
+                .add("compared", static_cast<std::uint64_t>(diff.compared))
+                .add("mapped", static_cast<std::uint64_t>(diff.mapped))
+                .add("changed_levels", static_cast<std::uint64_t>(diff.levels.size()));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+// Tree index benchmark: a mirror of a 1M-node tree view (100 x 100 x 100) built as the wrapper's inserts
+// would build it, then queried. Each query is timed against the walk tree_view does without the mirror, with
+// the index's navigation standing in for TVM_GETNEXTITEM and TVM_GETITEM; "messages" counts the calls that
+// walk would send the control, so the real gap is wider than the times show.
+
+#include "alloc_counter.hpp"
+#include "bench.hpp"
+#include "model/tree_index.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::model;
+
+namespace
+{
+    using handle = std::uint32_t;
+    using tree_index = basic_tree_index<handle>;
+
+    // get_all_items as it was: recurse and concatenate a vector per level
+    std::vector<handle> all_items(const tree_index& tree, handle parent, std::uint64_t& messages) {
+        std::vector<handle> items;
+        for (handle child = tree.first_child(parent); child != 0; child = tree.next_sibling(child)) {
+            messages += 2;
+            items.push_back(child);
+            std::vector<handle> below = all_items(tree, child, messages);
+            items.insert(items.end(), below.begin(), below.end());
+        }
+        return items;
+    }
+
+    handle walk_find_by_data(const tree_index& tree, std::uint64_t data, std::uint64_t& messages) {
+        for (handle item : all_items(tree, 0, messages)) {
+            messages++;
+            if (tree.data(item) == data)
+                return item;
+        }
+        return 0;
+    }
+
+    std::size_t walk_expanded_count(const tree_index& tree, std::uint64_t& messages) {
+        std::size_t expanded = 0;
+        for (handle item : all_items(tree, 0, messages)) {
+            messages++;
+            expanded += tree.is_expanded(item) ? 1 : 0;
+        }
+        return expanded;
+    }
+
+    handle walk_prev_sibling(const tree_index& tree, handle item, std::uint64_t& messages) {
+        handle prev = 0;
+        messages += 2;
+        for (handle child = tree.first_child(tree.parent(item)); child != 0 && child != item; child = tree.next_sibling(child)) {
+            messages++;
+            prev = child;
+        }
+        return prev;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const handle top = options.quick ? 10 : 100, middle = options.quick ? 20 : 100, leaves = options.quick ? 20 : 100;
+
+    // Handles number the nodes in insertion order; data is a key derived from the position, and every
+    // hundredth folder is expanded and every tenth leaf checked
+    tree_index tree;
+    handle next = 1;
+    auto before = bench::allocations();
+    auto start = bench::clock::now();
+    for (handle t = 0; t < top; ++t) {
+        handle volume = next++;
+        tree.insert_last(volume, 0, std::uint64_t{ t } << 40, true);
+        for (handle m = 0; m < middle; ++m) {
+            handle folder = next++;
+            tree.insert_last(folder, volume, (std::uint64_t{ t } << 40) | (std::uint64_t{ m + 1 } << 20), m % 100 == 0);
+            for (handle l = 0; l < leaves; ++l)
+                tree.insert_last(next++, folder, (std::uint64_t{ t } << 40) | (std::uint64_t{ m + 1 } << 20) | (l + 1), false, l % 10 == 0);
+        }
+    }
+    std::uint64_t build_ns = bench::elapsed_ns(start);
+    auto build_allocations = bench::allocations() - before;
+
+    bench::result("tree_index", "build")
+        .add("nodes", static_cast<std::uint64_t>(tree.size()))
+        .add("build_ns", build_ns)
+        .add("build_allocs", build_allocations.count)
+        .add("build_bytes", build_allocations.bytes);
+
+    // The last leaf of the last folder: the worst case for a walk in display order
+    const std::uint64_t wanted = (std::uint64_t{ top - 1 } << 40) | (std::uint64_t{ middle } << 20) | leaves;
+    const handle last = next - 1;
+    const int repeats = options.quick ? 2 : 5;
+
+    {
+        std::uint64_t indexed_ns = 0, walk_ns = 0, messages = 0;
+        handle found = 0, walked = 0;
+        for (int i = 0; i < repeats; ++i) {
+            start = bench::clock::now();
+            found = tree.find_by_data(wanted);
+            indexed_ns += bench::elapsed_ns(start);
+            messages = 0;
+            start = bench::clock::now();
+            walked = walk_find_by_data(tree, wanted, messages);
+            walk_ns += bench::elapsed_ns(start);
+        }
+        bench::result("tree_index", "find_by_data")
+            .add("nodes", static_cast<std::uint64_t>(tree.size()))
+            .add("index_ns", indexed_ns / repeats)
+            .add("walk_ns", walk_ns / repeats)
+            .add("walk_messages", messages)
+            .add("same", found == last && walked == last ? "yes" : "no");
+    }
+
+    {
+        std::uint64_t indexed_ns = 0, walk_ns = 0, messages = 0;
+        std::size_t counted = 0, walked = 0;
+        for (int i = 0; i < repeats; ++i) {
+            start = bench::clock::now();
+            counted = tree.expanded_count();
+            std::size_t checked = 0;
+            tree.for_each_checked([&](handle) { checked++; });
+            indexed_ns += bench::elapsed_ns(start);
+            bench::keep(checked);
+            messages = 0;
+            start = bench::clock::now();
+            walked = walk_expanded_count(tree, messages);
+            walk_ns += bench::elapsed_ns(start);
+        }
+        bench::result("tree_index", "expanded_and_checked")
+            .add("nodes", static_cast<std::uint64_t>(tree.size()))
+            .add("expanded", static_cast<std::uint64_t>(counted))
+            .add("checked", static_cast<std::uint64_t>(tree.checked_count()))
+            .add("index_ns", indexed_ns / repeats)
+            .add("walk_ns", walk_ns / repeats)
+            .add("walk_messages", messages)
+            .add("same", counted == walked ? "yes" : "no");
+    }
+
+    {
+        std::uint64_t indexed_ns = 0, walk_ns = 0, messages = 0;
+        handle prev = 0, walked = 0;
+        for (int i = 0; i < repeats; ++i) {
+            start = bench::clock::now();
+            prev = tree.prev_sibling(last);
+            indexed_ns += bench::elapsed_ns(start);
+            messages = 0;
+            start = bench::clock::now();
+            walked = walk_prev_sibling(tree, last, messages);
+            walk_ns += bench::elapsed_ns(start);
+        }
+        bench::result("tree_index", "prev_sibling")
+            .add("siblings", static_cast<std::uint64_t>(leaves))
+            .add("index_ns", indexed_ns / repeats)
+            .add("walk_ns", walk_ns / repeats)
+            .add("walk_messages", messages)
+            .add("same", prev == walked && prev == last - 1 ? "yes" : "no");
+    }
+
+    {
+        std::uint64_t indexed_ns = 0, walk_ns = 0, messages = 0;
+        std::size_t visited = 0, walked = 0;
+        for (int i = 0; i < repeats; ++i) {
+            visited = 0;
+            start = bench::clock::now();
+            tree.for_each(0, [&](handle) { visited++; });
+            indexed_ns += bench::elapsed_ns(start);
+            messages = 0;
+            start = bench::clock::now();
+            walked = all_items(tree, 0, messages).size();
+            walk_ns += bench::elapsed_ns(start);
+        }
+        bench::result("tree_index", "traverse")
+            .add("nodes", static_cast<std::uint64_t>(visited))
+            .add("index_ns", indexed_ns / repeats)
+            .add("walk_ns", walk_ns / repeats)
+            .add("walk_messages", messages)
+            .add("same", visited == walked ? "yes" : "no");
+    }
+
+    {
+        // Dropping a whole volume and inserting it again, as a refresh of one branch does
+        start = bench::clock::now();
+        std::size_t nodes = tree.size();
+        std::size_t removed = tree.erase(1);
+        std::uint64_t erase_ns = bench::elapsed_ns(start);
+        start = bench::clock::now();
+        tree.insert(1, 0, 0, 0, true);
+        for (handle m = 0; m < middle; ++m) {
+            handle folder = next++;
+            tree.insert_last(folder, 1, std::uint64_t{ m + 1 } << 20);
+            for (handle l = 0; l < leaves; ++l)
+                tree.insert_last(next++, folder, (std::uint64_t{ m + 1 } << 20) | (l + 1));
+        }
+        std::uint64_t insert_ns = bench::elapsed_ns(start);
+        bench::result("tree_index", "replace_branch")
+            .add("removed", static_cast<std::uint64_t>(removed))
+            .add("erase_ns", erase_ns)
+            .add("insert_ns", insert_ns)
+            .add("nodes", static_cast<std::uint64_t>(tree.size()))
+            .add("same", removed == std::size_t{ middle } * (leaves + 1) + 1 && tree.size() == nodes ? "yes" : "no");
+    }
+    return 0;
+}
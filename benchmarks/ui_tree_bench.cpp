@@ -0,0 +1,311 @@
+// Startup benchmark for compile-time ui trees: the same window (a toolbar docked over a 4x4 grid of 16-field
+// forms, 543 elements) is built three ways into the layout_tree snapshot panels capture into: by hand-written
+// calls, by walking a ui tree the way ui::build does (exact reserve, no intermediate containers), and by
+// instantiating the equivalent layout document. ui::build itself creates Win32 controls, so the walk here
+// stops at the snapshot; what is compared is the cost of describing the tree, not of creating windows.
+
+#include "alloc_counter.hpp"
+#include "bench.hpp"
+#include "layout/layout_engine.hpp"
+#include "layout/ui_tree.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace wpp;
+using namespace wpp::layout;
+
+namespace
+{
+    constexpr int pane_columns = 4;
+    constexpr int pane_count = 16;
+    constexpr int field_count = 16;
+    constexpr int tool_count = 12;
+    static_assert(pane_count / pane_columns == 4, "make_content declares four rows");
+
+    template<std::size_t... Fields>
+    consteval auto make_form(std::index_sequence<Fields...>) {
+        return ui::grid(ui::rows(((void)Fields, ui::auto_size())...), ui::columns(ui::auto_size(), ui::star()),
+                        ui::cell(static_cast<int>(Fields), 0, ui::static_text("Field", 60, 22))...,
+                        ui::cell(static_cast<int>(Fields), 1, ui::edit("", 160, 22))...)
+            .spacing(4);
+    }
+
+    template<std::size_t... Panes>
+    consteval auto make_content(std::index_sequence<Panes...>) {
+        constexpr auto form = make_form(std::make_index_sequence<field_count>{});
+        return ui::grid(ui::rows(ui::star(), ui::star(), ui::star(), ui::star()), ui::columns(ui::star(), ui::star(), ui::star(), ui::star()),
+                        ui::cell(static_cast<int>(Panes / pane_columns), static_cast<int>(Panes % pane_columns), form)...)
+            .spacing(8);
+    }
+
+    template<std::size_t... Tools>
+    constexpr auto make_toolbar(std::index_sequence<Tools...>) {
+        return ui::stack(orientation::horizontal, ((void)Tools, ui::button("Tool", 72, 24))...).spacing(4);
+    }
+
+    constexpr auto window_tree = ui::dock(ui::docked(dock_position::top, make_toolbar(std::make_index_sequence<tool_count>{})),
+                                          ui::docked(dock_position::fill, make_content(std::make_index_sequence<pane_count>{})))
+                                     .padding(8);
+
+    // Walks a ui tree into a snapshot, as ui::build walks it into panels and controls
+    template<control_kind Kind, typename CharT, typename Binding>
+    int add(layout_tree& tree, int parent, const ui::control_spec<Kind, CharT, Binding>& spec) {
+        int node = tree.add_node(node_kind::leaf, parent);
+        tree[node].preferred = { spec.width, spec.height };
+        return node;
+    }
+
+    template<typename Spec>
+    void add_options(layout_tree& tree, int node, const Spec& spec) {
+        if (spec.options.has_margin)
+            tree[node].margin = spec.options.margin;
+        if (spec.options.has_padding)
+            tree[node].padding = spec.options.padding;
+        if (spec.options.has_spacing)
+            tree[node].row_spacing = tree[node].column_spacing = spec.options.spacing;
+    }
+
+    template<typename Child>
+    void add_child(layout_tree& tree, int parent, const Child& child);
+
+    template<typename Spec>
+    void add_children(layout_tree& tree, int node, const Spec& spec) {
+        std::apply([&](const auto&... children) { (add_child(tree, node, children), ...); }, spec.children);
+    }
+
+    template<std::size_t Rows, std::size_t Columns, typename Binding, typename... Children>
+    int add(layout_tree& tree, int parent, const ui::grid_spec<Rows, Columns, Binding, Children...>& spec) {
+        int node = tree.add_node(node_kind::grid, parent);
+        tree.set_row_definitions(node, std::vector<grid_length>(spec.rows.begin(), spec.rows.end()));
+        tree.set_column_definitions(node, std::vector<grid_length>(spec.columns.begin(), spec.columns.end()));
+        add_options(tree, node, spec);
+        add_children(tree, node, spec);
+        return node;
+    }
+
+    template<typename Binding, typename... Children>
+    int add(layout_tree& tree, int parent, const ui::stack_spec<Binding, Children...>& spec) {
+        int node = tree.add_node(node_kind::stack, parent);
+        tree[node].stack_orientation = spec.direction;
+        add_options(tree, node, spec);
+        add_children(tree, node, spec);
+        return node;
+    }
+
+    template<typename Binding, typename... Children>
+    int add(layout_tree& tree, int parent, const ui::dock_spec<Binding, Children...>& spec) {
+        int node = tree.add_node(node_kind::dock, parent);
+        tree[node].last_child_fill = spec.last_child_fill;
+        add_options(tree, node, spec);
+        add_children(tree, node, spec);
+        return node;
+    }
+
+    template<typename Child>
+    void add_child(layout_tree& tree, int parent, const Child& child) {
+        if constexpr (ui::detail::is_cell<Child>::value)
+            tree[add(tree, parent, child.child)].cell = child.position;
+        else if constexpr (ui::detail::is_dock_child<Child>::value)
+            tree[add(tree, parent, child.child)].dock = child.side;
+        else
+            add(tree, parent, child);
+    }
+
+    void build_from_ui_tree(layout_tree& tree) {
+        using tree_type = decltype(window_tree);
+        tree.clear();
+        tree.reserve(ui::control_count<tree_type> + ui::panel_count<tree_type>);
+        add(tree, -1, window_tree);
+        tree.finalize();
+    }
+
+    // The same window written out by hand, as WindowGridPanel-style code builds it
+    void build_by_hand(layout_tree& tree) {
+        tree.clear();
+        int root = tree.add_node(node_kind::dock, -1);
+        tree[root].padding = { 8, 8, 8, 8 };
+
+        int toolbar = tree.add_node(node_kind::stack, root);
+        tree[toolbar].dock = dock_position::top;
+        tree[toolbar].stack_orientation = orientation::horizontal;
+        tree[toolbar].row_spacing = tree[toolbar].column_spacing = 4;
+        for (int i = 0; i < tool_count; ++i)
+            tree[tree.add_node(node_kind::leaf, toolbar)].preferred = { 72, 24 };
+
+        int content = tree.add_node(node_kind::grid, root);
+        tree[content].dock = dock_position::fill;
+        tree[content].row_spacing = tree[content].column_spacing = 8;
+        tree.set_row_definitions(content, std::vector<grid_length>(pane_count / pane_columns, grid_length::star()));
+        tree.set_column_definitions(content, std::vector<grid_length>(pane_columns, grid_length::star()));
+        for (int pane = 0; pane < pane_count; ++pane) {
+            int form = tree.add_node(node_kind::grid, content);
+            tree[form].cell = { pane / pane_columns, pane % pane_columns, 1, 1 };
+            tree[form].row_spacing = tree[form].column_spacing = 4;
+            tree.set_row_definitions(form, std::vector<grid_length>(field_count, grid_length::auto_size()));
+            tree.set_column_definitions(form, { grid_length::auto_size(), grid_length::star() });
+            for (int field = 0; field < field_count; ++field) {
+                int label = tree.add_node(node_kind::leaf, form);
+                tree[label].preferred = { 60, 22 };
+                tree[label].cell = { field, 0, 1, 1 };
+            }
+            for (int field = 0; field < field_count; ++field) {
+                int value = tree.add_node(node_kind::leaf, form);
+                tree[value].preferred = { 160, 22 };
+                tree[value].cell = { field, 1, 1, 1 };
+            }
+        }
+        tree.finalize();
+    }
+
+    std::string window_document() {
+        std::string text = "dock padding=8 {\n    stack dock=top orientation=horizontal spacing=4 {\n";
+        for (int i = 0; i < tool_count; ++i)
+            text += "        button text=\"Tool\" width=72 height=24\n";
+        text += "    }\n    grid dock=fill spacing=8 rows=*,*,*,* columns=*,*,*,* {\n";
+        for (int pane = 0; pane < pane_count; ++pane) {
+            text += "        grid row=" + std::to_string(pane / pane_columns) + " column=" + std::to_string(pane % pane_columns)
+                + " spacing=4 columns=auto,* rows=auto";
+            for (int field = 1; field < field_count; ++field)
+                text += ",auto";
+            text += " {\n";
+            for (int field = 0; field < field_count; ++field)
+                text += "            static text=\"Field\" width=60 height=22 row=" + std::to_string(field) + " column=0\n";
+            for (int field = 0; field < field_count; ++field)
+                text += "            edit width=160 height=22 row=" + std::to_string(field) + " column=1\n";
+            text += "        }\n";
+        }
+        text += "    }\n}\n";
+        return text;
+    }
+
+    // Instantiates a layout document into a snapshot; element indices match node indices
+    class snapshot_builder : public layout_builder {
+    public:
+        explicit snapshot_builder(layout_tree& tree) : m_tree(tree) {}
+
+        void reserve(std::size_t count) override {
+            m_tree.clear();
+            m_tree.reserve(count);
+        }
+
+        bool create(std::size_t, const layout_record& record, const layout_view& view) override {
+            constexpr node_kind kinds[] = { node_kind::grid, node_kind::stack, node_kind::dock, node_kind::canvas, node_kind::leaf };
+            int parent = record.parent == layout_record::no_parent ? -1 : static_cast<int>(record.parent);
+            int node = m_tree.add_node(kinds[static_cast<int>(record.kind)], parent);
+            auto& n = m_tree[node];
+            if (record.kind == element_kind::control)
+                n.preferred = { record.width, record.height };
+            if (record.flags & record_flags::padding)
+                n.padding = { record.padding[0], record.padding[1], record.padding[2], record.padding[3] };
+            if (record.flags & record_flags::spacing) {
+                n.row_spacing = record.spacing;
+                n.column_spacing = record.column_spacing;
+            }
+            if (record.flags & record_flags::orientation)
+                n.stack_orientation = static_cast<orientation>(record.orientation);
+            if (record.flags & record_flags::grid_position)
+                n.cell = { record.row, record.column, record.row_span, record.column_span };
+            if (record.flags & record_flags::dock)
+                n.dock = static_cast<dock_position>(record.dock);
+            if (record.kind == element_kind::grid) {
+                m_lengths.clear();
+                for (const auto& row : view.rows(record))
+                    m_lengths.push_back(row.length());
+                m_tree.set_row_definitions(node, m_lengths);
+                m_lengths.clear();
+                for (const auto& column : view.columns(record))
+                    m_lengths.push_back(column.length());
+                m_tree.set_column_definitions(node, m_lengths);
+            }
+            return true;
+        }
+
+        bool attach(std::size_t, std::size_t, const layout_record&, const layout_view&) override { return true; }
+
+    private:
+        layout_tree& m_tree;
+        std::vector<grid_length> m_lengths;
+    };
+
+    struct build_result {
+        std::uint64_t ns = 0;
+        bench::allocation_counts allocations;
+        std::size_t nodes = 0;
+    };
+
+    template<typename Build>
+    build_result measure(int repeats, Build&& build) {
+        layout_tree tree;
+        build(tree);    // warm up
+        build_result result;
+        for (int i = 0; i < repeats; ++i) {
+            layout_tree fresh;
+            auto before = bench::allocations();
+            auto start = bench::clock::now();
+            build(fresh);
+            result.ns += bench::elapsed_ns(start);
+            result.allocations = bench::allocations() - before;
+            result.nodes = fresh.size();
+            bench::keep(fresh.nodes().back().subtree_size);
+        }
+        result.ns /= repeats;
+        return result;
+    }
+
+    bool same_shape(const layout_tree& a, const layout_tree& b) {
+        if (a.size() != b.size())
+            return false;
+        for (int i = 0; i < static_cast<int>(a.size()); ++i) {
+            if (a[i].kind != b[i].kind || a[i].parent != b[i].parent || a[i].preferred != b[i].preferred
+                || a[i].cell.row != b[i].cell.row || a[i].cell.column != b[i].cell.column)
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto options = bench::parse_options(argc, argv);
+    const int repeats = options.quick ? 5 : 2'000;
+
+    std::vector<std::uint8_t> blob;
+    std::string error;
+    if (!compile_layout(window_document(), blob, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    layout_view view;
+    if (!layout_view::open(blob.data(), blob.size(), view, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    auto by_document = [&view](layout_tree& tree) {
+        snapshot_builder builder(tree);
+        instantiate(view, builder);
+        tree.finalize();
+    };
+
+    layout_tree hand, tree, document;
+    build_by_hand(hand);
+    build_from_ui_tree(tree);
+    by_document(document);
+    bool matches = same_shape(hand, tree) && same_shape(hand, document);
+
+    const std::pair<const char*, build_result> cases[] = {
+        { "hand_written", measure(repeats, build_by_hand) },
+        { "ui_tree", measure(repeats, build_from_ui_tree) },
+        { "layout_document", measure(repeats, by_document) },
+    };
+    for (const auto& [name, result] : cases) {
+        bench::result("ui_tree", name)
+            .add("elements", static_cast<std::uint64_t>(result.nodes))
+            .add("build_ns", result.ns)
+            .add("allocs", result.allocations.count)
+            .add("alloc_bytes", result.allocations.bytes)
+            .add("matches_hand_written", matches ? "yes" : "no");
+    }
+    return matches ? 0 : 1;
+}
@@ -29,6 +29,7 @@
 #endif
 
 #include <string>
+#include <span>
 #include <thread>
 #include <optional>
 #include <functional>
@@ -38,6 +39,8 @@
 #include <format>
 #include <algorithm>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 
 namespace wpp
 {
@@ -295,6 +298,116 @@ namespace wpp
 		HDWP m_hdwp;
 	};
 
+	inline void release_dpi_variant(HFONT font) { ::DeleteObject(font); }
+	inline void release_dpi_variant(HBITMAP bitmap) { ::DeleteObject(bitmap); }
+	inline void release_dpi_variant(HICON icon) { ::DestroyIcon(icon); }
+
+	/// <summary>
+	/// Caches one GDI resource per DPI value. Variants are created on first request by a factory and
+	/// released together when the cache is cleared or destroyed, so moving between monitors never recreates them.
+	/// </summary>
+	/// <typeparam name="Handle">HFONT, HBITMAP or HICON.</typeparam>
+	template<typename Handle>
+	class dpi_cache {
+	public:
+		using factory = std::function<Handle(UINT dpi)>;
+
+		dpi_cache() = default;
+
+		/// <summary>
+		/// Creates a cache that builds missing variants with the given factory.
+		/// </summary>
+		/// <param name="create">Called with the target DPI; returns the new resource or NULL.</param>
+		explicit dpi_cache(factory create)
+			: m_create(std::move(create)) {
+		}
+
+		~dpi_cache() {
+			clear();
+		}
+
+		// Non-copyable
+		dpi_cache(const dpi_cache&) = delete;
+		dpi_cache& operator=(const dpi_cache&) = delete;
+
+		// Movable
+		dpi_cache(dpi_cache&& other) noexcept
+			: m_create(std::move(other.m_create))
+			, m_variants(std::move(other.m_variants)) {
+			other.m_variants.clear();
+		}
+
+		dpi_cache& operator=(dpi_cache&& other) noexcept {
+			if (this != &other) {
+				clear();
+				m_create = std::move(other.m_create);
+				m_variants = std::move(other.m_variants);
+				other.m_variants.clear();
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// Gets the variant for a DPI, creating it on first use.
+		/// </summary>
+		/// <param name="dpi">The target DPI (96 = 100%).</param>
+		/// <returns>The cached resource, or NULL if the factory failed.</returns>
+		Handle get(UINT dpi) {
+			auto it = m_variants.find(dpi);
+			if (it != m_variants.end())
+				return it->second;
+
+			Handle variant = m_create ? m_create(dpi) : NULL;
+			if (variant)
+				m_variants.emplace(dpi, variant);
+			return variant;
+		}
+
+		/// <summary>
+		/// Releases every cached variant.
+		/// </summary>
+		void clear() {
+			for (auto& [dpi, variant] : m_variants)
+				release_dpi_variant(variant);
+			m_variants.clear();
+		}
+
+	private:
+		factory m_create;
+		std::unordered_map<UINT, Handle> m_variants;
+	};
+
+	/// <summary>
+	/// Creates a font cache whose variants scale the given font's height from base_dpi to the requested DPI.
+	/// </summary>
+	/// <param name="font">The font the variants are derived from. Not owned by the cache.</param>
+	/// <param name="base_dpi">The DPI the font was created for.</param>
+	inline dpi_cache<HFONT> make_font_dpi_cache(HFONT font, UINT base_dpi) {
+		LOGFONT base{};
+		if (!font || ::GetObject(font, sizeof(base), &base) == 0)
+			return {};
+
+		return dpi_cache<HFONT>([base, base_dpi](UINT dpi) {
+			LOGFONT scaled = base;
+			scaled.lfHeight = ::MulDiv(base.lfHeight, static_cast<int>(dpi), static_cast<int>(base_dpi));
+			scaled.lfWidth = ::MulDiv(base.lfWidth, static_cast<int>(dpi), static_cast<int>(base_dpi));
+			return ::CreateFontIndirect(&scaled);
+		});
+	}
+
+	/// <summary>
+	/// Creates an icon cache that loads a resource icon at logical_size (96 DPI pixels) scaled to the requested DPI.
+	/// </summary>
+	/// <param name="instance">Module containing the icon resource.</param>
+	/// <param name="resource">Icon resource name or MAKEINTRESOURCE id.</param>
+	/// <param name="logical_size">Icon edge length at 96 DPI.</param>
+	inline dpi_cache<HICON> make_icon_dpi_cache(HINSTANCE instance, LPCTSTR resource, int logical_size) {
+		return dpi_cache<HICON>([instance, resource, logical_size](UINT dpi) {
+			int size = ::MulDiv(logical_size, static_cast<int>(dpi), USER_DEFAULT_SCREEN_DPI);
+			return static_cast<HICON>(::LoadImage(instance, resource, IMAGE_ICON, size, size, LR_DEFAULTCOLOR));
+		});
+	}
+
 	/// <summary>
 	/// A wrapper class for Windows HWND (window handle) that provides an object-oriented interface for window management and manipulation.
 	/// </summary>
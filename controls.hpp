@@ -2,6 +2,7 @@
 #define __CONTROLS_HPP__
 
 #include "controls/control.hpp"
+#include "model.hpp"
 
 #include "controls/image_list.hpp"
 #include "controls/button.hpp"
@@ -297,19 +297,54 @@ namespace wpp
 		}
 
 		int add_items(const std::vector<tstring>& items) {
-			int lastIndex = CB_ERR;
-			for (const auto& item : items) {
-				lastIndex = add(item.c_str());
-			}
-			return lastIndex;
+			return add_range(items).last_index;
 		}
 
 		int add_items(const TCHAR** items, int count) {
-			int lastIndex = CB_ERR;
-			for (int i = 0; i < count; i++) {
-				lastIndex = add(items[i]);
+			return add_range(std::span<const TCHAR* const>(items, (std::max)(count, 0))).last_index;
+		}
+
+		model::bulk_insert_result add_items(std::span<const tstring_view> items) {
+			return add_range(items);
+		}
+
+		// Append every element of `items`, any range, as text_of(item): a string, string view or C string, so no
+		// copy of the range is built. Storage for all the strings is reserved up front (CB_INITSTORAGE) and
+		// painting is suspended, so the list neither regrows nor repaints per item. Stops at the first item the
+		// combo box refuses.
+		template<typename Range, typename TextFn = model::as_text>
+		model::bulk_insert_result add_range(const Range& items, TextFn text_of = {}) {
+			return add_range(items, text_of, nullptr);
+		}
+
+		// As add_range, also setting each item's data to data_of(item) (an integer or pointer)
+		template<typename Range, typename TextFn, typename DataFn>
+		model::bulk_insert_result add_range(const Range& items, TextFn text_of, DataFn data_of) {
+			auto start = std::chrono::steady_clock::now();
+			model::bulk_insert_result result;
+			result.requested = static_cast<size_t>(std::ranges::distance(items));
+			if (result.requested == 0)
+				return result;
+
+			redraw_lock lock(*this);
+			result.text_bytes = model::total_text_bytes<TCHAR>(items, text_of);
+			if (init_storage(static_cast<int>((std::min)(result.requested, static_cast<size_t>(INT_MAX))),
+							 static_cast<UINT>((std::min)(result.text_bytes, static_cast<size_t>(UINT_MAX)))) == CB_ERRSPACE)
+				return result;
+
+			model::terminated_text<TCHAR> text;
+			for (const auto& item : items) {
+				auto&& value = text_of(item);
+				int index = add(text(value));
+				if (index < 0)
+					break;
+				if constexpr (!std::is_null_pointer_v<DataFn>)
+					set_item_data(index, (DWORD_PTR)data_of(item));
+				result.last_index = index;
+				result.inserted++;
 			}
-			return lastIndex;
+			result.elapsed = std::chrono::steady_clock::now() - start;
+			return result;
 		}
 
 		BOOL select_first() {
@@ -721,22 +756,21 @@ namespace wpp
 		}
 
 		void populate(const std::vector<tstring>& items, bool clear_first = true) {
+			redraw_lock lock(*this);
 			if (clear_first) {
 				reset_content();
 			}
-			for (const auto& item : items) {
-				add(item.c_str());
-			}
+			add_range(items);
 		}
 
 		template<typename T>
 		void populate_with_data(const std::vector<std::pair<tstring, T*>>& items, bool clear_first = true) {
+			redraw_lock lock(*this);
 			if (clear_first) {
 				reset_content();
 			}
-			for (const auto& item : items) {
-				add_with_data(item.first.c_str(), item.second);
-			}
+			add_range(items, [](const std::pair<tstring, T*>& item) -> const tstring& { return item.first; },
+					  [](const std::pair<tstring, T*>& item) { return item.second; });
 		}
 
 		int get_selected_index() const {
@@ -759,6 +793,71 @@ namespace wpp
 		bool empty() const {
 			return is_empty();
 		}
+
+		// Make the list show `items` (a random-access range) in order by changing only what differs from the
+		// previous reconcile, instead of populate's clear and refill: entries are matched by key_of(item), an
+		// integer unique per item, and only removed, added, moved and retitled entries are touched, in one
+		// repaint. Item data and the selected entry follow their items. If the list was changed by other means
+		// since the last reconcile, it is refilled.
+		template<typename Range, typename KeyFn, typename TextFn>
+		BOOL reconcile(const Range& items, KeyFn&& key_of, TextFn&& text_of) {
+			auto next = model::make_snapshot(items, key_of, [&](const auto& item) { return model::content_hash(tstring_view(text_of(item))); });
+			auto text = [&](size_t index) { return tstring(text_of(std::begin(items)[index])); };
+
+			redraw_lock lock(*this);
+			if (m_reconciled.size() != static_cast<size_t>((std::max)(get_count(), 0))) {
+				reset_content();
+				m_reconciled.clear();
+			}
+
+			auto diff = model::diff_keyed<std::uint64_t>(m_reconciled.keys, next.keys, m_reconciled.content, next.content);
+			if (diff.empty()) {
+				m_reconciled = std::move(next);
+				return TRUE;
+			}
+
+			auto positions = diff.new_positions(m_reconciled.size());
+			int selected = get_cur_sel();
+			selected = selected >= 0 && static_cast<size_t>(selected) < positions.size() && positions[selected] != model::keyed_diff::npos
+				? static_cast<int>(positions[selected]) : -1;
+
+			std::vector<DWORD_PTR> moving(diff.moved ? positions.size() : 0);
+			for (size_t old_index : diff.removed) {
+				if (positions[old_index] != model::keyed_diff::npos)
+					moving[old_index] = get_item_data(static_cast<int>(old_index));
+				if (remove(static_cast<UINT>(old_index)) == CB_ERR)
+					return FALSE;
+			}
+
+			for (size_t new_index : diff.inserted) {
+				int index = insert_string(static_cast<int>(new_index), text(new_index).c_str());
+				if (index < 0)
+					return FALSE;
+				if (diff.is_move(new_index))
+					set_item_data(index, moving[diff.source[new_index]]);
+			}
+
+			// The list has no way to retitle an entry; replace it, keeping its data
+			for (size_t new_index : diff.updated) {
+				int index = static_cast<int>(new_index);
+				DWORD_PTR data = get_item_data(index);
+				remove(static_cast<UINT>(index));
+				insert_string(index, text(new_index).c_str());
+				set_item_data(index, data);
+			}
+
+			if (get_cur_sel() != selected)
+				set_cur_sel(selected);
+
+			m_reconciled = std::move(next);
+			return TRUE;
+		}
+
+		// Forget what the last reconcile showed; the next one refills the list
+		void reset_reconcile() { m_reconciled.clear(); }
+
+	private:
+		model::keyed_snapshot m_reconciled;
 	};
 
 	class combo_box_ex : public control {
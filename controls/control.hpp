@@ -76,6 +76,51 @@ namespace wpp
 			}
 		}
 
+		// Registered message a control's background work posts to the parent window; the window answers it on
+		// the UI thread by calling on_async_ready on the control with the ID in wParam
+		static UINT async_ready_message() {
+			static const UINT message = ::RegisterWindowMessage(TEXT("wpp_control_async_ready"));
+			return message;
+		}
+
+		// A callable for background threads that schedules on_async_ready on the UI thread. It holds only the
+		// parent handle and control ID, so it stays harmless after the control is gone.
+		std::function<void()> make_async_notifier() const {
+			HWND parent = m_parent_handle;
+			WPARAM id = static_cast<WPARAM>(m_item_id);
+			return [parent, id]() { ::PostMessage(parent, async_ready_message(), id, 0); };
+		}
+
+		// Called on the UI thread after background work signalled through make_async_notifier
+		virtual void on_async_ready() {}
+
+		// Called by the parent for WM_DRAWITEM with this control's ID; owner-drawn controls paint the item and
+		// return TRUE
+		virtual BOOL on_draw_item(LPDRAWITEMSTRUCT draw_item) { return FALSE; }
+
+		// Suspends painting of the control for a scope (WM_SETREDRAW) and repaints it once when the outermost
+		// lock ends, so a batch of item changes costs one paint instead of one per change
+		class redraw_lock {
+		public:
+			explicit redraw_lock(control& target) : m_target(target) {
+				if (m_target.m_redraw_locks++ == 0)
+					m_target.send_message(WM_SETREDRAW, FALSE);
+			}
+
+			~redraw_lock() {
+				if (--m_target.m_redraw_locks == 0) {
+					m_target.send_message(WM_SETREDRAW, TRUE);
+					::RedrawWindow(m_target.get_handle(), NULL, NULL, RDW_ERASE | RDW_FRAME | RDW_INVALIDATE | RDW_ALLCHILDREN);
+				}
+			}
+
+			redraw_lock(const redraw_lock&) = delete;
+			redraw_lock& operator=(const redraw_lock&) = delete;
+
+		private:
+			control& m_target;
+		};
+
 		void on_command_callback(WPARAM wParam, LPARAM lParam) {
 			UINT command = HIWORD(wParam);
 			auto it = m_command_callbacks.find(command);
@@ -235,6 +280,7 @@ namespace wpp
 	protected:
 		std::unordered_map<UINT, std::vector<command_callback>> m_command_callbacks;
 		std::unordered_map<UINT, std::vector<notify_callback>> m_notify_callbacks;
+		int m_redraw_locks = 0;
 	};
 
 	template<typename T = control>
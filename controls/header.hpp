@@ -559,19 +559,9 @@ namespace wpp
 		}
 
 		void auto_size_column(int nIndex) {
-			RECT rc = get_item_rect(nIndex);
-			int width = rc.right - rc.left;
-
-			HDC hdc = GetDC(m_handle);
-			if (hdc) {
-				tstring text = get_item_text(nIndex);
-				SIZE size = { 0 };
-				GetTextExtentPoint32(hdc, text.c_str(), (int)text.length(), &size);
-				width = size.cx + 20;
-				ReleaseDC(m_handle, hdc);
-			}
-
-			set_item_width(nIndex, width);
+			tstring text = get_item_text(nIndex);
+			SIZE size = graphics::text_metrics::shared().measure(get_font(), ::GetDpiForWindow(m_handle), text);
+			set_item_width(nIndex, size.cx + 20);
 		}
 
 		void auto_size_all_columns() {
@@ -51,18 +51,36 @@ namespace wpp
 		}
 
 		int set_current_selected(int index) {
-			return ListBox_SetCurSel(m_handle, index);
+			int result = ListBox_SetCurSel(m_handle, index);
+			// LB_SETCURSEL reports LB_ERR when clearing a single-selection list too; only a real failure keeps the bitmap
+			if (m_source && (result != LB_ERR || (index < 0 && !is_multi_select()))) {
+				m_selection.clear();
+				if (index >= 0)
+					m_selection.set(static_cast<size_t>(index));
+			}
+			return result;
 		}
 
 		int get_selected(int index) {
+			if (m_source)
+				return index >= 0 && m_selection.test(static_cast<size_t>(index)) ? 1 : 0;
 			return ListBox_GetSel(m_handle, index);
 		}
 
 		int set_selected(int index, BOOL selected = TRUE) {
-			return ListBox_SetSel(m_handle, selected, index);
+			int result = ListBox_SetSel(m_handle, selected, index);
+			if (m_source && result != LB_ERR) {
+				if (index < 0)
+					m_selection.set_range(0, m_selection.size(), selected != FALSE);
+				else
+					m_selection.set(static_cast<size_t>(index), selected != FALSE);
+			}
+			return result;
 		}
 
 		int get_selected_count() const {
+			if (m_source && is_multi_select())
+				return static_cast<int>(m_selection.count());
 			return ListBox_GetSelCount(m_handle);
 		}
 
@@ -109,6 +127,8 @@ namespace wpp
 		}
 
 		int get_item_text_length(int index) {
+			if (m_source)
+				return is_valid_index(index) ? static_cast<int>(source_text(index).size()) : LB_ERR;
 			return ListBox_GetTextLen(m_handle, index);
 		}
 
@@ -187,9 +207,12 @@ namespace wpp
 		}
 
 		int select_item_range(BOOL bSelect, int first_item, int last_item) {
-			return bSelect ?
+			int result = bSelect ?
 				(int)SendMessage(m_handle, LB_SELITEMRANGEEX, first_item, last_item) :
 				(int)SendMessage(m_handle, LB_SELITEMRANGEEX, last_item, first_item);
+			if (m_source && result != LB_ERR && first_item >= 0 && last_item >= first_item)
+				m_selection.set_range(static_cast<size_t>(first_item), static_cast<size_t>(last_item), bSelect != FALSE);
+			return result;
 		}
 
 		int get_count() const {
@@ -209,6 +232,9 @@ namespace wpp
 		}
 
 		tstring get_item_text(int index) const {
+			if (m_source)
+				return is_valid_index(index) ? source_text(index) : tstring();
+
 			int len = ListBox_GetTextLen(m_handle, index);
 			if (len <= 0) return tstring();
 
@@ -235,6 +261,12 @@ namespace wpp
 
 		std::vector<int> get_selected_items() const {
 			std::vector<int> items;
+			if (m_source) {
+				items.reserve(m_selection.count());
+				m_selection.for_each([&](size_t item) { items.push_back(static_cast<int>(item)); });
+				return items;
+			}
+
 			int count = get_selected_count();
 			if (count > 0) {
 				items.resize(count);
@@ -255,6 +287,7 @@ namespace wpp
 		std::vector<std::basic_string<TCHAR>> get_all_items() const {
 			std::vector<std::basic_string<TCHAR>> items;
 			int count = get_count();
+			items.reserve(static_cast<size_t>((std::max)(count, 0)));
 			for (int i = 0; i < count; i++) {
 				items.push_back(get_item_text(i));
 			}
@@ -270,10 +303,7 @@ namespace wpp
 
 		void clear_selection() {
 			if (is_multi_select()) {
-				int count = get_count();
-				for (int i = 0; i < count; i++) {
-					set_selected(i, FALSE);
-				}
+				set_selected(-1, FALSE);
 			} else {
 				set_current_selected(-1);
 			}
@@ -281,15 +311,16 @@ namespace wpp
 
 		void select_all() {
 			if (is_multi_select()) {
-				int count = get_count();
-				for (int i = 0; i < count; i++) {
-					set_selected(i, TRUE);
-				}
+				set_selected(-1, TRUE);
 			}
 		}
 
 		void invert_selection() {
-			if (is_multi_select()) {
+			if (is_multi_select() && m_source) {
+				redraw_lock lock(*this);
+				m_selection.invert();
+				apply_selection();
+			} else if (is_multi_select()) {
 				int count = get_count();
 				for (int i = 0; i < count; i++) {
 					BOOL selected = get_selected(i);
@@ -312,19 +343,54 @@ namespace wpp
 		}
 
 		int add_items(const std::vector<std::basic_string<TCHAR>>& items) {
-			int lastIndex = -1;
-			for (const auto& item : items) {
-				lastIndex = add(item.c_str());
-			}
-			return lastIndex;
+			return add_range(items).last_index;
 		}
 
 		int add_items(const TCHAR** items, int count) {
-			int lastIndex = -1;
-			for (int i = 0; i < count; i++) {
-				lastIndex = add(items[i]);
+			return add_range(std::span<const TCHAR* const>(items, (std::max)(count, 0))).last_index;
+		}
+
+		model::bulk_insert_result add_items(std::span<const tstring_view> items) {
+			return add_range(items);
+		}
+
+		// Append every element of `items`, any range, as text_of(item): a string, string view or C string, so no
+		// copy of the range is built. Storage for all the strings is reserved up front (LB_INITSTORAGE) and
+		// painting is suspended, so the list neither regrows nor repaints per item. Stops at the first item the
+		// list refuses. A virtual list box holds no strings and adds nothing.
+		template<typename Range, typename TextFn = model::as_text>
+		model::bulk_insert_result add_range(const Range& items, TextFn text_of = {}) {
+			return add_range(items, text_of, nullptr);
+		}
+
+		// As add_range, also setting each item's data to data_of(item) (an integer or pointer)
+		template<typename Range, typename TextFn, typename DataFn>
+		model::bulk_insert_result add_range(const Range& items, TextFn text_of, DataFn data_of) {
+			auto start = std::chrono::steady_clock::now();
+			model::bulk_insert_result result;
+			result.requested = static_cast<size_t>(std::ranges::distance(items));
+			if (result.requested == 0 || is_virtual())
+				return result;
+
+			redraw_lock lock(*this);
+			result.text_bytes = model::total_text_bytes<TCHAR>(items, text_of);
+			if (init_storage(static_cast<int>((std::min)(result.requested, static_cast<size_t>(INT_MAX))),
+							 static_cast<UINT>((std::min)(result.text_bytes, static_cast<size_t>(UINT_MAX)))) == LB_ERRSPACE)
+				return result;
+
+			model::terminated_text<TCHAR> text;
+			for (const auto& item : items) {
+				auto&& value = text_of(item);
+				int index = add(text(value));
+				if (index < 0)
+					break;
+				if constexpr (!std::is_null_pointer_v<DataFn>)
+					set_item_data(index, (DWORD_PTR)data_of(item));
+				result.last_index = index;
+				result.inserted++;
 			}
-			return lastIndex;
+			result.elapsed = std::chrono::steady_clock::now() - start;
+			return result;
 		}
 
 		void clear() {
@@ -530,6 +596,271 @@ namespace wpp
 			}
 			return find_first_exact(text);
 		}
+
+		// Make the list show `items` (a random-access range) in order by changing only what differs from the
+		// previous reconcile: entries are matched by key_of(item), an integer unique per item, and only removed,
+		// added, moved and retitled entries are touched, in one repaint. Kept entries keep their item data and
+		// selection, moved entries take theirs along, and the first visible entry stays on top. If the list was
+		// changed by other means since the last reconcile, it is refilled. Fails on a virtual list box, whose items
+		// come from its data source.
+		template<typename Range, typename KeyFn, typename TextFn>
+		BOOL reconcile(const Range& items, KeyFn&& key_of, TextFn&& text_of) {
+			if (is_virtual())
+				return FALSE;
+
+			auto next = model::make_snapshot(items, key_of, [&](const auto& item) { return model::content_hash(tstring_view(text_of(item))); });
+			auto text = [&](size_t index) { return tstring(text_of(std::begin(items)[index])); };
+
+			redraw_lock lock(*this);
+			if (m_reconciled.size() != static_cast<size_t>((std::max)(get_count(), 0))) {
+				reset_content();
+				m_reconciled.clear();
+			}
+
+			auto diff = model::diff_keyed<std::uint64_t>(m_reconciled.keys, next.keys, m_reconciled.content, next.content);
+			if (diff.empty()) {
+				m_reconciled = std::move(next);
+				return TRUE;
+			}
+
+			auto positions = diff.new_positions(m_reconciled.size());
+			auto moved_to = [&](int old_index) {
+				return old_index >= 0 && static_cast<size_t>(old_index) < positions.size() && positions[old_index] != model::keyed_diff::npos
+					? static_cast<int>(positions[old_index]) : -1;
+			};
+
+			BOOL multi = is_multi_select();
+			int top = moved_to(get_top_index());
+			int caret = moved_to(get_caret_index());
+			int current = multi ? -1 : moved_to(get_current_selected());
+
+			struct carried { DWORD_PTR data = 0; BOOL selected = FALSE; };
+			std::vector<carried> moving(diff.moved ? positions.size() : 0);
+			for (size_t old_index : diff.removed) {
+				int index = static_cast<int>(old_index);
+				if (positions[old_index] != model::keyed_diff::npos)
+					moving[old_index] = { get_item_data(index), multi && get_selected(index) > 0 };
+				if (remove(index) == LB_ERR)
+					return FALSE;
+			}
+
+			for (size_t new_index : diff.inserted) {
+				int index = insert(static_cast<int>(new_index), text(new_index).c_str());
+				if (index < 0)
+					return FALSE;
+				if (diff.is_move(new_index)) {
+					const carried& item = moving[diff.source[new_index]];
+					set_item_data(index, item.data);
+					if (item.selected)
+						set_selected(index, TRUE);
+				}
+			}
+
+			for (size_t new_index : diff.updated)
+				replace_item(static_cast<int>(new_index), text(new_index).c_str());
+
+			if (!multi)
+				set_current_selected(current);
+			if (caret >= 0)
+				set_caret_index(caret, FALSE);
+			if (top >= 0)
+				set_top_index(top);
+
+			m_reconciled = std::move(next);
+			return TRUE;
+		}
+
+		// Forget what the last reconcile showed; the next one refills the list
+		void reset_reconcile() { m_reconciled.clear(); }
+
+		using data_source = model::basic_list_box_source<TCHAR>;
+
+		// Virtual mode. The control must have been created with LBS_NODATA | LBS_OWNERDRAWFIXED | LBS_NOTIFY; it then
+		// stores only the item count, draws each visible line from the source (WM_DRAWITEM, forwarded by the parent)
+		// and the selection is mirrored in a bitmap, so selection queries never walk the items.
+		BOOL set_data_source(std::shared_ptr<data_source> source) {
+			constexpr DWORD required = LBS_NODATA | LBS_OWNERDRAWFIXED | LBS_NOTIFY;
+			if (source && (get_style() & required) != required)
+				return FALSE;
+
+			m_source = std::move(source);
+			m_selection.clear();
+			m_synced_anchor = m_synced_caret = -1;
+			if (m_source && !m_source_hooked) {
+				// Ahead of the application's handlers, so on_sel_change sees the new selection
+				auto& callbacks = m_command_callbacks[LBN_SELCHANGE];
+				callbacks.insert(callbacks.begin(), [this](WPARAM, LPARAM) { sync_selection(); });
+				m_source_hooked = true;
+			}
+			return source_changed();
+		}
+
+		const std::shared_ptr<data_source>& get_data_source() const { return m_source; }
+		BOOL is_virtual() const { return (get_style() & LBS_NODATA) != 0; }
+
+		// Selected items of a virtual list box, one bit per item
+		const model::selection_bitmap& get_selection() const { return m_selection; }
+
+		// The source's item count changed. Only the count is sent to the control; the selection is kept for
+		// items that still exist.
+		BOOL source_changed() {
+			int count = m_source ? static_cast<int>((std::min)(m_source->item_count(), static_cast<size_t>(INT_MAX))) : 0;
+			redraw_lock lock(*this);
+			int top = get_top_index();
+			int result = (int)SendMessage(m_handle, LB_SETCOUNT, (WPARAM)count, 0L);
+			if (result == LB_ERR || result == LB_ERRSPACE)
+				return FALSE;
+
+			m_selection.resize(static_cast<size_t>(count));
+			apply_selection();
+			if (top > 0 && top < count)
+				set_top_index(top);
+			return TRUE;
+		}
+
+		// `count` items were inserted into the source before `position`; selected items after it move along
+		BOOL items_inserted(int position, int count) {
+			if (position < 0 || count <= 0)
+				return FALSE;
+			m_selection.insert(static_cast<size_t>(position), static_cast<size_t>(count));
+			return source_changed();
+		}
+
+		// `count` items starting at `position` were removed from the source; their selection goes with them
+		BOOL items_removed(int position, int count) {
+			if (position < 0 || count <= 0)
+				return FALSE;
+			m_selection.erase(static_cast<size_t>(position), static_cast<size_t>(count));
+			return source_changed();
+		}
+
+		// Items in [first, last] changed in the source without the count changing; repaints the visible part only
+		void items_changed(int first, int last) {
+			int top = get_top_index();
+			first = (std::max)(first, top);
+			last = (std::min)({ last, top + get_visible_count(), get_count() - 1 });
+			for (int index = first; index <= last; ++index) {
+				RECT rc;
+				if (get_item_rect(index, &rc) != LB_ERR)
+					::InvalidateRect(m_handle, &rc, FALSE);
+			}
+		}
+
+		// Draws a line of a virtual list box: the source's text, single line with an ellipsis, in the system
+		// selection colours. Override to draw richer items.
+		BOOL on_draw_item(LPDRAWITEMSTRUCT draw_item) override {
+			if (!m_source || draw_item->CtlType != ODT_LISTBOX)
+				return FALSE;
+
+			HDC dc = draw_item->hDC;
+			RECT rc = draw_item->rcItem;
+			if (draw_item->itemAction == ODA_FOCUS) {
+				::DrawFocusRect(dc, &rc);
+				return TRUE;
+			}
+
+			BOOL selected = (draw_item->itemState & ODS_SELECTED) != 0;
+			::FillRect(dc, &rc, ::GetSysColorBrush(selected ? COLOR_HIGHLIGHT : COLOR_WINDOW));
+			if (draw_item->itemID != static_cast<UINT>(-1) && draw_item->itemID < m_source->item_count()) {
+				TCHAR text[text_capacity];
+				size_t length = m_source->item_text(draw_item->itemID, text, text_capacity);
+				int color = (draw_item->itemState & ODS_DISABLED) ? COLOR_GRAYTEXT : selected ? COLOR_HIGHLIGHTTEXT : COLOR_WINDOWTEXT;
+				COLORREF old_color = ::SetTextColor(dc, ::GetSysColor(color));
+				int old_mode = ::SetBkMode(dc, TRANSPARENT);
+				RECT text_rc = rc;
+				text_rc.left += 2;
+				::DrawText(dc, text, static_cast<int>(length), &text_rc, DT_SINGLELINE | DT_VCENTER | DT_NOPREFIX | DT_END_ELLIPSIS);
+				::SetBkMode(dc, old_mode);
+				::SetTextColor(dc, old_color);
+			}
+			if (draw_item->itemState & ODS_FOCUS)
+				::DrawFocusRect(dc, &rc);
+			return TRUE;
+		}
+
+	private:
+		static constexpr size_t text_capacity = 1024;  // longest line a virtual list box draws or returns
+
+		tstring source_text(int index) const {
+			TCHAR text[text_capacity];
+			size_t length = m_source->item_text(static_cast<size_t>(index), text, text_capacity);
+			return tstring(text, length);
+		}
+
+		// Push the bitmap to the control: one range message per run of selected items
+		void apply_selection() {
+			if (!is_multi_select()) {
+				size_t current = m_selection.first();
+				ListBox_SetCurSel(m_handle, current == model::selection_bitmap::npos ? -1 : static_cast<int>(current));
+				return;
+			}
+			ListBox_SetSel(m_handle, FALSE, -1);
+			m_selection.for_each_run([this](size_t first, size_t last) {
+				SendMessage(m_handle, LB_SELITEMRANGEEX, (WPARAM)first, (LPARAM)last);
+			});
+		}
+
+		// The user changed the selection. A click or key only changes items between the anchor and the caret, now
+		// or before it, so only that range is read back; the control's selected count tells whether everything
+		// outside it was deselected (a plain click) or stayed. The whole selection is read only when the range is
+		// longer than the selection or the counts disagree.
+		void sync_selection() {
+			if (!m_source)
+				return;
+			if (!is_multi_select()) {
+				m_selection.clear();
+				int current = ListBox_GetCurSel(m_handle);
+				if (current >= 0)
+					m_selection.set(static_cast<size_t>(current));
+				return;
+			}
+
+			int total = ListBox_GetSelCount(m_handle);
+			if (total < 0)
+				return;
+			int anchor = get_anchor_index(), caret = get_caret_index();
+			int first = INT_MAX, last = -1;
+			for (int index : { anchor, caret, m_synced_anchor, m_synced_caret }) {
+				if (index >= 0 && static_cast<size_t>(index) < m_selection.size()) {
+					first = (std::min)(first, index);
+					last = (std::max)(last, index);
+				}
+			}
+			m_synced_anchor = anchor;
+			m_synced_caret = caret;
+
+			if (last >= 0 && last - first < total) {
+				int inside = 0;
+				for (int index = first; index <= last; ++index) {
+					BOOL selected = ListBox_GetSel(m_handle, index) > 0;
+					m_selection.set(static_cast<size_t>(index), selected != FALSE);
+					inside += selected ? 1 : 0;
+				}
+				if (m_selection.count() == static_cast<size_t>(total))
+					return;
+				if (inside == total) {
+					if (first > 0)
+						m_selection.set_range(0, static_cast<size_t>(first - 1), false);
+					m_selection.set_range(static_cast<size_t>(last) + 1, m_selection.size(), false);
+					return;
+				}
+			}
+
+			m_selection.clear();
+			if (total == 0)
+				return;
+			std::vector<int> items(static_cast<size_t>(total));
+			total = ListBox_GetSelItems(m_handle, total, items.data());
+			for (int i = 0; i < total; ++i)
+				m_selection.set(static_cast<size_t>(items[i]));
+		}
+
+		std::shared_ptr<data_source> m_source;
+		model::selection_bitmap m_selection;
+		bool m_source_hooked = false;
+		int m_synced_anchor = -1;                     // anchor and caret when the selection was last read back
+		int m_synced_caret = -1;
+		model::keyed_snapshot m_reconciled;
 	};
 }
 
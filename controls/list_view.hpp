@@ -800,6 +800,32 @@ namespace wpp
 			}
 		}
 
+		// Sizes columns from model data instead of asking the control to scan its items: cell_text(row, column) is
+		// measured through the shared text metrics cache, one batch per column, and the widest text plus padding
+		// (in 96 DPI pixels) becomes the column width.
+		void auto_size_columns(int row_count, const std::function<tstring(int row, int column)>& cell_text, BOOL bUseHeader = TRUE, int padding = 12) {
+			int count = get_column_count();
+			UINT dpi = ::GetDpiForWindow(m_handle);
+			HFONT font = get_font();
+			header hdr = get_header();
+			auto& metrics = graphics::text_metrics::shared();
+
+			std::vector<tstring> texts(row_count > 0 ? row_count : 0);
+			std::vector<tstring_view> views;
+			for (int column = 0; column < count; column++) {
+				for (int row = 0; row < row_count; row++)
+					texts[row] = cell_text(row, column);
+				views.assign(texts.begin(), texts.end());
+
+				int width = metrics.max_width(font, dpi, views);
+				if (bUseHeader) {
+					tstring title = hdr.get_item_text(column);
+					width = (std::max)(width, static_cast<int>(metrics.measure(hdr.get_font(), dpi, title).cx));
+				}
+				set_column_width(column, width + ::MulDiv(padding, static_cast<int>(dpi), USER_DEFAULT_SCREEN_DPI));
+			}
+		}
+
 		int find_item_by_data(DWORD_PTR data) const {
 			int count = get_item_count();
 			for (int i = 0; i < count; i++) {
@@ -866,6 +892,256 @@ namespace wpp
 
 		void clear() { delete_all_items(); }
 		BOOL has_items() const { return !is_empty(); }
+
+		// Append one row per element of `items`, any range: text_of(item, column) gives each cell for the header's
+		// columns as a string, string view or C string, so no copy of the range is built. Room for all rows is
+		// reserved first (LVM_SETITEMCOUNT) and painting is suspended, so the control neither regrows nor repaints
+		// per row. Stops at the first row the control refuses. Not for owner-data lists, which reflect their source.
+		template<typename Range, typename TextFn>
+		model::bulk_insert_result add_rows(const Range& items, TextFn text_of) {
+			return add_rows(items, text_of, nullptr);
+		}
+
+		// As add_rows, also setting each row's lParam to data_of(item) (an integer or pointer)
+		template<typename Range, typename TextFn, typename DataFn>
+		model::bulk_insert_result add_rows(const Range& items, TextFn text_of, DataFn data_of) {
+			auto start = std::chrono::steady_clock::now();
+			model::bulk_insert_result result;
+			result.requested = static_cast<size_t>(std::ranges::distance(items));
+			if (result.requested == 0 || is_owner_data())
+				return result;
+
+			int columns = (std::max)(get_header().get_item_count(), 1);
+			redraw_lock lock(*this);
+			int position = (std::max)(get_item_count(), 0);
+			set_item_count(static_cast<int>((std::min)(static_cast<size_t>(position) + result.requested, static_cast<size_t>(INT_MAX))));
+
+			model::terminated_text<TCHAR> text;
+			auto bytes = [](const auto& value) { return (model::terminated_text<TCHAR>::size(value) + 1) * sizeof(TCHAR); };
+			for (const auto& item : items) {
+				auto&& label = text_of(item, 0);
+				LVITEM row = { 0 };
+				row.mask = LVIF_TEXT;
+				row.iItem = position++;
+				row.pszText = const_cast<LPTSTR>(text(label));
+				if constexpr (!std::is_null_pointer_v<DataFn>) {
+					row.mask |= LVIF_PARAM;
+					row.lParam = (LPARAM)data_of(item);
+				}
+				int index = insert_item(&row);
+				if (index < 0)
+					break;
+				result.text_bytes += bytes(label);
+
+				for (int column = 1; column < columns; column++) {
+					auto&& cell = text_of(item, column);
+					set_item_text(index, column, text(cell));
+					result.text_bytes += bytes(cell);
+				}
+				result.last_index = index;
+				result.inserted++;
+			}
+			result.elapsed = std::chrono::steady_clock::now() - start;
+			return result;
+		}
+
+		// Single-column add_rows over views
+		model::bulk_insert_result add_items(std::span<const tstring_view> items) {
+			return add_rows(items, [](tstring_view item, int column) { return column == 0 ? item : tstring_view(); });
+		}
+
+		// Make the list show `items` (a random-access range) in order by changing only what differs from the
+		// previous reconcile: rows are matched by key_of(item), an integer unique per item, and only removed,
+		// added, moved and changed rows are touched, in one repaint. text_of(item, column) gives each cell for
+		// the header's columns. Kept rows keep their lParam, image and state (selection, focus, check), moved
+		// rows take theirs along, and the first visible row stays on top. If the list was changed by other
+		// means since the last reconcile, it is refilled. Not for owner-data lists, which reflect their source.
+		template<typename Range, typename KeyFn, typename TextFn>
+		BOOL reconcile(const Range& items, KeyFn&& key_of, TextFn&& text_of) {
+			if (is_owner_data())
+				return FALSE;
+
+			int columns = (std::max)(get_header().get_item_count(), 1);
+			auto next = model::make_snapshot(items, key_of, [&](const auto& item) {
+				std::uint64_t hash = model::content_hash(tstring_view(text_of(item, 0)));
+				for (int column = 1; column < columns; column++)
+					hash = model::content_hash(tstring_view(text_of(item, column)), hash);
+				return hash;
+			});
+			auto set_texts = [&](int index, size_t new_index, int first_column) {
+				const auto& item = std::begin(items)[new_index];
+				for (int column = first_column; column < columns; column++)
+					set_item_text(index, column, tstring(text_of(item, column)).c_str());
+			};
+
+			redraw_lock lock(*this);
+			if (m_reconciled.size() != static_cast<size_t>((std::max)(get_item_count(), 0))) {
+				delete_all_items();
+				m_reconciled.clear();
+			}
+
+			auto diff = model::diff_keyed<std::uint64_t>(m_reconciled.keys, next.keys, m_reconciled.content, next.content);
+			if (diff.empty()) {
+				m_reconciled = std::move(next);
+				return TRUE;
+			}
+
+			auto positions = diff.new_positions(m_reconciled.size());
+			int old_top = get_top_index();
+			int top = old_top >= 0 && static_cast<size_t>(old_top) < positions.size() && positions[old_top] != model::keyed_diff::npos
+				? static_cast<int>(positions[old_top]) : -1;
+
+			const UINT carried_state = LVIS_SELECTED | LVIS_FOCUSED | LVIS_CUT | LVIS_DROPHILITED | LVIS_OVERLAYMASK | LVIS_STATEIMAGEMASK;
+			std::vector<LVITEM> moving(diff.moved ? positions.size() : 0);
+			for (size_t old_index : diff.removed) {
+				int index = static_cast<int>(old_index);
+				if (positions[old_index] != model::keyed_diff::npos) {
+					LVITEM& item = moving[old_index];
+					item.mask = LVIF_PARAM | LVIF_IMAGE | LVIF_STATE | LVIF_INDENT;
+					item.iItem = index;
+					item.stateMask = carried_state;
+					get_item(&item);
+				}
+				if (!delete_item(index))
+					return FALSE;
+			}
+
+			if (diff.inserted.size() > 64)
+				set_item_count(static_cast<int>(next.size()));
+			for (size_t new_index : diff.inserted) {
+				tstring first = tstring(text_of(std::begin(items)[new_index], 0));
+				LVITEM item = diff.is_move(new_index) ? moving[diff.source[new_index]] : LVITEM{};
+				item.mask |= LVIF_TEXT;
+				item.iItem = static_cast<int>(new_index);
+				item.iSubItem = 0;
+				item.pszText = first.data();
+				int index = insert_item(&item);
+				if (index < 0)
+					return FALSE;
+				set_texts(index, new_index, 1);
+			}
+
+			for (size_t new_index : diff.updated)
+				set_texts(static_cast<int>(new_index), new_index, 0);
+
+			int new_top = get_top_index();
+			RECT bounds;
+			if (top >= 0 && new_top >= 0 && top != new_top && (get_style() & LVS_TYPEMASK) == LVS_REPORT && get_item_rect(0, &bounds, LVIR_BOUNDS))
+				scroll(SIZE{ 0, (top - new_top) * (bounds.bottom - bounds.top) });
+
+			m_reconciled = std::move(next);
+			return TRUE;
+		}
+
+		// Forget what the last reconcile showed; the next one refills the list
+		void reset_reconcile() { m_reconciled.clear(); }
+
+		using data_source = model::basic_list_view_source<TCHAR>;
+
+		// Owner-data (virtual) mode. The control must have been created with LVS_OWNERDATA; it then keeps only the
+		// row count and selection and asks the source for each cell as it is painted (LVN_GETDISPINFO).
+		BOOL set_data_source(std::shared_ptr<data_source> source) {
+			if (source && !(get_style() & LVS_OWNERDATA))
+				return FALSE;
+
+			if (m_source)
+				m_source->set_ready_notifier(nullptr);
+			m_source = std::move(source);
+			if (m_source && !m_source_hooked) {
+				register_notify_callback(LVN_GETDISPINFO, [this](LPNMHDR nm) { on_source_display_info(nm); });
+				register_notify_callback(LVN_ODCACHEHINT, [this](LPNMHDR nm) { on_source_cache_hint(nm); });
+				m_source_hooked = true;
+			}
+			if (m_source)
+				m_source->set_ready_notifier(make_async_notifier());
+			return source_changed(false);
+		}
+
+		using column_model = model::basic_column_model<TCHAR>;
+
+		// Collation for column_model text columns matching the user's locale, as the shell sorts names.
+		// Keys are built once per row, so the cost of LCMapString is not paid per comparison.
+		static column_model::collation_function locale_collation(DWORD flags = NORM_IGNORECASE) {
+			return [flags](std::basic_string_view<TCHAR> text) {
+				std::string key;
+				if (text.empty())
+					return key;
+				int length = static_cast<int>((std::min)(text.size(), static_cast<size_t>(INT_MAX)));
+				int size = LCMapString(LOCALE_USER_DEFAULT, LCMAP_SORTKEY | flags, text.data(), length, NULL, 0);
+				if (size <= 0)
+					return key;
+				key.resize(static_cast<size_t>(size));
+				size = LCMapString(LOCALE_USER_DEFAULT, LCMAP_SORTKEY | flags, text.data(), length, reinterpret_cast<LPTSTR>(key.data()), size);
+				key.resize(size > 0 ? static_cast<size_t>(size) - 1 : 0); // drop the terminating zero byte
+				return key;
+			};
+		}
+
+		const std::shared_ptr<data_source>& get_data_source() const { return m_source; }
+		BOOL is_owner_data() const { return (get_style() & LVS_OWNERDATA) != 0; }
+
+		// The source's row count changed (rows added or removed). Only the count is sent to the control;
+		// with keepPosition the scroll position is kept and only the visible rows are repainted.
+		BOOL source_changed(bool keepPosition = true) {
+			int count = m_source ? static_cast<int>((std::min)(m_source->row_count(), static_cast<size_t>(INT_MAX))) : 0;
+			DWORD flags = keepPosition ? LVSICF_NOSCROLL | LVSICF_NOINVALIDATEALL : 0;
+			if (!set_item_count_ex(count, flags))
+				return FALSE;
+			if (keepPosition)
+				redraw_visible_rows(0, count - 1);
+			return TRUE;
+		}
+
+		// Rows in [first, last] changed in the source without the count changing; repaints the visible part only
+		void rows_changed(int first, int last) {
+			redraw_visible_rows(first, last);
+		}
+
+		// Rows fetched in the background by an asynchronous source have landed; repaint them in one batch
+		void on_async_ready() override {
+			size_t first = 0, last = 0;
+			if (m_source && m_source->take_ready_rows(first, last))
+				redraw_visible_rows(static_cast<int>((std::min)(first, static_cast<size_t>(INT_MAX))), static_cast<int>((std::min)(last, static_cast<size_t>(INT_MAX))));
+		}
+
+	private:
+		void redraw_visible_rows(int first, int last) {
+			int top = get_top_index();
+			int bottom = top + get_count_per_page(); // one past the last fully visible row, which may be partly shown
+			first = (std::max)(first, top);
+			last = (std::min)({ last, bottom, get_item_count() - 1 });
+			if (first <= last)
+				redraw_items(first, last);
+		}
+
+		void on_source_cache_hint(LPNMHDR nm) {
+			auto hint = reinterpret_cast<NMLVCACHEHINT*>(nm);
+			if (m_source && hint->iFrom >= 0 && hint->iTo >= hint->iFrom)
+				m_source->cache_hint(static_cast<size_t>(hint->iFrom), static_cast<size_t>(hint->iTo));
+		}
+
+		void on_source_display_info(LPNMHDR nm) {
+			if (!m_source)
+				return;
+
+			LVITEM& item = reinterpret_cast<NMLVDISPINFO*>(nm)->item;
+			if (item.iItem < 0 || static_cast<size_t>(item.iItem) >= m_source->row_count())
+				return;
+
+			size_t row = static_cast<size_t>(item.iItem);
+			if ((item.mask & LVIF_TEXT) && item.pszText && item.cchTextMax > 0)
+				m_source->cell_text(row, item.iSubItem, item.pszText, static_cast<size_t>(item.cchTextMax));
+			if (item.mask & LVIF_IMAGE)
+				item.iImage = m_source->image(row, item.iSubItem);
+			if (item.mask & LVIF_STATE)
+				item.state = (item.state & ~item.stateMask) | (m_source->state(row) & item.stateMask);
+			if (item.mask & LVIF_INDENT)
+				item.iIndent = m_source->indent(row);
+		}
+
+		std::shared_ptr<data_source> m_source;
+		bool m_source_hooked = false;
+		model::keyed_snapshot m_reconciled;
 	};
 }
 
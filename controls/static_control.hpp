@@ -363,10 +363,7 @@ namespace wpp
 				LOGFONT lf = { 0 };
 				if (::GetObject(hFont, sizeof(LOGFONT), &lf)) {
 					lf.lfWeight = bold ? FW_BOLD : FW_NORMAL;
-					HFONT hNewFont = ::CreateFontIndirect(&lf);
-					if (hNewFont) {
-						set_font(hNewFont);
-					}
+					apply_font(lf);
 				}
 			}
 		}
@@ -377,10 +374,7 @@ namespace wpp
 				LOGFONT lf = { 0 };
 				if (::GetObject(hFont, sizeof(LOGFONT), &lf)) {
 					lf.lfItalic = italic ? TRUE : FALSE;
-					HFONT hNewFont = ::CreateFontIndirect(&lf);
-					if (hNewFont) {
-						set_font(hNewFont);
-					}
+					apply_font(lf);
 				}
 			}
 		}
@@ -391,10 +385,7 @@ namespace wpp
 				LOGFONT lf = { 0 };
 				if (::GetObject(hFont, sizeof(LOGFONT), &lf)) {
 					lf.lfUnderline = underline ? TRUE : FALSE;
-					HFONT hNewFont = ::CreateFontIndirect(&lf);
-					if (hNewFont) {
-						set_font(hNewFont);
-					}
+					apply_font(lf);
 				}
 			}
 		}
@@ -404,17 +395,31 @@ namespace wpp
 			if (hFont) {
 				LOGFONT lf = { 0 };
 				if (::GetObject(hFont, sizeof(LOGFONT), &lf)) {
-					HDC hdc = ::GetDC(m_handle);
-					lf.lfHeight = -::MulDiv(point_size, ::GetDeviceCaps(hdc, LOGPIXELSY), 72);
-					::ReleaseDC(m_handle, hdc);
+					lf.lfHeight = -::MulDiv(point_size, static_cast<int>(font_dpi()), 72);
 
-					HFONT hNewFont = ::CreateFontIndirect(&lf);
-					if (hNewFont) {
-						set_font(hNewFont);
-					}
+					apply_font(lf);
 				}
 			}
 		}
+
+	private:
+		// Variants come from the shared GDI cache; the control keeps its variant alive while it uses it. `lf` is
+		// in device pixels at the window's DPI, as GetObject returns it.
+		void apply_font(const LOGFONT& lf) {
+			UINT dpi = font_dpi();
+			auto font = graphics::gdi_cache::shared().font(lf, dpi, dpi);
+			if (font) {
+				set_font(font.get());
+				m_font_variant = std::move(font);
+			}
+		}
+
+		UINT font_dpi() const {
+			UINT dpi = ::GetDpiForWindow(m_handle);
+			return dpi ? dpi : USER_DEFAULT_SCREEN_DPI;
+		}
+
+		graphics::shared_font m_font_variant;
 	};
 
 	using label = static_control;
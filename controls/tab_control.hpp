@@ -176,6 +176,12 @@ namespace wpp
 			BOOL result = send_message<BOOL>(TCM_DELETEALLITEMS, 0, 0L);
 			if (result) {
 				m_page_controls.clear();
+				for (auto& [tabIndex, page] : m_lazy_pages) {
+					if (page.realized) {
+						unload(page);
+					}
+				}
+				m_lazy_pages.clear();
 			}
 			return result;
 		}
@@ -354,7 +360,95 @@ namespace wpp
 			return empty;
 		}
 
+		// Content of a lazily created page. controls are shown and hidden with the page. layout receives the display
+		// rect in the coordinates of the tab control's parent; without it each control is fitted to the display rect.
+		// release destroys the page when it is unloaded, typically with window::destroy_control so the window stops
+		// tracking the controls. Pages without release are never unloaded, only hidden.
+		struct page_content {
+			std::vector<HWND> controls;
+			std::function<void(const RECT& display)> layout;
+			std::function<void()> release;
+		};
+
+		using page_factory = std::function<page_content()>;
+
+		struct page_statistics {
+			int realized_pages = 0;       // pages whose controls currently exist
+			UINT64 realizations = 0;      // factory calls
+			UINT64 unloads = 0;           // pages destroyed by unload_page or the unload policy
+			UINT64 layouts = 0;           // page layouts run
+			UINT64 realize_us = 0;        // time spent in page factories
+			UINT64 layout_us = 0;         // time spent laying out pages
+			UINT64 last_layout_us = 0;    // duration of the most recent page layout
+		};
+
+		// Register a page whose controls are created by `factory` the first time the tab is selected.
+		// Hidden pages are never laid out; their layout is redone on activation if the display rect changed meanwhile.
+		tab_control& set_page_factory(int tabIndex, page_factory factory) {
+			if (!is_valid_index(tabIndex) || !factory) {
+				return *this;
+			}
+
+			unload_page(tabIndex);
+			m_lazy_pages[tabIndex].factory = std::move(factory);
+			sync_managed_pages();
+			return *this;
+		}
+
+		BOOL is_page_realized(int tabIndex) const {
+			auto it = m_lazy_pages.find(tabIndex);
+			return it != m_lazy_pages.end() && it->second.realized;
+		}
+
+		// Create a page's controls ahead of its first activation (e.g. during idle time)
+		void realize_page(int tabIndex) {
+			auto it = m_lazy_pages.find(tabIndex);
+			if (it != m_lazy_pages.end() && !it->second.realized) {
+				realize(it->second);
+				if (tabIndex != get_cur_sel()) {
+					show_page(it->second, false);
+				}
+			}
+		}
+
+		// Force a relayout of a page the next time it is shown (e.g. after its content changed)
+		void invalidate_page_layout(int tabIndex) {
+			auto it = m_lazy_pages.find(tabIndex);
+			if (it != m_lazy_pages.end()) {
+				it->second.layout_stale = true;
+			}
+		}
+
+		// Destroy a lazily created page's controls; the factory recreates them on the next activation.
+		// The selected page and pages without a release callback are never unloaded.
+		BOOL unload_page(int tabIndex) {
+			auto it = m_lazy_pages.find(tabIndex);
+			if (it == m_lazy_pages.end() || !is_unloadable(it->second) || tabIndex == get_cur_sel()) {
+				return FALSE;
+			}
+
+			unload(it->second);
+			return TRUE;
+		}
+
+		// Memory pressure policy: keep at most max_hidden_pages realized pages besides the selected one, unloading
+		// the least recently selected first (0 disables the limit). Applied on every page switch.
+		void set_page_unload_policy(size_t max_hidden_pages) {
+			m_max_hidden_pages = max_hidden_pages;
+			apply_unload_policy();
+		}
+
+		const page_statistics& get_page_statistics() const { return m_page_statistics; }
+
 		void fit_page_to_display_rect(int tabIndex) {
+			auto lazy = m_lazy_pages.find(tabIndex);
+			if (lazy != m_lazy_pages.end()) {
+				if (lazy->second.realized) {
+					layout_page(lazy->second, lazy->second.layout_stale);
+				}
+				return;
+			}
+
 			auto it = m_page_controls.find(tabIndex);
 			if (it == m_page_controls.end()) {
 				return;
@@ -374,6 +468,31 @@ namespace wpp
 
 		void sync_managed_pages() {
 			int selected = get_cur_sel();
+
+			// Hide the old page before realizing the new one so at most one page is visible at a time
+			for (auto& [tabIndex, page] : m_lazy_pages) {
+				if (tabIndex != selected && page.realized && page.visible) {
+					show_page(page, false);
+					page.last_active = ::GetTickCount64();
+				}
+			}
+
+			auto active = m_lazy_pages.find(selected);
+			if (active != m_lazy_pages.end()) {
+				auto& page = active->second;
+				if (!page.realized) {
+					realize(page);
+				}
+				if (page.realized) {
+					layout_page(page, page.layout_stale);
+					if (!page.visible) {
+						show_page(page, true);
+					}
+					page.last_active = ::GetTickCount64();
+				}
+				apply_unload_policy();
+			}
+
 			for (auto& [tabIndex, controls] : m_page_controls) {
 				bool show = (tabIndex == selected);
 				for (HWND handle : controls) {
@@ -510,28 +629,148 @@ namespace wpp
 			);
 		}
 
+		struct lazy_page {
+			page_factory factory;
+			page_content content;
+			bool realized = false;
+			bool visible = false;
+			bool layout_stale = true;
+			RECT layout_rect = { 0, 0, 0, 0 };
+			ULONGLONG last_active = 0;
+		};
+
+		static UINT64 elapsed_us(std::chrono::steady_clock::time_point start) {
+			return static_cast<UINT64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		void realize(lazy_page& page) {
+			auto start = std::chrono::steady_clock::now();
+			page.content = page.factory();
+			page.realized = true;
+			page.visible = false;
+			page.layout_stale = true;
+			page.last_active = ::GetTickCount64();
+			m_page_statistics.realized_pages++;
+			m_page_statistics.realizations++;
+			m_page_statistics.realize_us += elapsed_us(start);
+		}
+
+		static bool is_unloadable(const lazy_page& page) {
+			return page.realized && page.content.release;
+		}
+
+		// Pages without release only lose their tab (it was deleted): the controls belong to the window that
+		// created them, so they are hidden rather than destroyed behind its back
+		void unload(lazy_page& page) {
+			if (page.content.release) {
+				page.content.release();
+			} else {
+				show_page(page, false);
+			}
+
+			page.content = {};
+			page.realized = false;
+			page.visible = false;
+			page.layout_stale = true;
+			m_page_statistics.realized_pages--;
+			m_page_statistics.unloads++;
+		}
+
+		void show_page(lazy_page& page, bool show) {
+			for (HWND handle : page.content.controls) {
+				if (::IsWindow(handle)) {
+					::ShowWindow(handle, show ? SW_SHOW : SW_HIDE);
+				}
+			}
+			page.visible = show;
+		}
+
+		// Lay out a realized page unless it is already laid out for the current display rect
+		void layout_page(lazy_page& page, bool force) {
+			RECT display = get_display_rect();
+			if (!force && ::EqualRect(&display, &page.layout_rect)) {
+				return;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			if (page.content.layout) {
+				RECT mapped = display;
+				HWND parent = ::GetParent(m_handle);
+				if (parent) {
+					::MapWindowPoints(m_handle, parent, reinterpret_cast<LPPOINT>(&mapped), 2);
+				}
+				page.content.layout(mapped);
+			} else {
+				for (HWND handle : page.content.controls) {
+					fit_control_to_display_rect(handle);
+				}
+			}
+
+			page.layout_rect = display;
+			page.layout_stale = false;
+			m_page_statistics.layouts++;
+			m_page_statistics.last_layout_us = elapsed_us(start);
+			m_page_statistics.layout_us += m_page_statistics.last_layout_us;
+		}
+
+		void apply_unload_policy() {
+			if (m_max_hidden_pages == 0) {
+				return;
+			}
+
+			int selected = get_cur_sel();
+			std::vector<std::pair<ULONGLONG, int>> hidden;
+			for (auto& [tabIndex, page] : m_lazy_pages) {
+				if (tabIndex != selected && is_unloadable(page)) {
+					hidden.emplace_back(page.last_active, tabIndex);
+				}
+			}
+
+			// Least recently selected first
+			if (m_max_hidden_pages != 0 && hidden.size() > m_max_hidden_pages) {
+				std::sort(hidden.begin(), hidden.end());
+				for (size_t i = 0; i < hidden.size() - m_max_hidden_pages; ++i) {
+					unload(m_lazy_pages[hidden[i].second]);
+				}
+			}
+		}
+
+		template<typename Page>
+		static void shift_pages(std::unordered_map<int, Page>& pages, int fromIndex, int delta) {
+			std::unordered_map<int, Page> shifted;
+			for (auto& [index, page] : pages) {
+				shifted[index >= fromIndex ? index + delta : index] = std::move(page);
+			}
+			pages = std::move(shifted);
+		}
+
 		void on_tab_deleted(int deletedIndex) {
 			auto erased = m_page_controls.find(deletedIndex);
 			if (erased != m_page_controls.end()) {
 				m_page_controls.erase(erased);
 			}
 
-			std::unordered_map<int, std::vector<HWND>> shifted;
-			for (auto& [index, controls] : m_page_controls) {
-				shifted[index > deletedIndex ? index - 1 : index] = std::move(controls);
+			auto lazy = m_lazy_pages.find(deletedIndex);
+			if (lazy != m_lazy_pages.end()) {
+				if (lazy->second.realized) {
+					unload(lazy->second);
+				}
+				m_lazy_pages.erase(lazy);
 			}
-			m_page_controls = std::move(shifted);
+
+			shift_pages(m_page_controls, deletedIndex + 1, -1);
+			shift_pages(m_lazy_pages, deletedIndex + 1, -1);
 		}
 
 		void on_tab_inserted(int insertedIndex) {
-			std::unordered_map<int, std::vector<HWND>> shifted;
-			for (auto& [index, controls] : m_page_controls) {
-				shifted[index >= insertedIndex ? index + 1 : index] = std::move(controls);
-			}
-			m_page_controls = std::move(shifted);
+			shift_pages(m_page_controls, insertedIndex, 1);
+			shift_pages(m_lazy_pages, insertedIndex, 1);
 		}
 
 		std::unordered_map<int, std::vector<HWND>> m_page_controls;
+		std::unordered_map<int, lazy_page> m_lazy_pages;
+		page_statistics m_page_statistics;
+		size_t m_max_hidden_pages = 0;
 	};
 }
 
@@ -50,7 +50,10 @@ namespace wpp
 		}
 
 		BOOL set_item(LPTVITEM pItem) {
-			return TreeView_SetItem(m_handle, pItem);
+			BOOL bRes = TreeView_SetItem(m_handle, pItem);
+			if (bRes && m_index)
+				index_item_changed(*pItem);
+			return bRes;
 		}
 
 		BOOL set_item(HTREEITEM hItem, UINT nMask, LPCTSTR lpszItem, int nImage,
@@ -64,7 +67,7 @@ namespace wpp
 			item.state = nState;
 			item.stateMask = nStateMask;
 			item.lParam = lParam;
-			return TreeView_SetItem(m_handle, &item);
+			return set_item(&item);
 		}
 
 		BOOL get_item_text(HTREEITEM hItem, LPTSTR lpstrText, int nLen) const {
@@ -106,6 +109,8 @@ namespace wpp
 		}
 
 		DWORD_PTR get_item_data(HTREEITEM hItem) const {
+			if (m_index && m_index->contains(hItem))
+				return static_cast<DWORD_PTR>(m_index->data(hItem));
 			TVITEM item = { 0 };
 			item.hItem = hItem;
 			item.mask = TVIF_PARAM;
@@ -220,7 +225,7 @@ namespace wpp
 		}
 
 		BOOL set_item(LPTVITEMEX pItem) {
-			return TreeView_SetItem(m_handle, (LPTVITEM)pItem);
+			return set_item((LPTVITEM)pItem);
 		}
 
 		DWORD get_extended_style() const {
@@ -245,7 +250,10 @@ namespace wpp
 		}
 
 		HTREEITEM insert_item(LPTVINSERTSTRUCT lpInsertStruct) {
-			return TreeView_InsertItem(m_handle, lpInsertStruct);
+			HTREEITEM hItem = TreeView_InsertItem(m_handle, lpInsertStruct);
+			if (hItem && m_index)
+				index_item_inserted(hItem, *lpInsertStruct);
+			return hItem;
 		}
 
 		HTREEITEM insert_item(LPCTSTR lpszItem, int nImage,
@@ -270,19 +278,32 @@ namespace wpp
 			tvis.item.state = nState;
 			tvis.item.stateMask = nStateMask;
 			tvis.item.lParam = lParam;
-			return TreeView_InsertItem(m_handle, &tvis);
+			return insert_item(&tvis);
 		}
 
 		BOOL delete_item(HTREEITEM hItem) {
-			return TreeView_DeleteItem(m_handle, hItem);
+			BOOL bRes = TreeView_DeleteItem(m_handle, hItem);
+			if (bRes && m_index) {
+				if (hItem == TVI_ROOT)
+					m_index->clear();
+				else
+					m_index->erase(hItem);
+			}
+			return bRes;
 		}
 
 		BOOL delete_all_items() {
-			return TreeView_DeleteAllItems(m_handle);
+			BOOL bRes = TreeView_DeleteAllItems(m_handle);
+			if (bRes && m_index)
+				m_index->clear();
+			return bRes;
 		}
 
 		BOOL expand(HTREEITEM hItem, UINT nCode = TVE_EXPAND) {
-			return TreeView_Expand(m_handle, hItem, nCode);
+			BOOL bRes = TreeView_Expand(m_handle, hItem, nCode);
+			if (bRes && m_index) // TVM_EXPAND sends no TVN_ITEMEXPANDED
+				m_index->set_expanded(hItem, (TreeView_GetItemState(m_handle, hItem, TVIS_EXPANDED) & TVIS_EXPANDED) != 0);
+			return bRes;
 		}
 
 		HTREEITEM get_next_item(HTREEITEM hItem, UINT nCode) const {
@@ -290,18 +311,28 @@ namespace wpp
 		}
 
 		HTREEITEM get_child_item(HTREEITEM hItem) const {
+			if (m_index && (hItem == NULL || hItem == TVI_ROOT))
+				return m_index->first_child(NULL);
+			if (m_index && m_index->contains(hItem))
+				return m_index->first_child(hItem);
 			return TreeView_GetChild(m_handle, hItem);
 		}
 
 		HTREEITEM get_next_sibling_item(HTREEITEM hItem) const {
+			if (m_index && m_index->contains(hItem))
+				return m_index->next_sibling(hItem);
 			return TreeView_GetNextSibling(m_handle, hItem);
 		}
 
 		HTREEITEM get_prev_sibling_item(HTREEITEM hItem) const {
+			if (m_index && m_index->contains(hItem))
+				return m_index->prev_sibling(hItem);
 			return TreeView_GetPrevSibling(m_handle, hItem);
 		}
 
 		HTREEITEM get_parent_item(HTREEITEM hItem) const {
+			if (m_index && m_index->contains(hItem))
+				return m_index->parent(hItem);
 			return TreeView_GetParent(m_handle, hItem);
 		}
 
@@ -330,6 +361,8 @@ namespace wpp
 		}
 
 		HTREEITEM get_root_item() const {
+			if (m_index)
+				return m_index->first_child(NULL);
 			return TreeView_GetRoot(m_handle);
 		}
 
@@ -379,7 +412,10 @@ namespace wpp
 		}
 
 		BOOL sort_children(HTREEITEM hItem, BOOL bRecurse = FALSE) {
-			return TreeView_SortChildren(m_handle, hItem, bRecurse);
+			BOOL bRes = TreeView_SortChildren(m_handle, hItem, bRecurse);
+			if (bRes && m_index)
+				index_children_reordered(hItem, bRecurse);
+			return bRes;
 		}
 
 		BOOL ensure_visible(HTREEITEM hItem) {
@@ -387,7 +423,10 @@ namespace wpp
 		}
 
 		BOOL sort_children_cb(LPTVSORTCB pSort, BOOL bRecurse = FALSE) {
-			return TreeView_SortChildrenCB(m_handle, pSort, bRecurse);
+			BOOL bRes = TreeView_SortChildrenCB(m_handle, pSort, bRecurse);
+			if (bRes && m_index)
+				index_children_reordered(pSort->hParent, bRecurse);
+			return bRes;
 		}
 
 		image_list remove_image_list(int nImageList) {
@@ -467,6 +506,8 @@ namespace wpp
 		}
 
 		BOOL is_item_expanded(HTREEITEM hItem) const {
+			if (m_index && m_index->contains(hItem))
+				return m_index->is_expanded(hItem);
 			return (get_item_state(hItem, TVIS_EXPANDED) & TVIS_EXPANDED) != 0;
 		}
 
@@ -588,7 +629,12 @@ namespace wpp
 			return NULL;
 		}
 
+		// With the index enabled this is a hash lookup, and of several items with the same data the one inserted
+		// first is returned rather than the first in display order
 		HTREEITEM find_item_by_data(DWORD_PTR data, HTREEITEM hStart = TVI_ROOT) const {
+			if (m_index && (hStart == TVI_ROOT || m_index->contains(hStart)))
+				return m_index->find_by_data(static_cast<std::uint64_t>(data), hStart == TVI_ROOT ? NULL : hStart);
+
 			if (hStart == TVI_ROOT) {
 				hStart = get_root_item();
 			}
@@ -617,25 +663,9 @@ namespace wpp
 
 		std::vector<HTREEITEM> get_all_items(HTREEITEM hStart = TVI_ROOT) const {
 			std::vector<HTREEITEM> items;
-			
-			if (hStart == TVI_ROOT) {
-				hStart = get_root_item();
-			}
-			
-			if (!hStart) return items;
-			
-			HTREEITEM hCurrent = hStart;
-			while (hCurrent) {
-				items.push_back(hCurrent);
-				
-				HTREEITEM hChild = get_child_item(hCurrent);
-				if (hChild) {
-					std::vector<HTREEITEM> childItems = get_all_items(hChild);
-					items.insert(items.end(), childItems.begin(), childItems.end());
-				}
-				
-				hCurrent = get_next_sibling_item(hCurrent);
-			}
+			if (m_index && hStart == TVI_ROOT)
+				items.reserve(m_index->size());
+			walk_items(hStart, [&items](HTREEITEM hItem) { items.push_back(hItem); });
 			return items;
 		}
 
@@ -662,23 +692,7 @@ namespace wpp
 		}
 
 		void for_each_item(std::function<void(HTREEITEM)> func, HTREEITEM hStart = TVI_ROOT) {
-			if (hStart == TVI_ROOT) {
-				hStart = get_root_item();
-			}
-			
-			if (!hStart) return;
-			
-			HTREEITEM hCurrent = hStart;
-			while (hCurrent) {
-				func(hCurrent);
-				
-				HTREEITEM hChild = get_child_item(hCurrent);
-				if (hChild) {
-					for_each_item(func, hChild);
-				}
-				
-				hCurrent = get_next_sibling_item(hCurrent);
-			}
+			walk_items(hStart, func);
 		}
 
 		BOOL delete_children(HTREEITEM hItem) {
@@ -735,6 +749,14 @@ namespace wpp
 		}
 
 		int get_checked_count(HTREEITEM hStart = TVI_ROOT) const {
+			if (m_index && hStart == TVI_ROOT)
+				return static_cast<int>(m_index->checked_count());
+			if (m_index && m_index->contains(hStart)) {
+				int checked = 0;
+				m_index->for_each(hStart, [&](HTREEITEM hItem) { checked += m_index->is_checked(hItem) ? 1 : 0; });
+				return checked;
+			}
+
 			int count = 0;
 			std::vector<HTREEITEM> items = get_all_items(hStart);
 			for (HTREEITEM hItem : items) {
@@ -743,8 +765,21 @@ namespace wpp
 			return count;
 		}
 
+		// With the index enabled, items come most recently checked first when hStart is the root
 		std::vector<HTREEITEM> get_checked_items(HTREEITEM hStart = TVI_ROOT) const {
 			std::vector<HTREEITEM> checked;
+			if (m_index && hStart == TVI_ROOT) {
+				checked.reserve(m_index->checked_count());
+				m_index->for_each_checked([&](HTREEITEM hItem) { checked.push_back(hItem); });
+				return checked;
+			}
+			if (m_index && m_index->contains(hStart)) {
+				m_index->for_each(hStart, [&](HTREEITEM hItem) {
+					if (m_index->is_checked(hItem)) checked.push_back(hItem);
+				});
+				return checked;
+			}
+
 			std::vector<HTREEITEM> items = get_all_items(hStart);
 			for (HTREEITEM hItem : items) {
 				if (get_check_state(hItem)) checked.push_back(hItem);
@@ -902,6 +937,9 @@ namespace wpp
 		}
 
 		HTREEITEM get_prev_item(HTREEITEM hItem) const {
+			if (m_index && m_index->contains(hItem))
+				return m_index->prev_sibling(hItem);
+
 			HTREEITEM hParent = get_parent_item(hItem);
 			HTREEITEM hSibling = get_child_item(hParent ? hParent : TVI_ROOT);
 			HTREEITEM hPrev = NULL;
@@ -922,6 +960,14 @@ namespace wpp
 		}
 
 		int get_expanded_count(HTREEITEM hStart = TVI_ROOT) const {
+			if (m_index && hStart == TVI_ROOT)
+				return static_cast<int>(m_index->expanded_count());
+			if (m_index && m_index->contains(hStart)) {
+				int expanded = 0;
+				m_index->for_each(hStart, [&](HTREEITEM hItem) { expanded += m_index->is_expanded(hItem) ? 1 : 0; });
+				return expanded;
+			}
+
 			int count = 0;
 			std::vector<HTREEITEM> items = get_all_items(hStart);
 			for (HTREEITEM hItem : items) {
@@ -935,6 +981,550 @@ namespace wpp
 			get_item_rect(hItem, &rc, bTextOnly);
 			return rc;
 		}
+
+		using tree_index = model::basic_tree_index<HTREEITEM>;
+
+		// Keep a mirror of the tree's structure, item data and expanded/checked state, so navigation,
+		// find_item_by_data, the checked and expanded queries and whole-tree walks need no message per item.
+		// It follows the inserts, deletes, sorts and state changes made through this wrapper, and deletes,
+		// expansion and checkbox clicks reported by notifications. Enabling it reads the current items once.
+		BOOL enable_index(BOOL bEnable = TRUE) {
+			m_index.reset();
+			if (!bEnable)
+				return TRUE;
+
+			if (!m_index_hooked) {
+				register_notify_callback(TVN_DELETEITEM, [this](LPNMHDR nm) { on_index_delete(nm); });
+				register_notify_callback(TVN_ITEMEXPANDED, [this](LPNMHDR nm) { on_index_expanded(nm); });
+				register_notify_callback(TVN_ITEMCHANGED, [this](LPNMHDR nm) { on_index_item_changed(nm); });
+				m_index_hooked = true;
+			}
+
+			auto index = std::make_unique<tree_index>();
+			BOOL complete = TRUE;
+			walk_items(TVI_ROOT, [&](HTREEITEM hItem) {
+				TVITEM item = { 0 };
+				item.hItem = hItem;
+				item.mask = TVIF_PARAM | TVIF_STATE;
+				item.stateMask = TVIS_EXPANDED | TVIS_STATEIMAGEMASK;
+				get_item(&item);
+				if (!index->insert_last(hItem, get_parent_item(hItem), static_cast<std::uint64_t>(item.lParam),
+										(item.state & TVIS_EXPANDED) != 0, is_checked_state(item.state)))
+					complete = FALSE;
+			});
+			if (!complete)
+				return FALSE;
+			m_index = std::move(index);
+			return TRUE;
+		}
+
+		BOOL has_index() const { return m_index != nullptr; }
+		const tree_index* get_index() const { return m_index.get(); }
+
+		using tree_snapshot = model::basic_tree_snapshot<TCHAR>;
+
+		// Bring the tree in line with a snapshot of the hierarchy, changing only what differs from the previous
+		// reconcile: children are matched by key under their matched parent, level by level, and removed,
+		// inserted or updated in place, so expansion, selection, checks and images of kept items survive.
+		// Items carry the snapshot's data as lParam. Children of a node are inserted when it is first expanded,
+		// and collapsed subtrees that were never shown are not compared at all. Tree items cannot be re-parented
+		// or reordered, so a moved item is rebuilt with its shown subtree and their state is carried over. If
+		// items were added or deleted by other means since the last reconcile, the tree is refilled.
+		BOOL reconcile(tree_snapshot snapshot) {
+			if (!m_tree_hooked) {
+				register_notify_callback(TVN_ITEMEXPANDING, [this](LPNMHDR nm) { on_tree_expanding(nm); });
+				m_tree_hooked = true;
+			}
+
+			redraw_lock lock(*this);
+			if (m_tree_items.empty() || get_count() != m_tree_count) {
+				delete_all_items();
+				reset_reconcile();
+			}
+
+			auto diff = model::diff_trees(m_tree, snapshot, [this](tree_snapshot::node_id node) { return static_cast<bool>(m_tree_realized[node]); });
+
+			std::vector<HTREEITEM> items(snapshot.size(), NULL);
+			std::vector<bool> realized(snapshot.size(), false);
+			for (size_t node = 0; node < snapshot.size(); ++node) {
+				if (diff.old_of[node] != model::tree_diff::npos) {
+					items[node] = m_tree_items[diff.old_of[node]];
+					realized[node] = m_tree_realized[diff.old_of[node]];
+				}
+			}
+
+			tree_moves moves;
+			for (const model::tree_level& level : diff.levels) {
+				const model::keyed_diff& children = level.children;
+				HTREEITEM parent = items[level.new_parent];
+
+				auto positions = children.new_positions(level.old_children.size());
+				for (size_t old_index : children.removed) {
+					tree_snapshot::node_id old_node = level.old_children[old_index];
+					if (positions[old_index] != model::keyed_diff::npos)
+						capture_tree_state(old_node, moves);
+					if (!delete_item(m_tree_items[old_node]))
+						return FALSE;
+				}
+
+				for (size_t new_index : children.inserted) {
+					tree_snapshot::node_id node = level.new_children[new_index];
+					HTREEITEM after = new_index == 0 ? TVI_FIRST : items[level.new_children[new_index - 1]];
+					items[node] = insert_tree_node(snapshot, node, parent, after);
+					if (!items[node])
+						return FALSE;
+					if (children.is_move(new_index))
+						rebuild_tree_node(snapshot, level.old_children[children.source[new_index]], node, items, realized, moves);
+				}
+
+				for (size_t new_index : children.updated) {
+					tree_snapshot::node_id node = level.new_children[new_index];
+					tstring text(snapshot.text(node));
+					TVITEM item = { 0 };
+					item.hItem = items[node];
+					item.mask = TVIF_TEXT | TVIF_PARAM | TVIF_CHILDREN;
+					item.pszText = text.data();
+					item.lParam = static_cast<LPARAM>(snapshot.data(node));
+					item.cChildren = snapshot.has_children(node) ? 1 : 0;
+					set_item(&item);
+				}
+			}
+
+			if (moves.selected)
+				select_item(moves.selected);
+			if (moves.first_visible)
+				select_set_first_visible(moves.first_visible);
+
+			m_tree = std::move(snapshot);
+			m_tree_items = std::move(items);
+			m_tree_realized = std::move(realized);
+			m_tree_count = static_cast<UINT>(std::count_if(m_tree_items.begin() + 1, m_tree_items.end(), [](HTREEITEM item) { return item != NULL; }));
+			m_tree_nodes.clear();
+			return TRUE;
+		}
+
+		// Forget what the last reconcile showed; the next one refills the tree
+		void reset_reconcile() {
+			m_tree.clear();
+			m_tree_items.assign(1, TVI_ROOT);
+			m_tree_realized.assign(1, true);
+			m_tree_nodes.clear();
+			m_tree_count = 0;
+		}
+
+		using lazy_loader = model::basic_lazy_tree_loader<TCHAR>;
+
+		// Lazy children. Items inserted with insert_lazy_item show an expand button (I_CHILDRENCALLBACK) but have
+		// no children until first expanded; the loader then lists them on a background thread while a placeholder
+		// item is shown, and they are inserted in batches as they arrive. Collapsing or deleting the item before
+		// its load completes cancels it, and the next expansion starts over.
+		void set_lazy_loader(std::shared_ptr<lazy_loader> loader, tstring placeholder = TEXT("Loading...")) {
+			if (m_lazy)
+				m_lazy->set_ready_notifier(nullptr);
+			cancel_lazy_loads();
+			m_lazy = std::move(loader);
+			m_lazy_placeholder = std::move(placeholder);
+			if (m_lazy && !m_lazy_hooked) {
+				register_notify_callback(TVN_GETDISPINFO, [this](LPNMHDR nm) { on_lazy_display_info(nm); });
+				register_notify_callback(TVN_ITEMEXPANDING, [this](LPNMHDR nm) { on_lazy_expanding(nm); });
+				register_notify_callback(TVN_ITEMEXPANDED, [this](LPNMHDR nm) { on_lazy_expanded(nm); });
+				register_notify_callback(TVN_DELETEITEM, [this](LPNMHDR nm) { on_lazy_delete(nm); });
+				m_lazy_hooked = true;
+			}
+			if (m_lazy)
+				m_lazy->set_ready_notifier(make_async_notifier());
+		}
+
+		const std::shared_ptr<lazy_loader>& get_lazy_loader() const { return m_lazy; }
+
+		HTREEITEM insert_lazy_item(HTREEITEM hParent, LPCTSTR lpszText, LPARAM lParam, HTREEITEM hInsertAfter = TVI_LAST) {
+			TVINSERTSTRUCT tvis = { 0 };
+			tvis.hParent = hParent;
+			tvis.hInsertAfter = hInsertAfter;
+			tvis.item.mask = TVIF_TEXT | TVIF_PARAM | TVIF_CHILDREN;
+			tvis.item.pszText = (LPTSTR)lpszText;
+			tvis.item.lParam = lParam;
+			tvis.item.cChildren = I_CHILDRENCALLBACK;
+			HTREEITEM hItem = insert_item(&tvis);
+			if (hItem)
+				m_lazy_unloaded.insert(hItem);
+			return hItem;
+		}
+
+		BOOL is_item_loading(HTREEITEM hItem) const {
+			return m_lazy_loads.find(hItem) != m_lazy_loads.end();
+		}
+
+		BOOL is_item_loaded(HTREEITEM hItem) const {
+			return m_lazy_unloaded.find(hItem) == m_lazy_unloaded.end() && !is_item_loading(hItem);
+		}
+
+		// Drop the children of a lazy item and list them again; reloads at once if the item is expanded
+		BOOL reload_item(HTREEITEM hItem) {
+			if (!is_valid_item(hItem))
+				return FALSE;
+
+			cancel_lazy_load(hItem);
+			delete_children(hItem);
+			TVITEM item = { 0 };
+			item.hItem = hItem;
+			item.mask = TVIF_CHILDREN;
+			item.cChildren = I_CHILDRENCALLBACK;
+			set_item(&item);
+			m_lazy_unloaded.insert(hItem);
+			if (is_item_expanded(hItem))
+				start_lazy_load(hItem);
+			return TRUE;
+		}
+
+		// Children listed in the background have landed; insert them with painting suspended
+		void on_async_ready() override {
+			std::vector<lazy_loader::batch> batches;
+			if (!m_lazy || !m_lazy->take_ready(batches))
+				return;
+
+			redraw_lock lock(*this);
+			for (lazy_loader::batch& batch : batches) {
+				HTREEITEM hItem = reinterpret_cast<HTREEITEM>(static_cast<std::uintptr_t>(batch.node));
+				auto it = m_lazy_loads.find(hItem);
+				if (it == m_lazy_loads.end())
+					continue;
+
+				lazy_load& load = it->second;
+				for (lazy_loader::child& child : batch.children) {
+					TVINSERTSTRUCT tvis = { 0 };
+					tvis.hParent = hItem;
+					tvis.hInsertAfter = load.last;
+					tvis.item.mask = TVIF_TEXT | TVIF_PARAM | TVIF_CHILDREN;
+					tvis.item.pszText = child.text.data();
+					tvis.item.lParam = static_cast<LPARAM>(child.data);
+					tvis.item.cChildren = child.has_children ? I_CHILDRENCALLBACK : 0;
+					HTREEITEM hChild = insert_item(&tvis);
+					if (!hChild)
+						continue;
+					if (child.has_children)
+						m_lazy_unloaded.insert(hChild);
+					load.last = hChild;
+					load.count++;
+				}
+
+				if (batch.done) {
+					TVITEM item = { 0 };
+					item.hItem = hItem;
+					item.mask = TVIF_CHILDREN;
+					item.cChildren = load.count > 0 ? 1 : 0;
+					HTREEITEM placeholder = load.placeholder;
+					m_lazy_loads.erase(it);
+					m_lazy_unloaded.erase(hItem);
+					if (placeholder)
+						delete_item(placeholder);
+					set_item(&item);
+				}
+			}
+		}
+
+	private:
+		static bool is_checked_state(UINT state) {
+			return ((state & TVIS_STATEIMAGEMASK) >> 12) >= 2;
+		}
+
+		// Visit hStart, its subtree, then its following siblings and theirs, in display order, without recursion
+		template<typename Fn>
+		void walk_items(HTREEITEM hStart, Fn&& fn) const {
+			if (hStart == TVI_ROOT)
+				hStart = get_root_item();
+			if (!hStart)
+				return;
+			if (m_index && m_index->contains(hStart)) {
+				m_index->for_each(hStart, fn);
+				return;
+			}
+
+			HTREEITEM hStop = get_parent_item(hStart);
+			HTREEITEM hCurrent = hStart;
+			while (hCurrent) {
+				fn(hCurrent);
+				HTREEITEM hNext = get_child_item(hCurrent);
+				while (!hNext && hCurrent) {
+					hNext = get_next_sibling_item(hCurrent);
+					if (!hNext) {
+						hCurrent = get_parent_item(hCurrent);
+						if (hCurrent == hStop)
+							hCurrent = NULL;
+					}
+				}
+				hCurrent = hNext;
+			}
+		}
+
+		void index_item_inserted(HTREEITEM hItem, const TVINSERTSTRUCT& tvis) {
+			HTREEITEM hParent = tvis.hParent == TVI_ROOT ? NULL : tvis.hParent;
+			HTREEITEM hAfter = tvis.hInsertAfter;
+			if (hAfter == TVI_FIRST)
+				hAfter = NULL;
+			else if (hAfter == TVI_LAST)
+				hAfter = m_index->last_child(hParent);
+			else if (hAfter == TVI_SORT || hAfter == TVI_ROOT || !m_index->contains(hAfter))
+				hAfter = TreeView_GetPrevSibling(m_handle, hItem);
+
+			const TVITEM& item = tvis.item;
+			UINT state = (item.mask & TVIF_STATE) ? item.state & item.stateMask : 0;
+			if (!m_index->insert(hItem, hParent, hAfter, (item.mask & TVIF_PARAM) ? static_cast<std::uint64_t>(item.lParam) : 0,
+								 (state & TVIS_EXPANDED) != 0, is_checked_state(state)))
+				m_index.reset(); // lost track of the control; fall back to asking it
+		}
+
+		void index_item_changed(const TVITEM& item) {
+			if (item.mask & TVIF_PARAM)
+				m_index->set_data(item.hItem, static_cast<std::uint64_t>(item.lParam));
+			if (item.mask & TVIF_STATE) {
+				if (item.stateMask & TVIS_EXPANDED)
+					m_index->set_expanded(item.hItem, (item.state & TVIS_EXPANDED) != 0);
+				if (item.stateMask & TVIS_STATEIMAGEMASK)
+					m_index->set_checked(item.hItem, is_checked_state(item.state));
+			}
+		}
+
+		// The control sorted the children of hParent (and their descendants with bRecurse); read the new order
+		void index_children_reordered(HTREEITEM hParent, BOOL bRecurse) {
+			std::vector<HTREEITEM> pending{ hParent == TVI_ROOT ? NULL : hParent };
+			std::vector<HTREEITEM> order;
+			while (!pending.empty() && m_index) {
+				HTREEITEM hCurrent = pending.back();
+				pending.pop_back();
+				order.clear();
+				for (HTREEITEM hChild = TreeView_GetChild(m_handle, hCurrent ? hCurrent : TVI_ROOT); hChild; hChild = TreeView_GetNextSibling(m_handle, hChild))
+					order.push_back(hChild);
+				if (!m_index->reorder_children(hCurrent, order))
+					m_index.reset();
+				if (bRecurse)
+					pending.insert(pending.end(), order.begin(), order.end());
+			}
+		}
+
+		void on_index_delete(LPNMHDR nm) {
+			if (m_index)
+				m_index->erase(reinterpret_cast<LPNMTREEVIEW>(nm)->itemOld.hItem);
+		}
+
+		void on_index_expanded(LPNMHDR nm) {
+			const TVITEM& item = reinterpret_cast<LPNMTREEVIEW>(nm)->itemNew;
+			if (m_index)
+				m_index->set_expanded(item.hItem, (item.state & TVIS_EXPANDED) != 0);
+		}
+
+		void on_index_item_changed(LPNMHDR nm) {
+			auto change = reinterpret_cast<NMTVITEMCHANGE*>(nm);
+			if (m_index && (change->uChanged & TVIF_STATE)) {
+				m_index->set_expanded(change->hItem, (change->uStateNew & TVIS_EXPANDED) != 0);
+				m_index->set_checked(change->hItem, is_checked_state(change->uStateNew));
+			}
+		}
+
+		// State read from the items of moved subtrees before they are deleted, by node of the previous snapshot
+		struct tree_moves {
+			struct carried { UINT state = 0; int image = 0; int selected_image = 0; };
+			std::unordered_map<tree_snapshot::node_id, carried> items;
+			HTREEITEM selected = NULL;
+			HTREEITEM first_visible = NULL;
+			tree_snapshot::node_id selected_node = tree_snapshot::npos;
+			tree_snapshot::node_id first_visible_node = tree_snapshot::npos;
+		};
+
+		HTREEITEM insert_tree_node(const tree_snapshot& snapshot, tree_snapshot::node_id node, HTREEITEM parent, HTREEITEM after) {
+			tstring text(snapshot.text(node));
+			TVINSERTSTRUCT tvis = { 0 };
+			tvis.hParent = parent;
+			tvis.hInsertAfter = after;
+			tvis.item.mask = TVIF_TEXT | TVIF_PARAM | TVIF_CHILDREN;
+			tvis.item.pszText = text.data();
+			tvis.item.lParam = static_cast<LPARAM>(snapshot.data(node));
+			tvis.item.cChildren = snapshot.has_children(node) ? 1 : 0;
+			return insert_item(&tvis);
+		}
+
+		void capture_tree_state(tree_snapshot::node_id old_node, tree_moves& moves) {
+			HTREEITEM selected = get_selected_item();
+			HTREEITEM first_visible = get_first_visible_item();
+			std::vector<tree_snapshot::node_id> pending{ old_node };
+			while (!pending.empty()) {
+				tree_snapshot::node_id node = pending.back();
+				pending.pop_back();
+
+				TVITEM item = { 0 };
+				item.hItem = m_tree_items[node];
+				item.mask = TVIF_STATE | TVIF_IMAGE | TVIF_SELECTEDIMAGE;
+				item.stateMask = TVIS_EXPANDED | TVIS_BOLD | TVIS_CUT | TVIS_OVERLAYMASK | TVIS_STATEIMAGEMASK;
+				get_item(&item);
+				moves.items[node] = { item.state & item.stateMask, item.iImage, item.iSelectedImage };
+				if (item.hItem == selected)
+					moves.selected_node = node;
+				if (item.hItem == first_visible)
+					moves.first_visible_node = node;
+
+				if (m_tree_realized[node]) {
+					for (auto child = m_tree.first_child(node); child != tree_snapshot::npos; child = m_tree.next_sibling(child))
+						pending.push_back(child);
+				}
+			}
+		}
+
+		// Give the item inserted for a moved node the state its old item had, and insert the children that were
+		// shown before, carrying state over to those that are still there
+		void rebuild_tree_node(const tree_snapshot& snapshot, tree_snapshot::node_id old_node, tree_snapshot::node_id node,
+							   std::vector<HTREEITEM>& items, std::vector<bool>& realized, tree_moves& moves) {
+			auto it = moves.items.find(old_node);
+			if (it == moves.items.end())
+				return;
+			const tree_moves::carried carried = it->second;
+
+			TVITEM item = { 0 };
+			item.hItem = items[node];
+			item.mask = TVIF_STATE | TVIF_IMAGE | TVIF_SELECTEDIMAGE;
+			item.state = carried.state & ~TVIS_EXPANDED;
+			item.stateMask = TVIS_BOLD | TVIS_CUT | TVIS_OVERLAYMASK | TVIS_STATEIMAGEMASK;
+			item.iImage = carried.image;
+			item.iSelectedImage = carried.selected_image;
+			set_item(&item);
+			if (old_node == moves.selected_node)
+				moves.selected = items[node];
+			if (old_node == moves.first_visible_node)
+				moves.first_visible = items[node];
+
+			if (!m_tree_realized[old_node])
+				return;
+
+			realized[node] = true;
+			auto matched = model::match_children(m_tree, old_node, snapshot, node);
+			size_t index = 0;
+			for (auto child = snapshot.first_child(node); child != tree_snapshot::npos; child = snapshot.next_sibling(child), ++index) {
+				items[child] = insert_tree_node(snapshot, child, items[node], TVI_LAST);
+				if (items[child] && matched[index] != model::tree_diff::npos)
+					rebuild_tree_node(snapshot, matched[index], child, items, realized, moves);
+			}
+			if ((carried.state & TVIS_EXPANDED) && snapshot.has_children(node))
+				set_item_state(items[node], TVIS_EXPANDED, TVIS_EXPANDED);
+		}
+
+		// Insert the children of a reconciled node the first time it is expanded
+		void on_tree_expanding(LPNMHDR nm) {
+			auto tv = reinterpret_cast<LPNMTREEVIEW>(nm);
+			if (!(tv->action & TVE_EXPAND) || m_tree_items.size() != m_tree.size())
+				return;
+
+			if (m_tree_nodes.empty()) {
+				m_tree_nodes.reserve(m_tree_count);
+				for (size_t node = 1; node < m_tree_items.size(); ++node) {
+					if (m_tree_items[node])
+						m_tree_nodes.emplace(m_tree_items[node], static_cast<tree_snapshot::node_id>(node));
+				}
+			}
+
+			auto it = m_tree_nodes.find(tv->itemNew.hItem);
+			if (it == m_tree_nodes.end() || m_tree_realized[it->second])
+				return;
+
+			tree_snapshot::node_id node = it->second;
+			redraw_lock lock(*this);
+			for (auto child = m_tree.first_child(node); child != tree_snapshot::npos; child = m_tree.next_sibling(child)) {
+				m_tree_items[child] = insert_tree_node(m_tree, child, m_tree_items[node], TVI_LAST);
+				if (m_tree_items[child]) {
+					m_tree_nodes.emplace(m_tree_items[child], child);
+					m_tree_count++;
+				}
+			}
+			m_tree_realized[node] = true;
+		}
+
+		tree_snapshot m_tree;                       // what the last reconcile showed
+		std::vector<HTREEITEM> m_tree_items;        // item per snapshot node, NULL while its parent is unexpanded
+		std::vector<bool> m_tree_realized;          // whether the node's children have been inserted
+		std::unordered_map<HTREEITEM, tree_snapshot::node_id> m_tree_nodes; // built on first expand after a reconcile
+		UINT m_tree_count = 0;
+		bool m_tree_hooked = false;
+
+		struct lazy_load {
+			HTREEITEM placeholder = NULL;
+			HTREEITEM last = TVI_FIRST;             // children go after this, ahead of the placeholder
+			size_t count = 0;
+		};
+
+		static std::uint64_t lazy_key(HTREEITEM hItem) {
+			return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(hItem));
+		}
+
+		void start_lazy_load(HTREEITEM hItem) {
+			if (!m_lazy || is_item_loading(hItem))
+				return;
+
+			lazy_load& load = m_lazy_loads[hItem];
+			load.placeholder = insert_item(TVIF_TEXT | TVIF_CHILDREN, m_lazy_placeholder.c_str(), 0, 0, 0, 0, 0, hItem, TVI_LAST);
+			m_lazy->load(lazy_key(hItem), static_cast<std::uint64_t>(get_item_data(hItem)));
+		}
+
+		// Stop a load in progress and remove what it inserted; the item stays lazy
+		void cancel_lazy_load(HTREEITEM hItem) {
+			auto it = m_lazy_loads.find(hItem);
+			if (it == m_lazy_loads.end())
+				return;
+			m_lazy_loads.erase(it);
+			if (m_lazy)
+				m_lazy->cancel(lazy_key(hItem));
+			delete_children(hItem);
+		}
+
+		void cancel_lazy_loads() {
+			std::vector<HTREEITEM> loading;
+			for (auto& [hItem, load] : m_lazy_loads)
+				loading.push_back(hItem);
+			for (HTREEITEM hItem : loading)
+				cancel_lazy_load(hItem);
+		}
+
+		void on_lazy_display_info(LPNMHDR nm) {
+			TVITEM& item = reinterpret_cast<LPNMTVDISPINFO>(nm)->item;
+			if ((item.mask & TVIF_CHILDREN) && m_lazy_unloaded.find(item.hItem) != m_lazy_unloaded.end())
+				item.cChildren = 1;
+		}
+
+		void on_lazy_expanding(LPNMHDR nm) {
+			auto tv = reinterpret_cast<LPNMTREEVIEW>(nm);
+			HTREEITEM hItem = tv->itemNew.hItem;
+			if ((tv->action & TVE_ACTIONMASK) == TVE_EXPAND && m_lazy_unloaded.find(hItem) != m_lazy_unloaded.end())
+				start_lazy_load(hItem);
+		}
+
+		void on_lazy_expanded(LPNMHDR nm) {
+			auto tv = reinterpret_cast<LPNMTREEVIEW>(nm);
+			if ((tv->action & TVE_ACTIONMASK) == TVE_COLLAPSE)
+				cancel_lazy_load(tv->itemNew.hItem);
+		}
+
+		void on_lazy_delete(LPNMHDR nm) {
+			HTREEITEM hItem = reinterpret_cast<LPNMTREEVIEW>(nm)->itemOld.hItem;
+			m_lazy_unloaded.erase(hItem);
+			auto it = m_lazy_loads.find(hItem);
+			if (it != m_lazy_loads.end()) {
+				m_lazy_loads.erase(it); // its children, placeholder included, are being deleted with it
+				if (m_lazy)
+					m_lazy->cancel(lazy_key(hItem));
+			}
+			for (auto& [hParent, load] : m_lazy_loads) {
+				if (load.placeholder == hItem)
+					load.placeholder = NULL;
+				if (load.last == hItem)
+					load.last = get_prev_sibling_item(hItem) ? get_prev_sibling_item(hItem) : TVI_FIRST;
+			}
+		}
+
+		std::shared_ptr<lazy_loader> m_lazy;
+		tstring m_lazy_placeholder;
+		std::unordered_set<HTREEITEM> m_lazy_unloaded;                 // lazy items whose children were never listed
+		std::unordered_map<HTREEITEM, lazy_load> m_lazy_loads;         // items loading, with what was inserted so far
+		bool m_lazy_hooked = false;
+
+		std::unique_ptr<tree_index> m_index;
+		bool m_index_hooked = false;
 	};
 }
 
@@ -0,0 +1,16 @@
+#ifndef WPP_GRAPHICS_HPP
+#define WPP_GRAPHICS_HPP
+
+// Painting helpers
+#include "graphics/surface_pool.hpp"
+#include "graphics/buffered_paint.hpp"
+#include "graphics/resource_cache.hpp"
+#include "graphics/text_extent_cache.hpp"
+#include "graphics/text_metrics.hpp"
+#include "graphics/gdi_cache.hpp"
+
+// Animation
+#include "graphics/animation_clock.hpp"
+#include "graphics/frame_clock.hpp"
+
+#endif // WPP_GRAPHICS_HPP
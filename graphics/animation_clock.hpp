@@ -0,0 +1,322 @@
+#ifndef WPP_GRAPHICS_ANIMATION_CLOCK_HPP
+#define WPP_GRAPHICS_ANIMATION_CLOCK_HPP
+
+// Interpolation and scheduling for UI animations. Free of Win32 so it can be driven by a virtual clock;
+// frame_clock runs it from a message loop timer.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wpp::graphics
+{
+	/// <summary>
+	/// Maps linear progress in [0, 1] to eased progress.
+	/// </summary>
+	using easing_function = double(*)(double);
+
+	namespace easing
+	{
+		inline double linear(double t) { return t; }
+		inline double ease_in_quad(double t) { return t * t; }
+		inline double ease_out_quad(double t) { return t * (2.0 - t); }
+		inline double ease_in_out_quad(double t) { return t < 0.5 ? 2.0 * t * t : -1.0 + (4.0 - 2.0 * t) * t; }
+		inline double ease_in_cubic(double t) { return t * t * t; }
+		inline double ease_out_cubic(double t) { double u = t - 1.0; return u * u * u + 1.0; }
+		inline double ease_in_out_cubic(double t) {
+			return t < 0.5 ? 4.0 * t * t * t : 1.0 + 4.0 * (t - 1.0) * (t - 1.0) * (t - 1.0);
+		}
+		inline double ease_in_out_sine(double t) { return 0.5 - 0.5 * std::cos(t * 3.14159265358979323846); }
+
+		/// <summary>
+		/// Overshoots slightly before settling, for slide-ins.
+		/// </summary>
+		inline double ease_out_back(double t) {
+			const double c1 = 1.70158, c3 = c1 + 1.0;
+			double u = t - 1.0;
+			return 1.0 + c3 * u * u * u + c1 * u * u;
+		}
+	}
+
+	/// <summary>
+	/// Describes one animated value. Times are in the clock's units (microseconds for frame_clock).
+	/// </summary>
+	struct animation_spec {
+		double from = 0.0;
+		double to = 1.0;
+		std::uint64_t duration = 250000;
+		std::uint64_t delay = 0;
+		easing_function easing = easing::ease_in_out_cubic;
+		int repeat = 0;               ///< Extra iterations after the first; -1 repeats until cancelled.
+		bool alternate = false;       ///< Reverse direction on every other iteration (pulses).
+		const void* owner = nullptr;  ///< Groups animations so they can be cancelled together, e.g. a window.
+		std::function<void(double value)> apply;  ///< Receives the interpolated value every frame.
+		std::function<void()> completed;           ///< Runs once after the final value was applied.
+	};
+
+	/// <summary>
+	/// Advances every running animation on one shared tick. Values are applied first, then the commits deferred
+	/// by the apply callbacks run once per key, so animations touching the same window cost one layout per frame.
+	/// Callbacks may start, cancel and defer freely. Not thread-safe; use it from the thread that ticks it.
+	/// </summary>
+	class animation_clock {
+	public:
+		using time_point = std::uint64_t;
+		using animation_id = std::uint64_t;
+
+		struct statistics {
+			std::uint64_t ticks = 0;       ///< Ticks with at least one animation.
+			std::uint64_t updates = 0;     ///< Values applied.
+			std::uint64_t commits = 0;     ///< Deferred commits run (after per-key coalescing).
+			std::uint64_t coalesced = 0;   ///< Deferred commits merged into one already queued this frame.
+			std::uint64_t completed = 0;   ///< Animations that ran to the end.
+			std::uint64_t cancelled = 0;
+		};
+
+		animation_clock() = default;
+
+		// Non-copyable
+		animation_clock(const animation_clock&) = delete;
+		animation_clock& operator=(const animation_clock&) = delete;
+
+		/// <summary>
+		/// Starts an animation at the given time; the first value is applied on the next tick.
+		/// </summary>
+		/// <returns>An id for cancel / is_running; never 0.</returns>
+		animation_id start(animation_spec spec, time_point now) {
+			entry e;
+			e.id = ++m_next_id;
+			e.start = now + spec.delay;
+			e.spec = std::move(spec);
+			if (e.spec.duration == 0)
+				e.spec.duration = 1;
+
+			// Entries must not move while a tick runs their callbacks; starts from callbacks wait in m_started
+			if (m_ticking) {
+				m_index.emplace(e.id, m_entries.size() + m_started.size());
+				m_started.push_back(std::move(e));
+			} else {
+				m_index.emplace(e.id, m_entries.size());
+				m_entries.push_back(std::move(e));
+			}
+			return m_next_id;
+		}
+
+		/// <summary>
+		/// Stops an animation.
+		/// </summary>
+		/// <param name="jump_to_end">Apply the final value before stopping.</param>
+		/// <returns>True if it was running.</returns>
+		bool cancel(animation_id id, bool jump_to_end = false) {
+			auto it = m_index.find(id);
+			if (it == m_index.end())
+				return false;
+
+			std::size_t i = it->second;
+			if (jump_to_end) {
+				auto apply = at(i).spec.apply;
+				if (apply)
+					apply(final_value(at(i).spec));
+			}
+			kill(i, true);
+
+			// Dead entries are skipped by ticks and removed by the next one; compacting on every cancel would make
+			// cancelling many animations quadratic, so only do it here once they dominate the storage
+			if (!m_ticking && m_dead * 2 > m_entries.size())
+				compact();
+			return true;
+		}
+
+		/// <summary>
+		/// Stops every animation of an owner without applying final values, e.g. when its window is destroyed.
+		/// Commits the owner deferred this frame are dropped as well.
+		/// </summary>
+		/// <returns>The number of animations stopped.</returns>
+		std::size_t cancel_owner(const void* owner) {
+			std::size_t count = 0;
+			for (std::size_t i = 0; i < m_entries.size() + m_started.size(); ++i) {
+				if (!at(i).dead && at(i).spec.owner == owner) {
+					kill(i, true);
+					count++;
+				}
+			}
+
+			if (!m_ticking)
+				compact();
+
+			for (auto* commits : { &m_commits, &m_running_commits }) {
+				for (auto& commit : *commits) {
+					if (commit.first == owner)
+						commit.second = nullptr;
+				}
+			}
+			return count;
+		}
+
+		bool is_running(animation_id id) const { return m_index.find(id) != m_index.end(); }
+
+		/// <summary>
+		/// Queues work to run once after all values of the current frame have been applied. Work deferred under the
+		/// same key in one frame runs once (the last queued callback wins). Outside a tick it runs on the next tick.
+		/// </summary>
+		void defer(const void* key, std::function<void()> commit) {
+			for (auto& queued : m_commits) {
+				if (queued.first == key) {
+					queued.second = std::move(commit);
+					m_statistics.coalesced++;
+					return;
+				}
+			}
+			m_commits.emplace_back(key, std::move(commit));
+		}
+
+		/// <summary>
+		/// Applies every animation's value for the given time, then runs the deferred commits.
+		/// </summary>
+		/// <returns>True while animations or commits remain, i.e. the clock must keep ticking.</returns>
+		bool tick(time_point now) {
+			if (m_index.empty() && m_commits.empty())
+				return false;
+
+			m_statistics.ticks++;
+			m_ticking = true;
+
+			// Animations started by callbacks during this tick begin on the next one
+			std::size_t count = m_entries.size();
+			for (std::size_t i = 0; i < count; ++i) {
+				if (m_entries[i].dead || now < m_entries[i].start)
+					continue;
+				advance(i, now);
+			}
+
+			m_ticking = false;
+			for (auto& started : m_started)
+				m_entries.push_back(std::move(started));
+			m_started.clear();
+			compact();
+			run_commits();
+			return active();
+		}
+
+		/// <summary>
+		/// True while anything is animating or waiting to commit.
+		/// </summary>
+		bool active() const { return !m_index.empty() || !m_commits.empty(); }
+
+		std::size_t size() const { return m_index.size(); }
+
+		const statistics& get_statistics() const { return m_statistics; }
+		void reset_statistics() { m_statistics = {}; }
+
+	private:
+		struct entry {
+			animation_id id = 0;
+			time_point start = 0;
+			animation_spec spec;
+			bool dead = false;
+		};
+
+		static double final_value(const animation_spec& spec) {
+			// An alternating animation with an odd number of iterations ends where it started
+			bool reversed = spec.alternate && spec.repeat > 0 && (spec.repeat % 2) == 1;
+			return reversed ? spec.from : spec.to;
+		}
+
+		entry& at(std::size_t i) { return i < m_entries.size() ? m_entries[i] : m_started[i - m_entries.size()]; }
+
+		void advance(std::size_t i, time_point now) {
+			// m_entries does not reallocate during a tick, so the reference stays valid across callbacks
+			animation_spec& spec = m_entries[i].spec;
+			std::uint64_t elapsed = now - m_entries[i].start;
+			std::uint64_t iteration = elapsed / spec.duration;
+			bool finished = spec.repeat >= 0 && iteration > static_cast<std::uint64_t>(spec.repeat);
+
+			double progress;
+			if (finished) {
+				iteration = static_cast<std::uint64_t>(spec.repeat);
+				progress = 1.0;
+			} else {
+				progress = static_cast<double>(elapsed % spec.duration) / static_cast<double>(spec.duration);
+			}
+
+			if (spec.alternate && (iteration & 1))
+				progress = 1.0 - progress;
+
+			double eased = spec.easing ? spec.easing(progress) : progress;
+			m_statistics.updates++;
+			if (spec.apply)
+				spec.apply(spec.from + (spec.to - spec.from) * eased);
+
+			// apply may have cancelled this animation
+			if (!finished || m_entries[i].dead)
+				return;
+
+			auto completed = std::move(spec.completed);
+			kill(i, false);
+			m_statistics.completed++;
+			if (completed)
+				completed();
+		}
+
+		void kill(std::size_t i, bool cancelled) {
+			entry& e = at(i);
+			if (e.dead)
+				return;
+
+			e.dead = true;
+			m_index.erase(e.id);
+			m_dead++;
+			if (cancelled)
+				m_statistics.cancelled++;
+		}
+
+		void compact() {
+			if (m_dead == 0)
+				return;
+
+			std::size_t kept = 0;
+			for (std::size_t i = 0; i < m_entries.size(); ++i) {
+				if (m_entries[i].dead)
+					continue;
+				if (kept != i) {
+					m_entries[kept] = std::move(m_entries[i]);
+					m_index[m_entries[kept].id] = kept;
+				}
+				kept++;
+			}
+			m_entries.resize(kept);
+			m_dead = 0;
+		}
+
+		void run_commits() {
+			// Commits may defer again (e.g. start an animation that defers); those run next frame
+			m_running_commits = std::move(m_commits);
+			m_commits.clear();
+			for (std::size_t i = 0; i < m_running_commits.size(); ++i) {
+				auto commit = std::move(m_running_commits[i].second);
+				if (commit) {
+					commit();
+					m_statistics.commits++;
+				}
+			}
+			m_running_commits.clear();
+		}
+
+		std::vector<entry> m_entries;
+		std::vector<entry> m_started; // started during the current tick
+		std::unordered_map<animation_id, std::size_t> m_index;
+		std::vector<std::pair<const void*, std::function<void()>>> m_commits;
+		std::vector<std::pair<const void*, std::function<void()>>> m_running_commits; // being run by the current tick
+		std::size_t m_dead = 0;
+		animation_id m_next_id = 0;
+		bool m_ticking = false;
+		statistics m_statistics;
+	};
+}
+
+#endif // WPP_GRAPHICS_ANIMATION_CLOCK_HPP
@@ -0,0 +1,133 @@
+#ifndef WPP_GRAPHICS_BUFFERED_PAINT_HPP
+#define WPP_GRAPHICS_BUFFERED_PAINT_HPP
+
+#include "..\common.hpp"
+#include "surface_pool.hpp"
+
+namespace wpp::graphics
+{
+	/// <summary>
+	/// Back buffer bitmaps shared by every buffered_paint on the UI thread.
+	/// Bitmaps are screen compatible, so one pooled bitmap serves any window.
+	/// </summary>
+	inline surface_pool<HBITMAP>& back_buffer_pool() {
+		static surface_pool<HBITMAP> pool(
+			[](int width, int height) -> HBITMAP {
+				HDC screen = ::GetDC(nullptr);
+				HBITMAP bitmap = screen ? ::CreateCompatibleBitmap(screen, width, height) : nullptr;
+				if (screen)
+					::ReleaseDC(nullptr, screen);
+				return bitmap;
+			},
+			[](HBITMAP bitmap) { ::DeleteObject(bitmap); });
+		return pool;
+	}
+
+	/// <summary>
+	/// Scoped WM_PAINT handling with an off-screen buffer. Wraps BeginPaint/EndPaint, renders into a pooled
+	/// bitmap covering only the update rectangle and presents it with a single BitBlt when destroyed.
+	/// The buffer DC uses client coordinates and is clipped to the update rectangle, so paint code is the same
+	/// as for the window DC. Falls back to painting directly if no buffer can be created.
+	/// </summary>
+	class buffered_paint {
+	public:
+		/// <summary>
+		/// Begins painting the window. Must be constructed while handling WM_PAINT.
+		/// </summary>
+		/// <param name="hwnd">The window being painted.</param>
+		/// <param name="pool">Pool the back buffer is taken from.</param>
+		explicit buffered_paint(HWND hwnd, surface_pool<HBITMAP>& pool = back_buffer_pool())
+			: m_hwnd(hwnd), m_pool(pool) {
+			m_paint_dc = ::BeginPaint(hwnd, &m_paint);
+			m_dc = m_paint_dc;
+			if (!m_paint_dc || empty())
+				return;
+
+			const RECT& rc = m_paint.rcPaint;
+			m_lease = m_pool.acquire(rc.right - rc.left, rc.bottom - rc.top);
+			if (!m_lease)
+				return;
+
+			HDC buffer_dc = ::CreateCompatibleDC(m_paint_dc);
+			if (!buffer_dc) {
+				m_pool.release(m_lease);
+				m_lease = {};
+				return;
+			}
+
+			m_old_bitmap = ::SelectObject(buffer_dc, m_lease.surface);
+			if (HFONT font = reinterpret_cast<HFONT>(::SendMessage(hwnd, WM_GETFONT, 0, 0)))
+				m_old_font = ::SelectObject(buffer_dc, font);
+
+			// Map the update rectangle's top-left corner to the bitmap origin and keep drawing inside it
+			::SetViewportOrgEx(buffer_dc, -rc.left, -rc.top, nullptr);
+			::IntersectClipRect(buffer_dc, rc.left, rc.top, rc.right, rc.bottom);
+			m_dc = buffer_dc;
+		}
+
+		/// <summary>
+		/// Presents the buffer, returns the bitmap to the pool and ends painting.
+		/// </summary>
+		~buffered_paint() {
+			if (is_buffered()) {
+				const RECT& rc = m_paint.rcPaint;
+				::BitBlt(m_paint_dc, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top, m_dc, rc.left, rc.top, SRCCOPY);
+
+				if (m_old_font)
+					::SelectObject(m_dc, m_old_font);
+				::SelectObject(m_dc, m_old_bitmap);
+				::DeleteDC(m_dc);
+				m_pool.release(m_lease);
+			}
+
+			if (m_paint_dc)
+				::EndPaint(m_hwnd, &m_paint);
+		}
+
+		// Non-copyable, non-movable (bound to one BeginPaint)
+		buffered_paint(const buffered_paint&) = delete;
+		buffered_paint& operator=(const buffered_paint&) = delete;
+
+		/// <summary>
+		/// Gets the DC to paint into, in client coordinates.
+		/// </summary>
+		HDC dc() const { return m_dc; }
+
+		/// <summary>
+		/// Gets the area being repainted, in client coordinates.
+		/// </summary>
+		const RECT& update_rect() const { return m_paint.rcPaint; }
+
+		/// <summary>
+		/// True when there is nothing to paint.
+		/// </summary>
+		bool empty() const { return ::IsRectEmpty(&m_paint.rcPaint) != FALSE; }
+
+		/// <summary>
+		/// True when painting goes to a back buffer rather than directly to the window.
+		/// </summary>
+		bool is_buffered() const { return m_dc && m_dc != m_paint_dc; }
+
+		/// <summary>
+		/// Fills the update rectangle. The buffer holds stale pixels from earlier frames, so paint code
+		/// that does not cover the whole area should start with this.
+		/// </summary>
+		/// <param name="brush">The background brush.</param>
+		void fill(HBRUSH brush) {
+			if (m_dc && brush)
+				::FillRect(m_dc, &m_paint.rcPaint, brush);
+		}
+
+	private:
+		HWND m_hwnd;
+		surface_pool<HBITMAP>& m_pool;
+		PAINTSTRUCT m_paint{};
+		HDC m_paint_dc = nullptr;
+		HDC m_dc = nullptr;
+		surface_pool<HBITMAP>::lease m_lease;
+		HGDIOBJ m_old_bitmap = nullptr;
+		HGDIOBJ m_old_font = nullptr;
+	};
+}
+
+#endif // WPP_GRAPHICS_BUFFERED_PAINT_HPP
@@ -0,0 +1,120 @@
+#ifndef WPP_GRAPHICS_FRAME_CLOCK_HPP
+#define WPP_GRAPHICS_FRAME_CLOCK_HPP
+
+#include "..\common.hpp"
+#include "animation_clock.hpp"
+
+#include <chrono>
+
+namespace wpp::graphics
+{
+	/// <summary>
+	/// Drives the animations of one message loop thread from a single thread timer. The timer runs only while
+	/// something is animating and is killed as soon as the clock goes idle. All values of a frame are applied
+	/// before the deferred commits run, so several animations on one window cost one layout per frame.
+	/// Durations and delays in animation_spec are in microseconds.
+	/// </summary>
+	class frame_clock {
+	public:
+		using animation_id = animation_clock::animation_id;
+
+		/// <summary>
+		/// Gets the clock of the calling thread's message loop.
+		/// </summary>
+		static frame_clock& current() {
+			thread_local frame_clock instance;
+			return instance;
+		}
+
+		~frame_clock() { stop_timer(); }
+
+		// Non-copyable
+		frame_clock(const frame_clock&) = delete;
+		frame_clock& operator=(const frame_clock&) = delete;
+
+		/// <summary>
+		/// Starts an animation now; its first value is applied on the next frame.
+		/// </summary>
+		animation_id animate(animation_spec spec) {
+			auto id = m_clock.start(std::move(spec), now());
+			start_timer();
+			return id;
+		}
+
+		/// <summary>
+		/// Starts an animation of a value from one point to another over duration_ms milliseconds.
+		/// </summary>
+		animation_id animate(double from, double to, UINT duration_ms, std::function<void(double)> apply,
+							 easing_function curve = easing::ease_in_out_cubic, const void* owner = nullptr) {
+			animation_spec spec;
+			spec.from = from;
+			spec.to = to;
+			spec.duration = static_cast<std::uint64_t>(duration_ms) * 1000;
+			spec.easing = curve;
+			spec.owner = owner;
+			spec.apply = std::move(apply);
+			return animate(std::move(spec));
+		}
+
+		bool cancel(animation_id id, bool jump_to_end = false) { return m_clock.cancel(id, jump_to_end); }
+		std::size_t cancel_owner(const void* owner) { return m_clock.cancel_owner(owner); }
+		bool is_running(animation_id id) const { return m_clock.is_running(id); }
+
+		/// <summary>
+		/// Queues work (typically a layout) to run once at the end of the current or next frame, coalesced by key.
+		/// </summary>
+		void defer(const void* key, std::function<void()> commit) {
+			m_clock.defer(key, std::move(commit));
+			start_timer();
+		}
+
+		/// <summary>
+		/// Sets the frame period. Takes effect the next time the clock wakes up.
+		/// </summary>
+		void set_frame_interval(UINT interval_ms) { m_interval = (std::max)(interval_ms, static_cast<UINT>(USER_TIMER_MINIMUM)); }
+		UINT get_frame_interval() const { return m_interval; }
+
+		/// <summary>
+		/// True when nothing is animating and no timer is running.
+		/// </summary>
+		bool is_idle() const { return m_timer == 0; }
+
+		const animation_clock::statistics& get_statistics() const { return m_clock.get_statistics(); }
+
+	private:
+		frame_clock() = default;
+
+		static animation_clock::time_point now() {
+			auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+			return static_cast<animation_clock::time_point>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+		}
+
+		// Thread timers are dispatched on the thread that created them, which owns current()
+		static void CALLBACK on_timer(HWND, UINT, UINT_PTR, DWORD) {
+			current().on_frame();
+		}
+
+		void on_frame() {
+			if (!m_clock.tick(now()))
+				stop_timer();
+		}
+
+		void start_timer() {
+			if (!m_timer)
+				m_timer = ::SetTimer(nullptr, 0, m_interval, on_timer);
+		}
+
+		void stop_timer() {
+			if (m_timer) {
+				::KillTimer(nullptr, m_timer);
+				m_timer = 0;
+			}
+		}
+
+		animation_clock m_clock;
+		UINT_PTR m_timer = 0;
+		UINT m_interval = 16;
+	};
+}
+
+#endif // WPP_GRAPHICS_FRAME_CLOCK_HPP
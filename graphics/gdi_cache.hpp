@@ -0,0 +1,196 @@
+#ifndef WPP_GRAPHICS_GDI_CACHE_HPP
+#define WPP_GRAPHICS_GDI_CACHE_HPP
+
+#include "..\common.hpp"
+#include "resource_cache.hpp"
+#include "text_metrics.hpp"
+
+namespace wpp::graphics
+{
+	using font_key = basic_font_key<TCHAR>;
+	using shared_font = resource_cache<font_key, HFONT>::handle;
+	using shared_pen = resource_cache<pen_key, HPEN>::handle;
+	using shared_brush = resource_cache<brush_key, HBRUSH>::handle;
+
+	/// <summary>
+	/// Process-wide cache of fonts, pens and brushes. Equal descriptions share one GDI object across all windows
+	/// and threads; objects are reference counted through the returned handles and a bounded number of unused ones
+	/// is kept for reuse before being deleted, least recently used first.
+	/// Keep the handle for as long as the object is selected into a DC or assigned to a control.
+	/// </summary>
+	class gdi_cache {
+	public:
+		struct statistics {
+			resource_cache<font_key, HFONT>::statistics fonts;
+			resource_cache<pen_key, HPEN>::statistics pens;
+			resource_cache<brush_key, HBRUSH>::statistics brushes;
+
+			/// <summary>
+			/// GDI objects currently alive because of the cache.
+			/// </summary>
+			std::size_t live_handles() const { return fonts.live + pens.live + brushes.live; }
+		};
+
+		/// <summary>
+		/// Gets the shared instance.
+		/// </summary>
+		static gdi_cache& shared() {
+			static gdi_cache instance;
+			return instance;
+		}
+
+		/// <summary>
+		/// Gets a font. The key's height and width are scaled from key.units_dpi to key.dpi.
+		/// </summary>
+		shared_font font(const font_key& key) { return m_fonts.acquire(key); }
+
+		/// <summary>
+		/// Gets a font by face, height at 96 DPI and weight, scaled to the given DPI.
+		/// </summary>
+		shared_font font(const tstring& face, int height, UINT dpi = USER_DEFAULT_SCREEN_DPI, int weight = FW_NORMAL,
+						 bool italic = false) {
+			font_key key;
+			key.face = face;
+			key.height = height;
+			key.weight = weight;
+			key.italic = italic;
+			key.dpi = dpi;
+			return m_fonts.acquire(key);
+		}
+
+		/// <summary>
+		/// Gets a font with every attribute of a LOGFONT, created for the given DPI. The LOGFONT's height and width
+		/// are in pixels at logical_dpi: 96 for a design-size LOGFONT, or the window's DPI for one read back from a
+		/// control's font with GetObject, which is then recreated at exactly its size.
+		/// </summary>
+		shared_font font(const LOGFONT& logical, UINT dpi = USER_DEFAULT_SCREEN_DPI, UINT logical_dpi = USER_DEFAULT_SCREEN_DPI) {
+			font_key key;
+			key.face = logical.lfFaceName;
+			key.height = logical.lfHeight;
+			key.width = logical.lfWidth;
+			key.escapement = logical.lfEscapement;
+			key.orientation = logical.lfOrientation;
+			key.weight = logical.lfWeight;
+			key.italic = logical.lfItalic != FALSE;
+			key.underline = logical.lfUnderline != FALSE;
+			key.strike_out = logical.lfStrikeOut != FALSE;
+			key.charset = logical.lfCharSet;
+			key.out_precision = logical.lfOutPrecision;
+			key.clip_precision = logical.lfClipPrecision;
+			key.quality = logical.lfQuality;
+			key.pitch_and_family = logical.lfPitchAndFamily;
+			key.dpi = dpi;
+			key.units_dpi = logical_dpi ? logical_dpi : USER_DEFAULT_SCREEN_DPI;
+
+			// Sizes that are whole pixels at 96 DPI are keyed there, so they share fonts made from design sizes
+			long long scale = USER_DEFAULT_SCREEN_DPI;
+			if (key.units_dpi != USER_DEFAULT_SCREEN_DPI && key.height * scale % key.units_dpi == 0 && key.width * scale % key.units_dpi == 0) {
+				key.height = static_cast<int>(key.height * scale / key.units_dpi);
+				key.width = static_cast<int>(key.width * scale / key.units_dpi);
+				key.units_dpi = USER_DEFAULT_SCREEN_DPI;
+			}
+			return m_fonts.acquire(key);
+		}
+
+		/// <summary>
+		/// Gets a pen.
+		/// </summary>
+		shared_pen pen(COLORREF color, int width = 1, int style = PS_SOLID) {
+			return m_pens.acquire({ style, width, static_cast<std::uint32_t>(color) });
+		}
+
+		/// <summary>
+		/// Gets a solid brush, e.g. for WM_CTLCOLOR* handlers.
+		/// </summary>
+		shared_brush brush(COLORREF color) {
+			return m_brushes.acquire({ static_cast<std::uint32_t>(color), -1 });
+		}
+
+		/// <summary>
+		/// Gets a hatched brush.
+		/// </summary>
+		/// <param name="hatch">One of the HS_* styles.</param>
+		shared_brush hatch_brush(COLORREF color, int hatch) {
+			return m_brushes.acquire({ static_cast<std::uint32_t>(color), hatch });
+		}
+
+		/// <summary>
+		/// Sets how many unused objects of each kind are kept before the least recently used are deleted.
+		/// </summary>
+		void set_max_idle(std::size_t max_idle) {
+			m_fonts.set_max_idle(max_idle);
+			m_pens.set_max_idle(max_idle);
+			m_brushes.set_max_idle(max_idle);
+		}
+
+		/// <summary>
+		/// Deletes every object that has no handles left.
+		/// </summary>
+		void purge() {
+			m_fonts.purge();
+			m_pens.purge();
+			m_brushes.purge();
+		}
+
+		statistics get_statistics() const {
+			return { m_fonts.get_statistics(), m_pens.get_statistics(), m_brushes.get_statistics() };
+		}
+
+	private:
+		gdi_cache()
+			: m_fonts(create_font, release_font)
+			, m_pens([](const pen_key& key) { return ::CreatePen(key.style, key.width, static_cast<COLORREF>(key.color)); },
+					 [](HPEN pen) { ::DeleteObject(pen); })
+			, m_brushes(create_brush, [](HBRUSH brush) { ::DeleteObject(brush); }) {
+		}
+
+		static HFONT create_font(const font_key& key) {
+			LOGFONT logical{};
+			logical.lfHeight = ::MulDiv(key.height, static_cast<int>(key.dpi), static_cast<int>(key.units_dpi));
+			logical.lfWidth = ::MulDiv(key.width, static_cast<int>(key.dpi), static_cast<int>(key.units_dpi));
+			logical.lfEscapement = key.escapement;
+			logical.lfOrientation = key.orientation;
+			logical.lfWeight = key.weight;
+			logical.lfItalic = key.italic;
+			logical.lfUnderline = key.underline;
+			logical.lfStrikeOut = key.strike_out;
+			logical.lfCharSet = key.charset;
+			logical.lfOutPrecision = key.out_precision;
+			logical.lfClipPrecision = key.clip_precision;
+			logical.lfQuality = key.quality;
+			logical.lfPitchAndFamily = key.pitch_and_family;
+			_tcsncpy_s(logical.lfFaceName, key.face.c_str(), _TRUNCATE);
+			return ::CreateFontIndirect(&logical);
+		}
+
+		static void release_font(HFONT font) {
+			// Cached extents must not outlive the handle value
+			text_metrics::shared().forget_font(font);
+			::DeleteObject(font);
+		}
+
+		static HBRUSH create_brush(const brush_key& key) {
+			COLORREF color = static_cast<COLORREF>(key.color);
+			return key.hatch < 0 ? ::CreateSolidBrush(color) : ::CreateHatchBrush(key.hatch, color);
+		}
+
+		// Constructed first so the metrics service outlives the fonts released at exit
+		text_metrics& m_text_metrics = text_metrics::shared();
+		resource_cache<font_key, HFONT> m_fonts;
+		resource_cache<pen_key, HPEN> m_pens;
+		resource_cache<brush_key, HBRUSH> m_brushes;
+	};
+
+	/// <summary>
+	/// The default UI font (Segoe UI, 9pt) at the given DPI.
+	/// </summary>
+	inline font_key default_font_key(UINT dpi = USER_DEFAULT_SCREEN_DPI) {
+		font_key key;
+		key.face = TEXT("Segoe UI");
+		key.height = -12;
+		key.dpi = dpi;
+		return key;
+	}
+}
+
+#endif // WPP_GRAPHICS_GDI_CACHE_HPP
@@ -0,0 +1,309 @@
+#ifndef WPP_GRAPHICS_RESOURCE_CACHE_HPP
+#define WPP_GRAPHICS_RESOURCE_CACHE_HPP
+
+// Keying and eviction policy for shared GDI objects. Free of Win32 so it can be exercised on its own;
+// gdi_cache instantiates it with HFONT, HPEN and HBRUSH.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace wpp::graphics
+{
+	inline void hash_combine(std::size_t& seed, std::size_t value) {
+		seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+	}
+
+	/// <summary>
+	/// Logical font description, one field per LOGFONT member. height and width are in pixels at units_dpi
+	/// (96 unless the description was read back from a device font; height negative for character height, as
+	/// in LOGFONT) and are scaled to dpi when the font is created, so every window on the same monitor shares
+	/// one font.
+	/// </summary>
+	template<typename CharT>
+	struct basic_font_key {
+		std::basic_string<CharT> face;
+		int height = -12;
+		int width = 0;
+		int escapement = 0;
+		int orientation = 0;
+		int weight = 400;
+		bool italic = false;
+		bool underline = false;
+		bool strike_out = false;
+		std::uint8_t charset = 1;           // DEFAULT_CHARSET
+		std::uint8_t out_precision = 0;     // OUT_DEFAULT_PRECIS
+		std::uint8_t clip_precision = 0;    // CLIP_DEFAULT_PRECIS
+		std::uint8_t quality = 5;           // CLEARTYPE_QUALITY
+		std::uint8_t pitch_and_family = 0;  // DEFAULT_PITCH | FF_DONTCARE
+		unsigned int dpi = 96;
+		unsigned int units_dpi = 96;
+
+		bool operator==(const basic_font_key& other) const {
+			return height == other.height && width == other.width && escapement == other.escapement
+				&& orientation == other.orientation && weight == other.weight && italic == other.italic
+				&& underline == other.underline && strike_out == other.strike_out && charset == other.charset
+				&& out_precision == other.out_precision && clip_precision == other.clip_precision
+				&& quality == other.quality && pitch_and_family == other.pitch_and_family && dpi == other.dpi
+				&& units_dpi == other.units_dpi && face == other.face;
+		}
+
+		std::size_t hash() const {
+			std::size_t seed = std::hash<std::basic_string<CharT>>{}(face);
+			hash_combine(seed, static_cast<std::size_t>(static_cast<unsigned int>(height)));
+			hash_combine(seed, static_cast<std::size_t>(static_cast<unsigned int>(width)));
+			hash_combine(seed, static_cast<std::size_t>(static_cast<unsigned int>(escapement)));
+			hash_combine(seed, static_cast<std::size_t>(static_cast<unsigned int>(orientation)));
+			hash_combine(seed, static_cast<std::size_t>(weight));
+			hash_combine(seed, (italic ? 1u : 0u) | (underline ? 2u : 0u) | (strike_out ? 4u : 0u));
+			hash_combine(seed, (static_cast<std::size_t>(charset) << 24) | (static_cast<std::size_t>(out_precision) << 16)
+				| (static_cast<std::size_t>(clip_precision) << 8) | quality);
+			hash_combine(seed, pitch_and_family);
+			hash_combine(seed, (static_cast<std::size_t>(dpi) << 16) ^ units_dpi);
+			return seed;
+		}
+	};
+
+	/// <summary>
+	/// Pen attributes. color is a COLORREF value.
+	/// </summary>
+	struct pen_key {
+		int style = 0;              // PS_SOLID
+		int width = 1;
+		std::uint32_t color = 0;
+
+		bool operator==(const pen_key& other) const {
+			return style == other.style && width == other.width && color == other.color;
+		}
+
+		std::size_t hash() const {
+			std::size_t seed = color;
+			hash_combine(seed, static_cast<std::size_t>(style));
+			hash_combine(seed, static_cast<std::size_t>(width));
+			return seed;
+		}
+	};
+
+	/// <summary>
+	/// Brush attributes. A hatch of -1 is a solid brush, otherwise one of the HS_* styles.
+	/// </summary>
+	struct brush_key {
+		std::uint32_t color = 0;
+		int hatch = -1;
+
+		bool operator==(const brush_key& other) const {
+			return color == other.color && hatch == other.hatch;
+		}
+
+		std::size_t hash() const {
+			std::size_t seed = color;
+			hash_combine(seed, static_cast<std::size_t>(hatch + 1));
+			return seed;
+		}
+	};
+
+	/// <summary>
+	/// Hashes any key type that provides a hash() member.
+	/// </summary>
+	struct key_hash {
+		template<typename Key>
+		std::size_t operator()(const Key& key) const { return key.hash(); }
+	};
+
+	/// <summary>
+	/// Thread-safe, reference counted cache of shared resources. Each distinct key maps to one resource,
+	/// created on first use and handed out as shared handles. When the last handle goes away the resource
+	/// stays cached but idle; idle resources beyond max_idle are released least recently used first.
+	/// </summary>
+	/// <typeparam name="Key">Resource description with operator== and a hash() member.</typeparam>
+	/// <typeparam name="Resource">Resource handle type (HFONT, HPEN, HBRUSH).</typeparam>
+	template<typename Key, typename Resource>
+	class resource_cache {
+		struct entry;
+		struct state;
+
+	public:
+		using factory = std::function<Resource(const Key&)>;
+		using releaser = std::function<void(Resource)>;
+
+		struct statistics {
+			std::size_t live = 0;          ///< Resources currently created (in use + idle).
+			std::size_t in_use = 0;        ///< Resources with at least one handle.
+			std::size_t idle = 0;          ///< Cached resources without handles.
+			std::uint64_t hits = 0;        ///< Acquires served from the cache.
+			std::uint64_t misses = 0;      ///< Acquires that created a resource.
+			std::uint64_t evictions = 0;   ///< Idle resources released.
+		};
+
+		/// <summary>
+		/// Shared reference to a cached resource. Copies share the reference; the resource stays valid while any
+		/// handle to it exists.
+		/// </summary>
+		class handle {
+		public:
+			handle() = default;
+			~handle() { reset(); }
+
+			handle(const handle& other) : m_state(other.m_state), m_entry(other.m_entry) {
+				if (m_entry) {
+					std::scoped_lock lock(m_state->mutex);
+					m_entry->refs++;
+				}
+			}
+
+			handle(handle&& other) noexcept
+				: m_state(std::move(other.m_state)), m_entry(std::exchange(other.m_entry, nullptr)) {
+			}
+
+			handle& operator=(handle other) noexcept {
+				std::swap(m_state, other.m_state);
+				std::swap(m_entry, other.m_entry);
+				return *this;
+			}
+
+			Resource get() const { return m_entry ? m_entry->resource : Resource{}; }
+			operator Resource() const { return get(); }
+			explicit operator bool() const { return m_entry != nullptr; }
+
+			void reset() {
+				if (m_entry) {
+					m_state->release(m_entry);
+					m_entry = nullptr;
+				}
+				m_state.reset();
+			}
+
+		private:
+			friend class resource_cache;
+			handle(std::shared_ptr<state> s, entry* e) : m_state(std::move(s)), m_entry(e) {}
+
+			std::shared_ptr<state> m_state;
+			entry* m_entry = nullptr;
+		};
+
+		resource_cache(factory create, releaser release, std::size_t max_idle = 64)
+			: m_state(std::make_shared<state>()) {
+			m_state->create = std::move(create);
+			m_state->release_resource = std::move(release);
+			m_state->max_idle = max_idle;
+		}
+
+		// Non-copyable
+		resource_cache(const resource_cache&) = delete;
+		resource_cache& operator=(const resource_cache&) = delete;
+
+		/// <summary>
+		/// Gets the shared resource for a key, creating it on first use.
+		/// </summary>
+		/// <returns>A handle to the resource; empty if the factory failed.</returns>
+		handle acquire(const Key& key) {
+			std::scoped_lock lock(m_state->mutex);
+			auto& s = *m_state;
+
+			auto it = s.entries.find(key);
+			if (it != s.entries.end()) {
+				entry& e = it->second;
+				if (e.refs++ == 0)
+					s.idle.erase(e.idle_position);
+				s.stats.hits++;
+				return handle(m_state, &e);
+			}
+
+			Resource resource = s.create ? s.create(key) : Resource{};
+			if (!resource)
+				return {};
+
+			auto inserted = s.entries.emplace(key, entry{}).first;
+			entry& e = inserted->second;
+			e.key = &inserted->first;
+			e.resource = resource;
+			e.refs = 1;
+			s.stats.misses++;
+			return handle(m_state, &e);
+		}
+
+		/// <summary>
+		/// Changes how many idle resources are kept, releasing the oldest beyond the new limit.
+		/// </summary>
+		void set_max_idle(std::size_t max_idle) {
+			std::scoped_lock lock(m_state->mutex);
+			m_state->max_idle = max_idle;
+			m_state->trim();
+		}
+
+		/// <summary>
+		/// Releases every idle resource. Resources with handles are unaffected.
+		/// </summary>
+		void purge() {
+			std::scoped_lock lock(m_state->mutex);
+			auto limit = std::exchange(m_state->max_idle, 0);
+			m_state->trim();
+			m_state->max_idle = limit;
+		}
+
+		statistics get_statistics() const {
+			std::scoped_lock lock(m_state->mutex);
+			auto stats = m_state->stats;
+			stats.live = m_state->entries.size();
+			stats.idle = m_state->idle.size();
+			stats.in_use = stats.live - stats.idle;
+			return stats;
+		}
+
+	private:
+		struct entry {
+			const Key* key = nullptr;
+			Resource resource{};
+			std::size_t refs = 0;
+			typename std::list<entry*>::iterator idle_position;
+		};
+
+		// Shared with the handles so a handle can outlive the cache object
+		struct state {
+			std::mutex mutex;
+			factory create;
+			releaser release_resource;
+			std::size_t max_idle = 64;
+			std::unordered_map<Key, entry, key_hash> entries;
+			std::list<entry*> idle; // most recently released at the front
+			statistics stats;
+
+			~state() {
+				if (release_resource) {
+					for (auto& [key, e] : entries)
+						release_resource(e.resource);
+				}
+			}
+
+			void release(entry* e) {
+				std::scoped_lock lock(mutex);
+				if (--e->refs == 0) {
+					idle.push_front(e);
+					e->idle_position = idle.begin();
+					trim();
+				}
+			}
+
+			void trim() {
+				while (idle.size() > max_idle) {
+					entry* oldest = idle.back();
+					idle.pop_back();
+					if (release_resource)
+						release_resource(oldest->resource);
+					stats.evictions++;
+					entries.erase(Key(*oldest->key));
+				}
+			}
+		};
+
+		std::shared_ptr<state> m_state;
+	};
+}
+
+#endif // WPP_GRAPHICS_RESOURCE_CACHE_HPP
@@ -0,0 +1,205 @@
+#ifndef WPP_GRAPHICS_SURFACE_POOL_HPP
+#define WPP_GRAPHICS_SURFACE_POOL_HPP
+
+// Free of Win32 so the pooling policy can be exercised on its own; buffered_paint instantiates it with HBITMAP.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace wpp::graphics
+{
+	/// <summary>
+	/// Pool of off-screen surfaces (back buffers) shared across frames and windows.
+	/// Requests are rounded up to size buckets so a window that resizes a few pixels at a time keeps reusing
+	/// the same surface; a free surface is reused when it is large enough and not wastefully larger.
+	/// Free surfaces are released least recently used first once they exceed the byte budget or sit idle too long.
+	/// Not thread-safe; painting happens on the UI thread.
+	/// </summary>
+	/// <typeparam name="Surface">Handle type of a surface (HBITMAP on Windows).</typeparam>
+	template<typename Surface>
+	class surface_pool {
+	public:
+		using factory = std::function<Surface(int width, int height)>;
+		using releaser = std::function<void(Surface)>;
+
+		struct options {
+			int granularity = 64;                     ///< Bucket step in pixels for both dimensions.
+			int max_waste_ratio = 4;                  ///< A free surface is reused only up to this many times the bucket area.
+			std::size_t max_free_bytes = 32u << 20;   ///< Budget for surfaces sitting in the pool unused.
+			std::uint64_t max_idle_acquires = 256;    ///< Free surfaces unused for this many acquires are released.
+			int bytes_per_pixel = 4;
+		};
+
+		/// <summary>
+		/// A surface on loan from the pool. width/height are the bucket size, at least the requested size.
+		/// </summary>
+		struct lease {
+			Surface surface{};
+			int width = 0;
+			int height = 0;
+
+			explicit operator bool() const { return width > 0 && height > 0; }
+		};
+
+		struct statistics {
+			std::uint64_t hits = 0;        ///< Acquires served from a free surface.
+			std::uint64_t misses = 0;      ///< Acquires that created a surface.
+			std::uint64_t evictions = 0;   ///< Free surfaces released by the budget or idle policy.
+			std::size_t live_bytes = 0;    ///< Bytes of every surface the pool owns, leased or free.
+			std::size_t free_bytes = 0;    ///< Bytes of the surfaces waiting in the pool.
+		};
+
+		surface_pool(factory create, releaser release)
+			: surface_pool(std::move(create), std::move(release), options{}) {
+		}
+
+		surface_pool(factory create, releaser release, options opts)
+			: m_create(std::move(create)), m_release(std::move(release)), m_options(opts) {
+			if (m_options.granularity < 1)
+				m_options.granularity = 1;
+			if (m_options.max_waste_ratio < 1)
+				m_options.max_waste_ratio = 1;
+		}
+
+		~surface_pool() {
+			clear();
+		}
+
+		// Non-copyable
+		surface_pool(const surface_pool&) = delete;
+		surface_pool& operator=(const surface_pool&) = delete;
+
+		/// <summary>
+		/// Takes a surface of at least width x height, reusing a free one when possible.
+		/// </summary>
+		/// <returns>The lease; empty if the size is empty or the factory failed.</returns>
+		lease acquire(int width, int height) {
+			if (width <= 0 || height <= 0)
+				return {};
+
+			++m_tick;
+			int bucket_width = bucket(width);
+			int bucket_height = bucket(height);
+			long long bucket_area = static_cast<long long>(bucket_width) * bucket_height;
+
+			// Best fit: the smallest free surface that is large enough
+			std::size_t best = m_free.size();
+			for (std::size_t i = 0; i < m_free.size(); ++i) {
+				const auto& entry = m_free[i];
+				if (entry.width < bucket_width || entry.height < bucket_height)
+					continue;
+
+				long long area = static_cast<long long>(entry.width) * entry.height;
+				if (area > bucket_area * m_options.max_waste_ratio)
+					continue;
+				if (best == m_free.size() || area < static_cast<long long>(m_free[best].width) * m_free[best].height)
+					best = i;
+			}
+
+			if (best != m_free.size()) {
+				entry_t entry = m_free[best];
+				m_free.erase(m_free.begin() + best);
+				m_statistics.free_bytes -= bytes(entry.width, entry.height);
+				m_statistics.hits++;
+				return { entry.surface, entry.width, entry.height };
+			}
+
+			Surface surface = m_create ? m_create(bucket_width, bucket_height) : Surface{};
+			if (!surface)
+				return {};
+
+			m_statistics.misses++;
+			m_statistics.live_bytes += bytes(bucket_width, bucket_height);
+			return { surface, bucket_width, bucket_height };
+		}
+
+		/// <summary>
+		/// Returns a leased surface to the pool, then applies the budget and idle policy.
+		/// </summary>
+		void release(const lease& leased) {
+			if (!leased)
+				return;
+
+			m_free.push_back({ leased.surface, leased.width, leased.height, m_tick });
+			m_statistics.free_bytes += bytes(leased.width, leased.height);
+			trim();
+		}
+
+		/// <summary>
+		/// Releases free surfaces that are idle too long or exceed the byte budget, oldest first.
+		/// </summary>
+		void trim() {
+			for (std::size_t i = 0; i < m_free.size();) {
+				if (m_tick - m_free[i].last_used > m_options.max_idle_acquires)
+					evict(i);
+				else
+					++i;
+			}
+
+			while (m_statistics.free_bytes > m_options.max_free_bytes && !m_free.empty()) {
+				std::size_t oldest = 0;
+				for (std::size_t i = 1; i < m_free.size(); ++i) {
+					if (m_free[i].last_used < m_free[oldest].last_used)
+						oldest = i;
+				}
+				evict(oldest);
+			}
+		}
+
+		/// <summary>
+		/// Releases every free surface. Leased surfaces stay valid and are pooled again when released.
+		/// </summary>
+		void clear() {
+			while (!m_free.empty())
+				evict(m_free.size() - 1);
+		}
+
+		const statistics& get_statistics() const { return m_statistics; }
+		const options& get_options() const { return m_options; }
+		std::size_t free_count() const { return m_free.size(); }
+
+		/// <summary>
+		/// Size bucket a request of the given length falls in.
+		/// </summary>
+		int bucket(int length) const {
+			int step = m_options.granularity;
+			return ((length + step - 1) / step) * step;
+		}
+
+	private:
+		struct entry_t {
+			Surface surface{};
+			int width = 0;
+			int height = 0;
+			std::uint64_t last_used = 0;
+		};
+
+		std::size_t bytes(int width, int height) const {
+			return static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * m_options.bytes_per_pixel;
+		}
+
+		void evict(std::size_t index) {
+			entry_t entry = m_free[index];
+			m_free.erase(m_free.begin() + index);
+
+			std::size_t size = bytes(entry.width, entry.height);
+			m_statistics.free_bytes -= size;
+			m_statistics.live_bytes -= size;
+			m_statistics.evictions++;
+			if (m_release)
+				m_release(entry.surface);
+		}
+
+		factory m_create;
+		releaser m_release;
+		options m_options;
+		std::vector<entry_t> m_free;
+		statistics m_statistics;
+		std::uint64_t m_tick = 0;
+	};
+}
+
+#endif // WPP_GRAPHICS_SURFACE_POOL_HPP
@@ -0,0 +1,218 @@
+#ifndef WPP_GRAPHICS_TEXT_EXTENT_CACHE_HPP
+#define WPP_GRAPHICS_TEXT_EXTENT_CACHE_HPP
+
+// Caching policy for text measurement. Free of Win32 so it can be exercised with a stub measurer;
+// text_metrics instantiates it with a GDI measurer.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace wpp::graphics
+{
+	struct text_extent {
+		int width = 0;
+		int height = 0;
+
+		bool operator==(const text_extent& other) const { return width == other.width && height == other.height; }
+	};
+
+	/// <summary>
+	/// Bounded LRU cache of single-line text extents keyed by (font, DPI, string). Misses are collected and
+	/// handed to the measurer in one batch, so the caller pays for one font selection per batch, not per string.
+	/// Thread-safe; the measurer is called with the cache lock held.
+	/// </summary>
+	/// <typeparam name="CharT">Character type of the measured strings.</typeparam>
+	template<typename CharT>
+	class basic_text_extent_cache {
+	public:
+		using string_view_type = std::basic_string_view<CharT>;
+		using font_id = std::uintptr_t;
+
+		/// <summary>
+		/// Measures texts[i] into extents[i] for one font and DPI.
+		/// </summary>
+		using measurer = std::function<void(font_id font, unsigned int dpi, const std::vector<string_view_type>& texts,
+											std::vector<text_extent>& extents)>;
+
+		struct statistics {
+			std::uint64_t hits = 0;
+			std::uint64_t misses = 0;
+			std::uint64_t batches = 0;     ///< Measurer calls.
+			std::uint64_t evictions = 0;
+			std::size_t entries = 0;
+		};
+
+		explicit basic_text_extent_cache(measurer measure, std::size_t capacity = 8192)
+			: m_measure(std::move(measure)), m_capacity(capacity < 1 ? 1 : capacity) {
+		}
+
+		// Non-copyable
+		basic_text_extent_cache(const basic_text_extent_cache&) = delete;
+		basic_text_extent_cache& operator=(const basic_text_extent_cache&) = delete;
+
+		text_extent measure(font_id font, unsigned int dpi, string_view_type text) {
+			text_extent extent;
+			measure(font, dpi, &text, &text + 1, &extent);
+			return extent;
+		}
+
+		/// <summary>
+		/// Measures many strings; only the ones not cached reach the measurer, in a single call.
+		/// </summary>
+		void measure(font_id font, unsigned int dpi, const std::vector<string_view_type>& texts, std::vector<text_extent>& extents) {
+			extents.resize(texts.size());
+			measure(font, dpi, texts.data(), texts.data() + texts.size(), extents.data());
+		}
+
+		/// <summary>
+		/// Widest extent of a set of strings (0 if empty).
+		/// </summary>
+		int max_width(font_id font, unsigned int dpi, const std::vector<string_view_type>& texts) {
+			std::vector<text_extent> extents;
+			measure(font, dpi, texts, extents);
+
+			int width = 0;
+			for (const auto& extent : extents)
+				width = extent.width > width ? extent.width : width;
+			return width;
+		}
+
+		/// <summary>
+		/// Drops every entry measured with a font (call before the font handle is deleted or reused).
+		/// </summary>
+		void forget_font(font_id font) {
+			std::scoped_lock lock(m_mutex);
+			for (auto it = m_entries.begin(); it != m_entries.end();) {
+				if (it->font == font) {
+					m_index.erase(key_of(*it));
+					it = m_entries.erase(it);
+				} else {
+					++it;
+				}
+			}
+		}
+
+		void clear() {
+			std::scoped_lock lock(m_mutex);
+			m_index.clear();
+			m_entries.clear();
+		}
+
+		void set_capacity(std::size_t capacity) {
+			std::scoped_lock lock(m_mutex);
+			m_capacity = capacity < 1 ? 1 : capacity;
+			trim();
+		}
+
+		statistics get_statistics() const {
+			std::scoped_lock lock(m_mutex);
+			auto stats = m_statistics;
+			stats.entries = m_entries.size();
+			return stats;
+		}
+
+	private:
+		struct entry {
+			font_id font;
+			unsigned int dpi;
+			std::size_t hash;
+			std::basic_string<CharT> text;
+			text_extent extent;
+		};
+
+		// Lookup key; text views the entry's own string (list nodes never move) or the caller's string during lookup
+		struct key {
+			font_id font;
+			unsigned int dpi;
+			std::size_t hash;
+			string_view_type text;
+
+			bool operator==(const key& other) const {
+				return hash == other.hash && font == other.font && dpi == other.dpi && text == other.text;
+			}
+		};
+
+		struct key_hasher {
+			std::size_t operator()(const key& k) const { return k.hash; }
+		};
+
+		static std::size_t hash_of(font_id font, unsigned int dpi, string_view_type text) {
+			std::size_t seed = std::hash<string_view_type>{}(text);
+			seed ^= static_cast<std::size_t>(font) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+			seed ^= static_cast<std::size_t>(dpi) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+
+		static key key_of(const entry& e) { return { e.font, e.dpi, e.hash, e.text }; }
+
+		void measure(font_id font, unsigned int dpi, const string_view_type* first, const string_view_type* last, text_extent* out) {
+			std::scoped_lock lock(m_mutex);
+
+			m_pending.clear();
+			m_pending_slots.clear();
+			for (const string_view_type* text = first; text != last; ++text) {
+				std::size_t slot = static_cast<std::size_t>(text - first);
+				auto it = m_index.find({ font, dpi, hash_of(font, dpi, *text), *text });
+				if (it != m_index.end()) {
+					m_entries.splice(m_entries.begin(), m_entries, it->second);
+					out[slot] = it->second->extent;
+					m_statistics.hits++;
+				} else {
+					m_pending.push_back(*text);
+					m_pending_slots.push_back(slot);
+				}
+			}
+
+			if (m_pending.empty())
+				return;
+
+			m_measured.assign(m_pending.size(), text_extent{});
+			if (m_measure)
+				m_measure(font, dpi, m_pending, m_measured);
+			m_statistics.batches++;
+
+			for (std::size_t i = 0; i < m_pending.size(); ++i) {
+				out[m_pending_slots[i]] = m_measured[i];
+				m_statistics.misses++;
+
+				// The same string may appear twice in one batch
+				key lookup{ font, dpi, hash_of(font, dpi, m_pending[i]), m_pending[i] };
+				if (m_index.find(lookup) != m_index.end())
+					continue;
+
+				m_entries.push_front({ font, dpi, lookup.hash, std::basic_string<CharT>(m_pending[i]), m_measured[i] });
+				m_index.emplace(key_of(m_entries.front()), m_entries.begin());
+			}
+			trim();
+		}
+
+		void trim() {
+			while (m_entries.size() > m_capacity) {
+				m_index.erase(key_of(m_entries.back()));
+				m_entries.pop_back();
+				m_statistics.evictions++;
+			}
+		}
+
+		measurer m_measure;
+		std::size_t m_capacity;
+		mutable std::mutex m_mutex;
+		std::list<entry> m_entries; // most recently used at the front
+		std::unordered_map<key, typename std::list<entry>::iterator, key_hasher> m_index;
+		statistics m_statistics;
+
+		// Scratch buffers reused across batches
+		std::vector<string_view_type> m_pending;
+		std::vector<std::size_t> m_pending_slots;
+		std::vector<text_extent> m_measured;
+	};
+}
+
+#endif // WPP_GRAPHICS_TEXT_EXTENT_CACHE_HPP
@@ -0,0 +1,104 @@
+#ifndef WPP_GRAPHICS_TEXT_METRICS_HPP
+#define WPP_GRAPHICS_TEXT_METRICS_HPP
+
+#include "..\common.hpp"
+#include "text_extent_cache.hpp"
+
+namespace wpp::graphics
+{
+	/// <summary>
+	/// Process-wide text measurement service. Single-line extents are cached per (font, DPI, string) in a bounded
+	/// LRU, and every batch of misses is measured with one font selection into a memory DC.
+	/// Fonts from gdi_cache are forgotten automatically when deleted; call forget_font before deleting a font
+	/// of your own that was measured.
+	/// </summary>
+	class text_metrics {
+	public:
+		/// <summary>
+		/// Gets the shared instance.
+		/// </summary>
+		static text_metrics& shared() {
+			static text_metrics instance;
+			return instance;
+		}
+
+		/// <summary>
+		/// Measures one string.
+		/// </summary>
+		/// <param name="font">The font, or NULL for the system font.</param>
+		/// <param name="dpi">DPI the font was created for.</param>
+		SIZE measure(HFONT font, UINT dpi, tstring_view text) {
+			auto extent = m_cache.measure(id_of(font), dpi, text);
+			return { extent.width, extent.height };
+		}
+
+		/// <summary>
+		/// Measures many strings with one font; only uncached strings are measured, in one batch.
+		/// </summary>
+		void measure(HFONT font, UINT dpi, const std::vector<tstring_view>& texts, std::vector<SIZE>& sizes) {
+			std::vector<text_extent> extents;
+			m_cache.measure(id_of(font), dpi, texts, extents);
+			sizes.resize(extents.size());
+			for (size_t i = 0; i < extents.size(); ++i)
+				sizes[i] = { extents[i].width, extents[i].height };
+		}
+
+		/// <summary>
+		/// Width of the widest string (0 if there are none).
+		/// </summary>
+		int max_width(HFONT font, UINT dpi, const std::vector<tstring_view>& texts) {
+			return m_cache.max_width(id_of(font), dpi, texts);
+		}
+
+		/// <summary>
+		/// Drops the cached extents of a font before it is deleted.
+		/// </summary>
+		void forget_font(HFONT font) {
+			m_cache.forget_font(id_of(font));
+		}
+
+		void clear() { m_cache.clear(); }
+		void set_capacity(size_t capacity) { m_cache.set_capacity(capacity); }
+		basic_text_extent_cache<TCHAR>::statistics get_statistics() const { return m_cache.get_statistics(); }
+
+	private:
+		text_metrics()
+			: m_cache(measure_batch) {
+		}
+
+		static basic_text_extent_cache<TCHAR>::font_id id_of(HFONT font) {
+			return reinterpret_cast<basic_text_extent_cache<TCHAR>::font_id>(font);
+		}
+
+		static void measure_batch(basic_text_extent_cache<TCHAR>::font_id font, unsigned int dpi,
+								  const std::vector<tstring_view>& texts, std::vector<text_extent>& extents) {
+			HDC screen = ::GetDC(nullptr);
+			HDC dc = screen ? ::CreateCompatibleDC(screen) : nullptr;
+			if (screen)
+				::ReleaseDC(nullptr, screen);
+			if (!dc)
+				return;
+
+			HGDIOBJ old_font = font ? ::SelectObject(dc, reinterpret_cast<HFONT>(font)) : nullptr;
+			for (size_t i = 0; i < texts.size(); ++i) {
+				SIZE size{};
+				if (!texts[i].empty()) {
+					::GetTextExtentPoint32(dc, texts[i].data(), static_cast<int>(texts[i].size()), &size);
+				} else {
+					TEXTMETRIC tm{};
+					::GetTextMetrics(dc, &tm);
+					size.cy = tm.tmHeight;
+				}
+				extents[i] = { size.cx, size.cy };
+			}
+
+			if (old_font)
+				::SelectObject(dc, old_font);
+			::DeleteDC(dc);
+		}
+
+		basic_text_extent_cache<TCHAR> m_cache;
+	};
+}
+
+#endif // WPP_GRAPHICS_TEXT_METRICS_HPP
@@ -2,9 +2,16 @@
 #define WPP_LAYOUT_HPP
 
 // Layout manager components
+#include "layout/layout_types.hpp"
+#include "layout/layout_engine.hpp"
+#include "layout/damage_region.hpp"
+#include "layout/resize_scheduler.hpp"
 #include "layout/panel.hpp"
 #include "layout/stack_panel.hpp"
 #include "layout/dock_panel.hpp"
 #include "layout/grid_panel.hpp"
+#include "layout/canvas_panel.hpp"
+#include "layout/constraint_panel.hpp"
+#include "layout/layout_document.hpp"
 
 #endif // WPP_LAYOUT_HPP
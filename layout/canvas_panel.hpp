@@ -0,0 +1,82 @@
+#ifndef WPP_LAYOUT_CANVAS_PANEL_HPP
+#define WPP_LAYOUT_CANVAS_PANEL_HPP
+
+#include "panel.hpp"
+#include "spatial_index.hpp"
+
+namespace wpp::layout
+{
+    // Canvas panel - places children at explicit coordinates with an explicit z-order.
+    // Child rectangles are kept in a spatial index, so hit-testing and dirty-rect queries stay cheap with thousands of children.
+    // All coordinates are relative to the canvas content origin (inside margin and padding).
+    class canvas_panel : public panel {
+    public:
+        explicit canvas_panel(HWND parent = nullptr, int index_cell_size = 128);
+        virtual ~canvas_panel() = default;
+
+        // Add a control at (0, 0) above all existing children
+        void add(control_ptr<> control) override;
+
+        // Add a control at a specific position and z-index
+        void add(control_ptr<> control, int x, int y);
+        void add(control_ptr<> control, int x, int y, int z_index);
+
+        // Add all controls from a window (used when adding a window to the panel)
+        void add_window_controls(window_base* window) override {
+            if (window != nullptr) {
+                for (const auto& control : window->get_controls())
+                    add(control);
+            }
+        }
+
+        void paint(HDC hdc) override;
+
+        // Position of a child on the canvas. Moving a child updates the index immediately.
+        void set_position(control_ptr<> control, int x, int y);
+        POINT get_position(control_ptr<> control) const;
+
+        // Higher z-index children are drawn above and hit-tested before lower ones
+        void set_z_index(control_ptr<> control, int z_index);
+        int get_z_index(control_ptr<> control) const;
+
+        // Topmost child under a point, or nullptr
+        control_ptr<> hit_test(int x, int y) const;
+        control_ptr<> hit_test(POINT pt) const { return hit_test(pt.x, pt.y); }
+
+        // Children intersecting an area, ordered bottom to top (paint order)
+        std::vector<control_ptr<>> query(const rect_t& area) const;
+        std::vector<control_ptr<>> query(const RECT& area) const {
+            return query(rect_t{ area.left, area.top, area.right - area.left, area.bottom - area.top });
+        }
+
+    protected:
+        void capture_node(layout_snapshot& snapshot, int node) const override;
+        void apply_node(const layout_snapshot& snapshot, int node) override;
+        void child_size_changed(const control_ptr<>& child) override;
+        void child_removed(const control_ptr<>& child) override;
+
+    private:
+        struct canvas_child {
+            control_ptr<> control;
+            int x = 0;
+            int y = 0;
+            int z_index = 0;
+            sizing_t size{ 0, 0 };  // size used for the index (size model, or last arranged size for panels)
+        };
+
+        std::vector<canvas_child> m_items;  // position in this vector is the spatial index id
+        std::unordered_map<control_ptr<>, int> m_item_ids;
+        spatial_grid m_index;
+        int m_next_z_index = 0;
+        bool m_z_order_dirty = false;
+
+        // Scratch buffer for index queries
+        mutable std::vector<int> m_query_ids;
+
+        int find_item(const control_ptr<>& control) const;
+        void reindex(int id);
+        void apply_z_order();
+    };
+}
+
+#endif // WPP_LAYOUT_CANVAS_PANEL_HPP
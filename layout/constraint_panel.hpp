@@ -0,0 +1,65 @@
+#ifndef WPP_LAYOUT_CONSTRAINT_PANEL_HPP
+#define WPP_LAYOUT_CONSTRAINT_PANEL_HPP
+
+#include "panel.hpp"
+#include "constraint_solver.hpp"
+
+namespace wpp::layout
+{
+    // Constraint panel - positions children by linear constraints over their left/top/width/height
+    // (e.g. "these two columns stay equal", "labels share the widest label width").
+    // The solver keeps its tableau between passes; a resize only re-solves the panel's size edit variables.
+    // Each child's size model is added as a medium-strength preference, so user constraints win over it.
+    class constraint_panel : public panel {
+    public:
+        explicit constraint_panel(HWND parent = nullptr);
+        virtual ~constraint_panel() = default;
+
+        // Add a control; it gets its own set of variables
+        void add(control_ptr<> control) override;
+
+        // Add all controls from a window (used when adding a window to the panel)
+        void add_window_controls(window_base* window) override {
+            if (window != nullptr) {
+                for (const auto& control : window->get_controls())
+                    add(control);
+            }
+        }
+
+        void paint(HDC hdc) override;
+
+        // Variables of a child's rectangle, relative to the content origin.
+        // Children that were not added return an unrelated variable.
+        constraints::variable left(const control_ptr<>& control) const { return slot_for(control).left; }
+        constraints::variable top(const control_ptr<>& control) const { return slot_for(control).top; }
+        constraints::variable width(const control_ptr<>& control) const { return slot_for(control).width; }
+        constraints::variable height(const control_ptr<>& control) const { return slot_for(control).height; }
+        constraints::expression right(const control_ptr<>& control) const { return left(control) + width(control); }
+        constraints::expression bottom(const control_ptr<>& control) const { return top(control) + height(control); }
+        constraints::expression center_x(const control_ptr<>& control) const { return left(control) + width(control) * 0.5; }
+        constraints::expression center_y(const control_ptr<>& control) const { return top(control) + height(control) * 0.5; }
+
+        // Content size of the panel, set by layout on every pass
+        constraints::variable content_width() const { return m_system->content_width(); }
+        constraints::variable content_height() const { return m_system->content_height(); }
+
+        // Returns false for duplicates and for required constraints that conflict with existing ones
+        bool add_constraint(const constraints::constraint& constraint);
+        bool remove_constraint(const constraints::constraint& constraint);
+
+        const std::shared_ptr<constraints::constraint_system>& get_constraint_system() const { return m_system; }
+
+    protected:
+        void capture_node(layout_snapshot& snapshot, int node) const override;
+        void child_removed(const control_ptr<>& child) override;
+
+    private:
+        const constraints::constraint_system::slot& slot_for(const control_ptr<>& control) const;
+
+        std::shared_ptr<constraints::constraint_system> m_system;
+        std::unordered_map<control_ptr<>, int> m_slots;
+        constraints::constraint_system::slot m_detached_slot;
+    };
+}
+
+#endif // WPP_LAYOUT_CONSTRAINT_PANEL_HPP
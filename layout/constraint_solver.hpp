@@ -0,0 +1,316 @@
+#ifndef WPP_LAYOUT_CONSTRAINT_SOLVER_HPP
+#define WPP_LAYOUT_CONSTRAINT_SOLVER_HPP
+
+// Incremental linear constraint solver (Cassowary). The tableau is kept between solves, so changing
+// an edit variable (e.g. the panel size) only re-runs the dual simplex on the affected rows.
+// Free of Win32 so it builds with the portable layout engine.
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wpp::layout::constraints
+{
+    // Priorities. Anything below required may be violated when constraints conflict.
+    namespace strength
+    {
+        inline double create(double a, double b, double c, double w = 1.0) {
+            auto clamp = [](double v) { return v < 0.0 ? 0.0 : (v > 1000.0 ? 1000.0 : v); };
+            return clamp(a * w) * 1000000.0 + clamp(b * w) * 1000.0 + clamp(c * w);
+        }
+
+        inline const double required = create(1000.0, 1000.0, 1000.0);
+        inline const double strong = create(1.0, 0.0, 0.0);
+        inline const double medium = create(0.0, 1.0, 0.0);
+        inline const double weak = create(0.0, 0.0, 1.0);
+
+        inline double clip(double value) {
+            return value < 0.0 ? 0.0 : (value > required ? required : value);
+        }
+    }
+
+    // A solver variable. Copies refer to the same variable; use equals() for identity since
+    // operator== builds a constraint.
+    class variable {
+    public:
+        variable() : m_data(std::make_shared<data>()) {}
+        explicit variable(std::string name) : m_data(std::make_shared<data>()) { m_data->name = std::move(name); }
+
+        const std::string& name() const { return m_data->name; }
+        double value() const { return m_data->value; }
+        void set_value(double value) { m_data->value = value; }
+
+        bool equals(const variable& other) const { return m_data == other.m_data; }
+        const void* id() const { return m_data.get(); }
+
+    private:
+        struct data {
+            std::string name;
+            double value = 0.0;
+        };
+        std::shared_ptr<data> m_data;
+    };
+
+    struct term {
+        variable var;
+        double coefficient = 1.0;
+
+        term(const variable& v, double c = 1.0) : var(v), coefficient(c) {}
+    };
+
+    struct expression {
+        std::vector<term> terms;
+        double constant = 0.0;
+
+        expression(double value = 0.0) : constant(value) {}
+        expression(const variable& v) : terms{ term(v) } {}
+        expression(const term& t) : terms{ t } {}
+        expression(std::vector<term> t, double c) : terms(std::move(t)), constant(c) {}
+
+        double value() const {
+            double result = constant;
+            for (const auto& t : terms)
+                result += t.coefficient * t.var.value();
+            return result;
+        }
+    };
+
+    inline expression operator*(const expression& e, double k) {
+        expression result(e.constant * k);
+        result.terms.reserve(e.terms.size());
+        for (const auto& t : e.terms)
+            result.terms.emplace_back(t.var, t.coefficient * k);
+        return result;
+    }
+    inline expression operator*(double k, const expression& e) { return e * k; }
+    inline expression operator*(const variable& v, double k) { return expression(term(v, k)); }
+    inline expression operator*(double k, const variable& v) { return expression(term(v, k)); }
+    inline expression operator/(const expression& e, double k) { return e * (1.0 / k); }
+    inline expression operator-(const expression& e) { return e * -1.0; }
+
+    inline expression operator+(const expression& a, const expression& b) {
+        expression result(a.constant + b.constant);
+        result.terms.reserve(a.terms.size() + b.terms.size());
+        result.terms.insert(result.terms.end(), a.terms.begin(), a.terms.end());
+        result.terms.insert(result.terms.end(), b.terms.begin(), b.terms.end());
+        return result;
+    }
+    inline expression operator-(const expression& a, const expression& b) { return a + (-b); }
+
+    enum class relation {
+        less_equal,
+        greater_equal,
+        equal
+    };
+
+    // `expression op 0` with a strength. Copies refer to the same constraint.
+    class constraint {
+    public:
+        constraint(const expression& e, relation op, double s = strength::required);
+
+        // Same relation with a different strength (a new, distinct constraint)
+        constraint(const constraint& other, double s) : constraint(other.expr(), other.op(), s) {}
+
+        const expression& expr() const { return m_data->expr; }
+        relation op() const { return m_data->op; }
+        double get_strength() const { return m_data->strength; }
+        const void* id() const { return m_data.get(); }
+
+    private:
+        struct data {
+            expression expr;
+            relation op = relation::equal;
+            double strength = 0.0;
+        };
+        std::shared_ptr<data> m_data;
+    };
+
+    inline constraint operator==(const expression& a, const expression& b) { return constraint(a - b, relation::equal); }
+    inline constraint operator<=(const expression& a, const expression& b) { return constraint(a - b, relation::less_equal); }
+    inline constraint operator>=(const expression& a, const expression& b) { return constraint(a - b, relation::greater_equal); }
+    // Exact overloads so C++20 does not try the reversed (non-bool) operator== candidates
+    inline constraint operator==(const variable& a, const expression& b) { return expression(a) == b; }
+    inline constraint operator==(const expression& a, const variable& b) { return a == expression(b); }
+    inline constraint operator==(const variable& a, const variable& b) { return expression(a) == expression(b); }
+    inline constraint operator<=(const variable& a, const expression& b) { return expression(a) <= b; }
+    inline constraint operator>=(const variable& a, const expression& b) { return expression(a) >= b; }
+    inline constraint operator|(const constraint& c, double s) { return constraint(c, s); }
+
+    class solver {
+    public:
+        solver() = default;
+        solver(const solver&) = delete;
+        solver& operator=(const solver&) = delete;
+
+        // Returns false if the constraint is already present or is a required constraint that cannot be satisfied
+        bool add_constraint(const constraint& c);
+        bool remove_constraint(const constraint& c);
+        bool has_constraint(const constraint& c) const { return m_constraints.count(c.id()) != 0; }
+
+        // Edit variables can be moved with suggest_value without touching the rest of the tableau.
+        // The strength must be below required.
+        bool add_edit_variable(const variable& v, double s);
+        bool remove_edit_variable(const variable& v);
+        bool has_edit_variable(const variable& v) const { return m_edits.count(v.id()) != 0; }
+        bool suggest_value(const variable& v, double value);
+
+        // Copy the current solution into the variables
+        void update_variables();
+
+        void reset();
+
+        size_t constraint_count() const { return m_constraints.size(); }
+
+    private:
+        struct symbol {
+            enum class kind : std::uint8_t { invalid, external, slack, error, dummy };
+
+            std::uint64_t id = 0;
+            kind type = kind::invalid;
+
+            bool valid() const { return type != kind::invalid; }
+            bool operator<(const symbol& other) const { return id < other.id; }
+            bool operator==(const symbol& other) const { return id == other.id; }
+        };
+
+        // Sparse row kept as a vector sorted by symbol id; merges are linear
+        class row {
+        public:
+            struct cell {
+                symbol sym;
+                double coefficient;
+            };
+
+            row() = default;
+            explicit row(double constant) : m_constant(constant) {}
+
+            double constant() const { return m_constant; }
+            const std::vector<cell>& cells() const { return m_cells; }
+
+            double add(double value) { return m_constant += value; }
+            void insert(const symbol& s, double coefficient = 1.0);
+            void insert(const row& other, double coefficient = 1.0);
+            void remove(const symbol& s);
+            void reverse_sign();
+            void solve_for(const symbol& s);
+            void solve_for(const symbol& lhs, const symbol& rhs);
+            double coefficient_for(const symbol& s) const;
+            void substitute(const symbol& s, const row& other);
+
+        private:
+            std::vector<cell>::iterator find(const symbol& s);
+            std::vector<cell>::const_iterator find(const symbol& s) const;
+
+            std::vector<cell> m_cells;
+            double m_constant = 0.0;
+        };
+
+        struct tag {
+            symbol marker;
+            symbol other;
+        };
+
+        struct constraint_entry {
+            constraint cn;
+            tag t;
+        };
+
+        struct edit_info {
+            variable var;
+            constraint cn;
+            tag t;
+            double constant = 0.0;
+        };
+
+        struct variable_entry {
+            variable var;
+            symbol sym;
+        };
+
+        using row_map = std::map<symbol, std::unique_ptr<row>>;
+
+        symbol make_symbol(symbol::kind type) { return { ++m_id_tick, type }; }
+        symbol variable_symbol(const variable& v);
+
+        std::unique_ptr<row> create_row(const constraint& c, tag& t);
+        symbol choose_subject(const row& r, const tag& t) const;
+        bool add_with_artificial_variable(const row& r);
+        void substitute(const symbol& s, const row& r);
+        bool optimize(const row& objective);
+        void dual_optimize();
+        symbol entering_symbol(const row& objective) const;
+        symbol dual_entering_symbol(const row& r) const;
+        static symbol any_pivotable_symbol(const row& r);
+        row_map::iterator leaving_row(const symbol& entering);
+        row_map::iterator marker_leaving_row(const symbol& marker);
+        void remove_constraint_effects(const constraint& c, const tag& t);
+        void remove_marker_effects(const symbol& marker, double s);
+        static bool all_dummies(const row& r);
+
+        std::unordered_map<const void*, constraint_entry> m_constraints;
+        std::unordered_map<const void*, edit_info> m_edits;
+        std::unordered_map<const void*, variable_entry> m_vars;
+        row_map m_rows;
+        std::vector<symbol> m_infeasible_rows;
+        row m_objective;
+        std::unique_ptr<row> m_artificial;
+        std::uint64_t m_id_tick = 0;
+    };
+
+    // Constraint state of one constraint panel, shared with the layout snapshots it produces.
+    // The engine solves it during measure/arrange (possibly on a worker thread), so all access goes through mutex().
+    class constraint_system {
+    public:
+        // Rectangle of one child, relative to the panel content origin
+        struct slot {
+            variable left;
+            variable top;
+            variable width;
+            variable height;
+        };
+
+        constraint_system();
+
+        std::mutex& mutex() { return m_mutex; }
+        solver& get_solver() { return m_solver; }
+
+        // Edit variables driven by the panel's content size
+        const variable& content_width() const { return m_content_width; }
+        const variable& content_height() const { return m_content_height; }
+
+        int add_slot();
+        const slot& get_slot(int index) const { return m_slots[index].vars; }
+        size_t slot_count() const { return m_slots.size(); }
+
+        // Keep a slot's size tied to the element's size model; only changed values touch the tableau
+        void sync_slot_size(int index, int desired_width, int desired_height, int min_width, int min_height, int max_width, int max_height);
+
+        // Drop the size model of a slot whose element is gone. Indices stay stable, so the slot itself remains;
+        // constraints the application added on its variables are left to the application.
+        void release_slot(int index);
+
+        // Suggest a new content size and refresh the variable values (incremental)
+        void resize(int width, int height);
+
+    private:
+        struct slot_state {
+            slot vars;
+            std::vector<constraint> size_constraints;
+            int size_key[6] = { -1, -1, -1, -1, -1, -1 };
+        };
+
+        std::mutex m_mutex;
+        solver m_solver;
+        variable m_content_width{ "content_width" };
+        variable m_content_height{ "content_height" };
+        std::vector<slot_state> m_slots;
+        int m_last_width = -1;
+        int m_last_height = -1;
+    };
+}
+
+#endif // WPP_LAYOUT_CONSTRAINT_SOLVER_HPP
@@ -0,0 +1,44 @@
+#ifndef WPP_LAYOUT_DAMAGE_REGION_HPP
+#define WPP_LAYOUT_DAMAGE_REGION_HPP
+
+#include "layout_types.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace wpp::layout
+{
+    // Accumulates the areas that need repainting as a short list of rectangles.
+    // Rectangles that overlap or touch are merged when the union wastes no more than they already cover;
+    // once the list reaches max_rects the two cheapest to join are merged, so invalidation stays one call per rect.
+    class damage_region {
+    public:
+        explicit damage_region(size_t max_rects = 16) : m_max_rects(max_rects < 1 ? 1 : max_rects) {}
+
+        // Add an area; empty rectangles are ignored
+        void add(const rect_t& area);
+        void add(const damage_region& other);
+
+        void clear() { m_rects.clear(); }
+        bool empty() const { return m_rects.empty(); }
+
+        const std::vector<rect_t>& rects() const { return m_rects; }
+
+        // Smallest rectangle covering all damage
+        rect_t bounds() const;
+
+        // Pixels covered by the damage (overlaps counted once)
+        long long area() const;
+
+    private:
+        static rect_t join(const rect_t& a, const rect_t& b);
+        static long long rect_area(const rect_t& r) { return static_cast<long long>(r.width) * r.height; }
+        static bool touches(const rect_t& a, const rect_t& b);
+        void merge_cheapest_pair();
+
+        std::vector<rect_t> m_rects;
+        size_t m_max_rects;
+    };
+}
+
+#endif // WPP_LAYOUT_DAMAGE_REGION_HPP
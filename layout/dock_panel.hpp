@@ -23,9 +23,6 @@ namespace wpp::layout
             }
         }
 
-        // Layout calculations
-        void measure(int available_width, int available_height) override;
-        void arrange(int x, int y, int width, int height) override;
         void paint(HDC hdc) override;
 
         // Configuration
@@ -36,6 +33,11 @@ namespace wpp::layout
         void set_last_child_fill(bool fill) { m_last_child_fill = fill; }
         bool get_last_child_fill() const { return m_last_child_fill; }
 
+    protected:
+        void capture_node(layout_snapshot& snapshot, int node) const override;
+        void apply_node(const layout_snapshot& snapshot, int node) override;
+        void child_removed(const control_ptr<>& child) override;
+
     private:
         std::unordered_map<control_ptr<>, dock_position> m_dock_positions;
         bool m_last_child_fill = true;
@@ -43,7 +45,7 @@ namespace wpp::layout
         struct child_measure {
             control_ptr<> control;
             dock_position position = dock_position::fill;
-            sizing_t desired_size = {};
+            sizing_t desired_size = {}; // remembered size of a nested panel
         };
         std::vector<child_measure> m_child_measures;
     };
@@ -5,36 +5,6 @@
 
 namespace wpp::layout
 {
-    // Grid size units
-    enum class grid_length_type {
-        auto_size,      // Size to content
-        pixel,          // Fixed pixel size
-        star            // Proportional size (e.g., 1*, 2*, 3*)
-    };
-
-    struct grid_length {
-        grid_length_type type = grid_length_type::auto_size;
-        double value = 1.0;  // For pixel or star types
-
-        static grid_length auto_size() { return { grid_length_type::auto_size, 0 }; }
-        static grid_length pixels(double px) { return { grid_length_type::pixel, px }; }
-        static grid_length star(double multiplier = 1.0) { return { grid_length_type::star, multiplier }; }
-    };
-
-    // Grid cell position
-    struct grid_position {
-        int row = 0;
-        int column = 0;
-        int row_span = 1;
-        int column_span = 1;
-    };
-
-    // Alignment for controls within grid cells
-    struct grid_alignment {
-        alignment horizontal = alignment::stretch;
-        alignment vertical = alignment::stretch;
-    };
-
     // Grid panel - arranges children in rows and columns
     class grid_panel : public panel {
     public:
@@ -56,10 +26,6 @@ namespace wpp::layout
             }
         }
 
-        // Layout calculations
-        void measure(int available_width, int available_height) override;
-        void arrange(int x, int y, int width, int height) override;
-       
 		// Optional: custom painting (for debugging grid lines)
         void paint(HDC hdc) override;
 
@@ -85,19 +51,33 @@ namespace wpp::layout
         grid_alignment get_alignment(control_ptr<> control) const;
 
         // Spacing between cells
-        void set_row_spacing(int spacing) { m_row_spacing = spacing; }
+        void set_row_spacing(int spacing) { m_row_spacing = spacing; invalidate_metrics(); }
         int get_row_spacing() const { return m_row_spacing; }
 
-        void set_column_spacing(int spacing) { m_column_spacing = spacing; }
+        void set_column_spacing(int spacing) { m_column_spacing = spacing; invalidate_metrics(); }
         int get_column_spacing() const { return m_column_spacing; }
 
         void set_spacing(int spacing) { 
             m_row_spacing = spacing;
             m_column_spacing = spacing;
+            invalidate_metrics();
         }
 
 		bool& paint_grid_lines() { return m_paint_grid_lines; }
 
+    protected:
+        void scale_metrics(scaled_metrics& metrics) const override {
+            metrics.row_spacing = scaled(m_row_spacing);
+            metrics.column_spacing = scaled(m_column_spacing);
+        }
+
+        void capture_node(layout_snapshot& snapshot, int node) const override;
+        void apply_node(const layout_snapshot& snapshot, int node) override;
+        void child_removed(const control_ptr<>& child) override {
+            m_grid_positions.erase(child);
+            m_alignments.erase(child);
+        }
+
     private:
         bool m_paint_grid_lines = false; // For debugging: whether to draw grid lines
 
@@ -109,20 +89,13 @@ namespace wpp::layout
         int m_row_spacing = 0;
         int m_column_spacing = 0;
 
-        // Calculated sizes during measure/arrange
+        // Track sizes from the last committed layout (used for grid line painting)
         std::vector<int> m_row_heights;
         std::vector<int> m_column_widths;
 
         // Helper functions
         void ensure_grid_capacity(int row, int column);
         grid_position get_next_available_position() const;
-        void calculate_track_sizes(
-            const std::vector<grid_length>& definitions,
-            int available_size,
-            int spacing,
-            const std::vector<int>& auto_sizes,
-            std::vector<int>& out_sizes
-        );
     };
 }
 
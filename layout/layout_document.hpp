@@ -0,0 +1,215 @@
+#ifndef WPP_LAYOUT_LAYOUT_DOCUMENT_HPP
+#define WPP_LAYOUT_LAYOUT_DOCUMENT_HPP
+
+// Declarative layout descriptions. A text form is authored by hand and compiled into a compact binary
+// form whose records can be used in place from mapped memory (a file view or an RCDATA resource).
+// Instantiation walks the records once, in document order, and hands each element to a builder;
+// the window supplies the builder that creates the real panels and controls.
+// Free of Win32 so the parser and loader build with the portable layout engine.
+//
+// Text form:
+//
+//   grid name=main padding=14 spacing=10 rows=64,*,48 columns=*,2* {
+//       static text="Title" row=0 column=0 column_span=2 height=28
+//       stack row=1 column=0 orientation=vertical spacing=6 {
+//           button name=ok text="OK" width=90 height=28
+//       }
+//   }
+//
+// Panels: grid, stack, dock, canvas. Controls: static, button, check_box, edit, rich_edit, list_box,
+// list_view, combo_box, tree_view, tab, progress, track_bar, group_box, link.
+// Any element: name; inside a grid row, column, row_span, column_span, h_align, v_align; inside a dock: dock;
+// inside a canvas: x, y, z. Panels: margin, padding, spacing; grid: rows, columns, row_spacing, column_spacing;
+// stack: orientation, align; dock: last_child_fill. Controls: text, width, height (default: the control's usual size).
+// Lengths are `auto`, pixels (`64`) or stars (`*`, `2*`); margins and padding take one or four values.
+// `//` starts a comment.
+
+#include "layout_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wpp::layout
+{
+    enum class element_kind : std::uint8_t {
+        grid,
+        stack,
+        dock,
+        canvas,
+        control
+    };
+
+    enum class control_kind : std::uint8_t {
+        none,
+        static_text,
+        button,
+        check_box,
+        edit,
+        rich_edit,
+        list_box,
+        list_view,
+        combo_box,
+        tree_view,
+        tab,
+        progress,
+        track_bar,
+        group_box,
+        link
+    };
+
+    // Which optional values of a record are set
+    namespace record_flags
+    {
+        constexpr std::uint16_t margin = 1 << 0;
+        constexpr std::uint16_t padding = 1 << 1;
+        constexpr std::uint16_t spacing = 1 << 2;
+        constexpr std::uint16_t column_spacing = 1 << 3;
+        constexpr std::uint16_t last_child_fill = 1 << 4;    // value of last_child_fill
+        constexpr std::uint16_t has_last_child_fill = 1 << 5;
+        constexpr std::uint16_t grid_position = 1 << 6;      // row/column given; otherwise the grid picks the next cell
+        constexpr std::uint16_t cell_alignment = 1 << 7;
+        constexpr std::uint16_t dock = 1 << 8;
+        constexpr std::uint16_t orientation = 1 << 9;
+        constexpr std::uint16_t alignment = 1 << 10;
+        constexpr std::uint16_t canvas_position = 1 << 11;
+    }
+
+    // One element, stored in document order (parents before their children). Plain data with a fixed layout,
+    // so the binary form can be read in place.
+    struct layout_record {
+        static constexpr std::uint32_t no_parent = 0xFFFFFFFFu;
+        static constexpr std::uint32_t no_string = 0xFFFFFFFFu;
+
+        element_kind kind = element_kind::control;
+        control_kind control = control_kind::none;
+        std::uint8_t orientation = 1;       // layout::orientation
+        std::uint8_t alignment = 3;         // layout::alignment (stack)
+        std::uint8_t dock = 4;              // layout::dock_position
+        std::uint8_t h_align = 3;           // layout::alignment (grid cell)
+        std::uint8_t v_align = 3;
+        std::uint8_t reserved = 0;
+        std::uint16_t flags = 0;            // record_flags
+        std::uint16_t row_count = 0;        // grid definitions at definitions_begin: rows, then columns
+        std::uint16_t column_count = 0;
+        std::uint16_t reserved2 = 0;
+        std::uint32_t definitions_begin = 0;
+        std::uint32_t parent = no_parent;
+        std::uint32_t subtree_size = 1;     // this element and all its descendants
+        std::uint32_t name = no_string;     // offsets into the string table
+        std::uint32_t text = no_string;
+        std::int32_t width = -1;            // -1 keeps the control's default size
+        std::int32_t height = -1;
+        std::int32_t x = 0;
+        std::int32_t y = 0;
+        std::int32_t z = 0;
+        std::int16_t row = 0;
+        std::int16_t column = 0;
+        std::int16_t row_span = 1;
+        std::int16_t column_span = 1;
+        std::int16_t spacing = 0;           // stack spacing, or grid row (and column) spacing
+        std::int16_t column_spacing = 0;
+        std::int16_t margin[4] = { 0, 0, 0, 0 };
+        std::int16_t padding[4] = { 0, 0, 0, 0 };
+    };
+    static_assert(sizeof(layout_record) == 84, "layout_record is part of the binary format");
+
+    struct layout_definition {
+        std::uint8_t type = 0;              // layout::grid_length_type
+        std::uint8_t reserved[3] = { 0, 0, 0 };
+        float value = 1.0f;
+
+        grid_length length() const { return { static_cast<grid_length_type>(type), value }; }
+    };
+    static_assert(sizeof(layout_definition) == 8, "layout_definition is part of the binary format");
+
+    // Binary form: header, records, definitions, then NUL-terminated UTF-8 strings, each section 8-byte aligned.
+    // Stored in the byte order of the machine that compiled it (little-endian on every Windows target).
+    struct layout_blob_header {
+        static constexpr std::uint32_t magic_value = 0x4C505057u; // "WPPL"
+        static constexpr std::uint16_t current_version = 1;
+
+        std::uint32_t magic = magic_value;
+        std::uint16_t version = current_version;
+        std::uint16_t header_size = sizeof(layout_blob_header);
+        std::uint32_t node_count = 0;
+        std::uint32_t definition_count = 0;
+        std::uint32_t string_bytes = 0;
+        std::uint32_t nodes_offset = 0;
+        std::uint32_t definitions_offset = 0;
+        std::uint32_t strings_offset = 0;
+        std::uint32_t total_size = 0;
+        std::uint32_t reserved = 0;
+    };
+    static_assert(sizeof(layout_blob_header) == 40, "layout_blob_header is part of the binary format");
+
+    // Parsed layout, owning its records. Produced by parse, turned into the binary form by serialize.
+    struct layout_document {
+        std::vector<layout_record> nodes;
+        std::vector<layout_definition> definitions;
+        std::string strings;
+
+        // Parse the text form; on failure `error` receives "line N: message"
+        static bool parse(std::string_view text, layout_document& document, std::string* error = nullptr);
+
+        std::vector<std::uint8_t> serialize() const;
+    };
+
+    // Read-only access to a binary layout without copying it. The bytes must outlive the view.
+    class layout_view {
+    public:
+        layout_view() = default;
+
+        // Validate a binary layout; every offset, string and parent link is checked once here so readers need no checks
+        static bool open(const void* data, std::size_t size, layout_view& view, std::string* error = nullptr);
+
+        std::size_t size() const { return m_nodes.size(); }
+        bool empty() const { return m_nodes.empty(); }
+        const layout_record& operator[](std::size_t index) const { return m_nodes[index]; }
+        std::span<const layout_record> nodes() const { return m_nodes; }
+
+        // Row and column definitions of a grid record
+        std::span<const layout_definition> rows(const layout_record& record) const {
+            return m_definitions.subspan(record.definitions_begin, record.row_count);
+        }
+        std::span<const layout_definition> columns(const layout_record& record) const {
+            return m_definitions.subspan(record.definitions_begin + record.row_count, record.column_count);
+        }
+
+        // String at an offset from a record, empty for no_string
+        std::string_view string(std::uint32_t offset) const {
+            return offset == layout_record::no_string ? std::string_view{} : std::string_view(m_strings.data() + offset);
+        }
+
+    private:
+        std::span<const layout_record> m_nodes;
+        std::span<const layout_definition> m_definitions;
+        std::span<const char> m_strings;
+    };
+
+    // Receives the elements of a layout during instantiation
+    class layout_builder {
+    public:
+        virtual ~layout_builder() = default;
+
+        // Called once before any element, with the number of elements, so storage can be allocated up front
+        virtual void reserve(std::size_t /*count*/) {}
+
+        // Create element `index`; its parent has already been created
+        virtual bool create(std::size_t index, const layout_record& record, const layout_view& view) = 0;
+
+        // Attach element `index` to its parent; called right after create for every element but the root
+        virtual bool attach(std::size_t parent, std::size_t index, const layout_record& record, const layout_view& view) = 0;
+    };
+
+    // Instantiate every element in one pass in document order. Stops at the first failing builder call.
+    bool instantiate(const layout_view& view, layout_builder& builder);
+
+    // Parse the text form and serialize it in one step
+    bool compile_layout(std::string_view text, std::vector<std::uint8_t>& blob, std::string* error = nullptr);
+}
+
+#endif // WPP_LAYOUT_LAYOUT_DOCUMENT_HPP
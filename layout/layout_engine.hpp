@@ -0,0 +1,211 @@
+#ifndef WPP_LAYOUT_ENGINE_HPP
+#define WPP_LAYOUT_ENGINE_HPP
+
+#include "layout_types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace wpp
+{
+    class thread_pool;
+}
+
+namespace wpp::layout::constraints
+{
+    class constraint_system;
+}
+
+namespace wpp::layout
+{
+    enum class node_kind {
+        leaf,
+        grid,
+        stack,
+        dock,
+        canvas,
+        constraint
+    };
+
+    // One element of a flattened layout tree. Nodes are stored in pre-order, so a node's
+    // descendants always follow it and have larger indices than their parent.
+    struct layout_node {
+        node_kind kind = node_kind::leaf;
+        int parent = -1;
+        int first_child = -1;
+        int last_child = -1;
+        int next_sibling = -1;
+        int child_count = 0;
+        int subtree_size = 1;
+
+        // Panel metrics, already scaled to device pixels
+        margin_t margin{ 0, 0, 0, 0 };
+        padding_t padding{ 0, 0, 0, 0 };
+        int row_spacing = 0;        // grid rows, or the stack spacing
+        int column_spacing = 0;
+        orientation stack_orientation = orientation::vertical;
+        alignment stack_alignment = alignment::start;
+        bool last_child_fill = true;
+
+        // Grid definitions live in layout_tree::track_definitions; computed sizes and offsets in layout_tree::tracks
+        int row_definition_offset = 0;
+        int row_definition_count = 0;
+        int column_definition_offset = 0;
+        int column_definition_count = 0;
+        int track_offset = -1;
+
+        // How this node sits inside its parent
+        grid_position cell{};
+        grid_alignment cell_alignment{};
+        dock_position dock = dock_position::fill;
+        int offset_x = 0;               // position on a canvas or constraint parent, relative to its content origin
+        int offset_y = 0;
+        int slot = -1;                  // this child's variables in the parent's constraint system
+        int system_index = -1;          // constraint panels: index into layout_tree::constraint_system
+        sizing_t preferred{ 0, 0 };     // leaf content size, or a dock child's remembered size
+        sizing_t min_size{ 0, 0 };
+        sizing_t max_size{ size_constraints::unbounded, size_constraints::unbounded };
+
+        // Results
+        sizing_t desired{ 0, 0 };
+        sizing_t measured{ 0, 0 };      // size assigned by a stack, dock or constraint parent during measure
+        rect_t bounds{ 0, 0, 0, 0 };
+
+        // Caller defined handle used to commit the result (index into the caller's target list)
+        std::int32_t target = -1;
+    };
+
+    // Value-type snapshot of a panel hierarchy. Contains no window handles, so it can be
+    // measured and arranged on any thread and handed back to the UI thread for commit.
+    class layout_tree {
+    public:
+        int add_node(node_kind kind, int parent);
+
+        void set_row_definitions(int node, const std::vector<grid_length>& rows);
+        void set_column_definitions(int node, const std::vector<grid_length>& columns);
+
+        // Constraint panels share their (stateful) solver with the snapshot instead of copying it
+        void set_constraint_system(int node, std::shared_ptr<constraints::constraint_system> system);
+        constraints::constraint_system* constraint_system(int node) const {
+            int index = m_nodes[node].system_index;
+            return index >= 0 ? m_systems[index].get() : nullptr;
+        }
+
+        // Computes subtree sizes and allocates grid track storage. Call once after building.
+        void finalize();
+
+        void clear();
+        void reserve(size_t node_count);
+
+        // Heap bytes held by the tree, for allocation accounting
+        size_t memory_usage() const {
+            return m_nodes.capacity() * sizeof(layout_node) + m_track_definitions.capacity() * sizeof(grid_length)
+                + m_tracks.capacity() * sizeof(int);
+        }
+
+        bool empty() const { return m_nodes.empty(); }
+        size_t size() const { return m_nodes.size(); }
+
+        layout_node& operator[](int index) { return m_nodes[index]; }
+        const layout_node& operator[](int index) const { return m_nodes[index]; }
+
+        std::vector<layout_node>& nodes() { return m_nodes; }
+        const std::vector<layout_node>& nodes() const { return m_nodes; }
+
+        int row_count(int node) const;
+        int column_count(int node) const;
+        const grid_length* row_definitions(int node) const { return m_track_definitions.data() + m_nodes[node].row_definition_offset; }
+        const grid_length* column_definitions(int node) const { return m_track_definitions.data() + m_nodes[node].column_definition_offset; }
+
+        // Track layout per grid node: [row sizes][column sizes][row offsets][column offsets]
+        int* row_sizes(int node) { return m_tracks.data() + m_nodes[node].track_offset; }
+        int* column_sizes(int node) { return row_sizes(node) + row_count(node); }
+        int* row_offsets(int node) { return column_sizes(node) + column_count(node); }
+        int* column_offsets(int node) { return row_offsets(node) + row_count(node); }
+        const int* row_sizes(int node) const { return m_tracks.data() + m_nodes[node].track_offset; }
+        const int* column_sizes(int node) const { return row_sizes(node) + row_count(node); }
+
+    private:
+        std::vector<layout_node> m_nodes;
+        std::vector<grid_length> m_track_definitions;
+        std::vector<int> m_tracks;
+        std::vector<std::shared_ptr<constraints::constraint_system>> m_systems;
+    };
+
+    // Cumulative counters for profiling layout. Attach one to an engine (and to a root panel for the
+    // capture/commit side) and compare before/after a change; all fields may be updated from worker threads.
+    struct layout_statistics {
+        std::atomic<std::uint64_t> measure_passes{ 0 };
+        std::atomic<std::uint64_t> arrange_passes{ 0 };
+        std::atomic<std::uint64_t> measure_ns{ 0 };
+        std::atomic<std::uint64_t> arrange_ns{ 0 };
+        std::atomic<std::uint64_t> nodes_measured{ 0 };
+        std::atomic<std::uint64_t> nodes_arranged{ 0 };
+        std::atomic<std::uint64_t> snapshots_captured{ 0 };
+        std::atomic<std::uint64_t> snapshot_bytes{ 0 };       // heap bytes reserved by captured trees
+        std::atomic<std::uint64_t> window_commits{ 0 };       // SetWindowPos / DeferWindowPos calls
+        std::atomic<std::uint64_t> repaints{ 0 };             // layout commits that invalidated anything
+        std::atomic<std::uint64_t> repaint_rects{ 0 };        // rectangles invalidated
+        std::atomic<std::uint64_t> repaint_area{ 0 };         // pixels invalidated
+        std::atomic<std::uint64_t> full_repaint_area{ 0 };    // pixels a whole-window repaint would have covered
+
+        void reset() {
+            for (auto* counter : { &measure_passes, &arrange_passes, &measure_ns, &arrange_ns, &nodes_measured,
+                                   &nodes_arranged, &snapshots_captured, &snapshot_bytes, &window_commits,
+                                   &repaints, &repaint_rects, &repaint_area, &full_repaint_area })
+                counter->store(0, std::memory_order_relaxed);
+        }
+    };
+
+    // Pure measure/arrange implementation for grid, stack, dock, canvas and constraint panels.
+    // When a pool is supplied, independent child subtrees of at least parallel_grain nodes are processed concurrently.
+    class layout_engine {
+    public:
+        explicit layout_engine(thread_pool* pool = nullptr, int parallel_grain = 32)
+            : m_pool(pool), m_parallel_grain(parallel_grain) {
+        }
+
+        // Collect timing and node counts into `statistics` (nullptr disables collection)
+        void set_statistics(layout_statistics* statistics) { m_statistics = statistics; }
+
+        void measure(layout_tree& tree, int node, int available_width, int available_height) const;
+        void arrange(layout_tree& tree, int node, const rect_t& bounds) const;
+
+        // Measure and arrange in one call, placing the node at (x, y)
+        void layout(layout_tree& tree, int node, int x, int y, int width, int height) const {
+            measure(tree, node, width, height);
+            arrange(tree, node, { x, y, width, height });
+        }
+
+    private:
+        void measure_node(layout_tree& tree, int node, int available_width, int available_height) const;
+        void arrange_node(layout_tree& tree, int node, const rect_t& slot) const;
+
+        void measure_grid(layout_tree& tree, int node, int available_width, int available_height) const;
+        void measure_stack(layout_tree& tree, int node, int available_width, int available_height) const;
+        void measure_dock(layout_tree& tree, int node, int available_width, int available_height) const;
+        void measure_canvas(layout_tree& tree, int node, int available_width, int available_height) const;
+        void measure_constraint(layout_tree& tree, int node, int available_width, int available_height) const;
+
+        void arrange_grid(layout_tree& tree, int node, const rect_t& bounds) const;
+        void arrange_stack(layout_tree& tree, int node, const rect_t& bounds) const;
+        void arrange_dock(layout_tree& tree, int node, const rect_t& bounds) const;
+        void arrange_canvas(layout_tree& tree, int node, const rect_t& bounds) const;
+        void arrange_constraint(layout_tree& tree, int node, const rect_t& bounds) const;
+        void solve_constraints(layout_tree& tree, int node, int content_width, int content_height) const;
+
+        bool should_fork(const layout_tree& tree, int node) const;
+
+        static void calculate_track_sizes(const grid_length* definitions, int definition_count,
+                                          int available_size, int* sizes, int track_count);
+
+        thread_pool* m_pool;
+        int m_parallel_grain;
+        layout_statistics* m_statistics = nullptr;
+    };
+}
+
+#endif // WPP_LAYOUT_ENGINE_HPP
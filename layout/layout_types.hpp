@@ -0,0 +1,98 @@
+#ifndef WPP_LAYOUT_TYPES_HPP
+#define WPP_LAYOUT_TYPES_HPP
+
+// Plain geometry types shared by the panels and the layout engine.
+// This header must stay free of Win32 so the engine can be built on any platform.
+
+#include <algorithm>
+#include <climits>
+
+namespace wpp::layout
+{
+    enum class orientation {
+        horizontal,
+        vertical
+    };
+
+    enum class alignment {
+        start,
+        center,
+        end,
+        stretch
+    };
+
+    enum class dock_position {
+        left,
+        top,
+        right,
+        bottom,
+        fill
+    };
+
+    enum class type {
+        stack,
+        dock,
+        grid,
+        absolute,
+        constraint,
+        base = -1
+    };
+
+    struct margin_t { int left, top, right, bottom; };
+    struct padding_t { int left, top, right, bottom; };
+    struct sizing_t { int width, height; };
+    struct rect_t { int x, y, width, height; };
+
+    inline bool operator==(const sizing_t& a, const sizing_t& b) { return a.width == b.width && a.height == b.height; }
+    inline bool operator!=(const sizing_t& a, const sizing_t& b) { return !(a == b); }
+    inline bool operator==(const rect_t& a, const rect_t& b) { return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height; }
+    inline bool operator!=(const rect_t& a, const rect_t& b) { return !(a == b); }
+
+    // Size model of a layout element. Desired is the content size the element asks for,
+    // minimum and maximum bound whatever the layout finally assigns to it.
+    struct size_constraints {
+        static constexpr int unbounded = INT_MAX;
+
+        sizing_t desired{ 0, 0 };
+        sizing_t minimum{ 0, 0 };
+        sizing_t maximum{ unbounded, unbounded };
+
+        sizing_t clamp(sizing_t size) const {
+            size.width = (std::max)(minimum.width, (std::min)(size.width, maximum.width));
+            size.height = (std::max)(minimum.height, (std::min)(size.height, maximum.height));
+            return size;
+        }
+    };
+
+    // Grid size units
+    enum class grid_length_type {
+        auto_size,      // Size to content
+        pixel,          // Fixed pixel size
+        star            // Proportional size (e.g., 1*, 2*, 3*)
+    };
+
+    struct grid_length {
+        grid_length_type type = grid_length_type::auto_size;
+        double value = 1.0;  // For pixel or star types
+
+        static grid_length auto_size() { return { grid_length_type::auto_size, 0 }; }
+        static grid_length pixels(double px) { return { grid_length_type::pixel, px }; }
+        static grid_length star(double multiplier = 1.0) { return { grid_length_type::star, multiplier }; }
+    };
+
+    // Grid cell position
+    struct grid_position {
+        int row = 0;
+        int column = 0;
+        int row_span = 1;
+        int column_span = 1;
+    };
+
+    // Alignment for controls within grid cells
+    struct grid_alignment {
+        alignment horizontal = alignment::stretch;
+        alignment vertical = alignment::stretch;
+    };
+}
+
+#endif // WPP_LAYOUT_TYPES_HPP
@@ -3,41 +3,19 @@
 
 #include "../winplusplus.hpp"
 #include "../controls/control.hpp"
+#include "layout_types.hpp"
+#include "layout_engine.hpp"
+#include "damage_region.hpp"
 
 namespace wpp::layout
 {
-	enum class orientation {
-		horizontal,
-		vertical
+	// Geometry snapshot of a panel hierarchy together with the controls its nodes commit to.
+	// Node targets index into `targets`; the root node has no target and commits to the panel that captured it.
+	struct layout_snapshot {
+		layout_tree tree;
+		std::vector<control_ptr<>> targets;
 	};
 
-	enum class alignment {
-		start,
-		center,
-		end,
-		stretch
-	};
-
-	enum class dock_position {
-		left,
-		top,
-		right,
-		bottom,
-		fill
-	};
-
-	enum class type {
-		stack,
-		dock,
-		grid,
-		absolute,
-		base = -1
-	};
-
-	struct margin_t { int left, top, right, bottom; };
-	struct padding_t { int left, top, right, bottom; };
-	struct sizing_t { int width, height; };
-
 	// Base class for all layout panels - inherits from control to allow nesting
 	class panel : public control {
 	public:
@@ -53,14 +31,40 @@ namespace wpp::layout
 			if (child_panel) {
 				// Attach the panel's window as a child
 				attach_child(child_panel->get_handle());
+				// Nested panels follow the DPI of the panel they live in
+				child_panel->set_dpi_scale(m_dpi_scale);
 				// Store in children collection as a control_ptr
 				add(std::static_pointer_cast<control>(child_panel));
 			}
 		}
 
-		// Layout calculations
-		virtual void measure(int available_width, int available_height) = 0;
-		virtual void arrange(int x, int y, int width, int height) = 0;
+		// Reserve room for a known number of children
+		void reserve_children(size_t count) { m_children.reserve(count); }
+
+		// Layout calculations. Both run the portable layout engine over a snapshot of this subtree;
+		// arrange then commits the resulting rectangles to the child windows. The areas that moved are added
+		// to `damage` when given, for the caller to repaint in one go; otherwise they are invalidated at once.
+		void measure(int available_width, int available_height);
+		void arrange(int x, int y, int width, int height, damage_region* damage = nullptr);
+
+		// Capture this panel's subtree as a window-free layout tree (UI thread only)
+		layout_snapshot capture_layout() const;
+
+		// Move child windows to the computed rectangles and read results back into the panels (UI thread only).
+		// Only windows whose rectangle changed since the previous commit are moved; their old and new
+		// rectangles, and those of windows gone since then, are added to `damage` (host client coordinates).
+		void commit_layout(const layout_snapshot& snapshot, damage_region& damage);
+
+		// Invalidate an area of the window hosting this panel, given in its client coordinates
+		void invalidate_damage(const damage_region& damage) const;
+
+		// Drop children whose window was destroyed, here and in nested panels, with their size models and
+		// panel specific state. Layout passes started from this panel do this first.
+		void prune_destroyed_children();
+
+		// Forget the committed rectangles so the next commit moves every window again
+		// (call after moving child windows outside of layout)
+		void reset_committed_bounds() { m_committed_bounds.clear(); }
 
 		// Optional: custom painting (for advanced panels)
 		virtual void paint(HDC hdc) = 0;
@@ -86,21 +90,28 @@ namespace wpp::layout
 		// Margin and padding
 		void set_margin(int left, int top, int right, int bottom) {
 			m_margin = { left, top, right, bottom };
+			invalidate_metrics();
 		}
 		void set_margin(int uniform) {
 			set_margin(uniform, uniform, uniform, uniform);
 		}
 		void set_padding(int left, int top, int right, int bottom) {
 			m_padding = { left, top, right, bottom };
+			invalidate_metrics();
 		}
 		void set_padding(int uniform) {
 			set_padding(uniform, uniform, uniform, uniform);
 		}
-		void set_margin(const margin_t& margin) { m_margin = margin; }
-		void set_padding(const padding_t& padding) { m_padding = padding; }
+		void set_margin(const margin_t& margin) { m_margin = margin; invalidate_metrics(); }
+		void set_padding(const padding_t& padding) { m_padding = padding; invalidate_metrics(); }
 
-		// DPI support
-		void set_dpi_scale(float scale) { m_dpi_scale = scale; }
+		// DPI support. Applies the scale to this panel and every nested panel in one walk of the tree.
+		void set_dpi_scale(float scale);
+		float get_dpi_scale() const { return m_dpi_scale; }
+
+		// Profiling counters for passes started from this panel (nullptr disables collection)
+		void set_layout_statistics(std::shared_ptr<layout_statistics> statistics) { m_statistics = std::move(statistics); }
+		const std::shared_ptr<layout_statistics>& get_layout_statistics() const { return m_statistics; }
 
 		// Get the type of this panel
 		type get_type() const { return m_panel_type; }
@@ -111,7 +122,85 @@ namespace wpp::layout
 		// Get the actual size (set during arrange phase)
 		sizing_t get_actual_size() const { return m_actual_size; }
 
+		// Size model of a child. The desired size is read from the control once when it is added,
+		// layout never queries the window again; call update_desired_size after resizing a control yourself.
+		void set_desired_size(const control_ptr<>& child, int width, int height) {
+			m_child_sizes[child].desired = { width, height };
+			child_size_changed(child);
+		}
+		void set_min_size(const control_ptr<>& child, int width, int height) {
+			m_child_sizes[child].minimum = { width, height };
+			child_size_changed(child);
+		}
+		void set_max_size(const control_ptr<>& child, int width, int height) {
+			m_child_sizes[child].maximum = { width, height };
+			child_size_changed(child);
+		}
+		void update_desired_size(const control_ptr<>& child);
+
+		// Desired size from text, measured through the shared text metrics cache rather than the window rect.
+		// extra_width/extra_height cover the control's chrome (button borders, check box glyph, ...).
+		void fit_to_text(const control_ptr<>& child, tstring_view text, int extra_width = 0, int extra_height = 0);
+
+		// Re-measure the window text of many children in one batch per font (e.g. after the UI language changed)
+		void fit_to_text(const std::vector<control_ptr<>>& children, int extra_width = 0, int extra_height = 0);
+		size_constraints get_size_constraints(const control_ptr<>& child) const {
+			auto it = m_child_sizes.find(child);
+			return it != m_child_sizes.end() ? it->second : size_constraints{};
+		}
+
 	protected:
+		// Margin, padding and spacing in device pixels for the current DPI
+		struct scaled_metrics {
+			margin_t margin{ 0, 0, 0, 0 };
+			padding_t padding{ 0, 0, 0, 0 };
+			int row_spacing = 0;        // grid rows, or the stack spacing
+			int column_spacing = 0;
+		};
+
+		// Scaled metrics, recomputed only after the DPI or one of the source values changed
+		const scaled_metrics& get_scaled_metrics() const;
+		void invalidate_metrics() { m_metrics_dirty = true; }
+
+		// Fill in the panel specific spacing; margin and padding are already scaled when this is called
+		virtual void scale_metrics(scaled_metrics& metrics) const {}
+
+		// Describe this panel in the snapshot: metrics on `node`, then one capture_child call per child
+		virtual void capture_node(layout_snapshot& snapshot, int node) const = 0;
+
+		// Pull computed results for `node` back into the panel after a commit
+		virtual void apply_node(const layout_snapshot& snapshot, int node);
+
+		// Record the size model of a newly added child (controls start at their current window size)
+		void track_child(const control_ptr<>& child);
+
+		// Called after a child's size model changed
+		virtual void child_size_changed(const control_ptr<>& child) {}
+
+		// Called for each child dropped by prune_destroyed_children, before it leaves m_children
+		virtual void child_removed(const control_ptr<>& child) {}
+
+		// Append a child (control or nested panel) under `parent`, carrying its size model
+		int capture_child(layout_snapshot& snapshot, int parent, const control_ptr<>& child) const;
+
+		// Copy the cached DPI scaled metrics into a snapshot node
+		void capture_metrics(layout_node& node) const;
+
+		int scaled(int value) const { return static_cast<int>(value * m_dpi_scale); }
+
+		// DPI matching the current scale, for fonts and text measurement
+		UINT font_dpi() const;
+
+		node_kind get_node_kind() const {
+			switch (m_panel_type) {
+			case type::grid: return node_kind::grid;
+			case type::dock: return node_kind::dock;
+			case type::absolute: return node_kind::canvas;
+			case type::constraint: return node_kind::constraint;
+			default: return node_kind::stack;
+			}
+		}
+
 		// Helper function to create a panel container window
 		inline HWND create_panel_window(HWND parent) {
 			if (!parent) return nullptr;
@@ -121,11 +210,14 @@ namespace wpp::layout
 		}
 
 		std::vector<control_ptr<>> m_children;
+		std::unordered_map<control_ptr<>, size_constraints> m_child_sizes;
 
 		// Layout properties
 		margin_t m_margin{ 0,0,0,0 };
 		padding_t m_padding{ 0,0,0,0 };
 		float m_dpi_scale = 1.0f;
+		mutable scaled_metrics m_scaled_metrics;
+		mutable bool m_metrics_dirty = true;
 
 		// Calculated sizes
 		sizing_t m_desired_size{ 0, 0 };
@@ -133,6 +225,14 @@ namespace wpp::layout
 
 		type m_panel_type = type::base;
 
+		std::shared_ptr<layout_statistics> m_statistics;
+
+		// Snapshot produced by measure and consumed by the following arrange
+		std::optional<layout_snapshot> m_pending_layout;
+
+		// Rectangles of the last commit
+		std::unordered_map<HWND, rect_t> m_committed_bounds;
+
 		// Window subclassing for custom paint handling
 		WNDPROC m_original_wndproc = nullptr;
 		static LRESULT CALLBACK panel_wndproc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -0,0 +1,78 @@
+#ifndef WPP_LAYOUT_RESIZE_SCHEDULER_HPP
+#define WPP_LAYOUT_RESIZE_SCHEDULER_HPP
+
+#include <cstdint>
+
+namespace wpp::layout
+{
+    // Paces layout during an interactive resize (WM_ENTERSIZEMOVE .. WM_EXITSIZEMOVE) to the display refresh.
+    // Every size is recorded, but only the latest one is laid out, at most once per frame interval; while the
+    // previous frame is still being committed (async layout) new frames are skipped rather than queued.
+    // end() reports whether a final, exact layout is needed. Outside a resize every size is laid out immediately.
+    // Time is passed in by the caller (microseconds on any monotonic clock), so the policy runs on a virtual clock.
+    class resize_scheduler {
+    public:
+        using time_point = std::uint64_t;
+
+        struct statistics {
+            std::uint64_t sizes = 0;          // sizes recorded during live resizes
+            std::uint64_t frames = 0;         // layouts started during live resizes
+            std::uint64_t coalesced = 0;      // sizes superseded before they were laid out
+            std::uint64_t busy_skips = 0;     // due frames skipped because the previous one was still committing
+            std::uint64_t final_layouts = 0;  // exact layouts requested by end()
+        };
+
+        explicit resize_scheduler(time_point frame_interval = 16667) { set_frame_interval(frame_interval); }
+
+        // Minimum time between two layouts during a live resize
+        void set_frame_interval(time_point interval) { m_frame_interval = interval < 1 ? 1 : interval; }
+        time_point frame_interval() const { return m_frame_interval; }
+
+        // A frame still committing after this many intervals is treated as lost (e.g. a dropped async result)
+        void set_stall_frames(unsigned int frames) { m_stall_frames = frames < 1 ? 1 : frames; }
+
+        void begin();
+        bool active() const { return m_active; }
+
+        // Record a new client size; true when it should be laid out now (then call frame_started)
+        bool size_changed(int width, int height, time_point now);
+
+        // Frame clock tick; true when the pending size should be laid out now (then call frame_started)
+        bool tick(time_point now);
+
+        // The pending size is being laid out; it counts as in flight until frame_committed
+        void frame_started(time_point now);
+        void frame_committed();
+
+        // Leave the live resize; true when the last recorded size still needs an exact layout
+        bool end();
+
+        bool has_pending() const { return m_has_pending; }
+        int pending_width() const { return m_pending_width; }
+        int pending_height() const { return m_pending_height; }
+        bool frame_in_flight() const { return m_in_flight; }
+
+        // Time left until the next frame may start (0 if it is due)
+        time_point time_to_next_frame(time_point now) const;
+
+        const statistics& get_statistics() const { return m_statistics; }
+        void reset_statistics() { m_statistics = {}; }
+
+    private:
+        bool frame_due(time_point now) const;
+        bool in_flight(time_point now);
+
+        time_point m_frame_interval = 16667;
+        unsigned int m_stall_frames = 4;
+        bool m_active = false;
+        bool m_has_pending = false;
+        bool m_in_flight = false;
+        bool m_has_frame = false;
+        int m_pending_width = 0;
+        int m_pending_height = 0;
+        time_point m_last_frame = 0;
+        statistics m_statistics;
+    };
+}
+
+#endif // WPP_LAYOUT_RESIZE_SCHEDULER_HPP
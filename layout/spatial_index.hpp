@@ -0,0 +1,75 @@
+#ifndef WPP_LAYOUT_SPATIAL_INDEX_HPP
+#define WPP_LAYOUT_SPATIAL_INDEX_HPP
+
+#include "layout_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace wpp::layout
+{
+    // Dynamic uniform-grid index over axis aligned rectangles. Ids are small caller assigned integers
+    // (dense indices work best). Moving an element only touches the cells it left and entered, so the
+    // index can be kept up to date on every move. Very large elements are kept in a separate list
+    // instead of being linked into hundreds of cells.
+    class spatial_grid {
+    public:
+        explicit spatial_grid(int cell_size = 128);
+
+        void insert(int id, const rect_t& bounds) { update(id, bounds); }
+
+        // Insert or move an element
+        void update(int id, const rect_t& bounds);
+        void remove(int id);
+        void clear();
+
+        bool contains(int id) const { return id >= 0 && id < static_cast<int>(m_entries.size()) && m_entries[id].live; }
+        const rect_t& bounds(int id) const { return m_entries[id].bounds; }
+        size_t size() const { return m_live_count; }
+
+        // Append the ids whose bounds contain the point / intersect the area. Order is unspecified, ids are unique.
+        void query_point(int x, int y, std::vector<int>& out) const;
+        void query_rect(const rect_t& area, std::vector<int>& out) const;
+
+    private:
+        struct cell_range {
+            int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+
+            bool operator==(const cell_range& other) const {
+                return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+            }
+            long long cell_count() const { return static_cast<long long>(x1 - x0 + 1) * (y1 - y0 + 1); }
+        };
+
+        struct entry {
+            rect_t bounds{ 0, 0, 0, 0 };
+            cell_range cells;
+            bool live = false;
+            bool large = false;
+        };
+
+        static constexpr long long max_cells_per_entry = 64;
+
+        cell_range range_for(const rect_t& bounds) const;
+        int cell_coordinate(int value) const;
+        static std::uint64_t cell_key(int cx, int cy);
+
+        void link(int id, const entry& e);
+        void unlink(int id, const entry& e);
+        void collect(int id, const rect_t& area, std::vector<int>& out) const;
+
+        int m_cell_size;
+        size_t m_live_count = 0;
+        std::vector<entry> m_entries;
+        std::unordered_map<std::uint64_t, std::vector<int>> m_cells;
+        std::vector<int> m_large;
+
+        // Per-query visit stamps, so elements spanning several cells are reported once
+        mutable std::vector<std::uint32_t> m_visited;
+        mutable std::uint32_t m_stamp = 0;
+    };
+}
+
+#endif // WPP_LAYOUT_SPATIAL_INDEX_HPP
@@ -22,9 +22,6 @@ namespace wpp::layout
             }
 		}
 
-        // Layout calculations
-        void measure(int available_width, int available_height) override;
-        void arrange(int x, int y, int width, int height) override;
 		void paint(HDC hdc) override;
 
         // Configuration
@@ -32,19 +29,23 @@ namespace wpp::layout
         orientation get_orientation() const { return m_orientation; }
 
 		// Spacing between children
-        void set_spacing(int spacing) { m_spacing = spacing; }
+        void set_spacing(int spacing) { m_spacing = spacing; invalidate_metrics(); }
         int get_spacing() const { return m_spacing; }
 
         void set_alignment(alignment align) { m_alignment = align; }
         alignment get_alignment() const { return m_alignment; }
 
+    protected:
+        void scale_metrics(scaled_metrics& metrics) const override {
+            metrics.row_spacing = scaled(m_spacing);
+        }
+
+        void capture_node(layout_snapshot& snapshot, int node) const override;
+
     private:
         orientation m_orientation;
         int m_spacing;
         alignment m_alignment;
-
-        // Per-child desired sizes
-        std::vector<sizing_t> m_child_sizes;
     };
 }
 
@@ -0,0 +1,349 @@
+#ifndef WPP_LAYOUT_UI_TREE_HPP
+#define WPP_LAYOUT_UI_TREE_HPP
+
+// Compile-time description of a panel and control tree. The tree is a constexpr value whose type encodes its
+// shape, so element counts are constants, grid cells are checked against their grid while compiling, and
+// building it (ui_builder.hpp) needs no intermediate containers.
+// Free of Win32; control texts are kept as pointers to the string literals they were declared with.
+//
+//   static constexpr auto form = ui::grid(ui::rows(ui::px(28), ui::star()), ui::columns(ui::px(80), ui::star()),
+//       ui::cell(0, 0, ui::static_text(_T("Name"), 80, 24)),
+//       ui::cell(0, 1, ui::edit(_T(""), 200, 24).bind(&my_window::m_name)),
+//       ui::cell(1, 0, ui::stack(layout::orientation::horizontal,
+//                                ui::button(_T("OK"), 90, 28).bind(&my_window::m_ok)).spacing(6), 1, 2))
+//       .padding(8).spacing(6);
+
+#include "layout_types.hpp"
+#include "layout_document.hpp"
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace wpp::layout::ui
+{
+    // Grid lengths usable in constant expressions
+    constexpr grid_length px(double pixels) { return { grid_length_type::pixel, pixels }; }
+    constexpr grid_length star(double weight = 1.0) { return { grid_length_type::star, weight }; }
+    constexpr grid_length auto_size() { return { grid_length_type::auto_size, 0.0 }; }
+
+    template<std::size_t N>
+    struct lengths {
+        std::array<grid_length, N> values;
+    };
+
+    template<typename... Lengths>
+    constexpr auto rows(Lengths... values) { return lengths<sizeof...(Lengths)>{ { values... } }; }
+
+    template<typename... Lengths>
+    constexpr auto columns(Lengths... values) { return lengths<sizeof...(Lengths)>{ { values... } }; }
+
+    // No member to store the created element in
+    struct no_binding {};
+
+    // Stores the created element in a member of the owning window
+    template<typename Owner, typename Member>
+    struct member_binding {
+        Member Owner::* member;
+    };
+
+    // Margin, padding and spacing shared by all panels
+    struct panel_options {
+        bool has_margin = false;
+        bool has_padding = false;
+        bool has_spacing = false;
+        margin_t margin{ 0, 0, 0, 0 };
+        padding_t padding{ 0, 0, 0, 0 };
+        int spacing = 0;
+    };
+
+    template<control_kind Kind, typename CharT, typename Binding = no_binding>
+    struct control_spec {
+        static constexpr std::size_t control_count = 1;
+        static constexpr std::size_t panel_count = 0;
+        static constexpr control_kind kind = Kind;
+
+        const CharT* text = nullptr;
+        int width = -1;                 // -1 keeps the control's default size
+        int height = -1;
+        Binding binding{};
+
+        template<typename Owner, typename Member>
+        constexpr auto bind(Member Owner::* member) const {
+            return control_spec<Kind, CharT, member_binding<Owner, Member>>{ text, width, height, { member } };
+        }
+    };
+
+    // Panel specs; Derived supplies the shape-specific data
+    template<typename Derived, typename Binding, typename... Children>
+    struct panel_spec {
+        static constexpr std::size_t control_count = (std::size_t{ 0 } + ... + Children::control_count);
+        static constexpr std::size_t panel_count = (std::size_t{ 1 } + ... + Children::panel_count);
+
+        std::tuple<Children...> children;
+        panel_options options{};
+        Binding binding{};
+
+        constexpr Derived margin(int uniform) const { return margin(uniform, uniform, uniform, uniform); }
+        constexpr Derived margin(int left, int top, int right, int bottom) const {
+            Derived copy = self();
+            copy.options.has_margin = true;
+            copy.options.margin = { left, top, right, bottom };
+            return copy;
+        }
+        constexpr Derived padding(int uniform) const { return padding(uniform, uniform, uniform, uniform); }
+        constexpr Derived padding(int left, int top, int right, int bottom) const {
+            Derived copy = self();
+            copy.options.has_padding = true;
+            copy.options.padding = { left, top, right, bottom };
+            return copy;
+        }
+        constexpr Derived spacing(int value) const {
+            Derived copy = self();
+            copy.options.has_spacing = true;
+            copy.options.spacing = value;
+            return copy;
+        }
+
+    protected:
+        constexpr const Derived& self() const { return static_cast<const Derived&>(*this); }
+    };
+
+    // Grid child with an explicit cell
+    template<typename Child>
+    struct cell_spec {
+        static constexpr std::size_t control_count = Child::control_count;
+        static constexpr std::size_t panel_count = Child::panel_count;
+
+        Child child;
+        grid_position position;
+        bool has_alignment = false;
+        grid_alignment cell_alignment{};
+
+        constexpr cell_spec align(alignment horizontal, alignment vertical) const {
+            cell_spec copy = *this;
+            copy.has_alignment = true;
+            copy.cell_alignment = { horizontal, vertical };
+            return copy;
+        }
+    };
+
+    template<typename Child>
+    struct dock_child_spec {
+        static constexpr std::size_t control_count = Child::control_count;
+        static constexpr std::size_t panel_count = Child::panel_count;
+
+        Child child;
+        dock_position side;
+    };
+
+    template<typename Child>
+    struct canvas_child_spec {
+        static constexpr std::size_t control_count = Child::control_count;
+        static constexpr std::size_t panel_count = Child::panel_count;
+
+        Child child;
+        int x;
+        int y;
+        int z;
+    };
+
+    template<std::size_t Rows, std::size_t Columns, typename Binding, typename... Children>
+    struct grid_spec : panel_spec<grid_spec<Rows, Columns, Binding, Children...>, Binding, Children...> {
+        std::array<grid_length, Rows> rows{};
+        std::array<grid_length, Columns> columns{};
+
+        template<typename Owner, typename Member>
+        constexpr auto bind(Member Owner::* member) const {
+            grid_spec<Rows, Columns, member_binding<Owner, Member>, Children...> bound;
+            bound.children = this->children;
+            bound.options = this->options;
+            bound.binding = { member };
+            bound.rows = rows;
+            bound.columns = columns;
+            return bound;
+        }
+    };
+
+    template<typename Binding, typename... Children>
+    struct stack_spec : panel_spec<stack_spec<Binding, Children...>, Binding, Children...> {
+        orientation direction = orientation::vertical;
+        bool has_alignment = false;
+        alignment align_children = alignment::stretch;
+
+        constexpr stack_spec align(alignment value) const {
+            stack_spec copy = *this;
+            copy.has_alignment = true;
+            copy.align_children = value;
+            return copy;
+        }
+
+        template<typename Owner, typename Member>
+        constexpr auto bind(Member Owner::* member) const {
+            stack_spec<member_binding<Owner, Member>, Children...> bound;
+            bound.children = this->children;
+            bound.options = this->options;
+            bound.binding = { member };
+            bound.direction = direction;
+            bound.has_alignment = has_alignment;
+            bound.align_children = align_children;
+            return bound;
+        }
+    };
+
+    template<typename Binding, typename... Children>
+    struct dock_spec : panel_spec<dock_spec<Binding, Children...>, Binding, Children...> {
+        bool last_child_fill = true;
+
+        constexpr dock_spec fill_last(bool fill) const {
+            dock_spec copy = *this;
+            copy.last_child_fill = fill;
+            return copy;
+        }
+
+        template<typename Owner, typename Member>
+        constexpr auto bind(Member Owner::* member) const {
+            dock_spec<member_binding<Owner, Member>, Children...> bound;
+            bound.children = this->children;
+            bound.options = this->options;
+            bound.binding = { member };
+            bound.last_child_fill = last_child_fill;
+            return bound;
+        }
+    };
+
+    template<typename Binding, typename... Children>
+    struct canvas_spec : panel_spec<canvas_spec<Binding, Children...>, Binding, Children...> {
+        template<typename Owner, typename Member>
+        constexpr auto bind(Member Owner::* member) const {
+            canvas_spec<member_binding<Owner, Member>, Children...> bound;
+            bound.children = this->children;
+            bound.options = this->options;
+            bound.binding = { member };
+            return bound;
+        }
+    };
+
+    namespace detail
+    {
+        template<typename T> struct is_cell : std::false_type {};
+        template<typename Child> struct is_cell<cell_spec<Child>> : std::true_type {};
+
+        template<typename T> struct is_dock_child : std::false_type {};
+        template<typename Child> struct is_dock_child<dock_child_spec<Child>> : std::true_type {};
+
+        template<typename T> struct is_canvas_child : std::false_type {};
+        template<typename Child> struct is_canvas_child<canvas_child_spec<Child>> : std::true_type {};
+
+        template<typename T> struct is_positioned : std::bool_constant<is_cell<T>::value || is_dock_child<T>::value || is_canvas_child<T>::value> {};
+
+        // Not a constant expression, so reaching it while compiling a consteval call is a compile error
+        inline void invalid_layout(const char*) {}
+
+        template<std::size_t Rows, std::size_t Columns, typename Child>
+        consteval void check_cell(const Child& child) {
+            if constexpr (is_cell<Child>::value) {
+                const grid_position& p = child.position;
+                if (p.row < 0 || p.column < 0 || p.row_span < 1 || p.column_span < 1)
+                    invalid_layout("grid cell index or span is negative");
+                if (static_cast<std::size_t>(p.row) + static_cast<std::size_t>(p.row_span) > Rows)
+                    invalid_layout("grid cell row is outside the grid's rows");
+                if (static_cast<std::size_t>(p.column) + static_cast<std::size_t>(p.column_span) > Columns)
+                    invalid_layout("grid cell column is outside the grid's columns");
+            }
+        }
+    }
+
+    // Controls
+    template<typename CharT>
+    constexpr auto static_text(const CharT* text, int width = -1, int height = -1) { return control_spec<control_kind::static_text, CharT>{ text, width, height }; }
+    template<typename CharT>
+    constexpr auto button(const CharT* text, int width = -1, int height = -1) { return control_spec<control_kind::button, CharT>{ text, width, height }; }
+    template<typename CharT>
+    constexpr auto check_box(const CharT* text, int width = -1, int height = -1) { return control_spec<control_kind::check_box, CharT>{ text, width, height }; }
+    template<typename CharT>
+    constexpr auto edit(const CharT* text, int width = -1, int height = -1) { return control_spec<control_kind::edit, CharT>{ text, width, height }; }
+    template<typename CharT>
+    constexpr auto rich_edit(const CharT* text, int width = -1, int height = -1) { return control_spec<control_kind::rich_edit, CharT>{ text, width, height }; }
+    template<typename CharT>
+    constexpr auto group_box(const CharT* text, int width = -1, int height = -1) { return control_spec<control_kind::group_box, CharT>{ text, width, height }; }
+    template<typename CharT>
+    constexpr auto link(const CharT* text, int width = -1, int height = -1) { return control_spec<control_kind::link, CharT>{ text, width, height }; }
+
+    // Controls without a caption
+    template<control_kind Kind>
+    constexpr auto plain(int width = -1, int height = -1) { return control_spec<Kind, char>{ nullptr, width, height }; }
+    constexpr auto list_box(int width = -1, int height = -1) { return plain<control_kind::list_box>(width, height); }
+    constexpr auto list_view(int width = -1, int height = -1) { return plain<control_kind::list_view>(width, height); }
+    constexpr auto combo_box(int width = -1, int height = -1) { return plain<control_kind::combo_box>(width, height); }
+    constexpr auto tree_view(int width = -1, int height = -1) { return plain<control_kind::tree_view>(width, height); }
+    constexpr auto tab(int width = -1, int height = -1) { return plain<control_kind::tab>(width, height); }
+    constexpr auto progress(int width = -1, int height = -1) { return plain<control_kind::progress>(width, height); }
+    constexpr auto track_bar(int width = -1, int height = -1) { return plain<control_kind::track_bar>(width, height); }
+
+    // Placement of a child inside its panel
+    template<typename Child>
+    constexpr auto cell(int row, int column, Child child, int row_span = 1, int column_span = 1) {
+        return cell_spec<Child>{ child, { row, column, row_span, column_span } };
+    }
+
+    template<typename Child>
+    constexpr auto docked(dock_position side, Child child) { return dock_child_spec<Child>{ child, side }; }
+
+    template<typename Child>
+    constexpr auto placed(int x, int y, Child child, int z = 0) { return canvas_child_spec<Child>{ child, x, y, z }; }
+
+    // Panels. grid is consteval: a cell outside the declared rows and columns does not compile.
+    template<std::size_t Rows, std::size_t Columns, typename... Children>
+    consteval auto grid(lengths<Rows> row_lengths, lengths<Columns> column_lengths, Children... children) {
+        static_assert(((!detail::is_dock_child<Children>::value && !detail::is_canvas_child<Children>::value) && ...),
+                      "grid children are placed with ui::cell");
+        (detail::check_cell<Rows, Columns>(children), ...);
+
+        grid_spec<Rows, Columns, no_binding, Children...> spec;
+        spec.children = std::tuple<Children...>(children...);
+        spec.rows = row_lengths.values;
+        spec.columns = column_lengths.values;
+        return spec;
+    }
+
+    template<typename... Children>
+    constexpr auto stack(orientation direction, Children... children) {
+        static_assert((!detail::is_positioned<Children>::value && ...), "stack children take no placement");
+
+        stack_spec<no_binding, Children...> spec;
+        spec.children = std::tuple<Children...>(children...);
+        spec.direction = direction;
+        return spec;
+    }
+
+    template<typename... Children>
+    constexpr auto dock(Children... children) {
+        static_assert(((!detail::is_cell<Children>::value && !detail::is_canvas_child<Children>::value) && ...),
+                      "dock children are placed with ui::docked");
+
+        dock_spec<no_binding, Children...> spec;
+        spec.children = std::tuple<Children...>(children...);
+        return spec;
+    }
+
+    template<typename... Children>
+    constexpr auto canvas(Children... children) {
+        static_assert(((!detail::is_cell<Children>::value && !detail::is_dock_child<Children>::value) && ...),
+                      "canvas children are placed with ui::placed");
+
+        canvas_spec<no_binding, Children...> spec;
+        spec.children = std::tuple<Children...>(children...);
+        return spec;
+    }
+
+    // Element counts of a tree, known while compiling
+    template<typename Tree>
+    inline constexpr std::size_t control_count = Tree::control_count;
+
+    template<typename Tree>
+    inline constexpr std::size_t panel_count = Tree::panel_count;
+}
+
+#endif // WPP_LAYOUT_UI_TREE_HPP
@@ -0,0 +1,18 @@
+#ifndef WPP_MODEL_HPP
+#define WPP_MODEL_HPP
+
+// Data models behind virtual controls
+#include "model/list_view_source.hpp"
+#include "model/paged_list_source.hpp"
+#include "model/parallel_sort.hpp"
+#include "model/column_model.hpp"
+#include "model/filter_index.hpp"
+#include "model/keyed_diff.hpp"
+#include "model/tree_diff.hpp"
+#include "model/lazy_tree_loader.hpp"
+#include "model/tree_index.hpp"
+#include "model/selection_bitmap.hpp"
+#include "model/list_box_source.hpp"
+#include "model/bulk_insert.hpp"
+
+#endif // WPP_MODEL_HPP
@@ -0,0 +1,63 @@
+#ifndef WPP_MODEL_BULK_INSERT_HPP
+#define WPP_MODEL_BULK_INSERT_HPP
+
+// Helpers for filling an item control from a range in one pass: elements are projected to text on the fly
+// instead of being copied into a vector of strings first, the text bytes are totalled so the control can
+// reserve its storage once, and the fill is timed. Free of Win32.
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace wpp::model
+{
+    // Default projection: the element is its own text (a string, string view or C string)
+    struct as_text {
+        template<typename T>
+        const T& operator()(const T& item) const { return item; }
+    };
+
+    // Projected text as the NUL-terminated pointer a control message wants. Strings and C strings are passed
+    // through; views are copied into one buffer reused for every item, so a fill allocates at most a few times.
+    template<typename CharT>
+    class terminated_text {
+    public:
+        const CharT* operator()(const CharT* text) { return text ? text : m_buffer.assign(0, CharT{}).c_str(); }
+        const CharT* operator()(const std::basic_string<CharT>& text) { return text.c_str(); }
+        const CharT* operator()(std::basic_string_view<CharT> text) { return m_buffer.assign(text).c_str(); }
+
+        static std::size_t size(const CharT* text) { return text ? std::char_traits<CharT>::length(text) : 0; }
+        static std::size_t size(const std::basic_string<CharT>& text) { return text.size(); }
+        static std::size_t size(std::basic_string_view<CharT> text) { return text.size(); }
+
+    private:
+        std::basic_string<CharT> m_buffer;
+    };
+
+    // Bytes needed for the texts of `items`, terminators included (what LB_INITSTORAGE and CB_INITSTORAGE take)
+    template<typename CharT, typename Range, typename TextFn>
+    std::size_t total_text_bytes(const Range& items, TextFn& text_of) {
+        std::size_t characters = 0;
+        for (const auto& item : items)
+            characters += terminated_text<CharT>::size(text_of(item)) + 1;
+        return characters * sizeof(CharT);
+    }
+
+    struct bulk_insert_result {
+        std::size_t requested = 0;          // elements in the range
+        std::size_t inserted = 0;           // items added before the control refused one, if it did
+        int last_index = -1;                // index of the last item added, or -1
+        std::size_t text_bytes = 0;         // text handed to the control, terminators included
+        std::chrono::nanoseconds elapsed{};
+
+        bool complete() const { return inserted == requested; }
+
+        double items_per_second() const {
+            double seconds = std::chrono::duration<double>(elapsed).count();
+            return seconds > 0 ? static_cast<double>(inserted) / seconds : 0.0;
+        }
+    };
+}
+
+#endif // WPP_MODEL_BULK_INSERT_HPP
@@ -0,0 +1,345 @@
+#ifndef WPP_MODEL_COLUMN_MODEL_HPP
+#define WPP_MODEL_COLUMN_MODEL_HPP
+
+// Typed, column-oriented table for large lists. Each column is stored contiguously (numbers in one array,
+// all text of a column in one buffer), and the displayed order is a permutation of row indices, so sorting
+// moves 4-byte indices instead of rows and never calls back into a control. Text columns are compared through
+// byte collation keys built once per column, with an 8-byte prefix per row that settles most comparisons.
+// Free of Win32; list_view supplies a locale collation on Windows.
+
+#include "list_view_source.hpp"
+#include "parallel_sort.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace wpp::model
+{
+    enum class column_type {
+        integer,
+        real,
+        text,
+        date            // integer ticks; displayed through the column's formatter
+    };
+
+    struct sort_key {
+        std::size_t column = 0;
+        bool descending = false;
+    };
+
+    template<typename CharT>
+    class basic_column_model {
+    public:
+        using string_type = std::basic_string<CharT>;
+        using string_view_type = std::basic_string_view<CharT>;
+        using row_index = std::uint32_t;
+
+        // One cell of append_row: integer and date columns take integers, real columns numbers, text columns text
+        using cell = std::variant<std::int64_t, double, string_view_type>;
+
+        // Byte string whose memcmp order is the wanted text order
+        using collation_function = std::function<std::string(string_view_type text)>;
+
+        // Display text of an integer or date cell
+        using integer_formatter = std::function<std::size_t(std::int64_t value, CharT* buffer, std::size_t capacity)>;
+
+        // Code units with ASCII case folded, big-endian, so memcmp orders like a case-insensitive ordinal compare
+        static std::string ordinal_collation(string_view_type text) {
+            std::string key;
+            key.reserve(text.size() * sizeof(CharT));
+            for (CharT c : text) {
+                auto unit = static_cast<std::make_unsigned_t<CharT>>(c);
+                if (unit >= 'A' && unit <= 'Z')
+                    unit = static_cast<decltype(unit)>(unit + ('a' - 'A'));
+                for (int shift = (sizeof(CharT) - 1) * 8; shift >= 0; shift -= 8)
+                    key.push_back(static_cast<char>((unit >> shift) & 0xFF));
+            }
+            return key;
+        }
+
+        basic_column_model() = default;
+
+        std::size_t add_column(column_type type) {
+            m_columns.push_back(std::make_unique<column>());
+            m_columns.back()->type = type;
+            m_columns.back()->text_offsets.push_back(0);
+            return m_columns.size() - 1;
+        }
+
+        std::size_t column_count() const { return m_columns.size(); }
+        column_type get_column_type(std::size_t column) const { return m_columns[column]->type; }
+        std::size_t row_count() const { return m_row_count; }
+
+        void reserve(std::size_t rows) {
+            for (auto& c : m_columns) {
+                if (c->type == column_type::real)
+                    c->reals.reserve(rows);
+                else if (c->type == column_type::text)
+                    c->text_offsets.reserve(rows + 1);
+                else
+                    c->integers.reserve(rows);
+            }
+            m_order.reserve(rows);
+        }
+
+        // Append a row, one cell per column in column order. Cells of the wrong kind are converted;
+        // missing cells are zero or empty. New rows are appended to the current order.
+        void append_row(std::initializer_list<cell> cells) {
+            auto it = cells.begin();
+            for (auto& c : m_columns) {
+                const cell* value = it != cells.end() ? &*it++ : nullptr;
+                switch (c->type) {
+                case column_type::real:
+                    c->reals.push_back(value ? as_real(*value) : 0.0);
+                    break;
+                case column_type::text: {
+                    string_view_type text = value && std::holds_alternative<string_view_type>(*value) ? std::get<string_view_type>(*value) : string_view_type{};
+                    c->chars.append(text);
+                    c->text_offsets.push_back(static_cast<std::uint32_t>(c->chars.size()));
+                    break;
+                }
+                default:
+                    c->integers.push_back(value ? as_integer(*value) : 0);
+                    break;
+                }
+            }
+            m_order.push_back(static_cast<row_index>(m_row_count++));
+        }
+
+        void clear() {
+            for (auto& c : m_columns) {
+                c->integers.clear();
+                c->reals.clear();
+                c->chars.clear();
+                c->text_offsets.assign(1, 0);
+                c->keys.clear();
+                c->key_offsets.clear();
+                c->key_prefixes.clear();
+                c->keyed_rows = 0;
+            }
+            m_order.clear();
+            m_row_count = 0;
+        }
+
+        // Cells by model row
+        std::int64_t integer(std::size_t column, std::size_t row) const { return m_columns[column]->integers[row]; }
+        double real(std::size_t column, std::size_t row) const { return m_columns[column]->reals[row]; }
+        string_view_type text(std::size_t column, std::size_t row) const { return text_of(*m_columns[column], row); }
+
+        // Display order: view row -> model row
+        std::size_t model_row(std::size_t view_row) const { return m_order[view_row]; }
+        std::span<const row_index> order() const { return m_order; }
+        void reset_order() { std::iota(m_order.begin(), m_order.end(), row_index{ 0 }); }
+
+        // Collation for text columns; changing it drops the keys built so far
+        void set_collation(collation_function collation) {
+            m_collation = std::move(collation);
+            for (auto& c : m_columns) {
+                c->keys.clear();
+                c->key_offsets.clear();
+                c->key_prefixes.clear();
+                c->keyed_rows = 0;
+            }
+        }
+
+        void set_formatter(std::size_t column, integer_formatter formatter) { m_columns[column]->formatter = std::move(formatter); }
+
+        // Write the display text of a cell (by model row) into a caller buffer
+        std::size_t format(std::size_t column, std::size_t row, CharT* buffer, std::size_t capacity) const {
+            if (column >= m_columns.size() || row >= m_row_count)
+                return copy_text(string_view_type{}, buffer, capacity);
+
+            const auto& c = *m_columns[column];
+            if (c.type == column_type::text)
+                return copy_text(text(column, row), buffer, capacity);
+            if (c.type != column_type::real && c.formatter)
+                return c.formatter(c.integers[row], buffer, capacity);
+
+            char digits[32];
+            auto result = c.type == column_type::real
+                ? std::to_chars(digits, digits + sizeof(digits), c.reals[row])
+                : std::to_chars(digits, digits + sizeof(digits), c.integers[row]);
+            CharT widened[32];
+            std::size_t length = static_cast<std::size_t>(result.ptr - digits);
+            for (std::size_t i = 0; i < length; ++i)
+                widened[i] = static_cast<CharT>(digits[i]);
+            return copy_text(string_view_type(widened, length), buffer, capacity);
+        }
+
+        // Stable sort of the display order by several keys, most significant first; rows equal on every key keep
+        // their current relative order. Collation keys of text columns are built on first use (in parallel).
+        void sort(std::span<const sort_key> keys, thread_pool* pool = &thread_pool::shared()) {
+            if (keys.empty())
+                return;
+            for (const sort_key& key : keys) {
+                if (key.column >= m_columns.size())
+                    return;
+                if (m_columns[key.column]->type == column_type::text)
+                    build_keys(*m_columns[key.column], pool);
+            }
+
+            parallel_stable_sort(m_order.begin(), m_order.end(), [this, keys](row_index a, row_index b) {
+                for (const sort_key& key : keys) {
+                    int order = compare(*m_columns[key.column], a, b);
+                    if (order != 0)
+                        return key.descending ? order > 0 : order < 0;
+                }
+                return false;
+            }, pool);
+        }
+
+        void sort(std::initializer_list<sort_key> keys, thread_pool* pool = &thread_pool::shared()) {
+            sort(std::span<const sort_key>(keys.begin(), keys.size()), pool);
+        }
+
+    private:
+        struct column {
+            column_type type = column_type::integer;
+            std::vector<std::int64_t> integers;         // integer and date
+            std::vector<double> reals;
+            string_type chars;                          // all text of the column
+            std::vector<std::uint32_t> text_offsets;    // row r is chars[text_offsets[r], text_offsets[r + 1])
+            integer_formatter formatter;
+
+            // Collation keys of rows [0, keyed_rows)
+            std::string keys;
+            std::vector<std::uint32_t> key_offsets;     // keyed_rows + 1 entries once built
+            std::vector<std::uint64_t> key_prefixes;    // first 8 key bytes, big-endian
+            std::size_t keyed_rows = 0;
+        };
+
+        static std::int64_t as_integer(const cell& value) {
+            if (auto* i = std::get_if<std::int64_t>(&value))
+                return *i;
+            if (auto* d = std::get_if<double>(&value))
+                return static_cast<std::int64_t>(*d);
+            return 0;
+        }
+
+        static double as_real(const cell& value) {
+            if (auto* d = std::get_if<double>(&value))
+                return *d;
+            if (auto* i = std::get_if<std::int64_t>(&value))
+                return static_cast<double>(*i);
+            return 0.0;
+        }
+
+        static std::uint64_t prefix_of(const char* key, std::size_t length) {
+            std::uint64_t prefix = 0;
+            for (std::size_t i = 0; i < 8; ++i)
+                prefix = (prefix << 8) | (i < length ? static_cast<unsigned char>(key[i]) : 0u);
+            return prefix;
+        }
+
+        int compare(const column& c, row_index a, row_index b) const {
+            switch (c.type) {
+            case column_type::real:
+                return c.reals[a] < c.reals[b] ? -1 : (c.reals[b] < c.reals[a] ? 1 : 0);
+            case column_type::text: {
+                if (c.key_prefixes[a] != c.key_prefixes[b])
+                    return c.key_prefixes[a] < c.key_prefixes[b] ? -1 : 1;
+                std::size_t length_a = c.key_offsets[a + 1] - c.key_offsets[a];
+                std::size_t length_b = c.key_offsets[b + 1] - c.key_offsets[b];
+                if (length_a <= 8 && length_b <= 8)
+                    return length_a < length_b ? -1 : (length_b < length_a ? 1 : 0); // zero padding hid the length
+                int order = std::memcmp(c.keys.data() + c.key_offsets[a], c.keys.data() + c.key_offsets[b], (std::min)(length_a, length_b));
+                if (order != 0)
+                    return order;
+                return length_a < length_b ? -1 : (length_b < length_a ? 1 : 0);
+            }
+            default:
+                return c.integers[a] < c.integers[b] ? -1 : (c.integers[b] < c.integers[a] ? 1 : 0);
+            }
+        }
+
+        // Build the collation keys of rows appended since the last build, in parallel chunks
+        void build_keys(column& c, thread_pool* pool) {
+            std::size_t first = c.keyed_rows;
+            if (first >= m_row_count)
+                return;
+
+            collation_function collation = m_collation ? m_collation : collation_function(&basic_column_model::ordinal_collation);
+            std::size_t count = m_row_count - first;
+            std::size_t chunks = pool && count >= 4096 ? (std::max)(std::size_t{ 1 }, static_cast<std::size_t>(pool->size()) * 2) : 1;
+
+            struct chunk_keys {
+                std::string keys;
+                std::vector<std::uint32_t> lengths;
+            };
+            std::vector<chunk_keys> built(chunks);
+            {
+                task_group group(chunks > 1 ? pool : nullptr);
+                for (std::size_t i = 0; i < chunks; ++i) {
+                    group.run([&, i] {
+                        std::size_t lo = first + count * i / chunks, hi = first + count * (i + 1) / chunks;
+                        built[i].lengths.reserve(hi - lo);
+                        for (std::size_t row = lo; row < hi; ++row) {
+                            std::string key = collation(text_of(c, row));
+                            built[i].keys += key;
+                            built[i].lengths.push_back(static_cast<std::uint32_t>(key.size()));
+                        }
+                    });
+                }
+            }
+
+            if (c.key_offsets.empty())
+                c.key_offsets.push_back(0);
+            c.key_offsets.reserve(m_row_count + 1);
+            c.key_prefixes.reserve(m_row_count);
+            for (auto& chunk : built) {
+                std::size_t base = c.keys.size();
+                c.keys += chunk.keys;
+                std::size_t offset = base;
+                for (std::uint32_t length : chunk.lengths) {
+                    c.key_prefixes.push_back(prefix_of(c.keys.data() + offset, length));
+                    offset += length;
+                    c.key_offsets.push_back(static_cast<std::uint32_t>(offset));
+                }
+            }
+            c.keyed_rows = m_row_count;
+        }
+
+        static string_view_type text_of(const column& c, std::size_t row) {
+            return string_view_type(c.chars.data() + c.text_offsets[row], c.text_offsets[row + 1] - c.text_offsets[row]);
+        }
+
+        std::vector<std::unique_ptr<column>> m_columns;
+        std::vector<row_index> m_order;
+        std::size_t m_row_count = 0;
+        collation_function m_collation;
+    };
+
+    // Presents a column model to an owner-data list_view in its current sort order. After sorting the model,
+    // repaint the list (its row count is unchanged).
+    template<typename CharT>
+    class column_list_source : public basic_list_view_source<CharT> {
+    public:
+        explicit column_list_source(std::shared_ptr<const basic_column_model<CharT>> model) : m_model(std::move(model)) {}
+
+        std::size_t row_count() const override { return m_model ? m_model->row_count() : 0; }
+
+        std::size_t cell_text(std::size_t row, int column, CharT* buffer, std::size_t capacity) const override {
+            if (!m_model || row >= m_model->row_count() || column < 0)
+                return copy_text(std::basic_string_view<CharT>{}, buffer, capacity);
+            return m_model->format(static_cast<std::size_t>(column), m_model->model_row(row), buffer, capacity);
+        }
+
+        const std::shared_ptr<const basic_column_model<CharT>>& get_model() const { return m_model; }
+
+    private:
+        std::shared_ptr<const basic_column_model<CharT>> m_model;
+    };
+}
+
+#endif // WPP_MODEL_COLUMN_MODEL_HPP
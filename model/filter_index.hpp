@@ -0,0 +1,433 @@
+#ifndef WPP_MODEL_FILTER_INDEX_HPP
+#define WPP_MODEL_FILTER_INDEX_HPP
+
+// Type-to-filter over a column model. Searchable columns are case folded once into one contiguous buffer per
+// column; indexed columns also get a trigram index (for "contains") and a sorted row table (for "starts with").
+// A query picks the cheapest way to its answer: the index, a single scan of the column buffer, or, when it only
+// extends the previous query, re-checking the previous matches. The result is a list of model rows in the model's
+// display order, shown through filtered_list_source. Free of Win32.
+
+#include "column_model.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace wpp::model
+{
+    enum class match_mode {
+        contains,
+        prefix
+    };
+
+    template<typename CharT>
+    class basic_filter_index {
+    public:
+        using model_type = basic_column_model<CharT>;
+        using string_type = std::basic_string<CharT>;
+        using string_view_type = std::basic_string_view<CharT>;
+        using row_index = typename model_type::row_index;
+        using fold_function = CharT(*)(CharT);
+
+        // How the last query was answered
+        enum class strategy {
+            all,            // empty query
+            unchanged,      // same query as before
+            index,          // trigram postings or prefix table, then verified
+            scan,           // full scan of the column buffers
+            narrow          // previous matches re-checked
+        };
+
+        struct statistics {
+            strategy last = strategy::all;
+            std::size_t candidates = 0;     // rows checked against the query by the last filter
+        };
+
+        static CharT ascii_fold(CharT c) {
+            return c >= CharT('A') && c <= CharT('Z') ? static_cast<CharT>(c + (CharT('a') - CharT('A'))) : c;
+        }
+
+        explicit basic_filter_index(std::shared_ptr<const model_type> model, fold_function fold = &ascii_fold)
+            : m_model(std::move(model)), m_fold(fold ? fold : &ascii_fold) {
+        }
+
+        // Make a column searchable. Indexed columns answer long queries without scanning but take memory
+        // (about one 4-byte posting per distinct trigram per row); call rebuild() afterwards.
+        void add_column(std::size_t column, bool indexed = true) {
+            searchable_column& added = m_columns.emplace_back();
+            added.column = column;
+            added.indexed = indexed;
+        }
+
+        // Refold and reindex every searchable column from the model, in parallel per column, and clear the filter.
+        // Needed after rows are added, removed or edited.
+        void rebuild(thread_pool* pool = &thread_pool::shared()) {
+            {
+                task_group group(pool);
+                for (auto& c : m_columns)
+                    group.run([this, &c, pool] { build_column(c, pool); });
+            }
+            m_row_count = m_model ? m_model->row_count() : 0;
+            m_matched.assign((m_row_count + 63) / 64, 0);
+            m_query.clear();
+            m_has_query = false;
+            show_all();
+        }
+
+        // Filter the rows; a row matches when any searchable column matches. Returns the number of matching rows.
+        std::size_t filter(string_view_type query, match_mode mode = match_mode::contains, thread_pool* pool = &thread_pool::shared()) {
+            string_type folded(query);
+            for (CharT& c : folded)
+                c = m_fold(c);
+
+            if (folded.empty()) {
+                m_query.clear();
+                m_has_query = false;
+                show_all();
+                return m_view.size();
+            }
+            if (m_has_query && mode == m_mode && folded == m_query) {
+                m_statistics.last = strategy::unchanged;
+                m_statistics.candidates = 0;
+                return m_view.size();
+            }
+
+            bool can_narrow = m_has_query && mode == m_mode
+                && (mode == match_mode::contains ? folded.find(m_query) != string_type::npos : folded.starts_with(m_query));
+            m_query = std::move(folded);
+            m_mode = mode;
+            m_has_query = true;
+
+            if (can_narrow && m_view.size() <= fresh_cost())
+                narrow(pool);
+            else
+                search(pool);
+            return m_view.size();
+        }
+
+        void clear_filter() {
+            m_query.clear();
+            m_has_query = false;
+            show_all();
+        }
+
+        // Matching model rows in display order; view row -> model row
+        std::span<const row_index> view() const { return m_view; }
+        std::size_t view_size() const { return m_view.size(); }
+        std::size_t model_row(std::size_t view_row) const { return m_view[view_row]; }
+
+        bool is_match(std::size_t row) const {
+            return !m_has_query || (row < m_row_count && (m_matched[row / 64] >> (row % 64) & 1));
+        }
+
+        // The model was re-sorted; put the matches in its new order without searching again
+        void refresh_order() {
+            m_view.clear();
+            for (row_index row : order())
+                if (is_match(row))
+                    m_view.push_back(row);
+        }
+
+        const std::shared_ptr<const model_type>& get_model() const { return m_model; }
+        const string_type& get_query() const { return m_query; }
+        const statistics& get_statistics() const { return m_statistics; }
+
+    private:
+        struct searchable_column {
+            std::size_t column = 0;
+            bool indexed = true;
+
+            string_type text;                           // folded rows, each followed by a NUL so matches stay in one row
+            std::vector<std::uint32_t> offsets;         // row r starts at text[offsets[r]]; row_count + 1 entries
+
+            std::unordered_map<std::uint64_t, std::uint32_t> trigram_ids;
+            std::vector<std::uint32_t> posting_offsets; // postings of trigram id t are [posting_offsets[t], posting_offsets[t + 1])
+            std::vector<row_index> postings;            // ascending rows per trigram
+            std::vector<row_index> sorted_rows;         // rows ordered by folded text, for prefix queries
+        };
+
+        static constexpr std::size_t gram = 3;
+
+        string_view_type row_text(const searchable_column& c, std::size_t row) const {
+            return string_view_type(c.text.data() + c.offsets[row], c.offsets[row + 1] - c.offsets[row] - 1);
+        }
+
+        static std::uint64_t trigram_key(const CharT* text) {
+            std::uint64_t key = 0;
+            for (std::size_t i = 0; i < gram; ++i)
+                key = (key << 21) | static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<CharT>>(text[i]));
+            return key;
+        }
+
+        std::span<const row_index> order() const {
+            return m_model ? m_model->order() : std::span<const row_index>{};
+        }
+
+        void show_all() {
+            auto rows = order();
+            m_view.assign(rows.begin(), rows.end());
+            m_statistics.last = strategy::all;
+            m_statistics.candidates = 0;
+        }
+
+        void build_column(searchable_column& c, thread_pool* pool) {
+            std::size_t rows = m_model ? m_model->row_count() : 0;
+            c.text.clear();
+            c.offsets.clear();
+            c.offsets.reserve(rows + 1);
+            c.trigram_ids.clear();
+            c.posting_offsets.clear();
+            c.postings.clear();
+            c.sorted_rows.clear();
+
+            bool is_text = m_model && c.column < m_model->column_count() && m_model->get_column_type(c.column) == column_type::text;
+            CharT cell[64];
+            for (std::size_t row = 0; row < rows; ++row) {
+                c.offsets.push_back(static_cast<std::uint32_t>(c.text.size()));
+                string_view_type text = is_text ? m_model->text(c.column, row)
+                    : string_view_type(cell, m_model->format(c.column, row, cell, std::size(cell)));
+                for (CharT ch : text)
+                    c.text.push_back(m_fold(ch));
+                c.text.push_back(CharT{});
+            }
+            c.offsets.push_back(static_cast<std::uint32_t>(c.text.size()));
+            if (!c.indexed)
+                return;
+
+            // Trigram postings in two passes over the rows: assign ids and count, then fill. Rows are visited in
+            // order, so every posting list comes out sorted.
+            std::vector<std::uint32_t> row_ids;         // distinct trigram ids of each row, concatenated
+            std::vector<std::uint32_t> row_id_ends;
+            std::vector<std::uint32_t> counts;
+            std::vector<std::uint64_t> keys;
+            row_id_ends.reserve(rows);
+            for (std::size_t row = 0; row < rows; ++row) {
+                string_view_type text = row_text(c, row);
+                keys.clear();
+                for (std::size_t i = 0; i + gram <= text.size(); ++i)
+                    keys.push_back(trigram_key(text.data() + i));
+                std::sort(keys.begin(), keys.end());
+                keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+                for (std::uint64_t key : keys) {
+                    auto [it, added] = c.trigram_ids.try_emplace(key, static_cast<std::uint32_t>(counts.size()));
+                    if (added)
+                        counts.push_back(0);
+                    counts[it->second]++;
+                    row_ids.push_back(it->second);
+                }
+                row_id_ends.push_back(static_cast<std::uint32_t>(row_ids.size()));
+            }
+
+            c.posting_offsets.resize(counts.size() + 1);
+            c.posting_offsets[0] = 0;
+            for (std::size_t id = 0; id < counts.size(); ++id)
+                c.posting_offsets[id + 1] = c.posting_offsets[id] + counts[id];
+            c.postings.resize(row_ids.size());
+            std::vector<std::uint32_t> cursor(c.posting_offsets.begin(), c.posting_offsets.end() - 1);
+            std::size_t begin = 0;
+            for (std::size_t row = 0; row < rows; ++row) {
+                for (std::size_t i = begin; i < row_id_ends[row]; ++i)
+                    c.postings[cursor[row_ids[i]]++] = static_cast<row_index>(row);
+                begin = row_id_ends[row];
+            }
+
+            c.sorted_rows.resize(rows);
+            std::iota(c.sorted_rows.begin(), c.sorted_rows.end(), row_index{ 0 });
+            parallel_stable_sort(c.sorted_rows.begin(), c.sorted_rows.end(), [this, &c](row_index a, row_index b) {
+                return row_text(c, a) < row_text(c, b);
+            }, pool);
+        }
+
+        // Rows a fresh search of one column would check, for choosing between searching and narrowing
+        std::size_t column_cost(const searchable_column& c) const {
+            if (!c.indexed)
+                return m_row_count;
+            if (m_mode == match_mode::prefix)
+                return 0;
+            if (m_query.size() < gram)
+                return m_row_count;
+            return smallest_posting(c).size();
+        }
+
+        std::size_t fresh_cost() const {
+            std::size_t cost = 0;
+            for (const auto& c : m_columns)
+                cost += column_cost(c);
+            return cost;
+        }
+
+        // The shortest posting list among the query's trigrams; empty when some trigram never occurs
+        std::span<const row_index> smallest_posting(const searchable_column& c) const {
+            std::span<const row_index> best;
+            bool found = false;
+            for (std::size_t i = 0; i + gram <= m_query.size(); ++i) {
+                auto it = c.trigram_ids.find(trigram_key(m_query.data() + i));
+                if (it == c.trigram_ids.end())
+                    return {};
+                std::span<const row_index> list(c.postings.data() + c.posting_offsets[it->second],
+                                                c.posting_offsets[it->second + 1] - c.posting_offsets[it->second]);
+                if (!found || list.size() < best.size()) {
+                    best = list;
+                    found = true;
+                }
+            }
+            return best;
+        }
+
+        bool matches(const searchable_column& c, std::size_t row) const {
+            string_view_type text = row_text(c, row);
+            return m_mode == match_mode::prefix ? text.starts_with(m_query) : text.find(m_query) != string_view_type::npos;
+        }
+
+        void mark(std::size_t row) { m_matched[row / 64] |= std::uint64_t{ 1 } << (row % 64); }
+
+        // Search every column from scratch, collecting matches in the bitmap, then lay them out in display order
+        void search(thread_pool* pool) {
+            std::fill(m_matched.begin(), m_matched.end(), 0);
+            std::size_t candidates = 0;
+            bool scanned = false;
+
+            for (const auto& c : m_columns) {
+                if (c.indexed && m_mode == match_mode::prefix) {
+                    auto first = std::lower_bound(c.sorted_rows.begin(), c.sorted_rows.end(), m_query, [&](row_index row, const string_type& query) {
+                        return row_text(c, row) < string_view_type(query);
+                    });
+                    for (auto it = first; it != c.sorted_rows.end() && row_text(c, *it).starts_with(m_query); ++it) {
+                        mark(*it);
+                        candidates++;
+                    }
+                } else if (c.indexed && m_query.size() >= gram) {
+                    for (row_index row : smallest_posting(c)) {
+                        if (matches(c, row))
+                            mark(row);
+                        candidates++;
+                    }
+                } else {
+                    candidates += scan(c, pool);
+                    scanned = true;
+                }
+            }
+
+            m_statistics.last = scanned ? strategy::scan : strategy::index;
+            m_statistics.candidates = candidates;
+            refresh_order();
+        }
+
+        // Scan a column's buffer in parallel row ranges. "Contains" runs one find over each range's contiguous
+        // text, which the standard library does with vectorized character searches; a hit skips to the next row.
+        std::size_t scan(const searchable_column& c, thread_pool* pool) {
+            std::size_t chunks = pool && m_row_count >= 65536 ? (std::max)(std::size_t{ 1 }, static_cast<std::size_t>(pool->size()) * 2) : 1;
+            std::vector<std::vector<row_index>> found(chunks);
+            {
+                task_group group(chunks > 1 ? pool : nullptr);
+                for (std::size_t i = 0; i < chunks; ++i) {
+                    group.run([&, i] {
+                        std::size_t lo = m_row_count * i / chunks, hi = m_row_count * (i + 1) / chunks;
+                        if (m_mode == match_mode::prefix) {
+                            for (std::size_t row = lo; row < hi; ++row)
+                                if (row_text(c, row).starts_with(m_query))
+                                    found[i].push_back(static_cast<row_index>(row));
+                            return;
+                        }
+
+                        string_view_type text(c.text.data() + c.offsets[lo], c.offsets[hi] - c.offsets[lo]);
+                        auto row_end = c.offsets.begin() + lo + 1;
+                        std::size_t position = 0;
+                        while ((position = text.find(m_query, position)) != string_view_type::npos) {
+                            std::uint32_t absolute = static_cast<std::uint32_t>(c.offsets[lo] + position);
+                            row_end = std::upper_bound(row_end, c.offsets.begin() + hi + 1, absolute);
+                            std::size_t row = static_cast<std::size_t>(row_end - c.offsets.begin()) - 1;
+                            found[i].push_back(static_cast<row_index>(row));
+                            position = *row_end - c.offsets[lo];
+                        }
+                    });
+                }
+            }
+
+            for (const auto& rows : found)
+                for (row_index row : rows)
+                    mark(row);
+            return m_row_count;
+        }
+
+        // The query extends the previous one, so only the previous matches can still match
+        void narrow(thread_pool* pool) {
+            std::size_t count = m_view.size();
+            std::size_t chunks = pool && count >= 65536 ? (std::max)(std::size_t{ 1 }, static_cast<std::size_t>(pool->size()) * 2) : 1;
+            std::vector<std::vector<row_index>> kept(chunks);
+            {
+                task_group group(chunks > 1 ? pool : nullptr);
+                for (std::size_t i = 0; i < chunks; ++i) {
+                    group.run([&, i] {
+                        std::size_t lo = count * i / chunks, hi = count * (i + 1) / chunks;
+                        for (std::size_t v = lo; v < hi; ++v) {
+                            row_index row = m_view[v];
+                            for (const auto& c : m_columns) {
+                                if (matches(c, row)) {
+                                    kept[i].push_back(row);
+                                    break;
+                                }
+                            }
+                        }
+                    });
+                }
+            }
+
+            for (row_index row : m_view)
+                m_matched[row / 64] &= ~(std::uint64_t{ 1 } << (row % 64));
+            m_view.clear();
+            for (const auto& rows : kept) {
+                for (row_index row : rows) {
+                    mark(row);
+                    m_view.push_back(row);
+                }
+            }
+
+            m_statistics.last = strategy::narrow;
+            m_statistics.candidates = count;
+        }
+
+        std::shared_ptr<const model_type> m_model;
+        fold_function m_fold;
+        std::vector<searchable_column> m_columns;
+        std::size_t m_row_count = 0;
+
+        string_type m_query;                    // folded
+        match_mode m_mode = match_mode::contains;
+        bool m_has_query = false;
+        std::vector<std::uint64_t> m_matched;   // one bit per model row
+        std::vector<row_index> m_view;
+        statistics m_statistics;
+    };
+
+    // Presents the rows passing a filter to an owner-data list_view, in the model's display order. After
+    // filtering, send the new row count to the list (list_view::source_changed).
+    template<typename CharT>
+    class filtered_list_source : public basic_list_view_source<CharT> {
+    public:
+        explicit filtered_list_source(std::shared_ptr<const basic_filter_index<CharT>> filter) : m_filter(std::move(filter)) {}
+
+        std::size_t row_count() const override { return m_filter ? m_filter->view_size() : 0; }
+
+        std::size_t cell_text(std::size_t row, int column, CharT* buffer, std::size_t capacity) const override {
+            if (!m_filter || !m_filter->get_model() || row >= m_filter->view_size() || column < 0)
+                return copy_text(std::basic_string_view<CharT>{}, buffer, capacity);
+            return m_filter->get_model()->format(static_cast<std::size_t>(column), m_filter->model_row(row), buffer, capacity);
+        }
+
+        const std::shared_ptr<const basic_filter_index<CharT>>& get_filter() const { return m_filter; }
+
+    private:
+        std::shared_ptr<const basic_filter_index<CharT>> m_filter;
+    };
+}
+
+#endif // WPP_MODEL_FILTER_INDEX_HPP
@@ -0,0 +1,167 @@
+#ifndef WPP_MODEL_KEYED_DIFF_HPP
+#define WPP_MODEL_KEYED_DIFF_HPP
+
+// Minimal edit script between two keyed sequences, for updating list controls in place instead of clearing and
+// refilling them. Items are matched by key; the matched items forming the longest increasing run of old
+// positions stay where they are, every other matched item is moved, and only changed content is rewritten.
+// Free of Win32.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace wpp::model
+{
+    // FNV-1a over text, for detecting changed rows without keeping their strings. Chain calls with the
+    // previous result as `seed` to hash several columns.
+    template<typename CharT>
+    std::uint64_t content_hash(std::basic_string_view<CharT> text, std::uint64_t seed = 14695981039346656037ull) {
+        std::uint64_t hash = seed;
+        for (CharT c : text) {
+            hash ^= static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<CharT>>(c));
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xFF; // column separator, so ("ab", "c") and ("a", "bc") differ
+        return hash * 1099511628211ull;
+    }
+
+    // Apply in this order to the old sequence: remove `removed` (descending, so indices stay valid), insert
+    // `inserted` (ascending, each at its final index), then rewrite `updated` in place.
+    struct keyed_diff {
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        std::vector<std::size_t> source;        // new index -> old index, or npos for an added item
+        std::vector<std::size_t> removed;       // old indices of deleted and moved items, descending
+        std::vector<std::size_t> inserted;      // new indices of added and moved items, ascending
+        std::vector<std::size_t> updated;       // new indices of items left in place whose content changed
+        std::size_t moved = 0;
+
+        bool empty() const { return removed.empty() && inserted.empty() && updated.empty(); }
+
+        // Whether the item at new index `index` is re-inserted from the old sequence rather than added
+        bool is_move(std::size_t index) const { return source[index] != npos; }
+
+        // Old index -> new index, or npos for removed items
+        std::vector<std::size_t> new_positions(std::size_t old_count) const {
+            std::vector<std::size_t> positions(old_count, npos);
+            for (std::size_t i = 0; i < source.size(); ++i)
+                if (source[i] != npos)
+                    positions[source[i]] = i;
+            return positions;
+        }
+    };
+
+    // Keys and content hashes of what a control shows, kept from one reconcile to the next
+    struct keyed_snapshot {
+        std::vector<std::uint64_t> keys;
+        std::vector<std::uint64_t> content;
+
+        std::size_t size() const { return keys.size(); }
+
+        void clear() {
+            keys.clear();
+            content.clear();
+        }
+    };
+
+    // Snapshot of a random-access range: key_of(item) gives an integer key, hash_of(item) its content hash
+    template<typename Range, typename KeyFn, typename HashFn>
+    keyed_snapshot make_snapshot(const Range& items, KeyFn&& key_of, HashFn&& hash_of) {
+        keyed_snapshot snapshot;
+        std::size_t count = std::size(items);
+        snapshot.keys.reserve(count);
+        snapshot.content.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& item = std::begin(items)[i];
+            snapshot.keys.push_back(static_cast<std::uint64_t>(key_of(item)));
+            snapshot.content.push_back(hash_of(item));
+        }
+        return snapshot;
+    }
+
+    namespace detail
+    {
+        // Positions in `values` of one longest strictly increasing subsequence, O(n log n)
+        inline std::vector<std::size_t> longest_increasing_run(std::span<const std::size_t> values) {
+            std::vector<std::size_t> tails;             // tails[k]: position of the smallest tail of a run of length k + 1
+            std::vector<std::size_t> previous(values.size(), keyed_diff::npos);
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                auto it = std::lower_bound(tails.begin(), tails.end(), values[i], [&](std::size_t position, std::size_t value) {
+                    return values[position] < value;
+                });
+                if (it != tails.begin())
+                    previous[i] = *(it - 1);
+                if (it == tails.end())
+                    tails.push_back(i);
+                else
+                    *it = i;
+            }
+
+            std::vector<std::size_t> run(tails.size());
+            std::size_t position = tails.empty() ? keyed_diff::npos : tails.back();
+            for (std::size_t k = run.size(); k-- > 0; position = previous[position])
+                run[k] = position;
+            return run;
+        }
+    }
+
+    // Diff two key sequences. Content hashes are optional; without them no updates are reported. A key that
+    // repeats in the new sequence matches at most one old item; the rest are added.
+    template<typename Key, typename Hash = std::hash<Key>>
+    keyed_diff diff_keyed(std::span<const Key> old_keys, std::span<const Key> new_keys,
+                          std::span<const std::uint64_t> old_content = {}, std::span<const std::uint64_t> new_content = {}) {
+        keyed_diff diff;
+        diff.source.assign(new_keys.size(), keyed_diff::npos);
+
+        std::unordered_map<Key, std::size_t, Hash> old_index;
+        old_index.reserve(old_keys.size());
+        for (std::size_t i = 0; i < old_keys.size(); ++i)
+            old_index.try_emplace(old_keys[i], i);
+
+        std::vector<bool> kept(old_keys.size());
+        std::vector<std::size_t> matched_new, matched_old;
+        matched_new.reserve(new_keys.size());
+        matched_old.reserve(new_keys.size());
+        for (std::size_t i = 0; i < new_keys.size(); ++i) {
+            auto it = old_index.find(new_keys[i]);
+            if (it == old_index.end() || kept[it->second])
+                continue;
+            kept[it->second] = true;
+            diff.source[i] = it->second;
+            matched_new.push_back(i);
+            matched_old.push_back(it->second);
+        }
+
+        // Matched items whose old positions increase along the new order keep their place
+        std::vector<bool> stays(new_keys.size());
+        for (std::size_t position : detail::longest_increasing_run(matched_old))
+            stays[matched_new[position]] = true;
+
+        std::vector<bool> leaves(old_keys.size());
+        for (std::size_t i = 0; i < new_keys.size(); ++i) {
+            if (stays[i]) {
+                if (!old_content.empty() && !new_content.empty() && old_content[diff.source[i]] != new_content[i])
+                    diff.updated.push_back(i);
+                continue;
+            }
+            diff.inserted.push_back(i);
+            if (diff.source[i] != keyed_diff::npos) {
+                leaves[diff.source[i]] = true;
+                diff.moved++;
+            }
+        }
+        for (std::size_t i = old_keys.size(); i-- > 0;)
+            if (!kept[i] || leaves[i])
+                diff.removed.push_back(i);
+        return diff;
+    }
+}
+
+#endif // WPP_MODEL_KEYED_DIFF_HPP
@@ -0,0 +1,240 @@
+#ifndef WPP_MODEL_LAZY_TREE_LOADER_HPP
+#define WPP_MODEL_LAZY_TREE_LOADER_HPP
+
+// Background enumeration of tree children on demand, for hierarchies too large to insert up front (file
+// systems, registries, remote catalogs). A provider lists the children of one node on a thread pool (by default
+// thread_pool::io(), as providers block on disks and networks) and hands them over in batches; the UI thread
+// takes the batches of loads it still wants and drops the rest, so a node collapsed or deleted while loading
+// costs nothing further. Free of Win32.
+
+#include "../thread_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wpp::model
+{
+    template<typename CharT>
+    class basic_lazy_tree_loader {
+        struct shared_state;
+
+    public:
+        using string_type = std::basic_string<CharT>;
+        using string_view_type = std::basic_string_view<CharT>;
+
+        struct child {
+            string_type text;
+            std::uint64_t data = 0;
+            bool has_children = false;          // loaded lazily in turn when expanded
+        };
+
+        // Children of one node in enumeration order; `done` marks the last batch of a load
+        struct batch {
+            std::uint64_t node = 0;
+            std::vector<child> children;
+            bool done = false;
+        };
+
+        struct options {
+            std::size_t batch_size = 256;       // children handed to the UI thread at a time
+        };
+
+        struct statistics {
+            std::uint64_t loads = 0;            // loads started
+            std::uint64_t completed = 0;        // loads whose last batch was taken
+            std::uint64_t cancelled = 0;        // loads cancelled before completing
+            std::uint64_t batches = 0;          // batches taken
+            std::uint64_t children = 0;         // children taken
+            std::uint64_t dropped = 0;          // batches of cancelled loads discarded on arrival
+        };
+
+        // Where a provider puts the children it finds. Used on the pool thread only.
+        class sink {
+        public:
+            // Set once the node was collapsed or deleted; the provider should return as soon as it sees it
+            bool cancelled() const { return m_cancelled->load(std::memory_order_relaxed); }
+
+            void add(child item) {
+                if (cancelled())
+                    return;
+                m_pending.push_back(std::move(item));
+                if (m_pending.size() >= m_batch_size)
+                    flush(false);
+            }
+
+            void add(string_view_type text, std::uint64_t data = 0, bool has_children = false) {
+                add(child{ string_type(text), data, has_children });
+            }
+
+        private:
+            friend class basic_lazy_tree_loader;
+
+            sink(std::shared_ptr<shared_state> state, std::shared_ptr<std::atomic<bool>> cancelled,
+                 std::uint64_t node, std::uint64_t ticket, std::size_t batch_size)
+                : m_state(std::move(state)), m_cancelled(std::move(cancelled)), m_node(node), m_ticket(ticket),
+                  m_batch_size(batch_size) {}
+
+            void flush(bool done) {
+                if (cancelled())
+                    return;
+                landed_batch result{ m_ticket, { m_node, std::move(m_pending), done } };
+                m_pending = {};
+
+                std::function<void()> notify;
+                {
+                    std::scoped_lock lock(m_state->mutex);
+                    bool first_landed = m_state->landed.empty();
+                    m_state->landed.push_back(std::move(result));
+                    if (first_landed)
+                        notify = m_state->notify; // one wake-up until the UI thread takes them
+                }
+                if (notify)
+                    notify();
+            }
+
+            std::shared_ptr<shared_state> m_state;
+            std::shared_ptr<std::atomic<bool>> m_cancelled;
+            std::uint64_t m_node;
+            std::uint64_t m_ticket;
+            std::size_t m_batch_size;
+            std::vector<child> m_pending;
+        };
+
+        // Runs on a pool thread; lists the children of the node whose data is `data` into `out`
+        using provider_function = std::function<void(std::uint64_t data, sink& out)>;
+
+        explicit basic_lazy_tree_loader(provider_function provider, options settings = {}, thread_pool& pool = thread_pool::io())
+            : m_options(settings), m_pool(pool), m_state(std::make_shared<shared_state>()) {
+            if (m_options.batch_size == 0)
+                m_options.batch_size = 1;
+            m_state->provider = std::move(provider);
+        }
+
+        ~basic_lazy_tree_loader() {
+            // Loads in flight keep the shared state alive; make sure they stop and notify no one
+            cancel_all();
+            std::scoped_lock lock(m_state->mutex);
+            m_state->notify = nullptr;
+        }
+
+        basic_lazy_tree_loader(const basic_lazy_tree_loader&) = delete;
+        basic_lazy_tree_loader& operator=(const basic_lazy_tree_loader&) = delete;
+
+        // Start listing the children of `node` (the caller's ID for it, e.g. an item handle), passing `data` to
+        // the provider. Returns false if the node is already loading.
+        bool load(std::uint64_t node, std::uint64_t data) {
+            auto [it, added] = m_active.try_emplace(node);
+            if (!added)
+                return false;
+
+            it->second.ticket = ++m_next_ticket;
+            it->second.cancelled = std::make_shared<std::atomic<bool>>(false);
+            m_statistics.loads++;
+
+            m_pool.submit([state = m_state, cancelled = it->second.cancelled, node, ticket = it->second.ticket,
+                           data, batch_size = m_options.batch_size] {
+                sink out(state, cancelled, node, ticket, batch_size);
+                if (!out.cancelled() && state->provider)
+                    state->provider(data, out);
+                out.flush(true);
+            });
+            return true;
+        }
+
+        // Stop loading `node`; batches already on their way are dropped. Returns false if it was not loading.
+        bool cancel(std::uint64_t node) {
+            auto it = m_active.find(node);
+            if (it == m_active.end())
+                return false;
+            it->second.cancelled->store(true, std::memory_order_relaxed);
+            m_active.erase(it);
+            m_statistics.cancelled++;
+            return true;
+        }
+
+        void cancel_all() {
+            for (auto& [node, load] : m_active)
+                load.cancelled->store(true, std::memory_order_relaxed);
+            m_statistics.cancelled += m_active.size();
+            m_active.clear();
+        }
+
+        bool is_loading(std::uint64_t node) const { return m_active.find(node) != m_active.end(); }
+        std::size_t loading_count() const { return m_active.size(); }
+
+        // Called from a pool thread whenever batches land while none were waiting
+        void set_ready_notifier(std::function<void()> notify) {
+            std::scoped_lock lock(m_state->mutex);
+            m_state->notify = std::move(notify);
+        }
+
+        // Append the batches that landed for loads still wanted, in arrival order. A load is finished, and the
+        // node no longer loading, once its batch with `done` has been taken.
+        bool take_ready(std::vector<batch>& out) {
+            std::vector<landed_batch> landed;
+            {
+                std::scoped_lock lock(m_state->mutex);
+                landed.swap(m_state->landed);
+            }
+
+            bool any = false;
+            for (auto& result : landed) {
+                auto it = m_active.find(result.contents.node);
+                if (it == m_active.end() || it->second.ticket != result.ticket) {
+                    m_statistics.dropped++; // cancelled, possibly loading again under a new ticket since
+                    continue;
+                }
+
+                if (result.contents.done) {
+                    m_active.erase(it);
+                    m_statistics.completed++;
+                }
+                m_statistics.batches++;
+                m_statistics.children += result.contents.children.size();
+                out.push_back(std::move(result.contents));
+                any = true;
+            }
+            return any;
+        }
+
+        const statistics& get_statistics() const { return m_statistics; }
+        void reset_statistics() { m_statistics = {}; }
+
+    private:
+        struct landed_batch {
+            std::uint64_t ticket = 0;
+            batch contents;
+        };
+
+        // Shared with the load tasks, which may outlive the loader
+        struct shared_state {
+            provider_function provider;
+            std::mutex mutex;                               // guards landed and notify
+            std::vector<landed_batch> landed;
+            std::function<void()> notify;
+        };
+
+        struct active_load {
+            std::uint64_t ticket = 0;
+            std::shared_ptr<std::atomic<bool>> cancelled;
+        };
+
+        options m_options;
+        thread_pool& m_pool;
+        std::shared_ptr<shared_state> m_state;
+        std::unordered_map<std::uint64_t, active_load> m_active;   // by node; UI thread only
+        std::uint64_t m_next_ticket = 0;
+        statistics m_statistics;
+    };
+}
+
+#endif // WPP_MODEL_LAZY_TREE_LOADER_HPP
@@ -0,0 +1,105 @@
+#ifndef WPP_MODEL_LIST_BOX_SOURCE_HPP
+#define WPP_MODEL_LIST_BOX_SOURCE_HPP
+
+// Data sources for virtual (LBS_NODATA) list boxes. Such a list box stores no strings at all, only a count;
+// each visible line is asked for when it is drawn, so pickers over millions of entries cost no item memory.
+// Free of Win32; list_box uses the TCHAR instantiation.
+
+#include "list_view_source.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace wpp::model
+{
+    template<typename CharT>
+    class basic_list_box_source {
+    public:
+        using char_type = CharT;
+        using string_view_type = std::basic_string_view<CharT>;
+
+        virtual ~basic_list_box_source() = default;
+
+        virtual std::size_t item_count() const = 0;
+
+        // Write the text of an item into `buffer` (see copy_text); items are below item_count()
+        virtual std::size_t item_text(std::size_t item, CharT* buffer, std::size_t capacity) const = 0;
+    };
+
+    // Items held by the application in a vector, shown through an accessor returning a view into the item.
+    // The vector is referenced, not copied; it must outlive the source.
+    template<typename Item, typename CharT>
+    class vector_list_box_source : public basic_list_box_source<CharT> {
+    public:
+        using string_view_type = std::basic_string_view<CharT>;
+        using text_accessor = std::function<string_view_type(const Item&)>;
+
+        vector_list_box_source(const std::vector<Item>& items, text_accessor text)
+            : m_items(&items), m_text(std::move(text)) {
+        }
+
+        std::size_t item_count() const override { return m_items->size(); }
+
+        std::size_t item_text(std::size_t item, CharT* buffer, std::size_t capacity) const override {
+            if (item >= m_items->size() || !m_text)
+                return copy_text(string_view_type{}, buffer, capacity);
+            return copy_text(m_text((*m_items)[item]), buffer, capacity);
+        }
+
+    private:
+        const std::vector<Item>* m_items;
+        text_accessor m_text;
+    };
+
+    // Source built from callbacks, for data that is computed or lives elsewhere
+    template<typename CharT>
+    class function_list_box_source : public basic_list_box_source<CharT> {
+    public:
+        using count_function = std::function<std::size_t()>;
+        using text_function = std::function<std::size_t(std::size_t item, CharT* buffer, std::size_t capacity)>;
+
+        function_list_box_source(count_function count, text_function text)
+            : m_count(std::move(count)), m_text(std::move(text)) {
+        }
+
+        std::size_t item_count() const override { return m_count ? m_count() : 0; }
+
+        std::size_t item_text(std::size_t item, CharT* buffer, std::size_t capacity) const override {
+            return m_text ? m_text(item, buffer, capacity) : copy_text(std::basic_string_view<CharT>{}, buffer, capacity);
+        }
+
+    private:
+        count_function m_count;
+        text_function m_text;
+    };
+
+    // One column of a list view source, so the same rows (a column_model, a filtered view) can feed a list box
+    template<typename CharT>
+    class column_list_box_source : public basic_list_box_source<CharT> {
+    public:
+        column_list_box_source(std::shared_ptr<const basic_list_view_source<CharT>> rows, int column = 0)
+            : m_rows(std::move(rows)), m_column(column) {
+        }
+
+        int column() const { return m_column; }
+        void set_column(int column) { m_column = column; }
+
+        std::size_t item_count() const override { return m_rows ? m_rows->row_count() : 0; }
+
+        std::size_t item_text(std::size_t item, CharT* buffer, std::size_t capacity) const override {
+            if (!m_rows || item >= m_rows->row_count())
+                return copy_text(std::basic_string_view<CharT>{}, buffer, capacity);
+            return m_rows->cell_text(item, m_column, buffer, capacity);
+        }
+
+    private:
+        std::shared_ptr<const basic_list_view_source<CharT>> m_rows;
+        int m_column;
+    };
+}
+
+#endif // WPP_MODEL_LIST_BOX_SOURCE_HPP
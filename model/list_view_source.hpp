@@ -0,0 +1,174 @@
+#ifndef WPP_MODEL_LIST_VIEW_SOURCE_HPP
+#define WPP_MODEL_LIST_VIEW_SOURCE_HPP
+
+// Data sources for owner-data (virtual) list views. The control keeps only a row count and its selection;
+// every cell is asked for when it is painted, so a source can hold millions of rows in whatever form suits
+// the application. Free of Win32; list_view uses the TCHAR instantiation.
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace wpp::model
+{
+    // Copy text into a caller buffer of `capacity` characters, truncating if needed; the result is always
+    // NUL-terminated when capacity > 0. Returns the number of characters written, without the terminator.
+    template<typename CharT>
+    std::size_t copy_text(std::basic_string_view<CharT> text, CharT* buffer, std::size_t capacity) {
+        if (!buffer || capacity == 0)
+            return 0;
+
+        std::size_t count = (std::min)(text.size(), capacity - 1);
+        std::copy_n(text.data(), count, buffer);
+        buffer[count] = CharT{};
+        return count;
+    }
+
+    template<typename CharT>
+    class basic_list_view_source {
+    public:
+        using char_type = CharT;
+        using string_view_type = std::basic_string_view<CharT>;
+
+        static constexpr int no_image = -1;
+
+        virtual ~basic_list_view_source() = default;
+
+        virtual std::size_t row_count() const = 0;
+
+        // Write the text of a cell into `buffer` (see copy_text); rows are below row_count()
+        virtual std::size_t cell_text(std::size_t row, int column, CharT* buffer, std::size_t capacity) const = 0;
+
+        // Image list index of a cell, or no_image
+        virtual int image(std::size_t /*row*/, int /*column*/) const { return no_image; }
+
+        // Item state bits the control does not track for owner-data rows (state image and overlay masks)
+        virtual unsigned state(std::size_t /*row*/) const { return 0; }
+
+        // Indentation of a row, in image widths
+        virtual int indent(std::size_t /*row*/) const { return 0; }
+
+        // Asynchronous sources. The control reports the rows it is about to paint, gives the source a callback
+        // that may be invoked from any thread once fetched rows are available, and then collects the rows to
+        // repaint on its own thread. Synchronous sources ignore all three.
+        virtual void cache_hint(std::size_t /*first*/, std::size_t /*last*/) {}
+        virtual void set_ready_notifier(std::function<void()> /*notify*/) {}
+        virtual bool take_ready_rows(std::size_t& /*first*/, std::size_t& /*last*/) { return false; }
+    };
+
+    // Rows held by the application in a vector, with one accessor per column returning a view into the row.
+    // The vector is referenced, not copied; it must outlive the source.
+    template<typename Row, typename CharT>
+    class vector_list_source : public basic_list_view_source<CharT> {
+    public:
+        using string_view_type = std::basic_string_view<CharT>;
+        using column_accessor = std::function<string_view_type(const Row&)>;
+
+        explicit vector_list_source(const std::vector<Row>& rows, std::vector<column_accessor> columns = {})
+            : m_rows(&rows), m_columns(std::move(columns)) {
+        }
+
+        vector_list_source& add_column(column_accessor accessor) {
+            m_columns.push_back(std::move(accessor));
+            return *this;
+        }
+
+        std::size_t column_count() const { return m_columns.size(); }
+
+        std::size_t row_count() const override { return m_rows->size(); }
+
+        std::size_t cell_text(std::size_t row, int column, CharT* buffer, std::size_t capacity) const override {
+            if (row >= m_rows->size() || column < 0 || static_cast<std::size_t>(column) >= m_columns.size())
+                return copy_text(string_view_type{}, buffer, capacity);
+            return copy_text(m_columns[column]((*m_rows)[row]), buffer, capacity);
+        }
+
+    private:
+        const std::vector<Row>* m_rows;
+        std::vector<column_accessor> m_columns;
+    };
+
+    // Source built from callbacks, for data that is computed or lives elsewhere
+    template<typename CharT>
+    class function_list_source : public basic_list_view_source<CharT> {
+    public:
+        using count_function = std::function<std::size_t()>;
+        using text_function = std::function<std::size_t(std::size_t row, int column, CharT* buffer, std::size_t capacity)>;
+        using image_function = std::function<int(std::size_t row, int column)>;
+
+        function_list_source(count_function count, text_function text, image_function image = nullptr)
+            : m_count(std::move(count)), m_text(std::move(text)), m_image(std::move(image)) {
+        }
+
+        std::size_t row_count() const override { return m_count ? m_count() : 0; }
+
+        std::size_t cell_text(std::size_t row, int column, CharT* buffer, std::size_t capacity) const override {
+            return m_text ? m_text(row, column, buffer, capacity) : copy_text(std::basic_string_view<CharT>{}, buffer, capacity);
+        }
+
+        int image(std::size_t row, int column) const override {
+            return m_image ? m_image(row, column) : basic_list_view_source<CharT>::no_image;
+        }
+
+    private:
+        count_function m_count;
+        text_function m_text;
+        image_function m_image;
+    };
+
+    // Strings stored per cell in a flat table; the simplest adapter when the data has no model of its own.
+    // One allocation per cell instead of one control item per cell.
+    template<typename CharT>
+    class table_list_source : public basic_list_view_source<CharT> {
+    public:
+        using string_type = std::basic_string<CharT>;
+
+        explicit table_list_source(std::size_t columns) : m_columns((std::max)(columns, std::size_t{ 1 })) {}
+
+        std::size_t column_count() const { return m_columns; }
+
+        void reserve(std::size_t rows) { m_cells.reserve(rows * m_columns); }
+        void clear() { m_cells.clear(); }
+
+        // Append a row; missing trailing cells are empty and extra ones are dropped
+        template<typename... Cells>
+        std::size_t add_row(Cells&&... cells) {
+            std::size_t row = row_count();
+            m_cells.resize((row + 1) * m_columns);
+            std::size_t column = 0;
+            ((column < m_columns ? void(m_cells[row * m_columns + column++] = string_type(std::forward<Cells>(cells))) : void()), ...);
+            return row;
+        }
+
+        void set_cell(std::size_t row, int column, string_type text) {
+            if (row < row_count() && column >= 0 && static_cast<std::size_t>(column) < m_columns)
+                m_cells[row * m_columns + column] = std::move(text);
+        }
+
+        const string_type& cell(std::size_t row, int column) const { return m_cells[row * m_columns + column]; }
+
+        void erase_rows(std::size_t first, std::size_t count) {
+            first = (std::min)(first, row_count());
+            count = (std::min)(count, row_count() - first);
+            m_cells.erase(m_cells.begin() + first * m_columns, m_cells.begin() + (first + count) * m_columns);
+        }
+
+        std::size_t row_count() const override { return m_cells.size() / m_columns; }
+
+        std::size_t cell_text(std::size_t row, int column, CharT* buffer, std::size_t capacity) const override {
+            if (row >= row_count() || column < 0 || static_cast<std::size_t>(column) >= m_columns)
+                return copy_text(std::basic_string_view<CharT>{}, buffer, capacity);
+            return copy_text(std::basic_string_view<CharT>(cell(row, column)), buffer, capacity);
+        }
+
+    private:
+        std::size_t m_columns;
+        std::vector<string_type> m_cells;
+    };
+}
+
+#endif // WPP_MODEL_LIST_VIEW_SOURCE_HPP
@@ -0,0 +1,346 @@
+#ifndef WPP_MODEL_PAGED_LIST_SOURCE_HPP
+#define WPP_MODEL_PAGED_LIST_SOURCE_HPP
+
+// Owner-data list source over a slow backend (database, remote service, decompression). Rows are fetched
+// in fixed-size pages on a thread pool (thread_pool::io() by default), around the range the list reports it is about to paint, and kept in
+// an LRU page cache. Display requests never block: rows still in flight show placeholder text and are
+// repainted in one batch when their pages land. Free of Win32.
+
+#include "list_view_source.hpp"
+#include "../thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace wpp::model
+{
+    // Which pages to request for a visible range, most urgent first: the visible pages, then pages ahead in
+    // the scroll direction, then pages behind it
+    struct prefetch_policy {
+        std::size_t page_size = 64;
+        std::size_t pages_ahead = 2;
+        std::size_t pages_behind = 1;
+
+        // Pages worth keeping in flight for this range; requests outside it are dropped before they start
+        void window(std::size_t first, std::size_t last, bool forward, std::size_t page_count,
+                    std::size_t& first_page, std::size_t& last_page) const {
+            std::size_t before = forward ? pages_behind : pages_ahead;
+            std::size_t after = forward ? pages_ahead : pages_behind;
+            first_page = first / page_size;
+            last_page = last / page_size;
+            first_page = first_page > before ? first_page - before : 0;
+            last_page = (std::min)(last_page + after, page_count ? page_count - 1 : 0);
+        }
+
+        // Append the pages to request for a range, in priority order
+        void plan(std::size_t first, std::size_t last, bool forward, std::size_t page_count, std::vector<std::size_t>& pages) const {
+            if (page_count == 0 || first > last)
+                return;
+
+            std::size_t visible_first = first / page_size;
+            std::size_t visible_last = (std::min)(last / page_size, page_count - 1);
+            for (std::size_t page = visible_first; page <= visible_last; ++page)
+                pages.push_back(page);
+
+            auto ahead = [&](std::size_t count) {
+                for (std::size_t i = 1; i <= count && visible_last + i < page_count; ++i)
+                    pages.push_back(visible_last + i);
+            };
+            auto behind = [&](std::size_t count) {
+                for (std::size_t i = 1; i <= count && i <= visible_first; ++i)
+                    pages.push_back(visible_first - i);
+            };
+            if (forward) {
+                ahead(pages_ahead);
+                behind(pages_behind);
+            } else {
+                behind(pages_ahead);
+                ahead(pages_behind);
+            }
+        }
+    };
+
+    // Least recently used cache of row pages. Single-threaded.
+    template<typename Row>
+    class row_page_cache {
+    public:
+        explicit row_page_cache(std::size_t capacity) : m_capacity((std::max)(capacity, std::size_t{ 1 })) {}
+
+        // Rows of a page, or nullptr; marks the page as recently used
+        const std::vector<Row>* find(std::size_t page) {
+            auto it = m_index.find(page);
+            if (it == m_index.end())
+                return nullptr;
+            m_pages.splice(m_pages.begin(), m_pages, it->second);
+            return &it->second->second;
+        }
+
+        bool contains(std::size_t page) const { return m_index.find(page) != m_index.end(); }
+
+        // Store a page, evicting the least recently used ones beyond capacity. Returns the number evicted.
+        std::size_t insert(std::size_t page, std::vector<Row> rows) {
+            auto it = m_index.find(page);
+            if (it != m_index.end()) {
+                it->second->second = std::move(rows);
+                m_pages.splice(m_pages.begin(), m_pages, it->second);
+                return 0;
+            }
+
+            m_pages.emplace_front(page, std::move(rows));
+            m_index.emplace(page, m_pages.begin());
+
+            std::size_t evicted = 0;
+            while (m_pages.size() > m_capacity) {
+                m_index.erase(m_pages.back().first);
+                m_pages.pop_back();
+                evicted++;
+            }
+            return evicted;
+        }
+
+        void clear() {
+            m_pages.clear();
+            m_index.clear();
+        }
+
+        std::size_t size() const { return m_pages.size(); }
+        std::size_t capacity() const { return m_capacity; }
+
+    private:
+        using page_list = std::list<std::pair<std::size_t, std::vector<Row>>>;
+
+        std::size_t m_capacity;
+        page_list m_pages;
+        std::unordered_map<std::size_t, typename page_list::iterator> m_index;
+    };
+
+    template<typename Row, typename CharT>
+    class paged_list_source : public basic_list_view_source<CharT> {
+    public:
+        using string_view_type = std::basic_string_view<CharT>;
+
+        // Runs on a pool thread and may block; returns up to `count` rows starting at `first`
+        using fetch_function = std::function<std::vector<Row>(std::size_t first, std::size_t count)>;
+
+        // Text of one column of a fetched row
+        using column_function = std::function<string_view_type(const Row& row, int column)>;
+
+        struct options {
+            prefetch_policy prefetch;
+            std::size_t cache_pages = 64;
+            string_view_type placeholder{};     // shown in the first column of rows still loading
+        };
+
+        struct statistics {
+            std::uint64_t hits = 0;             // cells served from the cache
+            std::uint64_t misses = 0;           // cells shown as placeholders
+            std::uint64_t requests = 0;         // pages queued for fetching
+            std::uint64_t fetches = 0;          // pages actually fetched
+            std::uint64_t skipped = 0;          // queued pages dropped because the list had scrolled away
+            std::uint64_t evictions = 0;
+            std::uint64_t batches = 0;          // take_ready_rows calls that produced rows to repaint
+        };
+
+        paged_list_source(std::size_t row_count, fetch_function fetch, column_function column,
+                          options settings = {}, thread_pool& pool = thread_pool::io())
+            : m_row_count(row_count), m_column(std::move(column)), m_options(settings),
+              m_cache(settings.cache_pages), m_pool(pool), m_state(std::make_shared<shared_state>()) {
+            if (m_options.prefetch.page_size == 0)
+                m_options.prefetch.page_size = 1;
+            m_state->fetch = std::move(fetch);
+        }
+
+        ~paged_list_source() override {
+            // In-flight fetches keep the shared state alive; make sure they neither fetch nor notify anymore
+            std::scoped_lock lock(m_state->mutex);
+            m_state->notify = nullptr;
+            m_state->generation.fetch_add(1);
+        }
+
+        paged_list_source(const paged_list_source&) = delete;
+        paged_list_source& operator=(const paged_list_source&) = delete;
+
+        std::size_t row_count() const override { return m_row_count; }
+
+        std::size_t cell_text(std::size_t row, int column, CharT* buffer, std::size_t capacity) const override {
+            if (row < m_row_count) {
+                std::size_t page = row / page_size();
+                if (const std::vector<Row>* rows = m_cache.find(page)) {
+                    std::size_t offset = row % page_size();
+                    if (offset < rows->size()) {
+                        m_statistics.hits++;
+                        return copy_text(m_column((*rows)[offset], column), buffer, capacity);
+                    }
+                } else {
+                    // Painted without a preceding cache hint (e.g. the list did not send one for this row); the row
+                    // is on screen whatever the last hint said, so the page is fetched even outside its window
+                    request(page, true);
+                }
+            }
+
+            m_statistics.misses++;
+            return copy_text(column == 0 ? m_options.placeholder : string_view_type{}, buffer, capacity);
+        }
+
+        void cache_hint(std::size_t first, std::size_t last) override {
+            if (m_row_count == 0)
+                return;
+
+            last = (std::min)(last, m_row_count - 1);
+            bool forward = first >= m_last_hint_first;
+            m_last_hint_first = first;
+
+            std::size_t first_page, last_page;
+            m_options.prefetch.window(first, last, forward, page_count(), first_page, last_page);
+            m_state->window_first.store(first_page);
+            m_state->window_last.store(last_page);
+
+            m_plan.clear();
+            m_options.prefetch.plan(first, last, forward, page_count(), m_plan);
+            for (std::size_t page : m_plan)
+                request(page, false);
+        }
+
+        void set_ready_notifier(std::function<void()> notify) override {
+            std::scoped_lock lock(m_state->mutex);
+            m_state->notify = std::move(notify);
+        }
+
+        bool take_ready_rows(std::size_t& first, std::size_t& last) override {
+            std::vector<landed_page> landed;
+            {
+                std::scoped_lock lock(m_state->mutex);
+                landed.swap(m_state->landed);
+            }
+
+            bool any = false;
+            std::uint64_t generation = m_state->generation.load();
+            std::size_t window_first = m_state->window_first.load();
+            std::size_t window_last = m_state->window_last.load();
+            for (auto& result : landed) {
+                if (result.generation != generation)
+                    continue; // invalidated while in flight; its page may have been requested again since
+                m_requested.erase(result.page);
+                if (!result.fetched) {
+                    m_statistics.skipped++;
+                    // Skipped while scrolled away, but a later hint came back to it before it was taken; that
+                    // hint found it still requested and queued nothing, so ask again or it would never load
+                    if (result.page >= window_first && result.page <= window_last)
+                        request(result.page, false);
+                    continue;
+                }
+
+                m_statistics.fetches++;
+                m_statistics.evictions += m_cache.insert(result.page, std::move(result.rows));
+
+                std::size_t page_first = result.page * page_size();
+                std::size_t page_last = (std::min)(page_first + page_size(), m_row_count) - 1;
+                if (page_first >= m_row_count)
+                    continue;
+                first = any ? (std::min)(first, page_first) : page_first;
+                last = any ? (std::max)(last, page_last) : page_last;
+                any = true;
+            }
+
+            if (any)
+                m_statistics.batches++;
+            return any;
+        }
+
+        // The backend changed: forget every cached page and ignore fetches already in flight
+        void invalidate(std::size_t row_count) {
+            m_row_count = row_count;
+            m_cache.clear();
+            m_requested.clear();
+            m_state->generation.fetch_add(1);
+        }
+
+        bool is_row_loaded(std::size_t row) const { return row < m_row_count && m_cache.contains(row / page_size()); }
+        std::size_t pending_pages() const { return m_requested.size(); }
+
+        const statistics& get_statistics() const { return m_statistics; }
+        void reset_statistics() { m_statistics = {}; }
+
+    private:
+        struct landed_page {
+            std::size_t page = 0;
+            std::uint64_t generation = 0;
+            bool fetched = false;
+            std::vector<Row> rows;
+        };
+
+        // Shared with the fetch tasks, which may outlive the source
+        struct shared_state {
+            fetch_function fetch;
+            std::mutex mutex;                               // guards landed and notify
+            std::vector<landed_page> landed;
+            std::function<void()> notify;
+            std::atomic<std::uint64_t> generation{ 0 };
+            std::atomic<std::size_t> window_first{ 0 };     // pages still wanted by the latest hint
+            std::atomic<std::size_t> window_last{ static_cast<std::size_t>(-1) };
+        };
+
+        std::size_t page_size() const { return m_options.prefetch.page_size; }
+        std::size_t page_count() const { return (m_row_count + page_size() - 1) / page_size(); }
+
+        // `pinned` pages are fetched even if a later hint moves the window away from them
+        void request(std::size_t page, bool pinned) const {
+            if (m_cache.contains(page) || !m_requested.insert(page).second)
+                return;
+
+            m_statistics.requests++;
+            std::size_t first = page * page_size();
+            std::size_t count = (std::min)(page_size(), m_row_count - first);
+            std::uint64_t generation = m_state->generation.load();
+            m_pool.submit([state = m_state, page, first, count, generation, pinned] {
+                landed_page result;
+                result.page = page;
+                result.generation = generation;
+
+                // Scrolled past while queued: drop it so the pool works on what is on screen now
+                bool wanted = state->generation.load() == generation
+                    && (pinned || (page >= state->window_first.load() && page <= state->window_last.load()));
+                if (wanted) {
+                    if (state->fetch)
+                        result.rows = state->fetch(first, count);
+                    result.fetched = true;
+                }
+
+                std::function<void()> notify;
+                {
+                    std::scoped_lock lock(state->mutex);
+                    bool first_landed = state->landed.empty();
+                    state->landed.push_back(std::move(result));
+                    if (first_landed)
+                        notify = state->notify; // one wake-up per batch; later pages join the pending one
+                }
+                if (notify)
+                    notify();
+            });
+        }
+
+        std::size_t m_row_count;
+        column_function m_column;
+        options m_options;
+        mutable row_page_cache<Row> m_cache;           // painting reorders and fills the cache
+        thread_pool& m_pool;
+        std::shared_ptr<shared_state> m_state;
+        mutable std::unordered_set<std::size_t> m_requested; // queued or fetching, not yet taken
+        std::vector<std::size_t> m_plan;
+        std::size_t m_last_hint_first = 0;
+        mutable statistics m_statistics;
+    };
+}
+
+#endif // WPP_MODEL_PAGED_LIST_SOURCE_HPP
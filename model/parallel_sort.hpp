@@ -0,0 +1,70 @@
+#ifndef WPP_MODEL_PARALLEL_SORT_HPP
+#define WPP_MODEL_PARALLEL_SORT_HPP
+
+// Stable merge sort on the shared thread pool: runs are sorted in parallel, then merged pairwise in parallel
+// rounds. Equal elements keep their order, which multi-key sorts rely on. Free of Win32.
+
+#include "../thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace wpp::model
+{
+    // Sort [first, last) stably. Ranges below `serial_threshold` (or without a pool) use std::stable_sort.
+    template<typename RandomIt, typename Compare>
+    void parallel_stable_sort(RandomIt first, RandomIt last, Compare compare, thread_pool* pool = &thread_pool::shared(),
+                              std::size_t serial_threshold = 16384) {
+        using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+        std::size_t count = static_cast<std::size_t>(last - first);
+        std::size_t workers = pool ? pool->size() : 1;
+        if (!pool || workers < 2 || count < serial_threshold) {
+            std::stable_sort(first, last, compare);
+            return;
+        }
+
+        // A power of two number of runs, about two per worker, so every merge round pairs runs evenly
+        std::size_t runs = 1;
+        while (runs < workers * 2 && count / (runs * 2) >= serial_threshold / 4)
+            runs *= 2;
+
+        std::vector<std::size_t> bounds(runs + 1);
+        for (std::size_t i = 0; i <= runs; ++i)
+            bounds[i] = count * i / runs;
+
+        {
+            task_group group(pool);
+            for (std::size_t i = 0; i < runs; ++i)
+                group.run([&, i] { std::stable_sort(first + bounds[i], first + bounds[i + 1], compare); });
+        }
+
+        std::vector<value_type> buffer(count);
+        bool in_buffer = false;
+        for (std::size_t width = 1; width < runs; width *= 2) {
+            task_group group(pool);
+            for (std::size_t i = 0; i < runs; i += width * 2) {
+                group.run([&, i] {
+                    std::size_t lo = bounds[i], mid = bounds[i + width], hi = bounds[(std::min)(i + width * 2, runs)];
+                    if (in_buffer)
+                        std::merge(std::make_move_iterator(buffer.begin() + lo), std::make_move_iterator(buffer.begin() + mid),
+                                   std::make_move_iterator(buffer.begin() + mid), std::make_move_iterator(buffer.begin() + hi),
+                                   first + lo, compare);
+                    else
+                        std::merge(std::make_move_iterator(first + lo), std::make_move_iterator(first + mid),
+                                   std::make_move_iterator(first + mid), std::make_move_iterator(first + hi),
+                                   buffer.begin() + lo, compare);
+                });
+            }
+            group.wait();
+            in_buffer = !in_buffer;
+        }
+
+        if (in_buffer)
+            std::move(buffer.begin(), buffer.end(), first);
+    }
+}
+
+#endif // WPP_MODEL_PARALLEL_SORT_HPP
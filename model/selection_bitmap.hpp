@@ -0,0 +1,184 @@
+#ifndef WPP_MODEL_SELECTION_BITMAP_HPP
+#define WPP_MODEL_SELECTION_BITMAP_HPP
+
+// Selection of a virtual list as one bit per item, with a running count, so that asking which of millions of
+// items are selected costs a scan of 64-item words instead of a message per item. Free of Win32.
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wpp::model
+{
+    class selection_bitmap {
+    public:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        selection_bitmap() = default;
+        explicit selection_bitmap(std::size_t size) { resize(size); }
+
+        std::size_t size() const { return m_size; }
+        std::size_t count() const { return m_count; }
+        bool any() const { return m_count != 0; }
+
+        // Items past the new size are deselected; new items start deselected
+        void resize(std::size_t size) {
+            if (size < m_size)
+                set_range(size, m_size - 1, false);
+            m_size = size;
+            m_words.resize(word_count(size), 0);
+        }
+
+        bool test(std::size_t item) const {
+            return item < m_size && (m_words[item / bits] >> (item % bits) & 1) != 0;
+        }
+
+        void set(std::size_t item, bool selected = true) {
+            if (item >= m_size)
+                return;
+            std::uint64_t& word = m_words[item / bits];
+            std::uint64_t mask = std::uint64_t{ 1 } << (item % bits);
+            if (((word & mask) != 0) == selected)
+                return;
+            word ^= mask;
+            selected ? m_count++ : m_count--;
+        }
+
+        // Select or deselect items first..last inclusive, clamped to the size
+        void set_range(std::size_t first, std::size_t last, bool selected = true) {
+            if (m_size == 0 || first >= m_size || first > last)
+                return;
+            last = (std::min)(last, m_size - 1);
+
+            std::size_t first_word = first / bits, last_word = last / bits;
+            for (std::size_t w = first_word; w <= last_word; ++w) {
+                std::uint64_t mask = ~std::uint64_t{ 0 };
+                if (w == first_word)
+                    mask &= ~std::uint64_t{ 0 } << (first % bits);
+                if (w == last_word)
+                    mask &= ~std::uint64_t{ 0 } >> (bits - 1 - last % bits);
+
+                std::uint64_t& word = m_words[w];
+                std::size_t before = static_cast<std::size_t>(std::popcount(word & mask));
+                if (selected) {
+                    word |= mask;
+                    m_count += static_cast<std::size_t>(std::popcount(mask)) - before;
+                } else {
+                    word &= ~mask;
+                    m_count -= before;
+                }
+            }
+        }
+
+        void clear() {
+            std::fill(m_words.begin(), m_words.end(), 0);
+            m_count = 0;
+        }
+
+        // Flip every item; returns the new count
+        std::size_t invert() {
+            for (std::uint64_t& word : m_words)
+                word = ~word;
+            trim();
+            m_count = m_size - m_count;
+            return m_count;
+        }
+
+        // First selected item at or after `from`, or npos
+        std::size_t find_next(std::size_t from) const {
+            if (from >= m_size)
+                return npos;
+            std::size_t w = from / bits;
+            std::uint64_t word = m_words[w] & (~std::uint64_t{ 0 } << (from % bits));
+            while (true) {
+                if (word != 0)
+                    return w * bits + static_cast<std::size_t>(std::countr_zero(word));
+                if (++w >= m_words.size())
+                    return npos;
+                word = m_words[w];
+            }
+        }
+
+        std::size_t first() const { return find_next(0); }
+
+        // Visit selected items in ascending order
+        template<typename Fn>
+        void for_each(Fn&& fn) const {
+            for (std::size_t w = 0; w < m_words.size(); ++w) {
+                for (std::uint64_t word = m_words[w]; word != 0; word &= word - 1)
+                    fn(w * bits + static_cast<std::size_t>(std::countr_zero(word)));
+            }
+        }
+
+        // Visit maximal runs of selected items as (first, last) inclusive, in ascending order
+        template<typename Fn>
+        void for_each_run(Fn&& fn) const {
+            std::size_t start = find_next(0);
+            while (start != npos) {
+                std::size_t end = find_next_clear(start);
+                fn(start, end - 1);
+                start = find_next(end);
+            }
+        }
+
+        // Items were inserted before `position` in the list: shift the selection up by `count`
+        void insert(std::size_t position, std::size_t count) {
+            if (count == 0)
+                return;
+            position = (std::min)(position, m_size);
+            std::vector<std::size_t> moved;
+            for (std::size_t item = find_next(position); item != npos; item = find_next(item + 1))
+                moved.push_back(item);
+            set_range(position, m_size, false);
+            resize(m_size + count);
+            for (std::size_t item : moved)
+                set(item + count);
+        }
+
+        // Items position..position+count-1 were removed from the list: drop them and shift the rest down
+        void erase(std::size_t position, std::size_t count) {
+            if (position >= m_size || count == 0)
+                return;
+            count = (std::min)(count, m_size - position);
+            std::vector<std::size_t> moved;
+            for (std::size_t item = find_next(position + count); item != npos; item = find_next(item + 1))
+                moved.push_back(item);
+            set_range(position, m_size - 1, false);
+            for (std::size_t item : moved)
+                set(item - count);
+            resize(m_size - count);
+        }
+
+    private:
+        static constexpr std::size_t bits = 64;
+
+        static std::size_t word_count(std::size_t size) { return (size + bits - 1) / bits; }
+
+        // First deselected item after `from`, or size()
+        std::size_t find_next_clear(std::size_t from) const {
+            std::size_t w = from / bits;
+            std::uint64_t word = ~m_words[w] & (~std::uint64_t{ 0 } << (from % bits));
+            while (true) {
+                if (word != 0)
+                    return (std::min)(w * bits + static_cast<std::size_t>(std::countr_zero(word)), m_size);
+                if (++w >= m_words.size())
+                    return m_size;
+                word = ~m_words[w];
+            }
+        }
+
+        // Keep the bits past the end of the last word clear
+        void trim() {
+            if (m_size % bits != 0)
+                m_words.back() &= ~std::uint64_t{ 0 } >> (bits - m_size % bits);
+        }
+
+        std::vector<std::uint64_t> m_words;
+        std::size_t m_size = 0;
+        std::size_t m_count = 0;
+    };
+}
+
+#endif // WPP_MODEL_SELECTION_BITMAP_HPP
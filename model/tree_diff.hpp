@@ -0,0 +1,248 @@
+#ifndef WPP_MODEL_TREE_DIFF_HPP
+#define WPP_MODEL_TREE_DIFF_HPP
+
+// Immutable snapshots of a keyed hierarchy and the per-level difference between two of them, for updating a
+// tree control in place. Children are matched by key under their matched parent, one level at a time, with the
+// same edit scripts as keyed lists; subtrees whose content hashes are equal are mapped without comparing, and
+// subtrees the caller never shows are not visited at all. Free of Win32.
+
+#include "keyed_diff.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wpp::model
+{
+    template<typename CharT>
+    class basic_tree_snapshot {
+    public:
+        using node_id = std::uint32_t;
+        using string_view_type = std::basic_string_view<CharT>;
+
+        static constexpr node_id root = 0;                      // invisible; its children are the top level
+        static constexpr node_id npos = static_cast<node_id>(-1);
+
+        basic_tree_snapshot() { clear(); }
+
+        void reserve(std::size_t nodes) {
+            m_keys.reserve(nodes + 1);
+            m_data.reserve(nodes + 1);
+            m_parent.reserve(nodes + 1);
+            m_first_child.reserve(nodes + 1);
+            m_last_child.reserve(nodes + 1);
+            m_next_sibling.reserve(nodes + 1);
+            m_text_offsets.reserve(nodes + 2);
+        }
+
+        void clear() {
+            m_keys.assign(1, 0);
+            m_data.assign(1, 0);
+            m_parent.assign(1, npos);
+            m_first_child.assign(1, npos);
+            m_last_child.assign(1, npos);
+            m_next_sibling.assign(1, npos);
+            m_text.clear();
+            m_text_offsets.assign(2, 0);
+            m_subtree_hashes.clear();
+        }
+
+        // Append a node as the last child of `parent`; keys must be unique among siblings
+        node_id add(node_id parent, std::uint64_t key, string_view_type text, std::uint64_t data = 0) {
+            node_id id = static_cast<node_id>(m_keys.size());
+            m_keys.push_back(key);
+            m_data.push_back(data);
+            m_parent.push_back(parent);
+            m_first_child.push_back(npos);
+            m_last_child.push_back(npos);
+            m_next_sibling.push_back(npos);
+            m_text.append(text);
+            m_text_offsets.push_back(static_cast<std::uint32_t>(m_text.size()));
+            m_subtree_hashes.clear();
+
+            if (m_last_child[parent] == npos)
+                m_first_child[parent] = id;
+            else
+                m_next_sibling[m_last_child[parent]] = id;
+            m_last_child[parent] = id;
+            return id;
+        }
+
+        std::size_t size() const { return m_keys.size(); }         // including the root
+        std::uint64_t key(node_id node) const { return m_keys[node]; }
+        std::uint64_t data(node_id node) const { return m_data[node]; }
+        node_id parent(node_id node) const { return m_parent[node]; }
+        node_id first_child(node_id node) const { return m_first_child[node]; }
+        node_id next_sibling(node_id node) const { return m_next_sibling[node]; }
+        bool has_children(node_id node) const { return m_first_child[node] != npos; }
+
+        string_view_type text(node_id node) const {
+            return string_view_type(m_text.data() + m_text_offsets[node], m_text_offsets[node + 1] - m_text_offsets[node]);
+        }
+
+        void children(node_id node, std::vector<node_id>& out) const {
+            out.clear();
+            for (node_id child = m_first_child[node]; child != npos; child = m_next_sibling[child])
+                out.push_back(child);
+        }
+
+        // What a tree item shows for the node: text, data and whether it has children
+        std::uint64_t node_hash(node_id node) const {
+            std::uint64_t hash = content_hash(text(node), m_data[node] * 1099511628211ull);
+            return has_children(node) ? ~hash : hash;
+        }
+
+        // Hash of each node's subtree: its own content, then its children's subtree hashes in order. Computed on
+        // first use and kept until the next add, so a snapshot diffed twice hashes once.
+        const std::vector<std::uint64_t>& subtree_hashes() const {
+            std::vector<std::uint64_t>& hashes = m_subtree_hashes;
+            if (hashes.size() == size())
+                return hashes;
+            hashes.assign(size(), 0);
+            for (std::size_t i = size(); i-- > 0;) {
+                node_id node = static_cast<node_id>(i);
+                std::uint64_t hash = mix(node_hash(node) ^ mix(m_keys[node]));
+                for (node_id child = m_first_child[node]; child != npos; child = m_next_sibling[child])
+                    hash = mix(hash ^ hashes[child]);
+                hashes[node] = hash;
+            }
+            return hashes;
+        }
+
+    private:
+        // splitmix64 finalizer; a plain xor-multiply chain lets a parent and child with equal text cancel out
+        static std::uint64_t mix(std::uint64_t value) {
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            return value ^ (value >> 31);
+        }
+
+        std::vector<std::uint64_t> m_keys;
+        std::vector<std::uint64_t> m_data;
+        std::vector<node_id> m_parent;
+        std::vector<node_id> m_first_child;
+        std::vector<node_id> m_last_child;
+        std::vector<node_id> m_next_sibling;
+        std::basic_string<CharT> m_text;                        // all node texts
+        std::vector<std::uint32_t> m_text_offsets;              // node n is m_text[offsets[n], offsets[n + 1])
+        mutable std::vector<std::uint64_t> m_subtree_hashes;
+    };
+
+    // Children of one matched parent pair that changed. Indices in `children` are positions in the child lists.
+    struct tree_level {
+        std::uint32_t old_parent = 0;
+        std::uint32_t new_parent = 0;
+        std::vector<std::uint32_t> old_children;
+        std::vector<std::uint32_t> new_children;
+        keyed_diff children;
+    };
+
+    struct tree_diff {
+        static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+        std::vector<std::uint32_t> old_of;      // new node -> old node kept in place under a visited parent, or npos
+        std::vector<tree_level> levels;         // changed levels, every parent before its descendants
+        std::size_t compared = 0;               // children compared by key
+        std::size_t mapped = 0;                 // nodes mapped through identical subtrees
+
+        bool empty() const { return levels.empty(); }
+    };
+
+    // Match the children of `new_parent` to those of `old_parent` by key: old child per new child, or npos
+    template<typename CharT>
+    std::vector<std::uint32_t> match_children(const basic_tree_snapshot<CharT>& old, std::uint32_t old_parent,
+                                              const basic_tree_snapshot<CharT>& next, std::uint32_t new_parent) {
+        std::vector<std::uint32_t> old_children, new_children, keys_old, matched;
+        old.children(old_parent, old_children);
+        next.children(new_parent, new_children);
+        std::unordered_map<std::uint64_t, std::uint32_t> by_key;
+        by_key.reserve(old_children.size());
+        for (std::uint32_t child : old_children)
+            by_key.try_emplace(old.key(child), child);
+
+        matched.reserve(new_children.size());
+        for (std::uint32_t child : new_children) {
+            auto it = by_key.find(next.key(child));
+            matched.push_back(it != by_key.end() ? it->second : tree_diff::npos);
+            if (it != by_key.end())
+                by_key.erase(it);
+        }
+        return matched;
+    }
+
+    // Diff two snapshots from the root down. descend(old_node) says whether the caller shows the node's
+    // children (for a tree control: whether they were ever inserted); unshown subtrees are skipped, since they
+    // are built from the new snapshot when first shown. Moved nodes are not descended either: the caller
+    // rebuilds them, using match_children to carry state over.
+    template<typename CharT, typename Descend>
+    tree_diff diff_trees(const basic_tree_snapshot<CharT>& old, const basic_tree_snapshot<CharT>& next, Descend&& descend) {
+        using node_id = std::uint32_t;
+
+        tree_diff diff;
+        diff.old_of.assign(next.size(), tree_diff::npos);
+        diff.old_of[0] = 0;
+
+        const std::vector<std::uint64_t>& old_hashes = old.subtree_hashes();
+        const std::vector<std::uint64_t>& new_hashes = next.subtree_hashes();
+
+        std::deque<std::pair<node_id, node_id>> pending{ { 0, 0 } };
+        std::vector<node_id> old_children, new_children;
+        std::vector<std::uint64_t> old_keys, new_keys, old_content, new_content;
+        while (!pending.empty()) {
+            auto [o, n] = pending.front();
+            pending.pop_front();
+
+            if (old_hashes[o] == new_hashes[n]) {
+                // Same subtree: pair the shown part off in lockstep
+                for (node_id oc = old.first_child(o), nc = next.first_child(n); oc != tree_diff::npos && nc != tree_diff::npos;
+                     oc = old.next_sibling(oc), nc = next.next_sibling(nc)) {
+                    diff.old_of[nc] = oc;
+                    diff.mapped++;
+                    if (descend(oc))
+                        pending.emplace_back(oc, nc);
+                }
+                continue;
+            }
+
+            old.children(o, old_children);
+            next.children(n, new_children);
+            old_keys.clear();
+            old_content.clear();
+            for (node_id child : old_children) {
+                old_keys.push_back(old.key(child));
+                old_content.push_back(old.node_hash(child));
+            }
+            new_keys.clear();
+            new_content.clear();
+            for (node_id child : new_children) {
+                new_keys.push_back(next.key(child));
+                new_content.push_back(next.node_hash(child));
+            }
+            diff.compared += new_children.size();
+
+            keyed_diff children = diff_keyed<std::uint64_t>(old_keys, new_keys, old_content, new_content);
+            std::vector<bool> reinserted(new_children.size());
+            for (std::size_t index : children.inserted)
+                reinserted[index] = true;
+            for (std::size_t i = 0; i < new_children.size(); ++i) {
+                if (reinserted[i] || children.source[i] == keyed_diff::npos)
+                    continue;
+                node_id oc = old_children[children.source[i]];
+                diff.old_of[new_children[i]] = oc;
+                if (descend(oc))
+                    pending.emplace_back(oc, new_children[i]);
+            }
+
+            if (!children.empty())
+                diff.levels.push_back({ o, n, old_children, new_children, std::move(children) });
+        }
+        return diff;
+    }
+}
+
+#endif // WPP_MODEL_TREE_DIFF_HPP
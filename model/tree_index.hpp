@@ -0,0 +1,402 @@
+#ifndef WPP_MODEL_TREE_INDEX_HPP
+#define WPP_MODEL_TREE_INDEX_HPP
+
+// A mirror of a tree control's structure kept next to it, so navigation, lookup by item data and the expanded
+// and checked sets are answered from memory instead of one message per item. Items are identified by the
+// control's handles; the mirror is told about every insert, delete, move and state change. Free of Win32.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wpp::model
+{
+    template<typename Handle>
+    class basic_tree_index {
+    public:
+        basic_tree_index() { clear(); }
+
+        // Insert `item` under `parent` (Handle{} for the top level) right after the sibling `after` (Handle{}
+        // to insert first). Fails if the item is already known or the parent or sibling is not.
+        bool insert(Handle item, Handle parent, Handle after, std::uint64_t data = 0, bool expanded = false, bool checked = false) {
+            if (item == Handle{} || m_slots.find(item) != m_slots.end())
+                return false;
+
+            slot_id parent_slot = top;
+            if (parent != Handle{}) {
+                parent_slot = find(parent);
+                if (parent_slot == npos)
+                    return false;
+            }
+            slot_id after_slot = npos;
+            if (after != Handle{}) {
+                after_slot = find(after);
+                if (after_slot == npos || m_nodes[after_slot].parent != parent_slot)
+                    return false;
+            }
+
+            slot_id id = allocate();
+            node& n = m_nodes[id];
+            n = node{};
+            n.item = item;
+            n.data = data;
+            n.parent = parent_slot;
+            link(id, parent_slot, after_slot);
+            m_slots.emplace(item, id);
+            link_data(id);
+            mark_expanded(id, expanded);
+            mark_checked(id, checked);
+            m_size++;
+            return true;
+        }
+
+        // Insert as the last child of `parent`
+        bool insert_last(Handle item, Handle parent, std::uint64_t data = 0, bool expanded = false, bool checked = false) {
+            return insert(item, parent, last_child(parent), data, expanded, checked);
+        }
+
+        // Remove an item and its subtree; returns the number of items removed
+        std::size_t erase(Handle item) {
+            slot_id id = find(item);
+            if (id == npos)
+                return 0;
+
+            unlink(id);
+            std::size_t removed = 0;
+            std::vector<slot_id> pending{ id };
+            while (!pending.empty()) {
+                slot_id current = pending.back();
+                pending.pop_back();
+                for (slot_id child = m_nodes[current].first_child; child != npos; child = m_nodes[child].next)
+                    pending.push_back(child);
+
+                mark_expanded(current, false);
+                mark_checked(current, false);
+                unlink_data(current);
+                m_slots.erase(m_nodes[current].item);
+                m_nodes[current] = node{};
+                m_nodes[current].next = m_free;
+                m_free = current;
+                removed++;
+            }
+            m_size -= removed;
+            return removed;
+        }
+
+        void clear() {
+            m_nodes.assign(1, node{});
+            m_slots.clear();
+            m_by_data.clear();
+            m_free = npos;
+            m_size = 0;
+            m_expanded = 0;
+            m_checked_head = npos;
+            m_checked = 0;
+        }
+
+        // The control reordered the children of `parent` (e.g. after sorting); `order` lists all of them
+        bool reorder_children(Handle parent, const std::vector<Handle>& order) {
+            slot_id parent_slot = parent == Handle{} ? top : find(parent);
+            if (parent_slot == npos)
+                return false;
+
+            std::vector<slot_id> slots;
+            slots.reserve(order.size());
+            for (Handle item : order) {
+                slot_id id = find(item);
+                if (id == npos || m_nodes[id].parent != parent_slot)
+                    return false;
+                slots.push_back(id);
+            }
+
+            node& p = m_nodes[parent_slot];
+            p.first_child = p.last_child = npos;
+            for (slot_id id : slots)
+                link(id, parent_slot, p.last_child);
+            return true;
+        }
+
+        bool contains(Handle item) const { return find(item) != npos; }
+        std::size_t size() const { return m_size; }
+
+        // Navigation; Handle{} where the control would return NULL. first_child(Handle{}) is the first top-level item.
+        Handle parent(Handle item) const { return item_of(parent_slot(item)); }
+        Handle first_child(Handle item) const { return item_of(child_slot(item, true)); }
+        Handle last_child(Handle item) const { return item_of(child_slot(item, false)); }
+        Handle next_sibling(Handle item) const { slot_id id = find(item); return id == npos ? Handle{} : item_of(m_nodes[id].next); }
+        Handle prev_sibling(Handle item) const { slot_id id = find(item); return id == npos ? Handle{} : item_of(m_nodes[id].prev); }
+
+        std::size_t depth(Handle item) const {
+            std::size_t levels = 0;
+            for (slot_id id = parent_slot(item); id != npos && id != top; id = m_nodes[id].parent)
+                levels++;
+            return levels;
+        }
+
+        bool is_ancestor(Handle ancestor, Handle item) const {
+            slot_id target = find(ancestor);
+            if (target == npos)
+                return false;
+            for (slot_id id = parent_slot(item); id != npos && id != top; id = m_nodes[id].parent)
+                if (id == target)
+                    return true;
+            return false;
+        }
+
+        std::uint64_t data(Handle item) const { slot_id id = find(item); return id == npos ? 0 : m_nodes[id].data; }
+
+        void set_data(Handle item, std::uint64_t data) {
+            slot_id id = find(item);
+            if (id == npos || m_nodes[id].data == data)
+                return;
+            unlink_data(id);
+            m_nodes[id].data = data;
+            link_data(id);
+        }
+
+        // Item holding `data`, the earliest inserted when several do; within `scope` and its descendants
+        // (and following siblings, as the control's searches go) when given
+        Handle find_by_data(std::uint64_t data, Handle scope = Handle{}) const {
+            auto it = m_by_data.find(data);
+            if (it == m_by_data.end())
+                return Handle{};
+
+            slot_id id = it->second;
+            if (scope == Handle{})
+                return m_nodes[id].item;
+
+            slot_id scope_slot = find(scope);
+            if (scope_slot == npos)
+                return Handle{};
+            do {
+                if (in_scope(id, scope_slot))
+                    return m_nodes[id].item;
+                id = m_nodes[id].data_next;
+            } while (id != it->second);
+            return Handle{};
+        }
+
+        bool is_expanded(Handle item) const { slot_id id = find(item); return id != npos && m_nodes[id].expanded; }
+        bool is_checked(Handle item) const { slot_id id = find(item); return id != npos && m_nodes[id].checked; }
+        void set_expanded(Handle item, bool expanded) { slot_id id = find(item); if (id != npos) mark_expanded(id, expanded); }
+        void set_checked(Handle item, bool checked) { slot_id id = find(item); if (id != npos) mark_checked(id, checked); }
+
+        std::size_t expanded_count() const { return m_expanded; }
+        std::size_t checked_count() const { return m_checked; }
+
+        // Checked items, most recently checked first
+        template<typename Fn>
+        void for_each_checked(Fn&& fn) const {
+            for (slot_id id = m_checked_head; id != npos; id = m_nodes[id].checked_next)
+                fn(m_nodes[id].item);
+        }
+
+        // Visit `first`, its subtree, then each following sibling and its subtree, in display order; from the
+        // first top-level item when `first` is Handle{}. Stops early if fn returns false.
+        template<typename Fn>
+        void for_each(Handle first, Fn&& fn) const {
+            slot_id id = first == Handle{} ? m_nodes[top].first_child : find(first);
+            if (id == npos)
+                return;
+
+            slot_id stop = m_nodes[id].parent;
+            while (id != npos) {
+                if (!visit(fn, m_nodes[id].item))
+                    return;
+                if (m_nodes[id].first_child != npos) {
+                    id = m_nodes[id].first_child;
+                    continue;
+                }
+                while (id != stop && m_nodes[id].next == npos)
+                    id = m_nodes[id].parent;
+                id = id == stop ? npos : m_nodes[id].next;
+            }
+        }
+
+        // Number of items in `first`'s subtree and those of its following siblings, as for_each visits them
+        std::size_t count(Handle first) const {
+            std::size_t items = 0;
+            for_each(first, [&](Handle) { items++; });
+            return items;
+        }
+
+    private:
+        using slot_id = std::uint32_t;
+        static constexpr slot_id npos = static_cast<slot_id>(-1);
+        static constexpr slot_id top = 0;                       // parent of the top-level items
+
+        struct node {
+            Handle item{};
+            std::uint64_t data = 0;
+            slot_id parent = npos;
+            slot_id first_child = npos;
+            slot_id last_child = npos;
+            slot_id prev = npos;
+            slot_id next = npos;                                // also links free slots
+            slot_id data_prev = npos;                           // ring of the items sharing a data value
+            slot_id data_next = npos;
+            slot_id checked_prev = npos;
+            slot_id checked_next = npos;
+            bool expanded = false;
+            bool checked = false;
+        };
+
+        template<typename Fn>
+        static bool visit(Fn& fn, Handle item) {
+            if constexpr (std::is_same_v<std::invoke_result_t<Fn&, Handle>, bool>)
+                return fn(item);
+            else {
+                fn(item);
+                return true;
+            }
+        }
+
+        slot_id find(Handle item) const {
+            auto it = m_slots.find(item);
+            return it == m_slots.end() ? npos : it->second;
+        }
+
+        Handle item_of(slot_id id) const { return id == npos || id == top ? Handle{} : m_nodes[id].item; }
+
+        slot_id parent_slot(Handle item) const {
+            slot_id id = find(item);
+            return id == npos ? npos : m_nodes[id].parent;
+        }
+
+        slot_id child_slot(Handle item, bool first) const {
+            slot_id id = item == Handle{} ? top : find(item);
+            if (id == npos)
+                return npos;
+            return first ? m_nodes[id].first_child : m_nodes[id].last_child;
+        }
+
+        // Whether `id` is `scope`, one of its following siblings, or a descendant of either
+        bool in_scope(slot_id id, slot_id scope) const {
+            slot_id scope_parent = m_nodes[scope].parent;
+            for (; id != npos && id != top; id = m_nodes[id].parent) {
+                if (m_nodes[id].parent != scope_parent)
+                    continue;
+                for (slot_id sibling = scope; sibling != npos; sibling = m_nodes[sibling].next)
+                    if (sibling == id)
+                        return true;
+                return false;
+            }
+            return false;
+        }
+
+        slot_id allocate() {
+            if (m_free != npos) {
+                slot_id id = m_free;
+                m_free = m_nodes[id].next;
+                return id;
+            }
+            m_nodes.emplace_back();
+            return static_cast<slot_id>(m_nodes.size() - 1);
+        }
+
+        void link(slot_id id, slot_id parent, slot_id after) {
+            node& n = m_nodes[id];
+            node& p = m_nodes[parent];
+            n.parent = parent;
+            n.prev = after;
+            n.next = after == npos ? p.first_child : m_nodes[after].next;
+            if (n.prev != npos)
+                m_nodes[n.prev].next = id;
+            else
+                p.first_child = id;
+            if (n.next != npos)
+                m_nodes[n.next].prev = id;
+            else
+                p.last_child = id;
+        }
+
+        void unlink(slot_id id) {
+            node& n = m_nodes[id];
+            node& p = m_nodes[n.parent];
+            if (n.prev != npos)
+                m_nodes[n.prev].next = n.next;
+            else
+                p.first_child = n.next;
+            if (n.next != npos)
+                m_nodes[n.next].prev = n.prev;
+            else
+                p.last_child = n.prev;
+            n.prev = n.next = npos;
+        }
+
+        void link_data(slot_id id) {
+            auto [it, added] = m_by_data.try_emplace(m_nodes[id].data, id);
+            if (added) {
+                m_nodes[id].data_prev = m_nodes[id].data_next = id;
+                return;
+            }
+            slot_id head = it->second;
+            slot_id tail = m_nodes[head].data_prev;
+            m_nodes[id].data_prev = tail;
+            m_nodes[id].data_next = head;
+            m_nodes[tail].data_next = id;
+            m_nodes[head].data_prev = id;
+        }
+
+        void unlink_data(slot_id id) {
+            node& n = m_nodes[id];
+            auto it = m_by_data.find(n.data);
+            if (n.data_next == id)
+                m_by_data.erase(it);
+            else {
+                m_nodes[n.data_prev].data_next = n.data_next;
+                m_nodes[n.data_next].data_prev = n.data_prev;
+                if (it->second == id)
+                    it->second = n.data_next;
+            }
+            n.data_prev = n.data_next = npos;
+        }
+
+        void mark_expanded(slot_id id, bool expanded) {
+            if (m_nodes[id].expanded == expanded)
+                return;
+            m_nodes[id].expanded = expanded;
+            expanded ? m_expanded++ : m_expanded--;
+        }
+
+        void mark_checked(slot_id id, bool checked) {
+            node& n = m_nodes[id];
+            if (n.checked == checked)
+                return;
+            n.checked = checked;
+            if (checked) {
+                n.checked_prev = npos;
+                n.checked_next = m_checked_head;
+                if (m_checked_head != npos)
+                    m_nodes[m_checked_head].checked_prev = id;
+                m_checked_head = id;
+                m_checked++;
+                return;
+            }
+
+            if (n.checked_prev != npos)
+                m_nodes[n.checked_prev].checked_next = n.checked_next;
+            else
+                m_checked_head = n.checked_next;
+            if (n.checked_next != npos)
+                m_nodes[n.checked_next].checked_prev = n.checked_prev;
+            n.checked_prev = n.checked_next = npos;
+            m_checked--;
+        }
+
+        std::vector<node> m_nodes;                              // slot 0 stands for the invisible root
+        std::unordered_map<Handle, slot_id> m_slots;
+        std::unordered_map<std::uint64_t, slot_id> m_by_data;   // first of each data ring
+        slot_id m_free = npos;
+        std::size_t m_size = 0;
+        std::size_t m_expanded = 0;
+        slot_id m_checked_head = npos;
+        std::size_t m_checked = 0;
+    };
+}
+
+#endif // WPP_MODEL_TREE_INDEX_HPP
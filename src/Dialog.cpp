@@ -41,9 +41,11 @@ namespace wpp
 			{WM_KEYDOWN, std::bind(&dialog::on_key_down, this, _1, _2, _3)},
 			{WM_KEYUP, std::bind(&dialog::on_key_up, this, _1, _2, _3)},
 			{WM_NOTIFY, std::bind(&dialog::on_notify, this, _1, _2, _3)},
+			{WM_DRAWITEM, std::bind(&dialog::on_control_draw_item, this, _1, _2, _3)},
 			{WM_HSCROLL, std::bind(&dialog::on_h_scroll, this, _1, _2, _3)},
 			{WM_VSCROLL, std::bind(&dialog::on_v_scroll, this, _1, _2, _3)},
 			{WM_DROPFILES, std::bind(&dialog::on_drop_files, this, _1, _2, _3)},
+			{static_cast<INT>(control::async_ready_message()), std::bind(&dialog::on_control_async_ready, this, _1, _2, _3)},
 		};
 	}
 
@@ -232,6 +234,28 @@ namespace wpp
 		return FALSE;
 	}
 
+	INT_PTR dialog::on_control_async_ready(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		// The control may have been destroyed since its work was queued
+		for (const auto& control : m_controls) {
+			if (control && control->get_id() == static_cast<int>(wParam)) {
+				control->on_async_ready();
+				break;
+			}
+		}
+		return TRUE;
+	}
+
+	INT_PTR dialog::on_control_draw_item(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		auto draw_item = reinterpret_cast<LPDRAWITEMSTRUCT>(lParam);
+		if (!draw_item || draw_item->CtlType == ODT_MENU)
+			return FALSE;
+		for (const auto& control : m_controls) {
+			if (control && control->get_id() == static_cast<int>(draw_item->CtlID))
+				return control->on_draw_item(draw_item);
+		}
+		return FALSE;
+	}
+
 	INT_PTR dialog::dialog_proc(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam) {
 		m_handle = hWnd;
 		auto it = m_message_events.find(Msg);
@@ -0,0 +1,181 @@
+#include "..\layout\canvas_panel.hpp"
+#include <algorithm>
+
+namespace wpp::layout
+{
+    canvas_panel::canvas_panel(HWND parent, int index_cell_size)
+        : panel(type::absolute, parent)
+        , m_index(index_cell_size) {
+    }
+
+    void canvas_panel::add(control_ptr<> control) {
+        add(control, 0, 0, m_next_z_index);
+    }
+
+    void canvas_panel::add(control_ptr<> control, int x, int y) {
+        add(control, x, y, m_next_z_index);
+    }
+
+    void canvas_panel::add(control_ptr<> control, int x, int y, int z_index) {
+        if (control && m_item_ids.find(control) == m_item_ids.end()) {
+            m_children.push_back(control);
+            track_child(control);
+
+            auto constraints = get_size_constraints(control);
+            int id = static_cast<int>(m_items.size());
+            m_items.push_back({ control, x, y, z_index, constraints.clamp(constraints.desired) });
+            m_item_ids[control] = id;
+            m_next_z_index = (std::max)(m_next_z_index, z_index + 1);
+            m_z_order_dirty = true;
+            reindex(id);
+        }
+    }
+
+    int canvas_panel::find_item(const control_ptr<>& control) const {
+        auto it = m_item_ids.find(control);
+        return it != m_item_ids.end() ? it->second : -1;
+    }
+
+    void canvas_panel::child_removed(const control_ptr<>& child) {
+        int id = find_item(child);
+        if (id < 0)
+            return;
+
+        // Ids are positions in m_items and break z-order ties, so the items after it move down one id
+        m_items.erase(m_items.begin() + id);
+        m_item_ids.erase(child);
+        for (int i = id; i < static_cast<int>(m_items.size()); ++i) {
+            m_item_ids[m_items[i].control] = i;
+            reindex(i);
+        }
+        m_index.remove(static_cast<int>(m_items.size()));
+    }
+
+    void canvas_panel::reindex(int id) {
+        const auto& item = m_items[id];
+        m_index.update(id, { item.x, item.y, item.size.width, item.size.height });
+    }
+
+    void canvas_panel::set_position(control_ptr<> control, int x, int y) {
+        int id = find_item(control);
+        if (id >= 0) {
+            m_items[id].x = x;
+            m_items[id].y = y;
+            reindex(id);
+        }
+    }
+
+    POINT canvas_panel::get_position(control_ptr<> control) const {
+        int id = find_item(control);
+        if (id >= 0) {
+            return { m_items[id].x, m_items[id].y };
+        }
+        return { 0, 0 };
+    }
+
+    void canvas_panel::set_z_index(control_ptr<> control, int z_index) {
+        int id = find_item(control);
+        if (id >= 0 && m_items[id].z_index != z_index) {
+            m_items[id].z_index = z_index;
+            m_next_z_index = (std::max)(m_next_z_index, z_index + 1);
+            m_z_order_dirty = true;
+        }
+    }
+
+    int canvas_panel::get_z_index(control_ptr<> control) const {
+        int id = find_item(control);
+        return id >= 0 ? m_items[id].z_index : 0;
+    }
+
+    void canvas_panel::child_size_changed(const control_ptr<>& child) {
+        int id = find_item(child);
+        if (id >= 0 && !is_panel(child)) {
+            auto constraints = get_size_constraints(child);
+            m_items[id].size = constraints.clamp(constraints.desired);
+            reindex(id);
+        }
+    }
+
+    control_ptr<> canvas_panel::hit_test(int x, int y) const {
+        m_query_ids.clear();
+        m_index.query_point(x, y, m_query_ids);
+
+        int best = -1;
+        for (int id : m_query_ids) {
+            if (best < 0 || m_items[id].z_index > m_items[best].z_index
+                || (m_items[id].z_index == m_items[best].z_index && id > best))
+                best = id;
+        }
+        return best >= 0 ? m_items[best].control : nullptr;
+    }
+
+    std::vector<control_ptr<>> canvas_panel::query(const rect_t& area) const {
+        m_query_ids.clear();
+        m_index.query_rect(area, m_query_ids);
+
+        std::sort(m_query_ids.begin(), m_query_ids.end(), [this](int a, int b) {
+            return m_items[a].z_index != m_items[b].z_index ? m_items[a].z_index < m_items[b].z_index : a < b;
+        });
+
+        std::vector<control_ptr<>> result;
+        result.reserve(m_query_ids.size());
+        for (int id : m_query_ids)
+            result.push_back(m_items[id].control);
+        return result;
+    }
+
+    void canvas_panel::capture_node(layout_snapshot& snapshot, int node) const {
+        auto& tree = snapshot.tree;
+        capture_metrics(tree[node]);
+
+        for (const auto& item : m_items) {
+            if (!item.control || !item.control->is_valid()) continue;
+
+            int child_node = capture_child(snapshot, node, item.control);
+            tree[child_node].offset_x = item.x;
+            tree[child_node].offset_y = item.y;
+        }
+    }
+
+    void canvas_panel::apply_node(const layout_snapshot& snapshot, int node) {
+        panel::apply_node(snapshot, node);
+
+        // Nested panels only know their size after a layout pass, refresh their index entries from the result
+        const auto& tree = snapshot.tree;
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            int id = find_item(snapshot.targets[tree[child].target]);
+            if (id < 0) continue;
+
+            sizing_t size{ tree[child].bounds.width, tree[child].bounds.height };
+            if (size != m_items[id].size) {
+                m_items[id].size = size;
+                reindex(id);
+            }
+        }
+
+        if (m_z_order_dirty) {
+            apply_z_order();
+        }
+    }
+
+    void canvas_panel::apply_z_order() {
+        std::vector<int> order(m_items.size());
+        for (int i = 0; i < static_cast<int>(order.size()); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            return m_items[a].z_index < m_items[b].z_index;
+        });
+
+        // Bring each child to the top in ascending z order, leaving the highest z-index topmost
+        for (int id : order) {
+            HWND handle = m_items[id].control ? m_items[id].control->get_handle() : nullptr;
+            if (handle)
+                ::SetWindowPos(handle, HWND_TOP, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+        }
+        m_z_order_dirty = false;
+    }
+
+    void canvas_panel::paint(HDC hdc) {
+        // Children paint themselves; the canvas has no chrome of its own
+    }
+}
@@ -0,0 +1,65 @@
+#include "..\layout\constraint_panel.hpp"
+
+namespace wpp::layout
+{
+    constraint_panel::constraint_panel(HWND parent)
+        : panel(type::constraint, parent)
+        , m_system(std::make_shared<constraints::constraint_system>()) {
+    }
+
+    void constraint_panel::add(control_ptr<> control) {
+        if (control && m_slots.find(control) == m_slots.end()) {
+            m_children.push_back(control);
+            track_child(control);
+
+            std::scoped_lock lock(m_system->mutex());
+            m_slots[control] = m_system->add_slot();
+        }
+    }
+
+    const constraints::constraint_system::slot& constraint_panel::slot_for(const control_ptr<>& control) const {
+        auto it = m_slots.find(control);
+        if (it == m_slots.end())
+            return m_detached_slot;
+
+        std::scoped_lock lock(m_system->mutex());
+        return m_system->get_slot(it->second);
+    }
+
+    bool constraint_panel::add_constraint(const constraints::constraint& constraint) {
+        std::scoped_lock lock(m_system->mutex());
+        return m_system->get_solver().add_constraint(constraint);
+    }
+
+    bool constraint_panel::remove_constraint(const constraints::constraint& constraint) {
+        std::scoped_lock lock(m_system->mutex());
+        return m_system->get_solver().remove_constraint(constraint);
+    }
+
+    void constraint_panel::capture_node(layout_snapshot& snapshot, int node) const {
+        auto& tree = snapshot.tree;
+        capture_metrics(tree[node]);
+        tree.set_constraint_system(node, m_system);
+
+        for (const auto& child : m_children) {
+            if (!child || !child->is_valid()) continue;
+
+            int child_node = capture_child(snapshot, node, child);
+            tree[child_node].slot = m_slots.at(child);
+        }
+    }
+
+    void constraint_panel::child_removed(const control_ptr<>& child) {
+        auto it = m_slots.find(child);
+        if (it == m_slots.end())
+            return;
+
+        std::scoped_lock lock(m_system->mutex());
+        m_system->release_slot(it->second);
+        m_slots.erase(it);
+    }
+
+    void constraint_panel::paint(HDC hdc) {
+        // Children paint themselves; the constraint panel has no chrome of its own
+    }
+}
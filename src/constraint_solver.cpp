@@ -0,0 +1,604 @@
+#include "../layout/constraint_solver.hpp"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace wpp::layout::constraints
+{
+    namespace {
+        bool near_zero(double value) {
+            constexpr double eps = 1.0e-8;
+            return value < 0.0 ? -value < eps : value < eps;
+        }
+    }
+
+    constraint::constraint(const expression& e, relation op, double s)
+        : m_data(std::make_shared<data>()) {
+        m_data->expr = e;
+        m_data->op = op;
+        m_data->strength = strength::clip(s);
+    }
+
+    // Row
+
+    std::vector<solver::row::cell>::iterator solver::row::find(const symbol& s) {
+        auto it = std::lower_bound(m_cells.begin(), m_cells.end(), s, [](const cell& c, const symbol& sym) { return c.sym < sym; });
+        return (it != m_cells.end() && it->sym == s) ? it : m_cells.end();
+    }
+
+    std::vector<solver::row::cell>::const_iterator solver::row::find(const symbol& s) const {
+        auto it = std::lower_bound(m_cells.begin(), m_cells.end(), s, [](const cell& c, const symbol& sym) { return c.sym < sym; });
+        return (it != m_cells.end() && it->sym == s) ? it : m_cells.end();
+    }
+
+    void solver::row::insert(const symbol& s, double coefficient) {
+        auto it = std::lower_bound(m_cells.begin(), m_cells.end(), s, [](const cell& c, const symbol& sym) { return c.sym < sym; });
+        if (it != m_cells.end() && it->sym == s) {
+            it->coefficient += coefficient;
+            if (near_zero(it->coefficient))
+                m_cells.erase(it);
+        } else if (!near_zero(coefficient)) {
+            m_cells.insert(it, { s, coefficient });
+        }
+    }
+
+    void solver::row::insert(const row& other, double coefficient) {
+        m_constant += other.m_constant * coefficient;
+        if (other.m_cells.empty())
+            return;
+
+        // Merge the two sorted cell lists
+        std::vector<cell> merged;
+        merged.reserve(m_cells.size() + other.m_cells.size());
+        auto a = m_cells.begin();
+        auto b = other.m_cells.begin();
+        while (a != m_cells.end() || b != other.m_cells.end()) {
+            if (b == other.m_cells.end() || (a != m_cells.end() && a->sym < b->sym)) {
+                merged.push_back(*a++);
+            } else if (a == m_cells.end() || b->sym < a->sym) {
+                double c = b->coefficient * coefficient;
+                if (!near_zero(c))
+                    merged.push_back({ b->sym, c });
+                ++b;
+            } else {
+                double c = a->coefficient + b->coefficient * coefficient;
+                if (!near_zero(c))
+                    merged.push_back({ a->sym, c });
+                ++a;
+                ++b;
+            }
+        }
+        m_cells.swap(merged);
+    }
+
+    void solver::row::remove(const symbol& s) {
+        auto it = find(s);
+        if (it != m_cells.end())
+            m_cells.erase(it);
+    }
+
+    void solver::row::reverse_sign() {
+        m_constant = -m_constant;
+        for (auto& c : m_cells)
+            c.coefficient = -c.coefficient;
+    }
+
+    void solver::row::solve_for(const symbol& s) {
+        auto it = find(s);
+        double coefficient = -1.0 / it->coefficient;
+        m_cells.erase(it);
+        m_constant *= coefficient;
+        for (auto& c : m_cells)
+            c.coefficient *= coefficient;
+    }
+
+    void solver::row::solve_for(const symbol& lhs, const symbol& rhs) {
+        insert(lhs, -1.0);
+        solve_for(rhs);
+    }
+
+    double solver::row::coefficient_for(const symbol& s) const {
+        auto it = find(s);
+        return it != m_cells.end() ? it->coefficient : 0.0;
+    }
+
+    void solver::row::substitute(const symbol& s, const row& other) {
+        auto it = find(s);
+        if (it != m_cells.end()) {
+            double coefficient = it->coefficient;
+            m_cells.erase(it);
+            insert(other, coefficient);
+        }
+    }
+
+    // Solver
+
+    bool solver::add_constraint(const constraint& c) {
+        if (has_constraint(c))
+            return false;
+
+        tag t;
+        auto r = create_row(c, t);
+        symbol subject = choose_subject(*r, t);
+
+        // A row made only of dummy variables is either redundant or unsatisfiable
+        if (!subject.valid() && all_dummies(*r)) {
+            if (!near_zero(r->constant()))
+                return false;
+            subject = t.marker;
+        }
+
+        if (!subject.valid()) {
+            if (!add_with_artificial_variable(*r))
+                return false;
+        } else {
+            r->solve_for(subject);
+            substitute(subject, *r);
+            m_rows[subject] = std::move(r);
+        }
+
+        m_constraints.emplace(c.id(), constraint_entry{ c, t });
+        optimize(m_objective);
+        return true;
+    }
+
+    bool solver::remove_constraint(const constraint& c) {
+        auto entry = m_constraints.find(c.id());
+        if (entry == m_constraints.end())
+            return false;
+
+        tag t = entry->second.t;
+        constraint cn = entry->second.cn;
+        m_constraints.erase(entry);
+
+        // Remove the error effects from the objective before pivoting, or substitutions into the objective lead to incorrect solver results
+        remove_constraint_effects(cn, t);
+
+        auto it = m_rows.find(t.marker);
+        if (it != m_rows.end()) {
+            m_rows.erase(it);
+        } else {
+            it = marker_leaving_row(t.marker);
+            if (it == m_rows.end())
+                return false;
+
+            symbol leaving = it->first;
+            std::unique_ptr<row> r = std::move(it->second);
+            m_rows.erase(it);
+            r->solve_for(leaving, t.marker);
+            substitute(t.marker, *r);
+        }
+
+        optimize(m_objective);
+        return true;
+    }
+
+    bool solver::add_edit_variable(const variable& v, double s) {
+        if (has_edit_variable(v))
+            return false;
+
+        s = strength::clip(s);
+        if (s >= strength::required)
+            return false;
+
+        constraint cn(expression(v), relation::equal, s);
+        if (!add_constraint(cn))
+            return false;
+
+        m_edits.emplace(v.id(), edit_info{ v, cn, m_constraints.at(cn.id()).t, 0.0 });
+        return true;
+    }
+
+    bool solver::remove_edit_variable(const variable& v) {
+        auto it = m_edits.find(v.id());
+        if (it == m_edits.end())
+            return false;
+
+        remove_constraint(it->second.cn);
+        m_edits.erase(it);
+        return true;
+    }
+
+    bool solver::suggest_value(const variable& v, double value) {
+        auto it = m_edits.find(v.id());
+        if (it == m_edits.end())
+            return false;
+
+        edit_info& info = it->second;
+        double delta = value - info.constant;
+        info.constant = value;
+        if (near_zero(delta))
+            return true;
+
+        // Check first if the positive error variable is basic
+        auto row_it = m_rows.find(info.t.marker);
+        if (row_it != m_rows.end()) {
+            if (row_it->second->add(-delta) < 0.0)
+                m_infeasible_rows.push_back(row_it->first);
+            dual_optimize();
+            return true;
+        }
+
+        // Check next if the negative error variable is basic
+        row_it = m_rows.find(info.t.other);
+        if (row_it != m_rows.end()) {
+            if (row_it->second->add(delta) < 0.0)
+                m_infeasible_rows.push_back(row_it->first);
+            dual_optimize();
+            return true;
+        }
+
+        // Otherwise update each row where the error variables exist
+        for (auto& [s, r] : m_rows) {
+            double coefficient = r->coefficient_for(info.t.marker);
+            if (coefficient != 0.0 && r->add(delta * coefficient) < 0.0 && s.type != symbol::kind::external)
+                m_infeasible_rows.push_back(s);
+        }
+        dual_optimize();
+        return true;
+    }
+
+    void solver::update_variables() {
+        for (auto& [id, entry] : m_vars) {
+            auto it = m_rows.find(entry.sym);
+            entry.var.set_value(it != m_rows.end() ? it->second->constant() : 0.0);
+        }
+    }
+
+    void solver::reset() {
+        m_constraints.clear();
+        m_edits.clear();
+        m_vars.clear();
+        m_rows.clear();
+        m_infeasible_rows.clear();
+        m_objective = row();
+        m_artificial.reset();
+        m_id_tick = 0;
+    }
+
+    solver::symbol solver::variable_symbol(const variable& v) {
+        auto it = m_vars.find(v.id());
+        if (it != m_vars.end())
+            return it->second.sym;
+
+        symbol s = make_symbol(symbol::kind::external);
+        m_vars.emplace(v.id(), variable_entry{ v, s });
+        return s;
+    }
+
+    std::unique_ptr<solver::row> solver::create_row(const constraint& c, tag& t) {
+        const expression& expr = c.expr();
+        auto r = std::make_unique<row>(expr.constant);
+
+        // Substitute the current basic variables into the row
+        for (const auto& term : expr.terms) {
+            if (near_zero(term.coefficient))
+                continue;
+
+            symbol s = variable_symbol(term.var);
+            auto it = m_rows.find(s);
+            if (it != m_rows.end())
+                r->insert(*it->second, term.coefficient);
+            else
+                r->insert(s, term.coefficient);
+        }
+
+        // Add the necessary slack, error, and dummy variables
+        switch (c.op()) {
+        case relation::less_equal:
+        case relation::greater_equal: {
+            double coefficient = c.op() == relation::less_equal ? 1.0 : -1.0;
+            symbol slack = make_symbol(symbol::kind::slack);
+            t.marker = slack;
+            r->insert(slack, coefficient);
+            if (c.get_strength() < strength::required) {
+                symbol error = make_symbol(symbol::kind::error);
+                t.other = error;
+                r->insert(error, -coefficient);
+                m_objective.insert(error, c.get_strength());
+            }
+            break;
+        }
+        case relation::equal:
+            if (c.get_strength() < strength::required) {
+                symbol error_plus = make_symbol(symbol::kind::error);
+                symbol error_minus = make_symbol(symbol::kind::error);
+                t.marker = error_plus;
+                t.other = error_minus;
+                r->insert(error_plus, -1.0);
+                r->insert(error_minus, 1.0);
+                m_objective.insert(error_plus, c.get_strength());
+                m_objective.insert(error_minus, c.get_strength());
+            } else {
+                symbol dummy = make_symbol(symbol::kind::dummy);
+                t.marker = dummy;
+                r->insert(dummy);
+            }
+            break;
+        }
+
+        // Ensure the row has a positive constant
+        if (r->constant() < 0.0)
+            r->reverse_sign();
+        return r;
+    }
+
+    solver::symbol solver::choose_subject(const row& r, const tag& t) const {
+        for (const auto& [s, c] : r.cells()) {
+            if (s.type == symbol::kind::external)
+                return s;
+        }
+        if (t.marker.type == symbol::kind::slack || t.marker.type == symbol::kind::error) {
+            if (r.coefficient_for(t.marker) < 0.0)
+                return t.marker;
+        }
+        if (t.other.type == symbol::kind::slack || t.other.type == symbol::kind::error) {
+            if (r.coefficient_for(t.other) < 0.0)
+                return t.other;
+        }
+        return {};
+    }
+
+    bool solver::add_with_artificial_variable(const row& r) {
+        // Create and add the artificial variable to the tableau
+        symbol art = make_symbol(symbol::kind::slack);
+        m_rows[art] = std::make_unique<row>(r);
+        m_artificial = std::make_unique<row>(r);
+
+        // Optimize the artificial objective. This is successful only if the artificial objective is optimized to zero.
+        optimize(*m_artificial);
+        bool success = near_zero(m_artificial->constant());
+        m_artificial.reset();
+
+        // If the artificial variable is basic, pivot the row so that it becomes non-basic.
+        // If the row is constant, exit early.
+        auto it = m_rows.find(art);
+        if (it != m_rows.end()) {
+            std::unique_ptr<row> basic = std::move(it->second);
+            m_rows.erase(it);
+            if (basic->cells().empty())
+                return success;
+
+            symbol entering = any_pivotable_symbol(*basic);
+            if (!entering.valid())
+                return false; // unsatisfiable (will this ever happen?)
+
+            basic->solve_for(art, entering);
+            substitute(entering, *basic);
+            m_rows[entering] = std::move(basic);
+        }
+
+        // Remove the artificial variable from the tableau
+        for (auto& [s, row_ptr] : m_rows)
+            row_ptr->remove(art);
+        m_objective.remove(art);
+        return success;
+    }
+
+    void solver::substitute(const symbol& s, const row& r) {
+        for (auto& [sym, row_ptr] : m_rows) {
+            row_ptr->substitute(s, r);
+            if (sym.type != symbol::kind::external && row_ptr->constant() < 0.0)
+                m_infeasible_rows.push_back(sym);
+        }
+        m_objective.substitute(s, r);
+        if (m_artificial)
+            m_artificial->substitute(s, r);
+    }
+
+    bool solver::optimize(const row& objective) {
+        for (;;) {
+            symbol entering = entering_symbol(objective);
+            if (!entering.valid())
+                return true;
+
+            auto it = leaving_row(entering);
+            if (it == m_rows.end())
+                return false; // objective is unbounded
+
+            // Pivot the entering symbol into the basis
+            symbol leaving = it->first;
+            std::unique_ptr<row> r = std::move(it->second);
+            m_rows.erase(it);
+            r->solve_for(leaving, entering);
+            substitute(entering, *r);
+            m_rows[entering] = std::move(r);
+        }
+    }
+
+    void solver::dual_optimize() {
+        while (!m_infeasible_rows.empty()) {
+            symbol leaving = m_infeasible_rows.back();
+            m_infeasible_rows.pop_back();
+
+            auto it = m_rows.find(leaving);
+            if (it == m_rows.end() || near_zero(it->second->constant()) || it->second->constant() >= 0.0)
+                continue;
+
+            symbol entering = dual_entering_symbol(*it->second);
+            if (!entering.valid())
+                continue; // dual optimize failed, leave the row as is
+
+            std::unique_ptr<row> r = std::move(it->second);
+            m_rows.erase(it);
+            r->solve_for(leaving, entering);
+            substitute(entering, *r);
+            m_rows[entering] = std::move(r);
+        }
+    }
+
+    solver::symbol solver::entering_symbol(const row& objective) const {
+        for (const auto& [s, c] : objective.cells()) {
+            if (s.type != symbol::kind::dummy && c < 0.0)
+                return s;
+        }
+        return {};
+    }
+
+    solver::symbol solver::dual_entering_symbol(const row& r) const {
+        symbol entering;
+        double ratio = (std::numeric_limits<double>::max)();
+        for (const auto& [s, c] : r.cells()) {
+            if (c > 0.0 && s.type != symbol::kind::dummy) {
+                double coefficient = m_objective.coefficient_for(s);
+                double candidate = coefficient / c;
+                if (candidate < ratio) {
+                    ratio = candidate;
+                    entering = s;
+                }
+            }
+        }
+        return entering;
+    }
+
+    solver::symbol solver::any_pivotable_symbol(const row& r) {
+        for (const auto& [s, c] : r.cells()) {
+            if (s.type == symbol::kind::slack || s.type == symbol::kind::error)
+                return s;
+        }
+        return {};
+    }
+
+    solver::row_map::iterator solver::leaving_row(const symbol& entering) {
+        double ratio = (std::numeric_limits<double>::max)();
+        auto found = m_rows.end();
+        for (auto it = m_rows.begin(); it != m_rows.end(); ++it) {
+            if (it->first.type == symbol::kind::external)
+                continue;
+
+            double coefficient = it->second->coefficient_for(entering);
+            if (coefficient < 0.0) {
+                double candidate = -it->second->constant() / coefficient;
+                if (candidate < ratio) {
+                    ratio = candidate;
+                    found = it;
+                }
+            }
+        }
+        return found;
+    }
+
+    solver::row_map::iterator solver::marker_leaving_row(const symbol& marker) {
+        const double max_ratio = (std::numeric_limits<double>::max)();
+        double r1 = max_ratio;
+        double r2 = max_ratio;
+        auto first = m_rows.end();
+        auto second = m_rows.end();
+        auto third = m_rows.end();
+
+        for (auto it = m_rows.begin(); it != m_rows.end(); ++it) {
+            double c = it->second->coefficient_for(marker);
+            if (c == 0.0)
+                continue;
+
+            if (it->first.type == symbol::kind::external) {
+                third = it;
+            } else if (c < 0.0) {
+                double r = -it->second->constant() / c;
+                if (r < r1) {
+                    r1 = r;
+                    first = it;
+                }
+            } else {
+                double r = it->second->constant() / c;
+                if (r < r2) {
+                    r2 = r;
+                    second = it;
+                }
+            }
+        }
+
+        if (first != m_rows.end())
+            return first;
+        if (second != m_rows.end())
+            return second;
+        return third;
+    }
+
+    void solver::remove_constraint_effects(const constraint& c, const tag& t) {
+        if (t.marker.type == symbol::kind::error)
+            remove_marker_effects(t.marker, c.get_strength());
+        if (t.other.type == symbol::kind::error)
+            remove_marker_effects(t.other, c.get_strength());
+    }
+
+    void solver::remove_marker_effects(const symbol& marker, double s) {
+        auto it = m_rows.find(marker);
+        if (it != m_rows.end())
+            m_objective.insert(*it->second, -s);
+        else
+            m_objective.insert(marker, -s);
+    }
+
+    bool solver::all_dummies(const row& r) {
+        for (const auto& [s, c] : r.cells()) {
+            if (s.type != symbol::kind::dummy)
+                return false;
+        }
+        return true;
+    }
+
+    // Constraint system
+
+    constraint_system::constraint_system() {
+        m_solver.add_edit_variable(m_content_width, strength::strong);
+        m_solver.add_edit_variable(m_content_height, strength::strong);
+    }
+
+    int constraint_system::add_slot() {
+        int index = static_cast<int>(m_slots.size());
+        auto& state = m_slots.emplace_back();
+
+        // Children never get a negative size
+        m_solver.add_constraint(state.vars.width >= 0.0);
+        m_solver.add_constraint(state.vars.height >= 0.0);
+        return index;
+    }
+
+    void constraint_system::sync_slot_size(int index, int desired_width, int desired_height,
+                                           int min_width, int min_height, int max_width, int max_height) {
+        auto& state = m_slots[index];
+        const int key[6] = { desired_width, desired_height, min_width, min_height, max_width, max_height };
+        if (std::equal(std::begin(key), std::end(key), std::begin(state.size_key)))
+            return;
+
+        for (const auto& c : state.size_constraints)
+            m_solver.remove_constraint(c);
+        state.size_constraints.clear();
+        std::copy(std::begin(key), std::end(key), std::begin(state.size_key));
+
+        // The size model is a preference, user constraints override it; min/max win over the preference
+        auto add = [&](const constraint& c) {
+            if (m_solver.add_constraint(c))
+                state.size_constraints.push_back(c);
+        };
+        add((state.vars.width == static_cast<double>(desired_width)) | strength::medium);
+        add((state.vars.height == static_cast<double>(desired_height)) | strength::medium);
+        add((state.vars.width >= static_cast<double>(min_width)) | strength::strong);
+        add((state.vars.height >= static_cast<double>(min_height)) | strength::strong);
+        if (max_width < (std::numeric_limits<int>::max)())
+            add((state.vars.width <= static_cast<double>(max_width)) | strength::strong);
+        if (max_height < (std::numeric_limits<int>::max)())
+            add((state.vars.height <= static_cast<double>(max_height)) | strength::strong);
+    }
+
+    void constraint_system::release_slot(int index) {
+        auto& state = m_slots[index];
+        for (const auto& c : state.size_constraints)
+            m_solver.remove_constraint(c);
+        state.size_constraints.clear();
+        std::fill(std::begin(state.size_key), std::end(state.size_key), -1);
+    }
+
+    void constraint_system::resize(int width, int height) {
+        if (width != m_last_width) {
+            m_solver.suggest_value(m_content_width, width);
+            m_last_width = width;
+        }
+        if (height != m_last_height) {
+            m_solver.suggest_value(m_content_height, height);
+            m_last_height = height;
+        }
+        m_solver.update_variables();
+    }
+}
@@ -0,0 +1,126 @@
+#include "../layout/damage_region.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace wpp::layout
+{
+    rect_t damage_region::join(const rect_t& a, const rect_t& b) {
+        int left = (std::min)(a.x, b.x);
+        int top = (std::min)(a.y, b.y);
+        int right = (std::max)(a.x + a.width, b.x + b.width);
+        int bottom = (std::max)(a.y + a.height, b.y + b.height);
+        return { left, top, right - left, bottom - top };
+    }
+
+    bool damage_region::touches(const rect_t& a, const rect_t& b) {
+        return a.x <= b.x + b.width && b.x <= a.x + a.width
+            && a.y <= b.y + b.height && b.y <= a.y + a.height;
+    }
+
+    void damage_region::add(const rect_t& area) {
+        if (area.width <= 0 || area.height <= 0)
+            return;
+
+        rect_t pending = area;
+        for (size_t i = 0; i < m_rects.size();) {
+            const rect_t& existing = m_rects[i];
+            if (touches(pending, existing)) {
+                rect_t joined = join(pending, existing);
+                if (joined == existing)
+                    return; // already covered
+
+                // Only merge when the bounding box does not cover more than the two rectangles on their own
+                if (rect_area(joined) <= rect_area(pending) + rect_area(existing)) {
+                    pending = joined;
+                    m_rects.erase(m_rects.begin() + i);
+                    i = 0;
+                    continue;
+                }
+            }
+            ++i;
+        }
+
+        m_rects.push_back(pending);
+        while (m_rects.size() > m_max_rects)
+            merge_cheapest_pair();
+    }
+
+    void damage_region::add(const damage_region& other) {
+        for (const auto& r : other.m_rects)
+            add(r);
+    }
+
+    void damage_region::merge_cheapest_pair() {
+        size_t best_a = 0, best_b = 1;
+        long long best_waste = -1;
+        for (size_t a = 0; a < m_rects.size(); ++a) {
+            for (size_t b = a + 1; b < m_rects.size(); ++b) {
+                long long waste = rect_area(join(m_rects[a], m_rects[b])) - rect_area(m_rects[a]) - rect_area(m_rects[b]);
+                if (best_waste < 0 || waste < best_waste) {
+                    best_waste = waste;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+
+        m_rects[best_a] = join(m_rects[best_a], m_rects[best_b]);
+        m_rects.erase(m_rects.begin() + best_b);
+    }
+
+    rect_t damage_region::bounds() const {
+        if (m_rects.empty())
+            return { 0, 0, 0, 0 };
+
+        rect_t result = m_rects.front();
+        for (size_t i = 1; i < m_rects.size(); ++i)
+            result = join(result, m_rects[i]);
+        return result;
+    }
+
+    long long damage_region::area() const {
+        // Sweep over the distinct x edges; the rect count is small so the quadratic walk is cheap
+        std::vector<int> edges;
+        edges.reserve(m_rects.size() * 2);
+        for (const auto& r : m_rects) {
+            edges.push_back(r.x);
+            edges.push_back(r.x + r.width);
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        long long total = 0;
+        std::vector<std::pair<int, int>> spans;
+        for (size_t e = 0; e + 1 < edges.size(); ++e) {
+            int x0 = edges[e], x1 = edges[e + 1];
+
+            spans.clear();
+            for (const auto& r : m_rects) {
+                if (r.x <= x0 && r.x + r.width >= x1)
+                    spans.emplace_back(r.y, r.y + r.height);
+            }
+            std::sort(spans.begin(), spans.end());
+
+            long long covered = 0;
+            int run_start = 0, run_end = 0;
+            bool in_run = false;
+            for (const auto& span : spans) {
+                if (!in_run || span.first > run_end) {
+                    if (in_run)
+                        covered += run_end - run_start;
+                    run_start = span.first;
+                    run_end = span.second;
+                    in_run = true;
+                } else {
+                    run_end = (std::max)(run_end, span.second);
+                }
+            }
+            if (in_run)
+                covered += run_end - run_start;
+
+            total += covered * (x1 - x0);
+        }
+        return total;
+    }
+}
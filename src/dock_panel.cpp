@@ -16,26 +16,22 @@ namespace wpp::layout
         if (control && std::find(m_children.begin(), m_children.end(), control) == m_children.end()) {
             m_children.push_back(control);
             m_dock_positions[control] = position;
+            track_child(control);
 
             child_measure measure;
             measure.control = control;
             measure.position = position;
-
-            // For nested panels, we'll measure them later
-            // For regular controls, use their current size
-            if (is_panel(control)) {
-                measure.desired_size = { 0, 0 };
-            } else {
-                RECT rc = control->get_rect();
-                int original_width = rc.right - rc.left;
-                int original_height = rc.bottom - rc.top;
-                measure.desired_size = { original_width, original_height };
-            }
-
             m_child_measures.push_back(measure);
         }
     }
 
+    void dock_panel::child_removed(const control_ptr<>& child) {
+        m_dock_positions.erase(child);
+        m_child_measures.erase(std::remove_if(m_child_measures.begin(), m_child_measures.end(),
+                                              [&](const child_measure& measure) { return measure.control == child; }),
+                               m_child_measures.end());
+    }
+
     void dock_panel::set_dock_position(control_ptr<> control, dock_position position) {
         if (control) {
             m_dock_positions[control] = position;
@@ -58,189 +54,37 @@ namespace wpp::layout
         return dock_position::fill;
     }
 
-    void dock_panel::measure(int available_width, int available_height) {
-        // Apply DPI scaling
-        int padding_h = static_cast<int>((m_padding.left + m_padding.right) * m_dpi_scale);
-        int padding_v = static_cast<int>((m_padding.top + m_padding.bottom) * m_dpi_scale);
-        int margin_h = static_cast<int>((m_margin.left + m_margin.right) * m_dpi_scale);
-        int margin_v = static_cast<int>((m_margin.top + m_margin.bottom) * m_dpi_scale);
+    void dock_panel::capture_node(layout_snapshot& snapshot, int node) const {
+        auto& tree = snapshot.tree;
+        capture_metrics(tree[node]);
+        tree[node].last_child_fill = m_last_child_fill;
 
-        // Adjust available space for padding and margin
-        int content_width = available_width - padding_h - margin_h;
-        int content_height = available_height - padding_v - margin_v;
-
-        int remaining_width = content_width;
-        int remaining_height = content_height;
-
-        // Update positions if last child fill is enabled
-        for (size_t i = 0; i < m_child_measures.size(); ++i) {
-            auto& measure = m_child_measures[i];
+        for (const auto& measure : m_child_measures) {
             if (!measure.control || !measure.control->is_valid()) continue;
 
-            // If last child and m_last_child_fill is true, override to fill
-            if (m_last_child_fill && i == m_child_measures.size() - 1) {
-                measure.position = dock_position::fill;
-            } else {
-                // Use stored position from m_dock_positions
-                measure.position = get_dock_position(measure.control);
-            }
-
-            int child_width = 0;
-            int child_height = 0;
-
-            // If this child is a nested panel, recursively measure it
-            if (auto child_panel = as_panel(measure.control)) {
-                child_panel->measure(remaining_width, remaining_height);
-                auto desired = child_panel->get_desired_size();
+            int child_node = capture_child(snapshot, node, measure.control);
+            tree[child_node].dock = get_dock_position(measure.control);
 
-                // Use the measured size for this pass, but preserve stored desired size if available
-                if (measure.desired_size.width > 0 && measure.desired_size.height > 0) {
-                    // Use stored preferred size, clamped to available space
-                    child_width = (std::min)(measure.desired_size.width, remaining_width);
-                    child_height = (std::min)(measure.desired_size.height, remaining_height);
-                } else {
-                    // First time measuring, store the result as preferred size
-                    child_width = desired.width;
-                    child_height = desired.height;
-                    measure.desired_size = { child_width, child_height };
-                }
-            } else {
-                // Use stored original sizes
-                child_width = measure.desired_size.width;
-                child_height = measure.desired_size.height;
-            }
-
-            // Reduce remaining space based on dock position
-            switch (measure.position) {
-            case dock_position::left:
-            case dock_position::right:
-                remaining_width -= child_width;
-                break;
-            case dock_position::top:
-            case dock_position::bottom:
-                remaining_height -= child_height;
-                break;
-            case dock_position::fill:
-                // Fill takes remaining space
-                break;
-            }
+            // Nested panels carry the size remembered from their first measure (0 until then)
+            if (tree[child_node].kind != node_kind::leaf)
+                tree[child_node].preferred = measure.desired_size;
         }
-
-        // Desired size is the full available space (including margin and padding)
-        m_desired_size.width = content_width + padding_h + margin_h;
-        m_desired_size.height = content_height + padding_v + margin_v;
     }
 
-    void dock_panel::arrange(int x, int y, int width, int height) {
-        m_actual_size = { width, height };
-
-        // Apply DPI scaling
-        int margin_left = static_cast<int>(m_margin.left * m_dpi_scale);
-        int margin_top = static_cast<int>(m_margin.top * m_dpi_scale);
-        int margin_right = static_cast<int>(m_margin.right * m_dpi_scale);
-        int margin_bottom = static_cast<int>(m_margin.bottom * m_dpi_scale);
-        int padding_left = static_cast<int>(m_padding.left * m_dpi_scale);
-        int padding_top = static_cast<int>(m_padding.top * m_dpi_scale);
-        int padding_right = static_cast<int>(m_padding.right * m_dpi_scale);
-        int padding_bottom = static_cast<int>(m_padding.bottom * m_dpi_scale);
-
-        // Apply margin offset to starting position
-        int margin_x = x + margin_left;
-        int margin_y = y + margin_top;
-
-        // Content area after margin and padding
-        int content_x = margin_x + padding_left;
-        int content_y = margin_y + padding_top;
-        int content_width = width - margin_left - margin_right - padding_left - padding_right;
-        int content_height = height - margin_top - margin_bottom - padding_top - padding_bottom;
-
-        // Track remaining space as we dock controls
-        int remaining_x = content_x;
-        int remaining_y = content_y;
-        int remaining_width = content_width;
-        int remaining_height = content_height;
-
-        for (auto& measure : m_child_measures) {
-            if (!measure.control || !measure.control->is_valid()) continue;
-
-            int child_x = 0, child_y = 0, child_width = 0, child_height = 0;
-
-            switch (measure.position) {
-            case dock_position::left:
-                child_x = remaining_x;
-                child_y = remaining_y;
-                child_width = measure.desired_size.width;
-                child_height = remaining_height;
-
-                // Update remaining space
-                remaining_x += child_width;
-                remaining_width -= child_width;
-                break;
-
-            case dock_position::top:
-                child_x = remaining_x;
-                child_y = remaining_y;
-                child_width = remaining_width;
-                child_height = measure.desired_size.height;
-
-                // Update remaining space
-                remaining_y += child_height;
-                remaining_height -= child_height;
-                break;
-
-            case dock_position::right:
-                child_width = measure.desired_size.width;
-                child_height = remaining_height;
-                child_x = remaining_x + remaining_width - child_width;
-                child_y = remaining_y;
-
-                // Update remaining space
-                remaining_width -= child_width;
-                break;
-
-            case dock_position::bottom:
-                child_width = remaining_width;
-                child_height = measure.desired_size.height;
-                child_x = remaining_x;
-                child_y = remaining_y + remaining_height - child_height;
-
-                // Update remaining space
-                remaining_height -= child_height;
-                break;
+    void dock_panel::apply_node(const layout_snapshot& snapshot, int node) {
+        panel::apply_node(snapshot, node);
 
-            case dock_position::fill:
-                child_x = remaining_x;
-                child_y = remaining_y;
-                child_width = remaining_width;
-                child_height = remaining_height;
-                break;
-            }
-
-            // Ensure non-negative dimensions
-            child_width = (std::max)(0, child_width);
-            child_height = (std::max)(0, child_height);
-
-            // Position the control
-            measure.control->move(child_x, child_y, child_width, child_height);
-
-            // If this is a nested panel, arrange its children
-            if (auto child_panel = as_panel(measure.control)) {
-                child_panel->arrange(child_x, child_y, child_width, child_height);
-                // Invalidate panel window to ensure it repaints
-                if (child_panel->get_handle()) {
-                    child_panel->invalidate();
+        const auto& tree = snapshot.tree;
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& target = snapshot.targets[tree[child].target];
+            for (auto& measure : m_child_measures) {
+                if (measure.control == target) {
+                    measure.position = tree[child].dock;
+                    if (tree[child].kind != node_kind::leaf)
+                        measure.desired_size = tree[child].preferred;
+                    break;
                 }
             }
-
-            // Invalidate control to prevent artifacts during resize
-            if (measure.control->get_handle()) {
-				measure.control->invalidate();
-            }
-        }
-
-        // Invalidate the panel window itself
-        if (m_handle) {
-            invalidate();
         }
     }
 
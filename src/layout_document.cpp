@@ -0,0 +1,556 @@
+#include "../layout/layout_document.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace wpp::layout
+{
+    namespace {
+        struct element_name {
+            std::string_view name;
+            element_kind kind;
+            control_kind control;
+        };
+
+        constexpr element_name element_names[] = {
+            { "grid", element_kind::grid, control_kind::none },
+            { "stack", element_kind::stack, control_kind::none },
+            { "dock", element_kind::dock, control_kind::none },
+            { "canvas", element_kind::canvas, control_kind::none },
+            { "static", element_kind::control, control_kind::static_text },
+            { "button", element_kind::control, control_kind::button },
+            { "check_box", element_kind::control, control_kind::check_box },
+            { "edit", element_kind::control, control_kind::edit },
+            { "rich_edit", element_kind::control, control_kind::rich_edit },
+            { "list_box", element_kind::control, control_kind::list_box },
+            { "list_view", element_kind::control, control_kind::list_view },
+            { "combo_box", element_kind::control, control_kind::combo_box },
+            { "tree_view", element_kind::control, control_kind::tree_view },
+            { "tab", element_kind::control, control_kind::tab },
+            { "progress", element_kind::control, control_kind::progress },
+            { "track_bar", element_kind::control, control_kind::track_bar },
+            { "group_box", element_kind::control, control_kind::group_box },
+            { "link", element_kind::control, control_kind::link },
+        };
+
+        constexpr std::size_t align_up(std::size_t value) { return (value + 7) & ~static_cast<std::size_t>(7); }
+
+        // Tokenizer and recursive descent parser for the text form
+        class parser {
+        public:
+            parser(std::string_view text, layout_document& document) : m_text(text), m_document(document) {}
+
+            bool run(std::string* error) {
+                skip_space();
+                if (at_end())
+                    return fail("empty layout", error);
+                if (!parse_element(layout_record::no_parent))
+                    return fail(m_error, error);
+
+                skip_space();
+                if (!at_end())
+                    return fail("only one root element is allowed", error);
+                if (m_document.nodes[0].kind == element_kind::control)
+                    return fail("the root element must be a panel", error);
+                return true;
+            }
+
+        private:
+            bool fail(const std::string& message, std::string* error) {
+                if (error)
+                    *error = "line " + std::to_string(m_line) + ": " + message;
+                return false;
+            }
+
+            bool error(std::string message) {
+                m_error = std::move(message);
+                return false;
+            }
+
+            // "'value' reason"; built by appending, which GCC 12 does not misreport under -Wrestrict
+            bool error(std::string_view value, std::string_view reason) {
+                std::string message;
+                message.reserve(value.size() + reason.size() + 3);
+                message.append(1, '\'').append(value).append("' ").append(reason);
+                return error(std::move(message));
+            }
+
+            bool at_end() const { return m_pos >= m_text.size(); }
+
+            void skip_space() {
+                while (!at_end()) {
+                    char c = m_text[m_pos];
+                    if (c == '\n') {
+                        m_line++;
+                        m_pos++;
+                    } else if (c == ' ' || c == '\t' || c == '\r') {
+                        m_pos++;
+                    } else if (c == '/' && m_pos + 1 < m_text.size() && m_text[m_pos + 1] == '/') {
+                        while (!at_end() && m_text[m_pos] != '\n')
+                            m_pos++;
+                    } else {
+                        break;
+                    }
+                }
+            }
+
+            static bool is_word_char(char c) {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+            }
+
+            std::string_view read_word() {
+                std::size_t start = m_pos;
+                while (!at_end() && is_word_char(m_text[m_pos]))
+                    m_pos++;
+                return m_text.substr(start, m_pos - start);
+            }
+
+            // A quoted string (with \" \\ \n \t escapes) or a bare run up to whitespace or a brace
+            bool read_value(std::string& value) {
+                value.clear();
+                if (at_end())
+                    return error("missing value");
+
+                if (m_text[m_pos] != '"') {
+                    std::size_t start = m_pos;
+                    while (!at_end() && m_text[m_pos] != ' ' && m_text[m_pos] != '\t' && m_text[m_pos] != '\r'
+                           && m_text[m_pos] != '\n' && m_text[m_pos] != '{' && m_text[m_pos] != '}')
+                        m_pos++;
+                    value.assign(m_text.substr(start, m_pos - start));
+                    return !value.empty() || error("missing value");
+                }
+
+                m_pos++;
+                while (!at_end() && m_text[m_pos] != '"') {
+                    char c = m_text[m_pos++];
+                    if (c == '\n')
+                        return error("unterminated string");
+                    if (c == '\\' && !at_end()) {
+                        char escaped = m_text[m_pos++];
+                        c = escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped;
+                    }
+                    value.push_back(c);
+                }
+                if (at_end())
+                    return error("unterminated string");
+                m_pos++;
+                return true;
+            }
+
+            bool parse_element(std::uint32_t parent) {
+                std::string_view name = read_word();
+                if (name.empty())
+                    return error("expected an element name");
+
+                const element_name* element = nullptr;
+                for (const auto& candidate : element_names) {
+                    if (candidate.name == name)
+                        element = &candidate;
+                }
+                if (!element)
+                    return error("unknown element '" + std::string(name) + "'");
+
+                std::size_t index = m_document.nodes.size();
+
+                layout_record record;
+                record.kind = element->kind;
+                record.control = element->control;
+                record.parent = parent;
+                m_document.nodes.push_back(record);
+
+                // Attributes up to the end of the element or its child block
+                std::vector<layout_definition> rows, columns;
+                for (;;) {
+                    skip_space();
+                    if (at_end() || m_text[m_pos] == '{' || m_text[m_pos] == '}')
+                        break;
+
+                    std::size_t checkpoint = m_pos;
+                    std::string_view key = read_word();
+                    if (key.empty() || at_end() || m_text[m_pos] != '=') {
+                        // Not an attribute: the next sibling element starts here
+                        m_pos = checkpoint;
+                        if (key.empty())
+                            return error("unexpected character '" + std::string(1, m_text[m_pos]) + "'");
+                        break;
+                    }
+                    m_pos++;
+
+                    std::string value;
+                    if (!read_value(value))
+                        return false;
+                    if (!set_attribute(index, key, value, rows, columns))
+                        return false;
+                }
+
+                if (!rows.empty() || !columns.empty()) {
+                    layout_record& grid = m_document.nodes[index];
+                    if (grid.kind != element_kind::grid)
+                        return error("rows and columns only apply to a grid");
+                    if (rows.size() > 0xFFFF || columns.size() > 0xFFFF)
+                        return error("too many grid definitions");
+                    grid.definitions_begin = static_cast<std::uint32_t>(m_document.definitions.size());
+                    grid.row_count = static_cast<std::uint16_t>(rows.size());
+                    grid.column_count = static_cast<std::uint16_t>(columns.size());
+                    m_document.definitions.insert(m_document.definitions.end(), rows.begin(), rows.end());
+                    m_document.definitions.insert(m_document.definitions.end(), columns.begin(), columns.end());
+                }
+
+                if (!at_end() && m_text[m_pos] == '{') {
+                    if (element->kind == element_kind::control)
+                        return error("controls cannot have children");
+                    m_pos++;
+                    for (;;) {
+                        skip_space();
+                        if (at_end())
+                            return error("missing '}'");
+                        if (m_text[m_pos] == '}') {
+                            m_pos++;
+                            break;
+                        }
+                        if (!parse_element(static_cast<std::uint32_t>(index)))
+                            return false;
+                    }
+                }
+
+                m_document.nodes[index].subtree_size = static_cast<std::uint32_t>(m_document.nodes.size() - index);
+                return true;
+            }
+
+            bool parse_int(std::string_view text, int& value) {
+                auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (result.ec != std::errc{} || result.ptr != text.data() + text.size())
+                    return error(text, "is not a number");
+                return true;
+            }
+
+            bool parse_short(std::string_view text, std::int16_t& value) {
+                int parsed = 0;
+                if (!parse_int(text, parsed))
+                    return false;
+                if (parsed < -32768 || parsed > 32767)
+                    return error(text, "is out of range");
+                value = static_cast<std::int16_t>(parsed);
+                return true;
+            }
+
+            // One or four comma separated values
+            bool parse_edges(std::string_view text, std::int16_t (&edges)[4]) {
+                std::int16_t values[4] = { 0, 0, 0, 0 };
+                int count = 0;
+                for (;;) {
+                    if (count == 4)
+                        return error("expected one or four values");
+
+                    std::size_t comma = text.find(',');
+                    if (!parse_short(text.substr(0, comma), values[count++]))
+                        return false;
+                    if (comma == std::string_view::npos)
+                        break;
+                    text.remove_prefix(comma + 1);
+                }
+
+                if (count != 1 && count != 4)
+                    return error("expected one or four values");
+                for (int i = 0; i < 4; ++i)
+                    edges[i] = values[count == 1 ? 0 : i];
+                return true;
+            }
+
+            bool parse_lengths(std::string_view text, std::vector<layout_definition>& lengths) {
+                while (!text.empty()) {
+                    std::size_t comma = text.find(',');
+                    std::string_view item = text.substr(0, comma);
+                    text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+
+                    layout_definition definition;
+                    if (item == "auto") {
+                        definition.type = static_cast<std::uint8_t>(grid_length_type::auto_size);
+                        definition.value = 0.0f;
+                    } else if (!item.empty() && item.back() == '*') {
+                        definition.type = static_cast<std::uint8_t>(grid_length_type::star);
+                        item.remove_suffix(1);
+                        if (!item.empty()) {
+                            auto result = std::from_chars(item.data(), item.data() + item.size(), definition.value);
+                            if (result.ec != std::errc{} || result.ptr != item.data() + item.size() || definition.value <= 0.0f)
+                                return error(std::string_view(item.data(), item.size() + 1), "is not a valid star length");
+                        }
+                    } else {
+                        int pixels = 0;
+                        if (!parse_int(item, pixels) || pixels < 0)
+                            return error(item, "is not a valid length");
+                        definition.type = static_cast<std::uint8_t>(grid_length_type::pixel);
+                        definition.value = static_cast<float>(pixels);
+                    }
+                    lengths.push_back(definition);
+                }
+                return !lengths.empty() || error("expected at least one length");
+            }
+
+            static bool parse_alignment(std::string_view text, std::uint8_t& value) {
+                constexpr std::string_view names[] = { "start", "center", "end", "stretch" };
+                for (std::uint8_t i = 0; i < 4; ++i) {
+                    if (names[i] == text) {
+                        value = i;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            std::uint32_t add_string(std::string_view text) {
+                auto it = m_string_offsets.find(std::string(text));
+                if (it != m_string_offsets.end())
+                    return it->second;
+
+                auto offset = static_cast<std::uint32_t>(m_document.strings.size());
+                m_document.strings.append(text);
+                m_document.strings.push_back('\0');
+                m_string_offsets.emplace(std::string(text), offset);
+                return offset;
+            }
+
+            bool set_attribute(std::size_t index, std::string_view key, const std::string& value,
+                               std::vector<layout_definition>& rows, std::vector<layout_definition>& columns) {
+                layout_record& record = m_document.nodes[index];
+                bool is_panel = record.kind != element_kind::control;
+                int number = 0;
+
+                if (key == "name") {
+                    if (!m_names.emplace(value).second)
+                        return error("duplicate name '" + value + "'");
+                    record.name = add_string(value);
+                } else if (key == "text" && !is_panel) {
+                    if (value.find('\0') != std::string::npos)
+                        return error("text cannot contain NUL");
+                    record.text = add_string(value);
+                } else if ((key == "width" || key == "height") && !is_panel) {
+                    if (!parse_int(value, number) || number < 0)
+                        return number < 0 ? error("sizes cannot be negative") : false;
+                    (key == "width" ? record.width : record.height) = number;
+                } else if (key == "margin" && is_panel) {
+                    if (!parse_edges(value, record.margin))
+                        return false;
+                    record.flags |= record_flags::margin;
+                } else if (key == "padding" && is_panel) {
+                    if (!parse_edges(value, record.padding))
+                        return false;
+                    record.flags |= record_flags::padding;
+                } else if ((key == "spacing" || key == "row_spacing") && is_panel) {
+                    if (!parse_short(value, record.spacing))
+                        return false;
+                    record.flags |= record_flags::spacing;
+                    if (key == "spacing" && !(record.flags & record_flags::column_spacing))
+                        record.column_spacing = record.spacing;
+                } else if (key == "column_spacing" && record.kind == element_kind::grid) {
+                    if (!parse_short(value, record.column_spacing))
+                        return false;
+                    record.flags |= record_flags::column_spacing;
+                } else if (key == "rows" && record.kind == element_kind::grid) {
+                    rows.clear();
+                    return parse_lengths(value, rows);
+                } else if (key == "columns" && record.kind == element_kind::grid) {
+                    columns.clear();
+                    return parse_lengths(value, columns);
+                } else if (key == "orientation" && record.kind == element_kind::stack) {
+                    if (value != "horizontal" && value != "vertical")
+                        return error("orientation is horizontal or vertical");
+                    record.orientation = static_cast<std::uint8_t>(value == "horizontal" ? orientation::horizontal : orientation::vertical);
+                    record.flags |= record_flags::orientation;
+                } else if (key == "align" && record.kind == element_kind::stack) {
+                    if (!parse_alignment(value, record.alignment))
+                        return error("align is start, center, end or stretch");
+                    record.flags |= record_flags::alignment;
+                } else if (key == "last_child_fill" && record.kind == element_kind::dock) {
+                    if (value != "true" && value != "false")
+                        return error("last_child_fill is true or false");
+                    record.flags |= record_flags::has_last_child_fill;
+                    if (value == "true")
+                        record.flags |= record_flags::last_child_fill;
+                } else if (key == "row" || key == "column" || key == "row_span" || key == "column_span") {
+                    std::int16_t cell = 0;
+                    if (!parse_short(value, cell))
+                        return false;
+                    if (cell < (key.ends_with("span") ? 1 : 0))
+                        return error(std::string(key) + " is out of range");
+                    if (key == "row") record.row = cell;
+                    else if (key == "column") record.column = cell;
+                    else if (key == "row_span") record.row_span = cell;
+                    else record.column_span = cell;
+                    record.flags |= record_flags::grid_position;
+                } else if (key == "h_align" || key == "v_align") {
+                    if (!parse_alignment(value, key == "h_align" ? record.h_align : record.v_align))
+                        return error(std::string(key) + " is start, center, end or stretch");
+                    record.flags |= record_flags::cell_alignment;
+                } else if (key == "dock") {
+                    constexpr std::string_view sides[] = { "left", "top", "right", "bottom", "fill" };
+                    bool found = false;
+                    for (std::uint8_t i = 0; i < 5; ++i) {
+                        if (sides[i] == value) {
+                            record.dock = i;
+                            found = true;
+                        }
+                    }
+                    if (!found)
+                        return error("dock is left, top, right, bottom or fill");
+                    record.flags |= record_flags::dock;
+                } else if (key == "x" || key == "y" || key == "z") {
+                    if (!parse_int(value, number))
+                        return false;
+                    (key == "x" ? record.x : key == "y" ? record.y : record.z) = number;
+                    record.flags |= record_flags::canvas_position;
+                } else {
+                    return error("unknown attribute '" + std::string(key) + "'");
+                }
+                return true;
+            }
+
+            std::string_view m_text;
+            layout_document& m_document;
+            std::size_t m_pos = 0;
+            int m_line = 1;
+            std::string m_error;
+            std::unordered_map<std::string, std::uint32_t> m_string_offsets;
+            std::unordered_set<std::string> m_names;
+        };
+    }
+
+    bool layout_document::parse(std::string_view text, layout_document& document, std::string* error) {
+        document = {};
+        parser p(text, document);
+        if (p.run(error))
+            return true;
+
+        document = {};
+        return false;
+    }
+
+    std::vector<std::uint8_t> layout_document::serialize() const {
+        layout_blob_header header;
+        header.node_count = static_cast<std::uint32_t>(nodes.size());
+        header.definition_count = static_cast<std::uint32_t>(definitions.size());
+        header.string_bytes = static_cast<std::uint32_t>(strings.size());
+
+        std::size_t offset = align_up(sizeof(layout_blob_header));
+        header.nodes_offset = static_cast<std::uint32_t>(offset);
+        offset = align_up(offset + nodes.size() * sizeof(layout_record));
+        header.definitions_offset = static_cast<std::uint32_t>(offset);
+        offset = align_up(offset + definitions.size() * sizeof(layout_definition));
+        header.strings_offset = static_cast<std::uint32_t>(offset);
+        offset = align_up(offset + strings.size());
+        header.total_size = static_cast<std::uint32_t>(offset);
+
+        std::vector<std::uint8_t> blob(offset, 0);
+        std::memcpy(blob.data(), &header, sizeof(header));
+        if (!nodes.empty())
+            std::memcpy(blob.data() + header.nodes_offset, nodes.data(), nodes.size() * sizeof(layout_record));
+        if (!definitions.empty())
+            std::memcpy(blob.data() + header.definitions_offset, definitions.data(), definitions.size() * sizeof(layout_definition));
+        if (!strings.empty())
+            std::memcpy(blob.data() + header.strings_offset, strings.data(), strings.size());
+        return blob;
+    }
+
+    bool layout_view::open(const void* data, std::size_t size, layout_view& view, std::string* error) {
+        auto fail = [error](const char* message) {
+            if (error)
+                *error = message;
+            return false;
+        };
+
+        view = {};
+        if (!data || size < sizeof(layout_blob_header))
+            return fail("layout data is too small");
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(layout_record) != 0)
+            return fail("layout data is not aligned");
+
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        const auto& header = *reinterpret_cast<const layout_blob_header*>(bytes);
+        if (header.magic != layout_blob_header::magic_value)
+            return fail("not a compiled layout");
+        if (header.version != layout_blob_header::current_version || header.header_size != sizeof(layout_blob_header))
+            return fail("unsupported layout version");
+        if (header.total_size > size || header.node_count == 0)
+            return fail("layout data is truncated");
+
+        auto section_fits = [&](std::uint32_t offset, std::uint64_t length, std::size_t alignment) {
+            return offset % alignment == 0 && offset >= sizeof(layout_blob_header)
+                && static_cast<std::uint64_t>(offset) + length <= header.total_size;
+        };
+        if (!section_fits(header.nodes_offset, static_cast<std::uint64_t>(header.node_count) * sizeof(layout_record), alignof(layout_record))
+            || !section_fits(header.definitions_offset, static_cast<std::uint64_t>(header.definition_count) * sizeof(layout_definition), alignof(layout_definition))
+            || !section_fits(header.strings_offset, header.string_bytes, 1))
+            return fail("layout section out of range");
+
+        std::span<const layout_record> nodes(reinterpret_cast<const layout_record*>(bytes + header.nodes_offset), header.node_count);
+        std::span<const layout_definition> definitions(reinterpret_cast<const layout_definition*>(bytes + header.definitions_offset),
+                                                       header.definition_count);
+        std::span<const char> strings(reinterpret_cast<const char*>(bytes + header.strings_offset), header.string_bytes);
+        if (!strings.empty() && strings.back() != '\0')
+            return fail("layout string table is not terminated");
+
+        auto valid_string = [&](std::uint32_t offset) {
+            return offset == layout_record::no_string || offset < strings.size();
+        };
+
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            const layout_record& record = nodes[i];
+            if (static_cast<std::uint8_t>(record.kind) > static_cast<std::uint8_t>(element_kind::control)
+                || static_cast<std::uint8_t>(record.control) > static_cast<std::uint8_t>(control_kind::link)
+                || (record.kind == element_kind::control) == (record.control == control_kind::none))
+                return fail("layout element has an unknown kind");
+            if (record.orientation > 1 || record.alignment > 3 || record.h_align > 3 || record.v_align > 3 || record.dock > 4)
+                return fail("layout element has an invalid option");
+            if (!valid_string(record.name) || !valid_string(record.text))
+                return fail("layout element string out of range");
+            if (static_cast<std::uint64_t>(record.definitions_begin) + record.row_count + record.column_count > definitions.size())
+                return fail("layout grid definitions out of range");
+            if (record.subtree_size == 0 || record.subtree_size > nodes.size() - i)
+                return fail("layout element subtree out of range");
+
+            // Parents come first, are panels, and contain their children's subtrees
+            if (i == 0) {
+                if (record.parent != layout_record::no_parent || record.subtree_size != nodes.size() || record.kind == element_kind::control)
+                    return fail("layout root is invalid");
+            } else {
+                if (record.parent >= i)
+                    return fail("layout element parent is out of order");
+                const layout_record& parent = nodes[record.parent];
+                if (parent.kind == element_kind::control || i + record.subtree_size > record.parent + static_cast<std::size_t>(parent.subtree_size))
+                    return fail("layout element parent is invalid");
+            }
+        }
+        for (const auto& definition : definitions) {
+            if (definition.type > static_cast<std::uint8_t>(grid_length_type::star))
+                return fail("layout grid definition is invalid");
+        }
+
+        view.m_nodes = nodes;
+        view.m_definitions = definitions;
+        view.m_strings = strings;
+        return true;
+    }
+
+    bool instantiate(const layout_view& view, layout_builder& builder) {
+        builder.reserve(view.size());
+        for (std::size_t i = 0; i < view.size(); ++i) {
+            const layout_record& record = view[i];
+            if (!builder.create(i, record, view))
+                return false;
+            if (record.parent != layout_record::no_parent && !builder.attach(record.parent, i, record, view))
+                return false;
+        }
+        return true;
+    }
+
+    bool compile_layout(std::string_view text, std::vector<std::uint8_t>& blob, std::string* error) {
+        layout_document document;
+        if (!layout_document::parse(text, document, error))
+            return false;
+
+        blob = document.serialize();
+        return true;
+    }
+}
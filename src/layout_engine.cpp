@@ -0,0 +1,731 @@
+#include "../layout/layout_engine.hpp"
+#include "../layout/constraint_solver.hpp"
+#include "../thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace wpp::layout
+{
+    namespace {
+        // Clamp a cell position to the valid grid range
+        grid_position clamp_cell(grid_position pos, int row_count, int column_count) {
+            pos.row = (std::min)(pos.row, row_count - 1);
+            pos.column = (std::min)(pos.column, column_count - 1);
+            pos.row_span = (std::min)(pos.row_span, row_count - pos.row);
+            pos.column_span = (std::min)(pos.column_span, column_count - pos.column);
+            return pos;
+        }
+
+        // Place a desired extent inside a slot along one axis
+        void align_axis(alignment align, int slot_pos, int slot_size, int desired, int& out_pos, int& out_size) {
+            out_pos = slot_pos;
+            out_size = slot_size;
+            switch (align) {
+            case alignment::start:
+                out_size = (std::min)(desired, slot_size);
+                break;
+            case alignment::center:
+                out_size = (std::min)(desired, slot_size);
+                out_pos = slot_pos + (slot_size - out_size) / 2;
+                break;
+            case alignment::end:
+                out_size = (std::min)(desired, slot_size);
+                out_pos = slot_pos + slot_size - out_size;
+                break;
+            case alignment::stretch:
+                break;
+            }
+        }
+
+        sizing_t clamp_size(const layout_node& n, sizing_t size) {
+            size.width = (std::max)(n.min_size.width, (std::min)(size.width, n.max_size.width));
+            size.height = (std::max)(n.min_size.height, (std::min)(size.height, n.max_size.height));
+            return size;
+        }
+
+        // Leaves never look at the available space, their desired size is the clamped content size
+        void measure_leaf(layout_node& n) {
+            n.desired = clamp_size(n, n.preferred);
+        }
+
+        int horizontal_insets(const layout_node& n) {
+            return n.margin.left + n.margin.right + n.padding.left + n.padding.right;
+        }
+
+        int vertical_insets(const layout_node& n) {
+            return n.margin.top + n.margin.bottom + n.padding.top + n.padding.bottom;
+        }
+    }
+
+    int layout_tree::add_node(node_kind kind, int parent) {
+        int index = static_cast<int>(m_nodes.size());
+        auto& node = m_nodes.emplace_back();
+        node.kind = kind;
+        node.parent = parent;
+
+        if (parent >= 0) {
+            auto& p = m_nodes[parent];
+            if (p.last_child >= 0)
+                m_nodes[p.last_child].next_sibling = index;
+            else
+                p.first_child = index;
+            p.last_child = index;
+            p.child_count++;
+        }
+        return index;
+    }
+
+    void layout_tree::set_row_definitions(int node, const std::vector<grid_length>& rows) {
+        m_nodes[node].row_definition_offset = static_cast<int>(m_track_definitions.size());
+        m_nodes[node].row_definition_count = static_cast<int>(rows.size());
+        m_track_definitions.insert(m_track_definitions.end(), rows.begin(), rows.end());
+    }
+
+    void layout_tree::set_column_definitions(int node, const std::vector<grid_length>& columns) {
+        m_nodes[node].column_definition_offset = static_cast<int>(m_track_definitions.size());
+        m_nodes[node].column_definition_count = static_cast<int>(columns.size());
+        m_track_definitions.insert(m_track_definitions.end(), columns.begin(), columns.end());
+    }
+
+    int layout_tree::row_count(int node) const {
+        return (std::max)(1, m_nodes[node].row_definition_count);
+    }
+
+    int layout_tree::column_count(int node) const {
+        return (std::max)(1, m_nodes[node].column_definition_count);
+    }
+
+    void layout_tree::finalize() {
+        // Pre-order storage: children always follow their parent, so a reverse sweep accumulates subtree sizes
+        for (auto& node : m_nodes)
+            node.subtree_size = 1;
+        for (int i = static_cast<int>(m_nodes.size()) - 1; i > 0; --i) {
+            int parent = m_nodes[i].parent;
+            if (parent >= 0)
+                m_nodes[parent].subtree_size += m_nodes[i].subtree_size;
+        }
+
+        size_t track_storage = 0;
+        for (int i = 0; i < static_cast<int>(m_nodes.size()); ++i) {
+            if (m_nodes[i].kind == node_kind::grid) {
+                m_nodes[i].track_offset = static_cast<int>(track_storage);
+                track_storage += 2 * static_cast<size_t>(row_count(i) + column_count(i));
+            }
+        }
+        m_tracks.assign(track_storage, 0);
+    }
+
+    void layout_tree::set_constraint_system(int node, std::shared_ptr<constraints::constraint_system> system) {
+        m_nodes[node].system_index = static_cast<int>(m_systems.size());
+        m_systems.push_back(std::move(system));
+    }
+
+    void layout_tree::clear() {
+        m_systems.clear();
+        m_nodes.clear();
+        m_track_definitions.clear();
+        m_tracks.clear();
+    }
+
+    void layout_tree::reserve(size_t node_count) {
+        m_nodes.reserve(node_count);
+    }
+
+    bool layout_engine::should_fork(const layout_tree& tree, int node) const {
+        return m_pool != nullptr && tree[node].kind != node_kind::leaf && tree[node].subtree_size >= m_parallel_grain;
+    }
+
+    void layout_engine::measure(layout_tree& tree, int node, int available_width, int available_height) const {
+        if (!m_statistics) {
+            measure_node(tree, node, available_width, available_height);
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        measure_node(tree, node, available_width, available_height);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        m_statistics->measure_passes.fetch_add(1, std::memory_order_relaxed);
+        m_statistics->measure_ns.fetch_add(static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed);
+    }
+
+    void layout_engine::arrange(layout_tree& tree, int node, const rect_t& bounds) const {
+        if (!m_statistics) {
+            arrange_node(tree, node, bounds);
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        arrange_node(tree, node, bounds);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        m_statistics->arrange_passes.fetch_add(1, std::memory_order_relaxed);
+        m_statistics->arrange_ns.fetch_add(static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed);
+    }
+
+    void layout_engine::measure_node(layout_tree& tree, int node, int available_width, int available_height) const {
+        if (m_statistics)
+            m_statistics->nodes_measured.fetch_add(1, std::memory_order_relaxed);
+
+        switch (tree[node].kind) {
+        case node_kind::grid:
+            measure_grid(tree, node, available_width, available_height);
+            break;
+        case node_kind::stack:
+            measure_stack(tree, node, available_width, available_height);
+            break;
+        case node_kind::dock:
+            measure_dock(tree, node, available_width, available_height);
+            break;
+        case node_kind::canvas:
+            measure_canvas(tree, node, available_width, available_height);
+            break;
+        case node_kind::constraint:
+            measure_constraint(tree, node, available_width, available_height);
+            break;
+        case node_kind::leaf:
+            measure_leaf(tree[node]);
+            return;
+        }
+        tree[node].desired = clamp_size(tree[node], tree[node].desired);
+    }
+
+    void layout_engine::arrange_node(layout_tree& tree, int node, const rect_t& slot) const {
+        if (m_statistics)
+            m_statistics->nodes_arranged.fetch_add(1, std::memory_order_relaxed);
+
+        // Whatever slot the parent hands out, the element keeps within its own min/max
+        sizing_t size = clamp_size(tree[node], { slot.width, slot.height });
+        rect_t bounds{ slot.x, slot.y, size.width, size.height };
+
+        switch (tree[node].kind) {
+        case node_kind::grid:
+            arrange_grid(tree, node, bounds);
+            break;
+        case node_kind::stack:
+            arrange_stack(tree, node, bounds);
+            break;
+        case node_kind::dock:
+            arrange_dock(tree, node, bounds);
+            break;
+        case node_kind::canvas:
+            arrange_canvas(tree, node, bounds);
+            break;
+        case node_kind::constraint:
+            arrange_constraint(tree, node, bounds);
+            break;
+        case node_kind::leaf:
+            tree[node].bounds = bounds;
+            break;
+        }
+    }
+
+    void layout_engine::measure_grid(layout_tree& tree, int node, int available_width, int available_height) const {
+        const int row_count = tree.row_count(node);
+        const int column_count = tree.column_count(node);
+        const int row_spacing = tree[node].row_spacing;
+        const int column_spacing = tree[node].column_spacing;
+        const int insets_h = horizontal_insets(tree[node]);
+        const int insets_v = vertical_insets(tree[node]);
+
+        // Calculate spacing overhead
+        int total_row_spacing = (row_count > 1) ? row_spacing * (row_count - 1) : 0;
+        int total_column_spacing = (column_count > 1) ? column_spacing * (column_count - 1) : 0;
+
+        int content_width = available_width - insets_h - total_column_spacing;
+        int content_height = available_height - insets_v - total_row_spacing;
+
+        // Nested panels are measured against the full content area; independent subtrees run in parallel
+        {
+            task_group group(m_pool);
+            for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+                if (should_fork(tree, child)) {
+                    group.run([this, &tree, child, content_width, content_height] {
+                        measure_node(tree, child, content_width, content_height);
+                    });
+                } else {
+                    measure_node(tree, child, content_width, content_height);
+                }
+            }
+        }
+
+        // Track storage doubles as the auto-size accumulator, calculate_track_sizes then resolves it in place
+        int* row_heights = tree.row_sizes(node);
+        int* column_widths = tree.column_sizes(node);
+        std::fill(row_heights, row_heights + row_count, 0);
+        std::fill(column_widths, column_widths + column_count, 0);
+
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            auto pos = clamp_cell(tree[child].cell, row_count, column_count);
+            if (pos.row_span == 1 && pos.column_span == 1) {
+                row_heights[pos.row] = (std::max)(row_heights[pos.row], tree[child].desired.height);
+                column_widths[pos.column] = (std::max)(column_widths[pos.column], tree[child].desired.width);
+            }
+        }
+
+        calculate_track_sizes(tree.row_definitions(node), tree[node].row_definition_count, content_height, row_heights, row_count);
+        calculate_track_sizes(tree.column_definitions(node), tree[node].column_definition_count, content_width, column_widths, column_count);
+
+        // Offsets relative to the content origin, consumed by arrange
+        int* row_offsets = tree.row_offsets(node);
+        int* column_offsets = tree.column_offsets(node);
+        for (int i = 0, offset = 0; i < row_count; ++i) {
+            row_offsets[i] = offset;
+            offset += row_heights[i] + row_spacing;
+        }
+        for (int i = 0, offset = 0; i < column_count; ++i) {
+            column_offsets[i] = offset;
+            offset += column_widths[i] + column_spacing;
+        }
+
+        int total_width = std::accumulate(column_widths, column_widths + column_count, 0) + total_column_spacing;
+        int total_height = std::accumulate(row_heights, row_heights + row_count, 0) + total_row_spacing;
+
+        tree[node].desired = { total_width + insets_h, total_height + insets_v };
+    }
+
+    void layout_engine::arrange_grid(layout_tree& tree, int node, const rect_t& bounds) const {
+        tree[node].bounds = bounds;
+
+        const int row_count = tree.row_count(node);
+        const int column_count = tree.column_count(node);
+        const int row_spacing = tree[node].row_spacing;
+        const int column_spacing = tree[node].column_spacing;
+        const int* row_heights = tree.row_sizes(node);
+        const int* column_widths = tree.column_sizes(node);
+        const int* row_offsets = tree.row_offsets(node);
+        const int* column_offsets = tree.column_offsets(node);
+
+        const int content_x = bounds.x + tree[node].margin.left + tree[node].padding.left;
+        const int content_y = bounds.y + tree[node].margin.top + tree[node].padding.top;
+
+        task_group group(m_pool);
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            auto pos = clamp_cell(tree[child].cell, row_count, column_count);
+
+            // Calculate cell bounds
+            rect_t cell{ content_x + column_offsets[pos.column], content_y + row_offsets[pos.row], 0, 0 };
+            for (int i = 0; i < pos.column_span; ++i) {
+                cell.width += column_widths[pos.column + i];
+                if (i > 0) cell.width += column_spacing;
+            }
+            for (int i = 0; i < pos.row_span; ++i) {
+                cell.height += row_heights[pos.row + i];
+                if (i > 0) cell.height += row_spacing;
+            }
+
+            if (tree[child].kind != node_kind::leaf) {
+                // Re-measure nested panels against the actual cell size.
+                // During the measure pass nested panels are measured before the final
+                // star track sizes are known, which can leave their tracks too large for the cell.
+                auto place_panel = [this, &tree, child, cell] {
+                    measure_node(tree, child, cell.width, cell.height);
+                    arrange_node(tree, child, cell);
+                };
+                if (should_fork(tree, child))
+                    group.run(std::move(place_panel));
+                else
+                    place_panel();
+            } else {
+                const auto& align = tree[child].cell_alignment;
+                const auto& desired = tree[child].desired;
+                rect_t placed{};
+                align_axis(align.horizontal, cell.x, cell.width, desired.width, placed.x, placed.width);
+                align_axis(align.vertical, cell.y, cell.height, desired.height, placed.y, placed.height);
+                tree[child].bounds = placed;
+            }
+        }
+    }
+
+    void layout_engine::measure_stack(layout_tree& tree, int node, int available_width, int available_height) const {
+        const auto& panel = tree[node];
+        const bool horizontal = panel.stack_orientation == orientation::horizontal;
+        const bool stretch = panel.stack_alignment == alignment::stretch;
+        const int spacing = panel.row_spacing;
+        const int insets_h = horizontal_insets(panel);
+        const int insets_v = vertical_insets(panel);
+
+        int content_width = available_width - insets_h;
+        int content_height = available_height - insets_v;
+
+        {
+            task_group group(m_pool);
+            for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+                if (should_fork(tree, child)) {
+                    group.run([this, &tree, child, content_width, content_height] {
+                        measure_node(tree, child, content_width, content_height);
+                    });
+                } else {
+                    measure_node(tree, child, content_width, content_height);
+                }
+            }
+        }
+
+        int total_main_axis = 0;
+        int max_cross_axis = 0;
+        bool first = true;
+
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            sizing_t size = tree[child].desired;
+
+            if (horizontal && stretch) {
+                size.height = content_height;
+            } else if (!horizontal && stretch) {
+                size.width = content_width;
+            }
+
+            tree[child].measured = size;
+
+            total_main_axis += horizontal ? size.width : size.height;
+            if (!first) total_main_axis += spacing;
+            max_cross_axis = (std::max)(max_cross_axis, horizontal ? size.height : size.width);
+            first = false;
+        }
+
+        if (horizontal) {
+            tree[node].desired = { total_main_axis + insets_h, max_cross_axis + insets_v };
+        } else {
+            tree[node].desired = { max_cross_axis + insets_h, total_main_axis + insets_v };
+        }
+    }
+
+    void layout_engine::arrange_stack(layout_tree& tree, int node, const rect_t& bounds) const {
+        tree[node].bounds = bounds;
+
+        const auto& panel = tree[node];
+        const bool horizontal = panel.stack_orientation == orientation::horizontal;
+        const alignment align = panel.stack_alignment;
+        const int spacing = panel.row_spacing;
+
+        const int content_x = bounds.x + panel.margin.left + panel.padding.left;
+        const int content_y = bounds.y + panel.margin.top + panel.padding.top;
+        const int content_width = bounds.width - horizontal_insets(panel);
+        const int content_height = bounds.height - vertical_insets(panel);
+
+        int total_desired_size = 0;
+        const int child_count = panel.child_count;
+        for (int child = panel.first_child; child != -1; child = tree[child].next_sibling) {
+            total_desired_size += horizontal ? tree[child].measured.width : tree[child].measured.height;
+        }
+        if (child_count > 1) {
+            total_desired_size += spacing * (child_count - 1);
+        }
+
+        int available_size = horizontal ? content_width : content_height;
+        int extra_space = available_size - total_desired_size;
+
+        // Only distribute extra space equally if alignment is stretch
+        int per_child_extra = 0;
+        int remainder = 0;
+        if (align == alignment::stretch && child_count > 0) {
+            per_child_extra = extra_space / child_count;
+            remainder = extra_space % child_count;
+        }
+
+        int current_pos = 0;
+        task_group group(m_pool);
+
+        for (int child = panel.first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& child_size = tree[child].measured;
+            rect_t placed{};
+
+            int main_size = (horizontal ? child_size.width : child_size.height) + per_child_extra;
+            if (remainder != 0) {
+                main_size += (remainder > 0) ? 1 : -1;
+                remainder += (remainder > 0) ? -1 : 1;
+            }
+            if (main_size < 1) main_size = 1;
+
+            if (horizontal) {
+                placed.x = content_x + current_pos;
+                placed.width = main_size;
+                align_axis(align, content_y, content_height, child_size.height, placed.y, placed.height);
+            } else {
+                placed.y = content_y + current_pos;
+                placed.height = main_size;
+                align_axis(align, content_x, content_width, child_size.width, placed.x, placed.width);
+            }
+            current_pos += main_size + spacing;
+
+            if (should_fork(tree, child)) {
+                group.run([this, &tree, child, placed] { arrange_node(tree, child, placed); });
+            } else {
+                arrange_node(tree, child, placed);
+            }
+        }
+    }
+
+    void layout_engine::measure_dock(layout_tree& tree, int node, int available_width, int available_height) const {
+        const int insets_h = horizontal_insets(tree[node]);
+        const int insets_v = vertical_insets(tree[node]);
+
+        int content_width = available_width - insets_h;
+        int content_height = available_height - insets_v;
+
+        int remaining_width = content_width;
+        int remaining_height = content_height;
+
+        // Each child consumes space from the next, so dock measurement is inherently sequential
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            auto& c = tree[child];
+
+            // If last child and last-child-fill is set, override to fill
+            if (tree[node].last_child_fill && c.next_sibling == -1) {
+                c.dock = dock_position::fill;
+            }
+
+            sizing_t size{};
+            measure_node(tree, child, remaining_width, remaining_height);
+            if (c.kind != node_kind::leaf) {
+                auto& measured = tree[child];
+
+                // Keep the first measured size as the preferred size so panels don't grow every pass
+                if (measured.preferred.width > 0 && measured.preferred.height > 0) {
+                    size.width = (std::min)(measured.preferred.width, remaining_width);
+                    size.height = (std::min)(measured.preferred.height, remaining_height);
+                } else {
+                    size = measured.desired;
+                    measured.preferred = size;
+                }
+            } else {
+                size = c.desired;
+            }
+            tree[child].measured = size;
+
+            // Reduce remaining space based on dock position
+            switch (tree[child].dock) {
+            case dock_position::left:
+            case dock_position::right:
+                remaining_width -= size.width;
+                break;
+            case dock_position::top:
+            case dock_position::bottom:
+                remaining_height -= size.height;
+                break;
+            case dock_position::fill:
+                break;
+            }
+        }
+
+        // Desired size is the full available space (including margin and padding)
+        tree[node].desired = { content_width + insets_h, content_height + insets_v };
+    }
+
+    void layout_engine::arrange_dock(layout_tree& tree, int node, const rect_t& bounds) const {
+        tree[node].bounds = bounds;
+
+        const auto& panel = tree[node];
+        int remaining_x = bounds.x + panel.margin.left + panel.padding.left;
+        int remaining_y = bounds.y + panel.margin.top + panel.padding.top;
+        int remaining_width = bounds.width - horizontal_insets(panel);
+        int remaining_height = bounds.height - vertical_insets(panel);
+
+        task_group group(m_pool);
+        for (int child = panel.first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& size = tree[child].measured;
+            rect_t placed{};
+
+            switch (tree[child].dock) {
+            case dock_position::left:
+                placed = { remaining_x, remaining_y, size.width, remaining_height };
+                remaining_x += size.width;
+                remaining_width -= size.width;
+                break;
+            case dock_position::top:
+                placed = { remaining_x, remaining_y, remaining_width, size.height };
+                remaining_y += size.height;
+                remaining_height -= size.height;
+                break;
+            case dock_position::right:
+                placed = { remaining_x + remaining_width - size.width, remaining_y, size.width, remaining_height };
+                remaining_width -= size.width;
+                break;
+            case dock_position::bottom:
+                placed = { remaining_x, remaining_y + remaining_height - size.height, remaining_width, size.height };
+                remaining_height -= size.height;
+                break;
+            case dock_position::fill:
+                placed = { remaining_x, remaining_y, remaining_width, remaining_height };
+                break;
+            }
+
+            // Ensure non-negative dimensions
+            placed.width = (std::max)(0, placed.width);
+            placed.height = (std::max)(0, placed.height);
+
+            if (should_fork(tree, child)) {
+                group.run([this, &tree, child, placed] { arrange_node(tree, child, placed); });
+            } else {
+                arrange_node(tree, child, placed);
+            }
+        }
+    }
+
+    void layout_engine::measure_canvas(layout_tree& tree, int node, int available_width, int available_height) const {
+        const int insets_h = horizontal_insets(tree[node]);
+        const int insets_v = vertical_insets(tree[node]);
+
+        int content_width = available_width - insets_h;
+        int content_height = available_height - insets_v;
+
+        {
+            task_group group(m_pool);
+            for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+                if (should_fork(tree, child)) {
+                    group.run([this, &tree, child, content_width, content_height] {
+                        measure_node(tree, child, content_width, content_height);
+                    });
+                } else {
+                    measure_node(tree, child, content_width, content_height);
+                }
+            }
+        }
+
+        // Children keep their explicit position, the canvas wants to be as large as their extent
+        int extent_width = 0;
+        int extent_height = 0;
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& c = tree[child];
+            extent_width = (std::max)(extent_width, c.offset_x + c.desired.width);
+            extent_height = (std::max)(extent_height, c.offset_y + c.desired.height);
+        }
+
+        tree[node].desired = { extent_width + insets_h, extent_height + insets_v };
+    }
+
+    void layout_engine::arrange_canvas(layout_tree& tree, int node, const rect_t& bounds) const {
+        tree[node].bounds = bounds;
+
+        const auto& panel = tree[node];
+        const int content_x = bounds.x + panel.margin.left + panel.padding.left;
+        const int content_y = bounds.y + panel.margin.top + panel.padding.top;
+
+        task_group group(m_pool);
+        for (int child = panel.first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& c = tree[child];
+            rect_t placed{ content_x + c.offset_x, content_y + c.offset_y, c.desired.width, c.desired.height };
+
+            if (should_fork(tree, child)) {
+                group.run([this, &tree, child, placed] { arrange_node(tree, child, placed); });
+            } else {
+                arrange_node(tree, child, placed);
+            }
+        }
+    }
+
+    void layout_engine::solve_constraints(layout_tree& tree, int node, int content_width, int content_height) const {
+        auto* system = tree.constraint_system(node);
+        if (!system)
+            return;
+
+        std::scoped_lock lock(system->mutex());
+
+        // Only changed size models and the content size reach the solver; the tableau is reused between passes
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& c = tree[child];
+            if (c.slot < 0) continue;
+            system->sync_slot_size(c.slot, c.desired.width, c.desired.height,
+                                   c.min_size.width, c.min_size.height, c.max_size.width, c.max_size.height);
+        }
+        system->resize(content_width, content_height);
+
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            auto& c = tree[child];
+            if (c.slot < 0) continue;
+            const auto& vars = system->get_slot(c.slot);
+            c.offset_x = static_cast<int>(vars.left.value() + 0.5);
+            c.offset_y = static_cast<int>(vars.top.value() + 0.5);
+            c.measured = { (std::max)(0, static_cast<int>(vars.width.value() + 0.5)),
+                           (std::max)(0, static_cast<int>(vars.height.value() + 0.5)) };
+        }
+    }
+
+    void layout_engine::measure_constraint(layout_tree& tree, int node, int available_width, int available_height) const {
+        const int insets_h = horizontal_insets(tree[node]);
+        const int insets_v = vertical_insets(tree[node]);
+
+        int content_width = available_width - insets_h;
+        int content_height = available_height - insets_v;
+
+        {
+            task_group group(m_pool);
+            for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+                if (should_fork(tree, child)) {
+                    group.run([this, &tree, child, content_width, content_height] {
+                        measure_node(tree, child, content_width, content_height);
+                    });
+                } else {
+                    measure_node(tree, child, content_width, content_height);
+                }
+            }
+        }
+
+        solve_constraints(tree, node, content_width, content_height);
+
+        int extent_width = 0;
+        int extent_height = 0;
+        for (int child = tree[node].first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& c = tree[child];
+            extent_width = (std::max)(extent_width, c.offset_x + c.measured.width);
+            extent_height = (std::max)(extent_height, c.offset_y + c.measured.height);
+        }
+
+        tree[node].desired = { extent_width + insets_h, extent_height + insets_v };
+    }
+
+    void layout_engine::arrange_constraint(layout_tree& tree, int node, const rect_t& bounds) const {
+        tree[node].bounds = bounds;
+
+        const auto& panel = tree[node];
+        const int content_x = bounds.x + panel.margin.left + panel.padding.left;
+        const int content_y = bounds.y + panel.margin.top + panel.padding.top;
+
+        // Re-solve for the final size; a no-op in the tableau when it matches the measure pass
+        solve_constraints(tree, node, bounds.width - horizontal_insets(panel), bounds.height - vertical_insets(panel));
+
+        task_group group(m_pool);
+        for (int child = panel.first_child; child != -1; child = tree[child].next_sibling) {
+            const auto& c = tree[child];
+            rect_t placed{ content_x + c.offset_x, content_y + c.offset_y, c.measured.width, c.measured.height };
+
+            if (should_fork(tree, child)) {
+                group.run([this, &tree, child, placed] { arrange_node(tree, child, placed); });
+            } else {
+                arrange_node(tree, child, placed);
+            }
+        }
+    }
+
+    void layout_engine::calculate_track_sizes(const grid_length* definitions, int definition_count,
+                                              int available_size, int* sizes, int track_count) {
+        if (track_count == 0) return;
+
+        // On entry sizes[] holds the auto (content) size of each track
+        int used_space = 0;
+        double total_star_value = 0.0;
+
+        for (int i = 0; i < track_count; ++i) {
+            if (i < definition_count) {
+                const auto& def = definitions[i];
+                if (def.type == grid_length_type::pixel) {
+                    sizes[i] = static_cast<int>(def.value);
+                } else if (def.type == grid_length_type::star) {
+                    sizes[i] = 0; // Calculated below
+                    total_star_value += def.value;
+                    continue;
+                }
+            }
+            used_space += sizes[i];
+        }
+
+        int remaining_space = (std::max)(0, available_size - used_space);
+
+        // Distribute remaining space to star-sized tracks
+        if (total_star_value > 0 && remaining_space > 0) {
+            for (int i = 0; i < definition_count && i < track_count; ++i) {
+                if (definitions[i].type == grid_length_type::star) {
+                    sizes[i] = static_cast<int>((remaining_space * definitions[i].value) / total_star_value);
+                }
+            }
+        }
+    }
+}
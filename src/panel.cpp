@@ -11,9 +11,293 @@ namespace wpp::layout
         }
     }
 
+	void panel::measure(int available_width, int available_height) {
+		layout_engine engine;
+		engine.set_statistics(m_statistics.get());
+
+		prune_destroyed_children();
+		m_pending_layout = capture_layout();
+		engine.measure(m_pending_layout->tree, 0, available_width, available_height);
+		m_desired_size = m_pending_layout->tree[0].desired;
+	}
+
+	void panel::arrange(int x, int y, int width, int height, damage_region* damage) {
+		layout_engine engine;
+		engine.set_statistics(m_statistics.get());
+
+		if (!m_pending_layout) {
+			prune_destroyed_children();
+			m_pending_layout = capture_layout();
+			engine.measure(m_pending_layout->tree, 0, width, height);
+		}
+
+		engine.arrange(m_pending_layout->tree, 0, { x, y, width, height });
+		if (damage) {
+			commit_layout(*m_pending_layout, *damage);
+		} else {
+			damage_region moved;
+			commit_layout(*m_pending_layout, moved);
+			invalidate_damage(moved);
+		}
+		m_pending_layout.reset();
+	}
+
+	void panel::invalidate_damage(const damage_region& damage) const {
+		HWND host = m_handle ? ::GetParent(m_handle) : m_parent_handle;
+		if (!host || damage.empty())
+			return;
+
+		HRGN region = ::CreateRectRgn(0, 0, 0, 0);
+		for (const auto& area : damage.rects()) {
+			HRGN part = ::CreateRectRgn(area.x, area.y, area.x + area.width, area.y + area.height);
+			::CombineRgn(region, region, part, RGN_OR);
+			::DeleteObject(part);
+		}
+		::RedrawWindow(host, nullptr, region, RDW_INVALIDATE | RDW_ALLCHILDREN);
+		::DeleteObject(region);
+	}
+
+	void panel::prune_destroyed_children() {
+		// Nested panels may not have a window of their own yet, only controls are judged by theirs
+		auto destroyed = [](const control_ptr<>& child) { return !child || (!is_panel(child) && !child->is_valid()); };
+
+		bool any = false;
+		for (const auto& child : m_children) {
+			if (destroyed(child)) {
+				child_removed(child);
+				m_child_sizes.erase(child);
+				any = true;
+			} else if (auto nested = as_panel(child)) {
+				nested->prune_destroyed_children();
+			}
+		}
+		if (any)
+			m_children.erase(std::remove_if(m_children.begin(), m_children.end(), destroyed), m_children.end());
+	}
+
+	layout_snapshot panel::capture_layout() const {
+		layout_snapshot snapshot;
+		int root = snapshot.tree.add_node(get_node_kind(), -1);
+		capture_node(snapshot, root);
+		snapshot.tree.finalize();
+
+		if (m_statistics) {
+			m_statistics->snapshots_captured.fetch_add(1, std::memory_order_relaxed);
+			m_statistics->snapshot_bytes.fetch_add(snapshot.tree.memory_usage() + snapshot.targets.capacity() * sizeof(control_ptr<>),
+												   std::memory_order_relaxed);
+		}
+		return snapshot;
+	}
+
+	void panel::track_child(const control_ptr<>& child) {
+		auto& constraints = m_child_sizes[child];
+
+		// Nested panels are sized by the engine, controls by their content
+		if (!is_panel(child)) {
+			RECT rc = child->get_rect();
+			constraints.desired = { rc.right - rc.left, rc.bottom - rc.top };
+		}
+	}
+
+	void panel::update_desired_size(const control_ptr<>& child) {
+		if (child && !is_panel(child) && child->is_valid()) {
+			RECT rc = child->get_rect();
+			m_child_sizes[child].desired = { rc.right - rc.left, rc.bottom - rc.top };
+			child_size_changed(child);
+		}
+	}
+
+	UINT panel::font_dpi() const {
+		return static_cast<UINT>(m_dpi_scale * USER_DEFAULT_SCREEN_DPI + 0.5f);
+	}
+
+	void panel::fit_to_text(const control_ptr<>& child, tstring_view text, int extra_width, int extra_height) {
+		if (!child)
+			return;
+
+		SIZE size = graphics::text_metrics::shared().measure(child->get_font(), font_dpi(), text);
+		set_desired_size(child, size.cx + extra_width, size.cy + extra_height);
+	}
+
+	void panel::fit_to_text(const std::vector<control_ptr<>>& children, int extra_width, int extra_height) {
+		// Group by font so each font is selected once for all of its strings
+		std::unordered_map<HFONT, std::vector<size_t>> by_font;
+		std::vector<tstring> texts(children.size());
+		for (size_t i = 0; i < children.size(); ++i) {
+			if (!children[i] || !children[i]->is_valid())
+				continue;
+			texts[i] = children[i]->get_text();
+			by_font[children[i]->get_font()].push_back(i);
+		}
+
+		std::vector<tstring_view> batch;
+		std::vector<SIZE> sizes;
+		for (const auto& [font, indices] : by_font) {
+			batch.clear();
+			for (size_t i : indices)
+				batch.push_back(texts[i]);
+
+			graphics::text_metrics::shared().measure(font, font_dpi(), batch, sizes);
+			for (size_t k = 0; k < indices.size(); ++k)
+				set_desired_size(children[indices[k]], sizes[k].cx + extra_width, sizes[k].cy + extra_height);
+		}
+	}
+
+	int panel::capture_child(layout_snapshot& snapshot, int parent, const control_ptr<>& child) const {
+		auto child_panel = as_panel(child);
+		int node = snapshot.tree.add_node(child_panel ? child_panel->get_node_kind() : node_kind::leaf, parent);
+
+		auto constraints = get_size_constraints(child);
+		snapshot.tree[node].preferred = constraints.desired;
+		snapshot.tree[node].min_size = constraints.minimum;
+		snapshot.tree[node].max_size = constraints.maximum;
+		snapshot.tree[node].target = static_cast<std::int32_t>(snapshot.targets.size());
+		snapshot.targets.push_back(child);
+
+		if (child_panel) {
+			child_panel->capture_node(snapshot, node);
+		}
+		return node;
+	}
+
+	void panel::set_dpi_scale(float scale) {
+		if (m_dpi_scale != scale) {
+			m_dpi_scale = scale;
+			invalidate_metrics();
+		}
+
+		for (const auto& child : m_children) {
+			if (auto child_panel = as_panel(child))
+				child_panel->set_dpi_scale(scale);
+		}
+	}
+
+	const panel::scaled_metrics& panel::get_scaled_metrics() const {
+		if (m_metrics_dirty) {
+			m_scaled_metrics = {};
+			m_scaled_metrics.margin = { scaled(m_margin.left), scaled(m_margin.top), scaled(m_margin.right), scaled(m_margin.bottom) };
+			m_scaled_metrics.padding = { scaled(m_padding.left), scaled(m_padding.top), scaled(m_padding.right), scaled(m_padding.bottom) };
+			scale_metrics(m_scaled_metrics);
+			m_metrics_dirty = false;
+		}
+		return m_scaled_metrics;
+	}
+
+	void panel::capture_metrics(layout_node& node) const {
+		const auto& metrics = get_scaled_metrics();
+		node.margin = metrics.margin;
+		node.padding = metrics.padding;
+		node.row_spacing = metrics.row_spacing;
+		node.column_spacing = metrics.column_spacing;
+	}
+
+	void panel::apply_node(const layout_snapshot& snapshot, int node) {
+		const auto& result = snapshot.tree[node];
+		m_desired_size = result.desired;
+		m_actual_size = { result.bounds.width, result.bounds.height };
+	}
+
+	void panel::commit_layout(const layout_snapshot& snapshot, damage_region& damage) {
+		const auto& tree = snapshot.tree;
+		if (tree.empty())
+			return;
+
+		auto resolve = [&](int node) -> control* {
+			int target = tree[node].target;
+			return target < 0 ? static_cast<control*>(this) : snapshot.targets[target].get();
+		};
+
+		// All layout coordinates are relative to the client area of the window hosting the root panel
+		HWND coordinate_space = m_handle ? ::GetParent(m_handle) : m_parent_handle;
+
+		// Controls share the host window as parent, so they can be moved in one DeferWindowPos batch.
+		// Panel windows may be re-parented into their parent panel and are positioned individually.
+		int control_count = 0;
+		for (int i = 0; i < static_cast<int>(tree.size()); ++i) {
+			if (tree[i].kind == node_kind::leaf && resolve(i)->get_handle())
+				control_count++;
+		}
+
+		std::uint64_t commits = 0;
+		std::unordered_map<HWND, rect_t> committed;
+		committed.reserve(tree.size());
+		deferred_window_pos dwp(control_count);
+		for (int i = 0; i < static_cast<int>(tree.size()); ++i) {
+			control* target = resolve(i);
+			HWND handle = target->get_handle();
+			if (!handle || !::IsWindow(handle))
+				continue;
+
+			const auto& bounds = tree[i].bounds;
+			committed[handle] = bounds;
+
+			// Unchanged windows keep their position and pixels
+			auto previous = m_committed_bounds.find(handle);
+			if (previous != m_committed_bounds.end()) {
+				if (previous->second == bounds)
+					continue;
+				damage.add(previous->second);
+			}
+			damage.add(bounds);
+
+			if (tree[i].kind == node_kind::leaf) {
+				if (!dwp.is_valid() || !dwp.defer(handle, bounds.x, bounds.y, bounds.width, bounds.height)) {
+					// Fallback to direct move if deferred positioning isn't available
+					target->move(bounds.x, bounds.y, bounds.width, bounds.height);
+				}
+				commits++;
+				continue;
+			}
+
+			POINT corners[2] = { { bounds.x, bounds.y }, { bounds.x + bounds.width, bounds.y + bounds.height } };
+			HWND actual_parent = ::GetParent(handle);
+			if (coordinate_space && actual_parent && actual_parent != coordinate_space) {
+				::MapWindowPoints(coordinate_space, actual_parent, corners, 2);
+			}
+			::SetWindowPos(handle, nullptr, corners[0].x, corners[0].y, bounds.width, bounds.height, SWP_NOZORDER | SWP_NOACTIVATE);
+			commits++;
+		}
+		dwp.end();
+
+		// Windows no longer in the layout (destroyed or removed) leave their last area behind
+		for (const auto& [handle, bounds] : m_committed_bounds) {
+			if (committed.find(handle) == committed.end())
+				damage.add(bounds);
+		}
+		m_committed_bounds = std::move(committed);
+
+		if (m_statistics)
+			m_statistics->window_commits.fetch_add(commits, std::memory_order_relaxed);
+
+		// Let panels pick up their computed sizes; repainting is left to whoever consumes the damage
+		for (int i = 0; i < static_cast<int>(tree.size()); ++i) {
+			if (tree[i].kind != node_kind::leaf) {
+				static_cast<panel*>(resolve(i))->apply_node(snapshot, i);
+			}
+		}
+	}
+
 	LRESULT CALLBACK panel::panel_wndproc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 		panel* panel_ptr = reinterpret_cast<panel*>(::GetWindowLongPtr(hwnd, GWLP_USERDATA));
 
+		if (panel_ptr) {
+			switch (msg) {
+			case WM_ERASEBKGND:
+				return 1; // the background is filled in the back buffer
+			case WM_PAINT: {
+				graphics::buffered_paint painter(hwnd);
+				if (!painter.empty()) {
+					// Same background the STATIC window would erase with
+					HBRUSH background = reinterpret_cast<HBRUSH>(::SendMessage(::GetParent(hwnd), WM_CTLCOLORSTATIC,
+						reinterpret_cast<WPARAM>(painter.dc()), reinterpret_cast<LPARAM>(hwnd)));
+					painter.fill(background ? background : ::GetSysColorBrush(COLOR_3DFACE));
+					panel_ptr->paint(painter.dc());
+				}
+				return 0;
+			}
+			}
+		}
+
 		LRESULT result = 0;
 		if (panel_ptr && panel_ptr->m_original_wndproc) {
 			result = ::CallWindowProc(panel_ptr->m_original_wndproc, hwnd, msg, wParam, lParam);
@@ -21,14 +305,6 @@ namespace wpp::layout
 			result = ::DefWindowProc(hwnd, msg, wParam, lParam);
 		}
 
-		if (msg == WM_PAINT && panel_ptr) {
-			HDC hdc = ::GetDC(hwnd);
-			if (hdc) {
-				panel_ptr->paint(hdc);
-				::ReleaseDC(hwnd, hdc);
-			}
-		}
-
 		return result;
 	}
 }
@@ -0,0 +1,93 @@
+#include "../layout/resize_scheduler.hpp"
+
+namespace wpp::layout
+{
+    void resize_scheduler::begin() {
+        m_active = true;
+        m_has_pending = false;
+        m_has_frame = false;
+    }
+
+    bool resize_scheduler::size_changed(int width, int height, time_point now) {
+        if (m_active) {
+            m_statistics.sizes++;
+            if (m_has_pending)
+                m_statistics.coalesced++;
+        }
+
+        m_pending_width = width;
+        m_pending_height = height;
+        m_has_pending = true;
+
+        // Outside a live resize (maximize, restore, programmatic moves) there is nothing to coalesce with
+        if (!m_active)
+            return true;
+
+        if (!frame_due(now))
+            return false;
+
+        if (in_flight(now)) {
+            m_statistics.busy_skips++;
+            return false;
+        }
+        return true;
+    }
+
+    bool resize_scheduler::tick(time_point now) {
+        if (!m_active || !m_has_pending || !frame_due(now))
+            return false;
+
+        // Fast path: the previous frame has not reached the screen yet, so another one would only queue up behind it
+        if (in_flight(now)) {
+            m_statistics.busy_skips++;
+            return false;
+        }
+        return true;
+    }
+
+    void resize_scheduler::frame_started(time_point now) {
+        if (m_active)
+            m_statistics.frames++;
+
+        m_last_frame = now;
+        m_has_frame = true;
+        m_has_pending = false;
+        m_in_flight = true;
+    }
+
+    void resize_scheduler::frame_committed() {
+        m_in_flight = false;
+    }
+
+    bool resize_scheduler::end() {
+        if (!m_active)
+            return false;
+
+        m_active = false;
+        if (!m_has_pending)
+            return false;
+
+        m_statistics.final_layouts++;
+        return true;
+    }
+
+    resize_scheduler::time_point resize_scheduler::time_to_next_frame(time_point now) const {
+        if (!m_has_frame || now < m_last_frame)
+            return 0;
+
+        time_point elapsed = now - m_last_frame;
+        return elapsed >= m_frame_interval ? 0 : m_frame_interval - elapsed;
+    }
+
+    bool resize_scheduler::frame_due(time_point now) const {
+        return time_to_next_frame(now) == 0;
+    }
+
+    bool resize_scheduler::in_flight(time_point now) {
+        // A result that never arrives must not stall the resize for good
+        if (m_in_flight && m_has_frame && now >= m_last_frame
+            && now - m_last_frame >= m_frame_interval * m_stall_frames)
+            m_in_flight = false;
+        return m_in_flight;
+    }
+}
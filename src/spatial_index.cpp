@@ -0,0 +1,174 @@
+#include "../layout/spatial_index.hpp"
+#include <algorithm>
+
+namespace wpp::layout
+{
+    namespace {
+        bool intersects(const rect_t& a, const rect_t& b) {
+            return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+        }
+
+        bool contains_point(const rect_t& r, int x, int y) {
+            return x >= r.x && x < r.x + r.width && y >= r.y && y < r.y + r.height;
+        }
+
+        void erase_id(std::vector<int>& ids, int id) {
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end()) {
+                *it = ids.back();
+                ids.pop_back();
+            }
+        }
+    }
+
+    spatial_grid::spatial_grid(int cell_size)
+        : m_cell_size((std::max)(1, cell_size)) {
+    }
+
+    int spatial_grid::cell_coordinate(int value) const {
+        // Floor division, so negative coordinates land in the correct cell
+        int q = value / m_cell_size;
+        return (value % m_cell_size < 0) ? q - 1 : q;
+    }
+
+    std::uint64_t spatial_grid::cell_key(int cx, int cy) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+    }
+
+    spatial_grid::cell_range spatial_grid::range_for(const rect_t& bounds) const {
+        if (bounds.width <= 0 || bounds.height <= 0)
+            return {};
+        return { cell_coordinate(bounds.x), cell_coordinate(bounds.y),
+                 cell_coordinate(bounds.x + bounds.width - 1), cell_coordinate(bounds.y + bounds.height - 1) };
+    }
+
+    void spatial_grid::link(int id, const entry& e) {
+        if (e.large) {
+            m_large.push_back(id);
+            return;
+        }
+        for (int cy = e.cells.y0; cy <= e.cells.y1; ++cy)
+            for (int cx = e.cells.x0; cx <= e.cells.x1; ++cx)
+                m_cells[cell_key(cx, cy)].push_back(id);
+    }
+
+    void spatial_grid::unlink(int id, const entry& e) {
+        if (e.large) {
+            erase_id(m_large, id);
+            return;
+        }
+        for (int cy = e.cells.y0; cy <= e.cells.y1; ++cy) {
+            for (int cx = e.cells.x0; cx <= e.cells.x1; ++cx) {
+                auto it = m_cells.find(cell_key(cx, cy));
+                if (it == m_cells.end())
+                    continue;
+                erase_id(it->second, id);
+                if (it->second.empty())
+                    m_cells.erase(it);
+            }
+        }
+    }
+
+    void spatial_grid::update(int id, const rect_t& bounds) {
+        if (id < 0)
+            return;
+        if (id >= static_cast<int>(m_entries.size()))
+            m_entries.resize(static_cast<size_t>(id) + 1);
+
+        auto& e = m_entries[id];
+        cell_range cells = range_for(bounds);
+        bool large = cells.cell_count() > max_cells_per_entry;
+
+        if (e.live && e.cells == cells && e.large == large) {
+            // Moved within the same cells, only the stored bounds change
+            e.bounds = bounds;
+            return;
+        }
+
+        if (e.live)
+            unlink(id, e);
+        else
+            m_live_count++;
+
+        e.bounds = bounds;
+        e.cells = cells;
+        e.large = large;
+        e.live = true;
+        link(id, e);
+    }
+
+    void spatial_grid::remove(int id) {
+        if (!contains(id))
+            return;
+        auto& e = m_entries[id];
+        unlink(id, e);
+        e = entry{};
+        m_live_count--;
+    }
+
+    void spatial_grid::clear() {
+        m_entries.clear();
+        m_cells.clear();
+        m_large.clear();
+        m_visited.clear();
+        m_live_count = 0;
+    }
+
+    void spatial_grid::collect(int id, const rect_t& area, std::vector<int>& out) const {
+        if (m_visited[id] == m_stamp)
+            return;
+        m_visited[id] = m_stamp;
+        if (intersects(m_entries[id].bounds, area))
+            out.push_back(id);
+    }
+
+    void spatial_grid::query_point(int x, int y, std::vector<int>& out) const {
+        auto it = m_cells.find(cell_key(cell_coordinate(x), cell_coordinate(y)));
+        if (it != m_cells.end()) {
+            for (int id : it->second)
+                if (contains_point(m_entries[id].bounds, x, y))
+                    out.push_back(id);
+        }
+        for (int id : m_large)
+            if (contains_point(m_entries[id].bounds, x, y))
+                out.push_back(id);
+    }
+
+    void spatial_grid::query_rect(const rect_t& area, std::vector<int>& out) const {
+        cell_range cells = range_for(area);
+        if (cells.cell_count() <= 0)
+            return;
+
+        if (m_visited.size() < m_entries.size())
+            m_visited.resize(m_entries.size(), 0);
+        if (++m_stamp == 0) {
+            std::fill(m_visited.begin(), m_visited.end(), 0);
+            m_stamp = 1;
+        }
+
+        // Querying more cells than there are occupied ones is wasteful; walk the occupied cells instead
+        if (cells.cell_count() > static_cast<long long>(m_cells.size())) {
+            for (const auto& [key, ids] : m_cells) {
+                int cx = static_cast<int>(static_cast<std::uint32_t>(key >> 32));
+                int cy = static_cast<int>(static_cast<std::uint32_t>(key));
+                if (cx < cells.x0 || cx > cells.x1 || cy < cells.y0 || cy > cells.y1)
+                    continue;
+                for (int id : ids)
+                    collect(id, area, out);
+            }
+        } else {
+            for (int cy = cells.y0; cy <= cells.y1; ++cy) {
+                for (int cx = cells.x0; cx <= cells.x1; ++cx) {
+                    auto it = m_cells.find(cell_key(cx, cy));
+                    if (it == m_cells.end())
+                        continue;
+                    for (int id : it->second)
+                        collect(id, area, out);
+                }
+            }
+        }
+
+        for (int id : m_large)
+            collect(id, area, out);
+    }
+}
@@ -1,8 +1,183 @@
 #include "..\window.hpp"
 #include "..\thunk.hpp"
+#include "..\thread_pool.hpp"
+
+#include <chrono>
 
 namespace wpp
 {
+	namespace {
+		// Posted by a layout job once its geometry is ready for commit
+		UINT layout_ready_message() {
+			static const UINT message = ::RegisterWindowMessage(TEXT("wpp_layout_ready"));
+			return message;
+		}
+
+		// Frame clock for live resize, in microseconds
+		layout::resize_scheduler::time_point frame_clock_now() {
+			auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+			return static_cast<layout::resize_scheduler::time_point>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+		}
+
+		// Refresh interval of the monitor the window is on, 60 Hz if it cannot be determined
+		layout::resize_scheduler::time_point frame_interval(HWND hwnd) {
+			MONITORINFOEX info{};
+			info.cbSize = sizeof(info);
+			DEVMODE mode{};
+			mode.dmSize = sizeof(mode);
+			if (::GetMonitorInfo(::MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST), &info)
+				&& ::EnumDisplaySettings(info.szDevice, ENUM_CURRENT_SETTINGS, &mode) && mode.dmDisplayFrequency > 1)
+				return 1000000 / mode.dmDisplayFrequency;
+			return 1000000 / 60;
+		}
+
+		// Creates the panels and controls of a compiled layout for a window
+		class window_layout_builder : public layout::layout_builder {
+		public:
+			window_layout_builder(window& owner, HWND hwnd, std::unordered_map<tstring, control_ptr<>>& names)
+				: m_window(owner), m_hwnd(hwnd), m_names(names) {
+			}
+
+			control_ptr<> root() const { return m_elements.empty() ? nullptr : m_elements.front(); }
+
+			void reserve(std::size_t count) override {
+				m_elements.reserve(count);
+			}
+
+			bool create(std::size_t index, const layout::layout_record& record, const layout::layout_view& view) override {
+				control_ptr<> element = record.kind == layout::element_kind::control
+					? create_control(record, view)
+					: create_panel(record, view);
+				if (!element)
+					return false;
+
+				if (record.name != layout::layout_record::no_string)
+					m_names[to_tstring(std::string(view.string(record.name)))] = element;
+				m_elements.push_back(std::move(element));
+				return true;
+			}
+
+			bool attach(std::size_t parent, std::size_t index, const layout::layout_record& record, const layout::layout_view& view) override {
+				auto container = layout::panel::as_panel(m_elements[parent]);
+				const control_ptr<>& child = m_elements[index];
+				if (!container)
+					return false;
+
+				if (auto child_panel = layout::panel::as_panel(child))
+					container->add_panel(child_panel);
+				else
+					container->add(child);
+
+				switch (view[parent].kind) {
+				case layout::element_kind::grid: {
+					auto grid = std::static_pointer_cast<layout::grid_panel>(container);
+					if (record.flags & layout::record_flags::grid_position)
+						grid->set_grid_position(child, record.row, record.column, record.row_span, record.column_span);
+					if (record.flags & layout::record_flags::cell_alignment)
+						grid->set_alignment(child, static_cast<layout::alignment>(record.h_align), static_cast<layout::alignment>(record.v_align));
+					break;
+				}
+				case layout::element_kind::dock:
+					if (record.flags & layout::record_flags::dock)
+						std::static_pointer_cast<layout::dock_panel>(container)->set_dock_position(child, static_cast<layout::dock_position>(record.dock));
+					break;
+				case layout::element_kind::canvas:
+					if (record.flags & layout::record_flags::canvas_position) {
+						auto canvas = std::static_pointer_cast<layout::canvas_panel>(container);
+						canvas->set_position(child, record.x, record.y);
+						canvas->set_z_index(child, record.z);
+					}
+					break;
+				default:
+					break;
+				}
+				return true;
+			}
+
+		private:
+			static int size_or(std::int32_t value, int fallback) { return value >= 0 ? value : fallback; }
+
+			control_ptr<> create_panel(const layout::layout_record& record, const layout::layout_view& view) {
+				std::shared_ptr<layout::panel> result;
+				switch (record.kind) {
+				case layout::element_kind::grid: {
+					auto grid = std::make_shared<layout::grid_panel>(m_hwnd);
+					auto rows = view.rows(record);
+					auto columns = view.columns(record);
+					std::vector<layout::grid_length> lengths;
+					lengths.reserve((std::max)(rows.size(), columns.size()));
+					for (const auto& row : rows)
+						lengths.push_back(row.length());
+					grid->set_row_definitions(lengths);
+					lengths.clear();
+					for (const auto& column : columns)
+						lengths.push_back(column.length());
+					grid->set_column_definitions(lengths);
+					if (record.flags & layout::record_flags::spacing)
+						grid->set_row_spacing(record.spacing);
+					if (record.flags & (layout::record_flags::spacing | layout::record_flags::column_spacing))
+						grid->set_column_spacing(record.column_spacing);
+					result = grid;
+					break;
+				}
+				case layout::element_kind::stack: {
+					auto stack = std::make_shared<layout::stack_panel>(static_cast<layout::orientation>(record.orientation), m_hwnd);
+					if (record.flags & layout::record_flags::spacing)
+						stack->set_spacing(record.spacing);
+					if (record.flags & layout::record_flags::alignment)
+						stack->set_alignment(static_cast<layout::alignment>(record.alignment));
+					result = stack;
+					break;
+				}
+				case layout::element_kind::dock: {
+					auto dock = std::make_shared<layout::dock_panel>(m_hwnd);
+					if (record.flags & layout::record_flags::has_last_child_fill)
+						dock->set_last_child_fill((record.flags & layout::record_flags::last_child_fill) != 0);
+					result = dock;
+					break;
+				}
+				case layout::element_kind::canvas:
+					result = std::make_shared<layout::canvas_panel>(m_hwnd);
+					break;
+				default:
+					return nullptr;
+				}
+
+				if (record.flags & layout::record_flags::margin)
+					result->set_margin(record.margin[0], record.margin[1], record.margin[2], record.margin[3]);
+				if (record.flags & layout::record_flags::padding)
+					result->set_padding(record.padding[0], record.padding[1], record.padding[2], record.padding[3]);
+				return result;
+			}
+
+			control_ptr<> create_control(const layout::layout_record& record, const layout::layout_view& view) {
+				tstring text = to_tstring(std::string(view.string(record.text)));
+				switch (record.control) {
+				case layout::control_kind::static_text: return m_window.create_static_control(text, size_or(record.width, 200), size_or(record.height, 20));
+				case layout::control_kind::button: return m_window.create_button(text, size_or(record.width, 80), size_or(record.height, 25));
+				case layout::control_kind::check_box: return m_window.create_check_box(text, size_or(record.width, 100), size_or(record.height, 25));
+				case layout::control_kind::edit: return m_window.create_edit_text(text, size_or(record.width, 200), size_or(record.height, 25));
+				case layout::control_kind::rich_edit: return m_window.create_rich_edit(text, size_or(record.width, 300), size_or(record.height, 200));
+				case layout::control_kind::list_box: return m_window.create_list_box(size_or(record.width, 200), size_or(record.height, 150));
+				case layout::control_kind::list_view: return m_window.create_list_view(size_or(record.width, 300), size_or(record.height, 200));
+				case layout::control_kind::combo_box: return m_window.create_combo_box(size_or(record.width, 200), size_or(record.height, 200));
+				case layout::control_kind::tree_view: return m_window.create_tree_view(size_or(record.width, 250), size_or(record.height, 200));
+				case layout::control_kind::tab: return m_window.create_tab_control(size_or(record.width, 300), size_or(record.height, 200));
+				case layout::control_kind::progress: return m_window.create_progress_bar(size_or(record.width, 200), size_or(record.height, 20));
+				case layout::control_kind::track_bar: return m_window.create_track_bar(size_or(record.width, 200), size_or(record.height, 30));
+				case layout::control_kind::group_box: return m_window.create_group_box(text, size_or(record.width, 200), size_or(record.height, 100));
+				case layout::control_kind::link: return m_window.create_link_control(text, size_or(record.width, 200), size_or(record.height, 20));
+				default: return nullptr;
+				}
+			}
+
+			window& m_window;
+			HWND m_hwnd;
+			std::unordered_map<tstring, control_ptr<>>& m_names;
+			std::vector<control_ptr<>> m_elements; // indexed like the layout records
+		};
+	}
+
 	window::window(window_class wnd_class, const tstring& window_name, int width, int height, DWORD style,
 				   int menu_id, HMENU menu, HFONT font, DWORD style_ex)
 		: window_base(NULL)
@@ -15,10 +190,8 @@ namespace wpp
 		, m_menu_handle(menu)
 		, m_font(font)
 		, m_owns_menu(false)
-		, m_owns_font(false)
 		, m_style_ex(style_ex) {
 		m_owns_menu = (m_menu_handle == NULL && m_menu_id != -1);
-		m_owns_font = (m_font == NULL);
 		init_message_events();
 	}
 
@@ -38,11 +211,15 @@ namespace wpp
 			{WM_COMMAND, std::bind(&window::on_command, this, _1, _2, _3)},
 			{WM_MENUCOMMAND, std::bind(&window::on_menu_command, this, _1, _2, _3)},
 			{WM_PAINT, std::bind(&window::on_paint, this, _1, _2, _3)},
+			{WM_ERASEBKGND, std::bind(&window::on_erase_background, this, _1, _2, _3)},
 			{WM_TIMER, std::bind(&window::on_timer, this, _1, _2, _3)},
 			{WM_SIZE, std::bind(&window::on_size, this, _1, _2, _3)},
+			{WM_ENTERSIZEMOVE, std::bind(&window::on_enter_size_move, this, _1, _2, _3)},
+			{WM_EXITSIZEMOVE, std::bind(&window::on_exit_size_move, this, _1, _2, _3)},
 			{WM_KEYDOWN, std::bind(&window::on_key_down, this, _1, _2, _3)},
 			{WM_KEYUP, std::bind(&window::on_key_up, this, _1, _2, _3)},
 			{WM_NOTIFY, std::bind(&window::on_notify, this, _1, _2, _3)},
+			{WM_DRAWITEM, std::bind(&window::on_control_draw_item, this, _1, _2, _3)},
 			{WM_HSCROLL, std::bind(&window::on_h_scroll, this, _1, _2, _3)},
 			{WM_VSCROLL, std::bind(&window::on_v_scroll, this, _1, _2, _3)},
 			{WM_DROPFILES, std::bind(&window::on_drop_files, this, _1, _2, _3)},
@@ -50,6 +227,8 @@ namespace wpp
 			{WM_DPICHANGED, std::bind(&window::on_dpi_changed, this, _1, _2, _3)},
 			{WM_CTLCOLORSTATIC, std::bind(&window::on_ctl_color_static, this, _1, _2, _3)},
 			{WM_GETMINMAXINFO, std::bind(&window::on_min_max_info, this, _1, _2, _3)},
+			{static_cast<INT>(layout_ready_message()), std::bind(&window::on_layout_ready, this, _1, _2, _3)},
+			{static_cast<INT>(control::async_ready_message()), std::bind(&window::on_control_async_ready, this, _1, _2, _3)},
 		};
 	}
 
@@ -62,25 +241,202 @@ namespace wpp
 	void window::update_layout() {
 		if (m_root_panel) {
 			RECT rc = get_client_rect();
+			layout::damage_region damage;
 			m_root_panel->measure(rc.right, rc.bottom);
-			m_root_panel->arrange(0, 0, rc.right, rc.bottom);
-			refresh_layout_visuals();
+			m_root_panel->arrange(0, 0, rc.right, rc.bottom, &damage);
+			refresh_layout_visuals(damage);
 		}
 	}
 
-	void window::refresh_layout_visuals() {
-		if (!m_handle)
-			return;
+	void window::request_async_layout(int width, int height) {
+		auto state = m_async_layout;
+		auto generation = ++state->latest_generation;
+
+		// Capture on the UI thread; the worker only ever sees the window-free tree
+		m_root_panel->prune_destroyed_children();
+		auto snapshot = m_root_panel->capture_layout();
+		m_async_layout_targets = std::move(snapshot.targets);
+
+		thread_pool::shared().submit([state, generation, tree = std::move(snapshot.tree), statistics = m_root_panel->get_layout_statistics(),
+									  hwnd = m_handle, width, height]() mutable {
+			// A newer size arrived before this job started
+			if (state->latest_generation.load(std::memory_order_acquire) != generation)
+				return;
+
+			layout::layout_engine engine(&thread_pool::shared());
+			engine.set_statistics(statistics.get());
+			engine.layout(tree, 0, 0, 0, width, height);
 
+			if (state->latest_generation.load(std::memory_order_acquire) != generation)
+				return;
+
+			{
+				std::scoped_lock lock(state->mutex);
+				state->completed = std::move(tree);
+				state->completed_generation = generation;
+			}
+			::PostMessage(hwnd, layout_ready_message(), 0, 0);
+		});
+	}
+
+	LRESULT window::on_control_async_ready(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		// The control may have been destroyed since its work was queued
+		for (auto& control : m_controls) {
+			if (control && control->get_id() == static_cast<int>(wParam)) {
+				control->on_async_ready();
+				break;
+			}
+		}
+		return TRUE;
+	}
+
+	LRESULT window::on_control_draw_item(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		auto draw_item = reinterpret_cast<LPDRAWITEMSTRUCT>(lParam);
+		if (!draw_item || draw_item->CtlType == ODT_MENU)
+			return FALSE;
 		for (auto& control : m_controls) {
-			if (!control || !control->is_valid())
-				continue;
+			if (control && control->get_id() == static_cast<int>(draw_item->CtlID))
+				return control->on_draw_item(draw_item);
+		}
+		return FALSE;
+	}
+
+	LRESULT window::on_layout_ready(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		if (!m_async_layout || !m_root_panel)
+			return TRUE;
+
+		layout::layout_snapshot snapshot;
+		{
+			std::scoped_lock lock(m_async_layout->mutex);
+			if (!m_async_layout->completed || m_async_layout->completed_generation != m_async_layout->latest_generation.load())
+				return TRUE; // superseded by a newer size, its own job will post again
+
+			snapshot.tree = std::move(*m_async_layout->completed);
+			m_async_layout->completed.reset();
+		}
+
+		snapshot.targets = std::move(m_async_layout_targets);
+		layout::damage_region damage;
+		m_root_panel->commit_layout(snapshot, damage);
+		refresh_layout_visuals(damage);
+		m_resize_scheduler.frame_committed();
+		return TRUE;
+	}
+
+	void window::layout_frame(int width, int height) {
+		m_resize_scheduler.frame_started(frame_clock_now());
+		if (m_async_layout) {
+			request_async_layout(width, height); // committed by on_layout_ready
+			return;
+		}
+
+		layout::damage_region damage;
+		m_root_panel->measure(width, height);
+		m_root_panel->arrange(0, 0, width, height, &damage);
+		refresh_layout_visuals(damage);
+		m_resize_scheduler.frame_committed();
+	}
+
+	graphics::frame_clock::animation_id window::animate(graphics::animation_spec spec, bool affects_layout) {
+		spec.owner = this;
+		if (affects_layout) {
+			spec.apply = [this, apply = std::move(spec.apply)](double value) {
+				if (apply)
+					apply(value);
+				graphics::frame_clock::current().defer(this, [this]() { update_layout(); });
+			};
+		}
+		return graphics::frame_clock::current().animate(std::move(spec));
+	}
 
-			if (std::dynamic_pointer_cast<tab_control>(control) && control->is_visible()) //tab controls must be kept above other controls to prevent occlusion issues in complex nested layouts
+	void window::on_resize_frame() {
+		if (m_root_panel && m_resize_scheduler.tick(frame_clock_now()))
+			layout_frame(m_resize_scheduler.pending_width(), m_resize_scheduler.pending_height());
+	}
+
+	void window::refresh_layout_visuals(const layout::damage_region& damage) {
+		if (!m_handle || !m_root_panel)
+			return;
+
+		// Nothing moved, nothing to repaint
+		if (damage.empty())
+			return;
+
+		for (const auto& control : m_top_controls) {
+			if (control->is_valid() && control->is_visible())
 				control->set_top();
 		}
 
-		redraw(nullptr, nullptr, RDW_INVALIDATE | RDW_ALLCHILDREN | RDW_UPDATENOW);
+		// One invalidation for the whole damage; the paint happens with the next WM_PAINT instead of synchronously
+		HRGN region = ::CreateRectRgn(0, 0, 0, 0);
+		for (const auto& area : damage.rects()) {
+			HRGN part = ::CreateRectRgn(area.x, area.y, area.x + area.width, area.y + area.height);
+			::CombineRgn(region, region, part, RGN_OR);
+			::DeleteObject(part);
+		}
+		redraw(nullptr, region, RDW_INVALIDATE | RDW_ALLCHILDREN);
+		::DeleteObject(region);
+
+		if (const auto& statistics = m_root_panel->get_layout_statistics()) {
+			RECT client = get_client_rect();
+			statistics->repaints.fetch_add(1, std::memory_order_relaxed);
+			statistics->repaint_rects.fetch_add(damage.rects().size(), std::memory_order_relaxed);
+			statistics->repaint_area.fetch_add(static_cast<std::uint64_t>(damage.area()), std::memory_order_relaxed);
+			statistics->full_repaint_area.fetch_add(static_cast<std::uint64_t>(client.right - client.left) * (client.bottom - client.top),
+													std::memory_order_relaxed);
+		}
+	}
+
+	bool window::load_layout(const layout::layout_view& view) {
+		if (!m_handle || view.empty())
+			return false;
+
+		m_layout_names.clear();
+		window_layout_builder builder(*this, m_handle, m_layout_names);
+		if (!layout::instantiate(view, builder))
+			return false;
+
+		m_root_panel = layout::panel::as_panel(builder.root());
+		m_root_panel->set_dpi_scale(m_dpi / static_cast<float>(USER_DEFAULT_SCREEN_DPI));
+		if (::IsWindowVisible(m_handle))
+			update_layout();
+		return true;
+	}
+
+	bool window::load_layout(std::string_view text, std::string* error) {
+		std::vector<std::uint8_t> blob;
+		layout::layout_view view;
+		return layout::compile_layout(text, blob, error) && layout::layout_view::open(blob.data(), blob.size(), view, error)
+			&& load_layout(view);
+	}
+
+	bool window::load_layout_resource(int resource_id) {
+		HMODULE module = m_window_class.instance();
+		HRSRC resource = ::FindResource(module, MAKEINTRESOURCE(resource_id), RT_RCDATA);
+		HGLOBAL loaded = resource ? ::LoadResource(module, resource) : nullptr;
+		const void* data = loaded ? ::LockResource(loaded) : nullptr;
+		if (!data)
+			return false;
+
+		// Resources stay mapped with the module image, so the records are read in place
+		layout::layout_view view;
+		return layout::layout_view::open(data, ::SizeofResource(module, resource), view) && load_layout(view);
+	}
+
+	bool window::destroy_control(HWND handle) {
+		auto owned = [handle](const control_ptr<>& control) { return control && control->get_handle() == handle; };
+		auto it = std::find_if(m_controls.begin(), m_controls.end(), owned);
+		if (it == m_controls.end())
+			return false;
+
+		// Callbacks often capture the control or its owner; drop them so nothing keeps the object alive
+		(*it)->clear_command_callbacks();
+		(*it)->clear_notify_callbacks();
+		m_controls.erase(it);
+		m_top_controls.erase(std::remove_if(m_top_controls.begin(), m_top_controls.end(), owned), m_top_controls.end());
+		if (::IsWindow(handle))
+			::DestroyWindow(handle);
+		return true;
 	}
 
 	bool window::handle_scroll_message(scroll_orientation orientation, WPARAM wParam, LPARAM lParam) {
@@ -154,17 +510,23 @@ namespace wpp
 		if (!m_handle)
 			return false;
 
+		m_dpi = ::GetDpiForWindow(m_handle);
+
 		if (m_root_panel) {
 			m_root_panel->initialize_window(m_handle);
+			m_root_panel->set_dpi_scale(m_dpi / static_cast<float>(USER_DEFAULT_SCREEN_DPI));
 		}
 
 		if (m_font == NULL) {
-			m_font = ::CreateFont(-12, 0, 0, 0,
-								  FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS,
-								  CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, DEFAULT_PITCH | FF_DONTCARE, TEXT("Segoe UI"));
-			m_owns_font = (m_font != NULL);
+			// One default font per DPI for the whole process instead of one per window
+			m_default_font = graphics::gdi_cache::shared().font(graphics::default_font_key(m_dpi));
+			m_font = m_default_font.get();
 		}
 
+		m_font_dpi = m_dpi;
+		if (!m_default_font)
+			m_font_variants = make_font_dpi_cache(m_font, m_font_dpi);
+
 		set_font(m_font);
 
 		for (auto& control : m_controls)
@@ -384,13 +746,27 @@ namespace wpp
 	}
 
 	LRESULT window::on_destroy(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		if (m_async_layout) {
+			m_async_layout->latest_generation++; // drop any layout still in flight
+			m_async_layout_targets.clear();
+		}
+		if (m_resize_timer) {
+			remove_timer(m_resize_timer);
+			m_resize_timer = 0;
+		}
+		m_resize_scheduler.end();
+		stop_animations();
+
 		m_controls.clear();
+		m_top_controls.clear();
+		m_layout_names.clear();
 		m_menu_command_events.clear();
 
-		if (m_font && m_owns_font) {
-			::DeleteObject(m_font);
+		m_font_variants.clear();
+		if (m_default_font) {
 			m_font = NULL;
-			m_owns_font = false;
+			m_default_font.reset();
+			m_default_font_variant.reset();
 		}
 		if (m_menu_handle && m_owns_menu) {
 			::DestroyMenu(m_menu_handle);
@@ -408,7 +784,21 @@ namespace wpp
 	}
 
 	LRESULT window::on_paint(HWND hWnd, WPARAM wParam, LPARAM lParam) {
-		return FALSE;
+		if (!m_paint_handler)
+			return FALSE;
+
+		graphics::buffered_paint painter(hWnd);
+		if (!painter.empty()) {
+			HBRUSH background = reinterpret_cast<HBRUSH>(::GetClassLongPtr(hWnd, GCLP_HBRBACKGROUND));
+			painter.fill(background ? background : ::GetSysColorBrush(COLOR_WINDOW));
+			m_paint_handler(painter.dc(), painter.update_rect());
+		}
+		return TRUE;
+	}
+
+	LRESULT window::on_erase_background(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		// Custom painted windows fill their background in the back buffer
+		return m_paint_handler ? TRUE : FALSE;
 	}
 
 	LRESULT window::on_display_change(HWND hWnd, WPARAM wParam, LPARAM lParam) {
@@ -428,9 +818,38 @@ namespace wpp
 		if (m_root_panel) {
 			int newWidth = LOWORD(lParam);
 			int newHeight = HIWORD(lParam);
-			m_root_panel->measure(newWidth, newHeight);
-			m_root_panel->arrange(0, 0, newWidth, newHeight);
-			refresh_layout_visuals();
+
+			// During a live resize the frame timer picks up sizes that are not due yet
+			if (m_resize_scheduler.size_changed(newWidth, newHeight, frame_clock_now()))
+				layout_frame(newWidth, newHeight);
+		}
+		return FALSE;
+	}
+
+	LRESULT window::on_enter_size_move(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		if (!m_live_resize_throttling)
+			return FALSE;
+
+		auto interval = frame_interval(hWnd);
+		m_resize_scheduler.set_frame_interval(interval);
+		m_resize_scheduler.begin();
+
+		// Timers keep firing inside the modal size/move loop
+		UINT period = (std::max)(static_cast<UINT>(USER_TIMER_MINIMUM), static_cast<UINT>(interval / 1000));
+		m_resize_timer = add_timer(period, [this]() { on_resize_frame(); });
+		return FALSE;
+	}
+
+	LRESULT window::on_exit_size_move(HWND hWnd, WPARAM wParam, LPARAM lParam) {
+		if (m_resize_timer) {
+			remove_timer(m_resize_timer);
+			m_resize_timer = 0;
+		}
+
+		// The last size of the drag may not have been laid out yet
+		if (m_resize_scheduler.end() && m_root_panel) {
+			RECT rc = get_client_rect();
+			layout_frame(rc.right, rc.bottom);
 		}
 		return FALSE;
 	}
@@ -482,10 +901,36 @@ namespace wpp
 	}
 
 	LRESULT window::on_dpi_changed(HWND hWnd, WPARAM wParam, LPARAM lParam) {
-		if (m_root_panel) {
-			float new_dpi = HIWORD(wParam) / 96.0f;
-			m_root_panel->set_dpi_scale(new_dpi);
+		// Sent only to the top-level window that moved to a monitor with a different DPI,
+		// so windows on other monitors are left alone
+		m_dpi = HIWORD(wParam);
+
+		if (HFONT font = get_dpi_font()) {
+			set_font(font, FALSE);
+			for (auto& control : m_controls)
+				control->set_font(font, FALSE);
 		}
+
+		if (m_root_panel)
+			m_root_panel->set_dpi_scale(m_dpi / static_cast<float>(USER_DEFAULT_SCREEN_DPI));
+
+		// Resizing to the suggested rect re-lays out through WM_SIZE; otherwise lay out once here
+		const RECT* suggested = reinterpret_cast<const RECT*>(lParam);
+		RECT current = get_rect();
+		bool resized = suggested != nullptr
+			&& (suggested->right - suggested->left != current.right - current.left
+				|| suggested->bottom - suggested->top != current.bottom - current.top);
+
+		if (suggested) {
+			::SetWindowPos(m_handle, nullptr, suggested->left, suggested->top,
+						   suggested->right - suggested->left, suggested->bottom - suggested->top, SWP_NOZORDER | SWP_NOACTIVATE);
+		}
+
+		if (!resized)
+			update_layout();
+
+		// Every control changed font, which layout damage does not cover
+		redraw(nullptr, nullptr, RDW_INVALIDATE | RDW_ALLCHILDREN);
 		return FALSE;
 	}
 
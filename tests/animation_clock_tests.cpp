@@ -0,0 +1,150 @@
+#include "check.hpp"
+#include "graphics/animation_clock.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace wpp::graphics;
+
+namespace
+{
+    bool near(double value, double expected) { return std::fabs(value - expected) < 1e-9; }
+
+    animation_spec linear_spec(double& value, std::uint64_t duration = 100) {
+        animation_spec spec;
+        spec.from = 0.0;
+        spec.to = 10.0;
+        spec.duration = duration;
+        spec.easing = easing::linear;
+        spec.apply = [&value](double v) { value = v; };
+        return spec;
+    }
+}
+
+WPP_TEST(easings_start_at_zero_and_end_at_one) {
+    for (easing_function f : { easing::linear, easing::ease_in_quad, easing::ease_out_quad, easing::ease_in_out_quad,
+                               easing::ease_in_cubic, easing::ease_out_cubic, easing::ease_in_out_cubic,
+                               easing::ease_in_out_sine, easing::ease_out_back }) {
+        WPP_CHECK(near(f(0.0), 0.0));
+        WPP_CHECK(near(f(1.0), 1.0));
+    }
+}
+
+WPP_TEST(value_follows_the_virtual_clock_and_completes_once) {
+    animation_clock clock;
+    double value = -1;
+    int completions = 0;
+    auto spec = linear_spec(value);
+    spec.completed = [&] { completions++; };
+    auto id = clock.start(spec, 1000);
+
+    WPP_CHECK(clock.tick(1000));
+    WPP_CHECK(near(value, 0.0));
+    clock.tick(1025);
+    WPP_CHECK(near(value, 2.5));
+    WPP_CHECK(clock.is_running(id));
+
+    WPP_CHECK(!clock.tick(1200));
+    WPP_CHECK(near(value, 10.0));
+    WPP_CHECK(completions == 1);
+    WPP_CHECK(!clock.is_running(id));
+    WPP_CHECK(!clock.tick(1300));
+    WPP_CHECK(clock.get_statistics().completed == 1);
+}
+
+WPP_TEST(delay_holds_the_animation_back) {
+    animation_clock clock;
+    double value = -1;
+    auto spec = linear_spec(value);
+    spec.delay = 50;
+    clock.start(spec, 0);
+    clock.tick(40);
+    WPP_CHECK(near(value, -1));
+    clock.tick(75);
+    WPP_CHECK(near(value, 2.5));
+}
+
+WPP_TEST(alternating_repeats_reverse_and_end_at_start) {
+    animation_clock clock;
+    double value = -1;
+    auto spec = linear_spec(value);
+    spec.repeat = 1;
+    spec.alternate = true;
+    clock.start(spec, 0);
+    clock.tick(125);      // second iteration, running backwards
+    WPP_CHECK(near(value, 7.5));
+    clock.tick(500);
+    WPP_CHECK(near(value, 0.0));
+    WPP_CHECK(clock.size() == 0);
+}
+
+WPP_TEST(cancel_can_jump_to_the_end) {
+    animation_clock clock;
+    double a = -1, b = -1;
+    auto first = clock.start(linear_spec(a), 0);
+    auto second = clock.start(linear_spec(b), 0);
+    clock.tick(50);
+    WPP_CHECK(clock.cancel(first));
+    WPP_CHECK(clock.cancel(second, true));
+    WPP_CHECK(!clock.cancel(second));
+    WPP_CHECK(near(a, 5.0));
+    WPP_CHECK(near(b, 10.0));
+    WPP_CHECK(clock.get_statistics().cancelled == 2);
+}
+
+WPP_TEST(deferred_commits_are_coalesced_per_key) {
+    animation_clock clock;
+    int window_a = 0, window_b = 0;
+    int commits_a = 0, commits_b = 0;
+    for (int i = 0; i < 10; ++i) {
+        animation_spec spec;
+        spec.duration = 100;
+        const void* owner = i % 2 ? static_cast<const void*>(&window_a) : static_cast<const void*>(&window_b);
+        int& counter = i % 2 ? commits_a : commits_b;
+        spec.apply = [&clock, owner, &counter](double) { clock.defer(owner, [&counter] { counter++; }); };
+        clock.start(spec, 0);
+    }
+    clock.tick(10);
+    WPP_CHECK(commits_a == 1);
+    WPP_CHECK(commits_b == 1);
+    WPP_CHECK(clock.get_statistics().commits == 2);
+    WPP_CHECK(clock.get_statistics().coalesced == 8);
+}
+
+WPP_TEST(cancel_owner_stops_its_animations_and_commits) {
+    animation_clock clock;
+    int owner = 0, other = 0;
+    int commits = 0;
+    double value = -1;
+    for (int i = 0; i < 3; ++i) {
+        auto spec = linear_spec(value);
+        spec.owner = &owner;
+        clock.start(spec, 0);
+    }
+    auto kept = linear_spec(value);
+    kept.owner = &other;
+    clock.start(kept, 0);
+
+    clock.defer(&owner, [&] { commits++; });
+    WPP_CHECK(clock.cancel_owner(&owner) == 3);
+    WPP_CHECK(clock.size() == 1);
+    clock.tick(10);
+    WPP_CHECK(commits == 0);
+}
+
+WPP_TEST(animation_started_from_a_callback_begins_next_tick) {
+    animation_clock clock;
+    double first = -1, second = -1;
+    auto spec = linear_spec(first);
+    spec.completed = [&] { clock.start(linear_spec(second), 100); };
+    clock.start(spec, 0);
+
+    clock.tick(100);
+    WPP_CHECK(near(first, 10.0));
+    WPP_CHECK(near(second, -1));
+    WPP_CHECK(clock.size() == 1);
+    clock.tick(150);
+    WPP_CHECK(near(second, 5.0));
+}
+
+int main() { return wpp::test::run_tests(); }
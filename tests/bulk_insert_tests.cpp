@@ -0,0 +1,82 @@
+#include "check.hpp"
+#include "model/bulk_insert.hpp"
+
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wpp::model;
+
+namespace
+{
+    struct entry {
+        std::string name;
+        int id = 0;
+    };
+}
+
+WPP_TEST(as_text_passes_the_element_through) {
+    as_text text_of;
+    std::string name = "alpha";
+    WPP_CHECK(&text_of(name) == &name);
+    const char* literal = "beta";
+    WPP_CHECK(text_of(literal) == literal);
+}
+
+WPP_TEST(terminated_text_reuses_one_buffer_for_views) {
+    terminated_text<char> text;
+    std::string owned = "owned";
+    WPP_CHECK(text(owned) == owned.c_str());
+
+    const char* literal = "literal";
+    WPP_CHECK(text(literal) == literal);
+    WPP_CHECK(std::string(text(static_cast<const char*>(nullptr))).empty());
+
+    // A view is not terminated where it ends, so it is copied; the next view reuses the copy
+    std::string_view both = "firstsecond";
+    const char* first = text(both.substr(0, 5));
+    WPP_CHECK(std::string(first) == "first");
+    const char* second = text(both.substr(5, 3));
+    WPP_CHECK(std::string(second) == "sec");
+}
+
+WPP_TEST(sizes_ignore_the_terminator) {
+    WPP_CHECK(terminated_text<char>::size("four") == 4);
+    WPP_CHECK(terminated_text<char>::size(static_cast<const char*>(nullptr)) == 0);
+    WPP_CHECK(terminated_text<char>::size(std::string("five!")) == 5);
+    WPP_CHECK(terminated_text<wchar_t>::size(std::wstring_view(L"wide")) == 4);
+}
+
+WPP_TEST(total_text_bytes_counts_terminators_and_char_size) {
+    std::vector<std::string> names{ "a", "bb", "" };
+    as_text same;
+    WPP_CHECK(total_text_bytes<char>(names, same) == 2 + 3 + 1);
+
+    std::vector<entry> entries{ { "one", 1 }, { "three", 3 } };
+    auto name_of = [](const entry& e) { return std::string_view(e.name); };
+    WPP_CHECK(total_text_bytes<char>(entries, name_of) == 4 + 6);
+
+    std::vector<std::wstring_view> wide{ L"xy", L"z" };
+    std::span<const std::wstring_view> view(wide);
+    WPP_CHECK(total_text_bytes<wchar_t>(view, same) == (3 + 2) * sizeof(wchar_t));
+
+    std::vector<std::string> none;
+    WPP_CHECK(total_text_bytes<char>(none, same) == 0);
+}
+
+WPP_TEST(result_reports_completion_and_throughput) {
+    bulk_insert_result result;
+    WPP_CHECK(result.complete() && result.items_per_second() == 0.0);
+
+    result.requested = 1000;
+    result.inserted = 500;
+    result.elapsed = std::chrono::milliseconds(250);
+    WPP_CHECK(!result.complete());
+    WPP_CHECK(result.items_per_second() > 1999.0 && result.items_per_second() < 2001.0);
+    result.inserted = 1000;
+    WPP_CHECK(result.complete());
+}
+
+int main() { return wpp::test::run_tests(); }
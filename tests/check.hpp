@@ -0,0 +1,57 @@
+#ifndef WPP_TESTS_CHECK_HPP
+#define WPP_TESTS_CHECK_HPP
+
+// Minimal test harness for the portable unit tests: WPP_TEST registers a case, WPP_CHECK records a failed
+// expectation without stopping the case, and run_tests() runs every case and returns the process exit code.
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace wpp::test
+{
+    struct test_case {
+        const char* name;
+        std::function<void()> body;
+    };
+
+    inline std::vector<test_case>& registry() {
+        static std::vector<test_case> cases;
+        return cases;
+    }
+
+    inline int& failure_count() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void check(bool passed, const char* expression, const char* file, int line) {
+        if (passed)
+            return;
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        failure_count()++;
+    }
+
+    struct registrar {
+        registrar(const char* name, void (*body)()) { registry().push_back({ name, body }); }
+    };
+
+    inline int run_tests() {
+        for (const auto& entry : registry()) {
+            int before = failure_count();
+            entry.body();
+            std::printf("%s %s\n", failure_count() == before ? "[pass]" : "[FAIL]", entry.name);
+        }
+        std::printf("%zu cases, %d failed checks\n", registry().size(), failure_count());
+        return failure_count() == 0 ? 0 : 1;
+    }
+}
+
+#define WPP_CHECK(expression) ::wpp::test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#define WPP_TEST(name)                                                  \
+    static void name();                                                 \
+    static ::wpp::test::registrar name##_registrar(#name, &name);       \
+    static void name()
+
+#endif // WPP_TESTS_CHECK_HPP
@@ -0,0 +1,155 @@
+#include "check.hpp"
+#include "model/column_model.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using wpp::thread_pool;
+using namespace wpp::model;
+
+namespace
+{
+    using model = basic_column_model<char>;
+
+    std::vector<std::size_t> view(const model& table) {
+        return std::vector<std::size_t>(table.order().begin(), table.order().end());
+    }
+
+    std::string cell(const model& table, std::size_t column, std::size_t view_row) {
+        char buffer[64];
+        table.format(column, table.model_row(view_row), buffer, sizeof(buffer));
+        return buffer;
+    }
+}
+
+WPP_TEST(parallel_sort_matches_stable_sort) {
+    thread_pool pool(4);
+    std::mt19937 random(3);
+    std::vector<std::pair<int, int>> values(200'000);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = { static_cast<int>(random() % 1000), static_cast<int>(i) };   // many ties, original index second
+
+    auto expected = values;
+    auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    parallel_stable_sort(values.begin(), values.end(), by_key, &pool, 1024);
+    WPP_CHECK(values == expected);
+}
+
+WPP_TEST(parallel_sort_handles_small_and_serial_ranges) {
+    thread_pool pool(4);
+    std::vector<int> empty;
+    parallel_stable_sort(empty.begin(), empty.end(), std::less<>(), &pool);
+    WPP_CHECK(empty.empty());
+
+    std::vector<int> small = { 5, 3, 9, 1 };
+    parallel_stable_sort(small.begin(), small.end(), std::less<>(), &pool);
+    WPP_CHECK((small == std::vector<int>{ 1, 3, 5, 9 }));
+
+    std::vector<int> serial(50'000);
+    for (std::size_t i = 0; i < serial.size(); ++i)
+        serial[i] = static_cast<int>((i * 7919) % serial.size());
+    parallel_stable_sort(serial.begin(), serial.end(), std::greater<>(), nullptr);
+    WPP_CHECK(std::is_sorted(serial.begin(), serial.end(), std::greater<>()));
+}
+
+WPP_TEST(append_and_format_cells) {
+    model table;
+    table.add_column(column_type::integer);
+    table.add_column(column_type::real);
+    table.add_column(column_type::text);
+    table.add_column(column_type::date);
+    table.set_formatter(3, [](std::int64_t value, char* buffer, std::size_t capacity) {
+        return copy_text(std::string_view(value == 0 ? "epoch" : "later"), buffer, capacity);
+    });
+
+    table.append_row({ std::int64_t{ 42 }, 2.5, std::string_view("alpha"), std::int64_t{ 0 } });
+    table.append_row({ 7.9, std::int64_t{ 3 } });       // converted kinds, missing cells
+    WPP_CHECK(table.row_count() == 2);
+    WPP_CHECK(table.integer(0, 1) == 7);
+    WPP_CHECK(table.real(1, 1) == 3.0);
+    WPP_CHECK(table.text(2, 1).empty());
+    WPP_CHECK(cell(table, 0, 0) == "42");
+    WPP_CHECK(cell(table, 1, 0) == "2.5");
+    WPP_CHECK(cell(table, 2, 0) == "alpha");
+    WPP_CHECK(cell(table, 3, 0) == "epoch");
+    WPP_CHECK(cell(table, 9, 0).empty());
+}
+
+WPP_TEST(sort_by_several_keys_is_stable) {
+    model table;
+    table.add_column(column_type::text);
+    table.add_column(column_type::integer);
+    const char* names[] = { "beta", "Alpha", "alpha", "gamma", "Beta", "alphabet" };
+    const std::int64_t sizes[] = { 1, 2, 2, 1, 3, 1 };
+    for (int i = 0; i < 6; ++i)
+        table.append_row({ std::string_view(names[i]), sizes[i] });
+
+    // Case-insensitive ordinal by default; Alpha and alpha tie and keep their order
+    table.sort({ { 0, false } });
+    WPP_CHECK((view(table) == std::vector<std::size_t>{ 1, 2, 5, 0, 4, 3 }));
+
+    table.sort({ { 1, true }, { 0, false } });
+    WPP_CHECK((view(table) == std::vector<std::size_t>{ 4, 1, 2, 5, 0, 3 }));
+
+    table.reset_order();
+    WPP_CHECK((view(table) == std::vector<std::size_t>{ 0, 1, 2, 3, 4, 5 }));
+
+    // Out-of-range keys leave the order alone
+    table.sort({ { 7, false } });
+    WPP_CHECK((view(table) == std::vector<std::size_t>{ 0, 1, 2, 3, 4, 5 }));
+}
+
+WPP_TEST(collation_keys_follow_appends_and_collation_changes) {
+    model table;
+    table.add_column(column_type::text);
+    table.append_row({ std::string_view("b") });
+    table.append_row({ std::string_view("c") });
+    table.sort({ { 0, false } });
+    table.append_row({ std::string_view("a") });       // keyed lazily on the next sort
+    table.sort({ { 0, false } });
+    WPP_CHECK((view(table) == std::vector<std::size_t>{ 2, 0, 1 }));
+
+    table.set_collation([](std::string_view text) {
+        std::string key(text);
+        std::reverse(key.begin(), key.end());
+        for (char& c : key)
+            c = static_cast<char>(0xFF - static_cast<unsigned char>(c));
+        return key;
+    });
+    table.sort({ { 0, false } });
+    WPP_CHECK((view(table) == std::vector<std::size_t>{ 1, 0, 2 }));
+}
+
+WPP_TEST(long_keys_compare_past_the_prefix) {
+    thread_pool pool(4);
+    auto shared = std::make_shared<model>();
+    model& table = *shared;
+    table.add_column(column_type::text);
+    std::mt19937 random(5);
+    std::vector<std::string> texts(20'000);
+    for (auto& text : texts) {
+        text = "common-prefix-";
+        for (int i = 0; i < 6; ++i)
+            text.push_back(static_cast<char>('a' + random() % 26));
+        table.append_row({ std::string_view(text) });
+    }
+
+    table.sort({ { 0, false } }, &pool);
+    bool sorted = true;
+    for (std::size_t i = 1; i < table.row_count(); ++i)
+        sorted &= texts[table.model_row(i - 1)] <= texts[table.model_row(i)];
+    WPP_CHECK(sorted);
+
+    column_list_source<char> source(shared);
+    WPP_CHECK(source.row_count() == texts.size());
+    char buffer[32];
+    source.cell_text(0, 0, buffer, sizeof(buffer));
+    WPP_CHECK(texts[table.model_row(0)] == buffer);
+}
+
+int main() { return wpp::test::run_tests(); }
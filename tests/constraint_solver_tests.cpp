@@ -0,0 +1,123 @@
+#include "check.hpp"
+#include "layout/constraint_solver.hpp"
+
+#include <cmath>
+
+using namespace wpp::layout::constraints;
+
+namespace
+{
+    bool near(double value, double expected) { return std::fabs(value - expected) < 1e-6; }
+}
+
+WPP_TEST(required_equalities_are_solved) {
+    solver s;
+    variable x("x"), y("y");
+    WPP_CHECK(s.add_constraint(x + y == expression(100.0)));
+    WPP_CHECK(s.add_constraint(x == y * 3.0));
+    s.update_variables();
+    WPP_CHECK(near(x.value(), 75.0));
+    WPP_CHECK(near(y.value(), 25.0));
+    WPP_CHECK(s.constraint_count() == 2);
+}
+
+WPP_TEST(unsatisfiable_required_constraint_is_refused) {
+    solver s;
+    variable x("x");
+    WPP_CHECK(s.add_constraint(x >= expression(10.0)));
+    WPP_CHECK(!s.add_constraint(x <= expression(5.0)));
+    WPP_CHECK(s.constraint_count() == 1);
+
+    constraint duplicate = x >= expression(0.0);
+    WPP_CHECK(s.add_constraint(duplicate));
+    WPP_CHECK(!s.add_constraint(duplicate));
+}
+
+WPP_TEST(stronger_preference_wins) {
+    solver s;
+    variable x("x");
+    s.add_constraint((x == 10.0) | strength::weak);
+    s.add_constraint((x == 20.0) | strength::strong);
+    s.update_variables();
+    WPP_CHECK(near(x.value(), 20.0));
+}
+
+WPP_TEST(removing_a_constraint_restores_the_weaker_one) {
+    solver s;
+    variable x("x");
+    s.add_constraint((x == 10.0) | strength::weak);
+    constraint pin = (x == 20.0) | strength::strong;
+    s.add_constraint(pin);
+    WPP_CHECK(s.remove_constraint(pin));
+    WPP_CHECK(!s.has_constraint(pin));
+    s.update_variables();
+    WPP_CHECK(near(x.value(), 10.0));
+}
+
+WPP_TEST(edit_variable_drives_dependent_variables) {
+    solver s;
+    variable total("total"), left("left"), right("right");
+    s.add_constraint(left + right == expression(total));
+    s.add_constraint(left == right * 2.0);
+    WPP_CHECK(s.add_edit_variable(total, strength::strong));
+    WPP_CHECK(!s.add_edit_variable(total, strength::strong));
+    WPP_CHECK(!s.add_edit_variable(left, strength::required));
+
+    for (double value : { 300.0, 90.0, 600.0 }) {
+        WPP_CHECK(s.suggest_value(total, value));
+        s.update_variables();
+        WPP_CHECK(near(left.value(), value * 2.0 / 3.0));
+        WPP_CHECK(near(right.value(), value / 3.0));
+    }
+    WPP_CHECK(s.remove_edit_variable(total));
+    WPP_CHECK(!s.suggest_value(total, 10.0));
+}
+
+WPP_TEST(constraint_system_honours_size_model_and_user_constraints) {
+    constraint_system system;
+    int first = system.add_slot();
+    int second = system.add_slot();
+    const auto& a = system.get_slot(first);
+    const auto& b = system.get_slot(second);
+
+    auto& s = system.get_solver();
+    s.add_constraint(a.left == 0.0);
+    s.add_constraint(b.left == a.left + a.width + expression(10.0));
+    // The second slot fills the rest of the content width
+    s.add_constraint((b.left + b.width == expression(system.content_width())) | strength::strong);
+
+    // The first slot is fixed by its min and max, the second only prefers a width
+    system.sync_slot_size(first, 100, 20, 100, 20, 100, 20);
+    system.sync_slot_size(second, 100, 20, 0, 0, 1000, 1000);
+    system.resize(400, 100);
+    WPP_CHECK(near(a.width.value(), 100.0));
+    WPP_CHECK(near(b.left.value(), 110.0));
+    WPP_CHECK(near(b.width.value(), 290.0));
+
+    // Resizing is incremental and only moves what depends on the content width
+    system.resize(250, 100);
+    WPP_CHECK(near(a.width.value(), 100.0));
+    WPP_CHECK(near(b.width.value(), 140.0));
+
+    // Max size beats the size preference
+    system.sync_slot_size(first, 400, 20, 50, 10, 150, 40);
+    system.resize(600, 100);
+    WPP_CHECK(near(a.width.value(), 150.0));
+}
+
+WPP_TEST(released_slot_drops_its_size_model) {
+    constraint_system system;
+    int index = system.add_slot();
+    const auto& slot = system.get_slot(index);
+    system.get_solver().add_constraint((slot.width == 30.0) | strength::weak);
+
+    system.sync_slot_size(index, 100, 20, 0, 0, 1000, 1000);
+    system.resize(400, 100);
+    WPP_CHECK(near(slot.width.value(), 100.0));
+
+    system.release_slot(index);
+    system.resize(410, 100);
+    WPP_CHECK(near(slot.width.value(), 30.0));
+}
+
+int main() { return wpp::test::run_tests(); }
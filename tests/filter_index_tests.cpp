@@ -0,0 +1,173 @@
+#include "check.hpp"
+#include "model/filter_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+using wpp::thread_pool;
+using namespace wpp::model;
+
+namespace
+{
+    using model = basic_column_model<char>;
+    using filter_index = basic_filter_index<char>;
+    using strategy = filter_index::strategy;
+
+    std::string lower(std::string_view text) {
+        std::string result(text);
+        for (char& c : result)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return result;
+    }
+
+    // Two text columns and an integer column with random content over a small alphabet, so queries hit often
+    std::shared_ptr<model> make_model(std::size_t rows, std::uint32_t seed) {
+        auto table = std::make_shared<model>();
+        table->add_column(column_type::text);
+        table->add_column(column_type::text);
+        table->add_column(column_type::integer);
+        std::mt19937 random(seed);
+        std::string name, path;
+        for (std::size_t row = 0; row < rows; ++row) {
+            name.clear();
+            path.clear();
+            for (int i = 0, length = 3 + static_cast<int>(random() % 10); i < length; ++i)
+                name.push_back(static_cast<char>((random() % 3 ? 'a' : 'A') + random() % 6));
+            for (int i = 0, length = static_cast<int>(random() % 8); i < length; ++i)
+                path.push_back(static_cast<char>('a' + random() % 6));
+            table->append_row({ std::string_view(name), std::string_view(path), static_cast<std::int64_t>(random() % 1000) });
+        }
+        return table;
+    }
+
+    // Rows in display order where any of `columns` matches, by brute force
+    std::vector<std::size_t> expected(const model& table, const std::vector<std::size_t>& columns, std::string_view query, match_mode mode) {
+        std::string folded = lower(query);
+        std::vector<std::size_t> rows;
+        for (auto row : table.order()) {
+            for (std::size_t column : columns) {
+                char buffer[64];
+                table.format(column, row, buffer, sizeof(buffer));
+                std::string text = lower(buffer);
+                if (mode == match_mode::prefix ? text.starts_with(folded) : text.find(folded) != std::string::npos) {
+                    rows.push_back(row);
+                    break;
+                }
+            }
+        }
+        return rows;
+    }
+
+    std::vector<std::size_t> view(const filter_index& filter) {
+        return std::vector<std::size_t>(filter.view().begin(), filter.view().end());
+    }
+}
+
+WPP_TEST(filter_matches_brute_force_in_both_modes) {
+    thread_pool pool(4);
+    auto table = make_model(20'000, 1);
+    filter_index filter(table);
+    filter.add_column(0);
+    filter.add_column(1, false);
+    filter.add_column(2);
+    filter.rebuild(&pool);
+    const std::vector<std::size_t> columns = { 0, 1, 2 };
+
+    for (const char* query : { "a", "Ab", "abc", "fedc", "12", "cafe", "zzz" }) {
+        for (match_mode mode : { match_mode::contains, match_mode::prefix }) {
+            filter.clear_filter();
+            std::size_t count = filter.filter(query, mode, &pool);
+            auto want = expected(*table, columns, query, mode);
+            WPP_CHECK(count == want.size());
+            WPP_CHECK(view(filter) == want);
+        }
+    }
+}
+
+WPP_TEST(typing_narrows_the_previous_matches) {
+    auto table = make_model(5'000, 2);
+    filter_index filter(table);
+    filter.add_column(0);
+    filter.rebuild(nullptr);
+
+    filter.filter("a", match_mode::contains, nullptr);
+    WPP_CHECK(filter.get_statistics().last == strategy::scan);    // too short for trigrams
+    filter.filter("ab", match_mode::contains, nullptr);
+    WPP_CHECK(filter.get_statistics().last == strategy::narrow);
+    filter.filter("abc", match_mode::contains, nullptr);
+    WPP_CHECK(view(filter) == expected(*table, { 0 }, "abc", match_mode::contains));
+
+    filter.filter("ABC", match_mode::contains, nullptr);
+    WPP_CHECK(filter.get_statistics().last == strategy::unchanged);
+
+    // Deleting a character cannot narrow
+    filter.filter("ab", match_mode::contains, nullptr);
+    WPP_CHECK(filter.get_statistics().last != strategy::narrow);
+    WPP_CHECK(view(filter) == expected(*table, { 0 }, "ab", match_mode::contains));
+
+    filter.filter("", match_mode::contains, nullptr);
+    WPP_CHECK(filter.get_statistics().last == strategy::all);
+    WPP_CHECK(filter.view_size() == table->row_count());
+}
+
+WPP_TEST(long_queries_use_the_index) {
+    auto table = make_model(5'000, 3);
+    filter_index filter(table);
+    filter.add_column(0);
+    filter.rebuild(nullptr);
+
+    filter.filter("bcd", match_mode::contains, nullptr);
+    WPP_CHECK(filter.get_statistics().last == strategy::index);
+    WPP_CHECK(filter.get_statistics().candidates < table->row_count());
+    WPP_CHECK(view(filter) == expected(*table, { 0 }, "bcd", match_mode::contains));
+
+    filter.clear_filter();
+    filter.filter("bc", match_mode::prefix, nullptr);
+    WPP_CHECK(filter.get_statistics().last == strategy::index);
+    WPP_CHECK(view(filter) == expected(*table, { 0 }, "bc", match_mode::prefix));
+}
+
+WPP_TEST(matches_follow_the_model_order) {
+    auto table = make_model(3'000, 4);
+    filter_index filter(table);
+    filter.add_column(0);
+    filter.rebuild(nullptr);
+    filter.filter("ab", match_mode::contains, nullptr);
+    std::size_t count = filter.view_size();
+
+    table->sort({ { 2, false } }, nullptr);
+    filter.refresh_order();
+    WPP_CHECK(filter.view_size() == count);
+    WPP_CHECK(view(filter) == expected(*table, { 0 }, "ab", match_mode::contains));
+    for (std::size_t row = 0; row < table->row_count(); ++row)
+        WPP_CHECK(filter.is_match(row) == (lower(table->text(0, row)).find("ab") != std::string::npos));
+}
+
+WPP_TEST(filtered_source_shows_matching_rows) {
+    auto table = std::make_shared<model>();
+    table->add_column(column_type::text);
+    table->add_column(column_type::integer);
+    table->append_row({ std::string_view("Report"), std::int64_t{ 1 } });
+    table->append_row({ std::string_view("invoice"), std::int64_t{ 2 } });
+    table->append_row({ std::string_view("Invoice 2"), std::int64_t{ 3 } });
+
+    auto filter = std::make_shared<filter_index>(table);
+    filter->add_column(0);
+    filter->rebuild(nullptr);
+    filter->filter("INVO", match_mode::prefix, nullptr);
+
+    filtered_list_source<char> source(filter);
+    WPP_CHECK(source.row_count() == 2);
+    char buffer[32];
+    source.cell_text(1, 0, buffer, sizeof(buffer));
+    WPP_CHECK(std::string(buffer) == "Invoice 2");
+    source.cell_text(1, 1, buffer, sizeof(buffer));
+    WPP_CHECK(std::string(buffer) == "3");
+    source.cell_text(5, 0, buffer, sizeof(buffer));
+    WPP_CHECK(buffer[0] == '\0');
+}
+
+int main() { return wpp::test::run_tests(); }
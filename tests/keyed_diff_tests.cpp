@@ -0,0 +1,152 @@
+#include "check.hpp"
+#include "model/keyed_diff.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wpp::model;
+
+namespace
+{
+    struct item {
+        int key;
+        std::string text;
+    };
+
+    // Apply a diff the way list_box::reconcile does: removals, insertions (moved items with their new text),
+    // then updates of items left in place
+    std::vector<item> apply(std::vector<item> list, const keyed_diff& diff, const std::vector<item>& new_items) {
+        for (std::size_t index : diff.removed)
+            list.erase(list.begin() + static_cast<std::ptrdiff_t>(index));
+        for (std::size_t index : diff.inserted)
+            list.insert(list.begin() + static_cast<std::ptrdiff_t>(index), new_items[index]);
+        for (std::size_t index : diff.updated)
+            list[index].text = new_items[index].text;
+        return list;
+    }
+
+    keyed_diff diff_items(const std::vector<item>& old_items, const std::vector<item>& new_items) {
+        auto hash = [](const item& i) { return content_hash(std::string_view(i.text)); };
+        auto key = [](const item& i) { return i.key; };
+        auto before = make_snapshot(old_items, key, hash);
+        auto after = make_snapshot(new_items, key, hash);
+        return diff_keyed<std::uint64_t>(before.keys, after.keys, before.content, after.content);
+    }
+
+    bool same(const std::vector<item>& a, const std::vector<item>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const item& x, const item& y) { return x.key == y.key && x.text == y.text; });
+    }
+
+    std::vector<item> numbered(int count) {
+        std::vector<item> items;
+        for (int i = 0; i < count; ++i)
+            items.push_back({ i, "item " + std::to_string(i) });
+        return items;
+    }
+}
+
+WPP_TEST(identical_sequences_need_no_edits) {
+    auto items = numbered(50);
+    auto diff = diff_items(items, items);
+    WPP_CHECK(diff.empty());
+    WPP_CHECK(diff.moved == 0);
+}
+
+WPP_TEST(content_changes_update_in_place) {
+    auto old_items = numbered(10);
+    auto new_items = old_items;
+    new_items[3].text = "renamed";
+    new_items[7].text = "renamed too";
+
+    auto diff = diff_items(old_items, new_items);
+    WPP_CHECK((diff.updated == std::vector<std::size_t>{ 3, 7 }));
+    WPP_CHECK(diff.removed.empty() && diff.inserted.empty());
+
+    // Without content hashes only structure is compared
+    std::vector<int> keys = { 0, 1, 2 };
+    WPP_CHECK(diff_keyed<int>(keys, keys).empty());
+}
+
+WPP_TEST(insertions_and_removals_touch_only_those_items) {
+    auto old_items = numbered(10);
+    auto new_items = old_items;
+    new_items.erase(new_items.begin() + 4);
+    new_items.erase(new_items.begin());
+    new_items.insert(new_items.begin() + 2, { 100, "new" });
+    new_items.push_back({ 101, "last" });
+
+    auto diff = diff_items(old_items, new_items);
+    WPP_CHECK((diff.removed == std::vector<std::size_t>{ 4, 0 }));
+    WPP_CHECK((diff.inserted == std::vector<std::size_t>{ 2, 9 }));
+    WPP_CHECK(diff.moved == 0);
+    WPP_CHECK(same(apply(old_items, diff, new_items), new_items));
+}
+
+WPP_TEST(moves_keep_the_longest_ordered_run) {
+    auto old_items = numbered(6);
+    std::vector<item> new_items = { old_items[5], old_items[0], old_items[1], old_items[2], old_items[3], old_items[4] };
+
+    auto diff = diff_items(old_items, new_items);
+    WPP_CHECK(diff.moved == 1);
+    WPP_CHECK((diff.removed == std::vector<std::size_t>{ 5 }));
+    WPP_CHECK((diff.inserted == std::vector<std::size_t>{ 0 }));
+    WPP_CHECK(same(apply(old_items, diff, new_items), new_items));
+
+    auto positions = diff.new_positions(old_items.size());
+    WPP_CHECK(positions[5] == 0 && positions[0] == 1);
+}
+
+WPP_TEST(repeated_new_keys_match_one_old_item) {
+    std::vector<int> old_keys = { 1, 2 };
+    std::vector<int> new_keys = { 1, 1, 2 };
+    auto diff = diff_keyed<int>(old_keys, new_keys);
+    WPP_CHECK(diff.source[0] == 0 && diff.source[1] == keyed_diff::npos && diff.source[2] == 1);
+    WPP_CHECK((diff.inserted == std::vector<std::size_t>{ 1 }));
+    WPP_CHECK(diff.removed.empty());
+}
+
+WPP_TEST(random_edits_reproduce_the_new_sequence) {
+    std::mt19937 random(9);
+    for (int round = 0; round < 200; ++round) {
+        auto old_items = numbered(static_cast<int>(random() % 60));
+        auto new_items = old_items;
+        int next_key = 1000;
+        for (int edit = 0, edits = static_cast<int>(random() % 12); edit < edits; ++edit) {
+            std::size_t size = new_items.size();
+            switch (random() % 4) {
+            case 0:
+                if (size)
+                    new_items.erase(new_items.begin() + static_cast<std::ptrdiff_t>(random() % size));
+                break;
+            case 1:
+                new_items.insert(new_items.begin() + static_cast<std::ptrdiff_t>(random() % (size + 1)), { next_key++, "added" });
+                break;
+            case 2:
+                if (size > 1)
+                    std::swap(new_items[random() % size], new_items[random() % size]);
+                break;
+            default:
+                if (size)
+                    new_items[random() % size].text += "*";
+                break;
+            }
+        }
+
+        auto diff = diff_items(old_items, new_items);
+        WPP_CHECK(same(apply(old_items, diff, new_items), new_items));
+        WPP_CHECK(std::is_sorted(diff.removed.rbegin(), diff.removed.rend()));
+        WPP_CHECK(std::is_sorted(diff.inserted.begin(), diff.inserted.end()));
+    }
+}
+
+WPP_TEST(content_hash_separates_columns) {
+    auto ab_c = content_hash(std::string_view("c"), content_hash(std::string_view("ab")));
+    auto a_bc = content_hash(std::string_view("bc"), content_hash(std::string_view("a")));
+    WPP_CHECK(ab_c != a_bc);
+    WPP_CHECK(content_hash(std::wstring_view(L"x")) == content_hash(std::wstring_view(L"x")));
+}
+
+int main() { return wpp::test::run_tests(); }
@@ -0,0 +1,179 @@
+#include "check.hpp"
+#include "layout/layout_document.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace wpp::layout;
+
+namespace
+{
+    constexpr const char* sample = R"(
+        // Settings page
+        grid name=main padding=14 spacing=10 rows=64,*,48 columns=auto,2* {
+            static text="Title" row=0 column=0 column_span=2 height=28
+            stack name=buttons row=1 column=0 orientation=vertical spacing=6 {
+                button name=ok text="OK" width=90 height=28
+                button name=cancel text="Cancel"
+            }
+            dock row=2 column=1 last_child_fill=false {
+                edit dock=left
+            }
+        }
+    )";
+
+    struct recording_builder : layout_builder {
+        std::size_t reserved = 0;
+        std::vector<std::size_t> created;
+        std::vector<std::pair<std::size_t, std::size_t>> attached;
+        std::size_t fail_at = static_cast<std::size_t>(-1);
+
+        void reserve(std::size_t count) override { reserved = count; }
+
+        bool create(std::size_t index, const layout_record&, const layout_view&) override {
+            created.push_back(index);
+            return index != fail_at;
+        }
+
+        bool attach(std::size_t parent, std::size_t index, const layout_record&, const layout_view&) override {
+            attached.emplace_back(parent, index);
+            return true;
+        }
+    };
+
+    bool parse_error(std::string_view text, std::string& error) {
+        layout_document document;
+        return !layout_document::parse(text, document, &error) && document.nodes.empty();
+    }
+}
+
+WPP_TEST(parse_records_elements_in_document_order) {
+    layout_document document;
+    std::string error;
+    WPP_CHECK(layout_document::parse(sample, document, &error));
+    WPP_CHECK(error.empty());
+    WPP_CHECK(document.nodes.size() == 7);
+
+    const auto& root = document.nodes[0];
+    WPP_CHECK(root.kind == element_kind::grid);
+    WPP_CHECK(root.parent == layout_record::no_parent);
+    WPP_CHECK(root.subtree_size == 7);
+    WPP_CHECK(root.row_count == 3 && root.column_count == 2);
+    WPP_CHECK(root.padding[0] == 14 && root.padding[3] == 14);
+    WPP_CHECK(root.spacing == 10 && root.column_spacing == 10);
+
+    const auto& stack = document.nodes[2];
+    WPP_CHECK(stack.kind == element_kind::stack);
+    WPP_CHECK(stack.parent == 0 && stack.subtree_size == 3);
+    WPP_CHECK(stack.orientation == static_cast<std::uint8_t>(orientation::vertical));
+
+    const auto& ok = document.nodes[3];
+    WPP_CHECK(ok.control == control_kind::button);
+    WPP_CHECK(ok.parent == 2);
+    WPP_CHECK(ok.width == 90 && ok.height == 28);
+    WPP_CHECK(document.nodes[4].width == -1);
+
+    const auto& dock = document.nodes[5];
+    WPP_CHECK((dock.flags & record_flags::has_last_child_fill) && !(dock.flags & record_flags::last_child_fill));
+    WPP_CHECK(document.nodes[6].dock == static_cast<std::uint8_t>(dock_position::left));
+}
+
+WPP_TEST(parse_reports_the_line_of_an_error) {
+    std::string error;
+    WPP_CHECK(parse_error("grid {\n  button width=wide\n}", error));
+    WPP_CHECK(error == "line 2: 'wide' is not a number");
+
+    WPP_CHECK(parse_error("grid rows=2x {}", error));
+    WPP_CHECK(error == "line 1: '2x' is not a valid length");
+    WPP_CHECK(parse_error("grid rows=0* {}", error));
+    WPP_CHECK(error == "line 1: '0*' is not a valid star length");
+    WPP_CHECK(parse_error("grid { button row=70000 }", error));
+    WPP_CHECK(error == "line 1: '70000' is out of range");
+    WPP_CHECK(parse_error("stack margin=1,2 {}", error));
+    WPP_CHECK(error == "line 1: expected one or four values");
+}
+
+WPP_TEST(parse_rejects_invalid_structure) {
+    std::string error;
+    WPP_CHECK(parse_error("", error));
+    WPP_CHECK(parse_error("button text=\"OK\"", error));
+    WPP_CHECK(parse_error("grid {} stack {}", error));
+    WPP_CHECK(parse_error("grid { button {} }", error));
+    WPP_CHECK(parse_error("grid { button", error));
+    WPP_CHECK(parse_error("grid { static text=\"open }", error));
+    WPP_CHECK(parse_error("grid { button colour=red }", error));
+}
+
+WPP_TEST(serialized_blob_opens_as_a_view) {
+    std::vector<std::uint8_t> blob;
+    WPP_CHECK(compile_layout(sample, blob));
+    WPP_CHECK(blob.size() % 8 == 0);
+
+    layout_view view;
+    std::string error;
+    WPP_CHECK(layout_view::open(blob.data(), blob.size(), view, &error));
+    WPP_CHECK(view.size() == 7);
+    WPP_CHECK(view.string(view[0].name) == "main");
+    WPP_CHECK(view.string(view[1].text) == "Title");
+    WPP_CHECK(view.string(view[1].name).empty());
+    WPP_CHECK(view.string(view[4].text) == "Cancel");
+
+    auto rows = view.rows(view[0]);
+    auto columns = view.columns(view[0]);
+    WPP_CHECK(rows.size() == 3 && columns.size() == 2);
+    WPP_CHECK(rows[0].length().type == grid_length_type::pixel && rows[0].length().value == 64.0f);
+    WPP_CHECK(rows[1].length().type == grid_length_type::star);
+    WPP_CHECK(columns[0].length().type == grid_length_type::auto_size);
+    WPP_CHECK(columns[1].length().value == 2.0f);
+}
+
+WPP_TEST(open_rejects_damaged_blobs) {
+    std::vector<std::uint8_t> blob;
+    WPP_CHECK(compile_layout(sample, blob));
+    layout_view view;
+
+    WPP_CHECK(!layout_view::open(nullptr, 0, view));
+    WPP_CHECK(!layout_view::open(blob.data(), blob.size() - 8, view));
+
+    auto damaged = blob;
+    damaged[0] ^= 0xFF;
+    WPP_CHECK(!layout_view::open(damaged.data(), damaged.size(), view));
+
+    // A child pointing past itself
+    damaged = blob;
+    auto* header = reinterpret_cast<layout_blob_header*>(damaged.data());
+    auto* records = reinterpret_cast<layout_record*>(damaged.data() + header->nodes_offset);
+    records[3].parent = 5;
+    WPP_CHECK(!layout_view::open(damaged.data(), damaged.size(), view));
+
+    // A string offset outside the table
+    damaged = blob;
+    header = reinterpret_cast<layout_blob_header*>(damaged.data());
+    records = reinterpret_cast<layout_record*>(damaged.data() + header->nodes_offset);
+    records[1].text = header->string_bytes + 10;
+    WPP_CHECK(!layout_view::open(damaged.data(), damaged.size(), view));
+    WPP_CHECK(view.empty());
+}
+
+WPP_TEST(instantiate_creates_parents_before_children) {
+    std::vector<std::uint8_t> blob;
+    WPP_CHECK(compile_layout(sample, blob));
+    layout_view view;
+    WPP_CHECK(layout_view::open(blob.data(), blob.size(), view));
+
+    recording_builder builder;
+    WPP_CHECK(instantiate(view, builder));
+    WPP_CHECK(builder.reserved == 7);
+    WPP_CHECK(builder.created.size() == 7);
+    WPP_CHECK(builder.attached.size() == 6);
+    for (auto [parent, index] : builder.attached)
+        WPP_CHECK(parent < index && builder.created[index] == index);
+
+    recording_builder failing;
+    failing.fail_at = 2;
+    WPP_CHECK(!instantiate(view, failing));
+    WPP_CHECK(failing.created.size() == 3);
+    WPP_CHECK(failing.attached.size() == 1);
+}
+
+int main() { return wpp::test::run_tests(); }
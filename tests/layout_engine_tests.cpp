@@ -0,0 +1,90 @@
+#include "check.hpp"
+#include "benchmarks/synthetic_trees.hpp"
+#include "layout/layout_engine.hpp"
+#include "thread_pool.hpp"
+
+#include <vector>
+
+using namespace wpp::layout;
+
+namespace
+{
+    std::vector<rect_t> bounds_of(const layout_tree& tree) {
+        std::vector<rect_t> result;
+        result.reserve(tree.size());
+        for (const auto& node : tree.nodes())
+            result.push_back(node.bounds);
+        return result;
+    }
+
+    bool same_bounds(const std::vector<rect_t>& a, const std::vector<rect_t>& b) {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i] != b[i])
+                return false;
+        }
+        return true;
+    }
+}
+
+WPP_TEST(parallel_layout_matches_sequential) {
+    wpp::thread_pool pool(4);
+    layout_tree sequential_tree, parallel_tree;
+    wpp::bench::build_forest(sequential_tree, 16, 40, 7);
+    wpp::bench::build_forest(parallel_tree, 16, 40, 7);
+
+    layout_engine sequential;
+    layout_engine parallel(&pool, 8);
+    for (int width : { 320, 800, 1280, 1920, 3840 }) {
+        sequential.layout(sequential_tree, 0, 0, 0, width, width * 9 / 16);
+        parallel.layout(parallel_tree, 0, 0, 0, width, width * 9 / 16);
+        WPP_CHECK(same_bounds(bounds_of(sequential_tree), bounds_of(parallel_tree)));
+    }
+}
+
+WPP_TEST(builders_produce_finalized_trees) {
+    layout_tree tree;
+    int leaves = wpp::bench::build_application(tree, 12, 8, 3);
+    WPP_CHECK(leaves == 12 + 20 + 4 + 12 * 8 * 2);
+    WPP_CHECK(tree[0].subtree_size == static_cast<int>(tree.size()));
+
+    layout_engine engine;
+    engine.layout(tree, 0, 0, 0, 1024, 768);
+    WPP_CHECK(tree[0].bounds == (rect_t{ 0, 0, 1024, 768 }));
+}
+
+WPP_TEST(grid_tracks_fill_available_space) {
+    // Two star columns and one star row share the content area after padding and spacing
+    layout_tree tree;
+    int root = tree.add_node(node_kind::grid, -1);
+    tree.set_row_definitions(root, { grid_length::star() });
+    tree.set_column_definitions(root, { grid_length::star(), grid_length::star() });
+    tree[root].column_spacing = 10;
+    int left = tree.add_node(node_kind::leaf, root);
+    int right = tree.add_node(node_kind::leaf, root);
+    tree[right].cell = { 0, 1, 1, 1 };
+    tree.finalize();
+
+    layout_engine engine;
+    engine.layout(tree, root, 0, 0, 210, 50);
+    WPP_CHECK(tree[left].bounds == (rect_t{ 0, 0, 100, 50 }));
+    WPP_CHECK(tree[right].bounds == (rect_t{ 110, 0, 100, 50 }));
+}
+
+WPP_TEST(statistics_count_passes_and_nodes) {
+    layout_tree tree;
+    wpp::bench::build_wide_grid(tree, 10, 10);
+    layout_statistics statistics;
+    layout_engine engine;
+    engine.set_statistics(&statistics);
+    engine.layout(tree, 0, 0, 0, 800, 600);
+    WPP_CHECK(statistics.measure_passes.load() == 1);
+    WPP_CHECK(statistics.arrange_passes.load() == 1);
+    WPP_CHECK(statistics.nodes_measured.load() == tree.size());
+    WPP_CHECK(statistics.nodes_arranged.load() >= 1); // grid leaves are placed inline, not counted
+}
+
+int main() {
+    return wpp::test::run_tests();
+}
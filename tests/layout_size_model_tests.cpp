@@ -0,0 +1,101 @@
+#include "check.hpp"
+#include "benchmarks/synthetic_trees.hpp"
+#include "layout/layout_engine.hpp"
+
+using namespace wpp::layout;
+
+WPP_TEST(leaf_desired_size_is_clamped_preferred_size) {
+    layout_tree tree;
+    int root = tree.add_node(node_kind::stack, -1);
+    int small = tree.add_node(node_kind::leaf, root);
+    int large = tree.add_node(node_kind::leaf, root);
+    tree[small].preferred = { 10, 5 };
+    tree[small].min_size = { 40, 20 };
+    tree[large].preferred = { 500, 300 };
+    tree[large].max_size = { 200, 100 };
+    tree.finalize();
+
+    layout_engine engine;
+    engine.measure(tree, root, 1000, 1000);
+    WPP_CHECK(tree[small].desired == (sizing_t{ 40, 20 }));
+    WPP_CHECK(tree[large].desired == (sizing_t{ 200, 100 }));
+}
+
+WPP_TEST(stack_places_children_by_desired_size) {
+    layout_tree tree;
+    int root = tree.add_node(node_kind::stack, -1);
+    tree[root].stack_alignment = alignment::start;
+    tree[root].row_spacing = 5;
+    int first = tree.add_node(node_kind::leaf, root);
+    int second = tree.add_node(node_kind::leaf, root);
+    tree[first].preferred = { 80, 20 };
+    tree[second].preferred = { 120, 30 };
+    tree.finalize();
+
+    layout_engine engine;
+    engine.layout(tree, root, 0, 0, 400, 300);
+    WPP_CHECK(tree[root].desired == (sizing_t{ 120, 55 }));
+    WPP_CHECK(tree[first].bounds == (rect_t{ 0, 0, 80, 20 }));
+    WPP_CHECK(tree[second].bounds == (rect_t{ 0, 25, 120, 30 }));
+}
+
+WPP_TEST(arranged_size_respects_maximum_in_a_stretching_stack) {
+    layout_tree tree;
+    int root = tree.add_node(node_kind::stack, -1);
+    tree[root].stack_alignment = alignment::stretch;
+    int capped = tree.add_node(node_kind::leaf, root);
+    tree[capped].preferred = { 10, 20 };
+    tree[capped].max_size = { 50, size_constraints::unbounded };
+    tree.finalize();
+
+    layout_engine engine;
+    engine.layout(tree, root, 0, 0, 400, 300);
+    WPP_CHECK(tree[capped].bounds.width == 50);
+}
+
+WPP_TEST(dock_consumes_edges_then_fills) {
+    layout_tree tree;
+    int root = tree.add_node(node_kind::dock, -1);
+    int left = tree.add_node(node_kind::leaf, root);
+    int top = tree.add_node(node_kind::leaf, root);
+    int fill = tree.add_node(node_kind::leaf, root);
+    tree[left].dock = dock_position::left;
+    tree[left].preferred = { 100, 10 };
+    tree[top].dock = dock_position::top;
+    tree[top].preferred = { 10, 30 };
+    tree[fill].preferred = { 1, 1 };
+    tree.finalize();
+
+    layout_engine engine;
+    engine.layout(tree, root, 0, 0, 640, 480);
+    WPP_CHECK(tree[left].bounds == (rect_t{ 0, 0, 100, 480 }));
+    WPP_CHECK(tree[top].bounds == (rect_t{ 100, 0, 540, 30 }));
+    WPP_CHECK(tree[fill].bounds == (rect_t{ 100, 30, 540, 450 }));
+}
+
+WPP_TEST(layout_depends_only_on_the_size_model) {
+    // Results must not depend on whatever geometry the tree held before the pass
+    layout_tree clean, dirty;
+    wpp::bench::build_application(clean, 8, 6, 11);
+    wpp::bench::build_application(dirty, 8, 6, 11);
+    for (auto& node : dirty.nodes())
+        node.bounds = { 1234, 5678, 91, 23 };
+
+    layout_engine engine;
+    engine.layout(clean, 0, 0, 0, 1280, 800);
+    engine.layout(dirty, 0, 0, 0, 1280, 800);
+    bool same = true;
+    for (size_t i = 0; i < clean.size(); ++i)
+        same = same && clean.nodes()[i].bounds == dirty.nodes()[i].bounds;
+    WPP_CHECK(same);
+
+    // And laying out again at the same size changes nothing
+    engine.layout(clean, 0, 0, 0, 1280, 800);
+    for (size_t i = 0; i < clean.size(); ++i)
+        same = same && clean.nodes()[i].bounds == dirty.nodes()[i].bounds;
+    WPP_CHECK(same);
+}
+
+int main() {
+    return wpp::test::run_tests();
+}
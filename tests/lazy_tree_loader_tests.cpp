@@ -0,0 +1,106 @@
+#include "check.hpp"
+#include "model/lazy_tree_loader.hpp"
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using wpp::thread_pool;
+using namespace wpp::model;
+
+namespace
+{
+    using loader = basic_lazy_tree_loader<char>;
+
+    // Wait until every task submitted so far has run: a one-worker pool takes outside submissions in order
+    void drain(thread_pool& pool) {
+        std::promise<void> done;
+        pool.submit([&done] { done.set_value(); });
+        done.get_future().wait();
+    }
+
+    // Lists `data` children named after their parent
+    void numbered_children(std::uint64_t data, loader::sink& out) {
+        for (std::uint64_t i = 0; i < data && !out.cancelled(); ++i)
+            out.add("child " + std::to_string(i), i, i % 2 == 0);
+    }
+}
+
+WPP_TEST(children_arrive_in_batches_and_finish_the_load) {
+    thread_pool pool(1);
+    loader::options settings;
+    settings.batch_size = 4;
+    loader tree(numbered_children, settings, pool);
+
+    WPP_CHECK(tree.load(7, 10));
+    WPP_CHECK(!tree.load(7, 10));           // already loading
+    drain(pool);
+
+    std::vector<loader::batch> batches;
+    WPP_CHECK(tree.take_ready(batches));
+    WPP_CHECK(batches.size() == 3);         // 4 + 4 + 2, the last one marked done
+    WPP_CHECK(batches.back().done && !batches.front().done);
+    WPP_CHECK(batches[0].node == 7 && batches[0].children[1].text == "child 1");
+    WPP_CHECK(!tree.is_loading(7));
+    WPP_CHECK(tree.get_statistics().children == 10);
+    WPP_CHECK(tree.get_statistics().completed == 1);
+}
+
+WPP_TEST(cancelled_loads_are_dropped) {
+    thread_pool pool(1);
+    loader tree(numbered_children, {}, pool);
+
+    std::promise<void> release;
+    pool.submit([gate = release.get_future().share()] { gate.wait(); });
+    tree.load(1, 5);
+    tree.load(2, 5);
+    WPP_CHECK(tree.cancel(1));
+    WPP_CHECK(!tree.cancel(1));
+    release.set_value();
+    drain(pool);
+
+    std::vector<loader::batch> batches;
+    WPP_CHECK(tree.take_ready(batches));
+    WPP_CHECK(batches.size() == 1 && batches[0].node == 2);
+    WPP_CHECK(tree.loading_count() == 0);
+    WPP_CHECK(tree.get_statistics().cancelled == 1);
+}
+
+WPP_TEST(a_reloaded_node_ignores_its_earlier_load) {
+    thread_pool pool(1);
+    loader tree(numbered_children, {}, pool);
+
+    std::promise<void> release;
+    pool.submit([gate = release.get_future().share()] { gate.wait(); });
+    tree.load(1, 3);
+    tree.cancel(1);
+    tree.load(1, 2);                        // expanded again under a new ticket
+    release.set_value();
+    drain(pool);
+
+    std::vector<loader::batch> batches;
+    WPP_CHECK(tree.take_ready(batches));
+    WPP_CHECK(batches.size() == 1 && batches[0].children.size() == 2);
+}
+
+WPP_TEST(loads_run_on_the_default_pool) {
+    std::promise<bool> ran_on_worker;
+    loader tree([&ran_on_worker](std::uint64_t, loader::sink& out) {
+        ran_on_worker.set_value(true);
+        out.add("x");
+    });
+    std::atomic<int> notified = 0;
+    tree.set_ready_notifier([&notified] { notified++; });
+    tree.load(1, 0);
+    WPP_CHECK(ran_on_worker.get_future().get());
+    while (notified == 0)
+        std::this_thread::yield();
+
+    std::vector<loader::batch> batches;
+    WPP_CHECK(tree.take_ready(batches));
+    WPP_CHECK(batches.size() == 1 && batches[0].done);
+}
+
+int main() { return wpp::test::run_tests(); }
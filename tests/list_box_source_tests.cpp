@@ -0,0 +1,89 @@
+#include "check.hpp"
+#include "model/list_box_source.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wpp::model;
+
+namespace
+{
+    struct symbol {
+        std::string name;
+        int address = 0;
+    };
+
+    template<typename Source>
+    std::string text(const Source& source, std::size_t item, std::size_t capacity = 64) {
+        std::vector<char> buffer(capacity + 1, '#');
+        std::size_t length = source.item_text(item, buffer.data(), capacity);
+        return std::string(buffer.data(), length);
+    }
+}
+
+WPP_TEST(vector_source_reads_through_the_accessor) {
+    std::vector<symbol> symbols{ { "main", 1 }, { "printf", 2 } };
+    vector_list_box_source<symbol, char> source(symbols, [](const symbol& s) { return std::string_view(s.name); });
+    WPP_CHECK(source.item_count() == 2);
+    WPP_CHECK(text(source, 0) == "main" && text(source, 1) == "printf");
+    WPP_CHECK(text(source, 2).empty());
+
+    // The vector is referenced, so later additions show without rebuilding the source
+    symbols.push_back({ "exit", 3 });
+    WPP_CHECK(source.item_count() == 3 && text(source, 2) == "exit");
+}
+
+WPP_TEST(text_is_truncated_and_terminated) {
+    std::vector<symbol> symbols{ { "a_rather_long_symbol_name", 1 } };
+    vector_list_box_source<symbol, char> source(symbols, [](const symbol& s) { return std::string_view(s.name); });
+    char buffer[8] = { '#', '#', '#', '#', '#', '#', '#', '#' };
+    WPP_CHECK(source.item_text(0, buffer, 8) == 7);
+    WPP_CHECK(std::string(buffer) == "a_rathe");
+    WPP_CHECK(source.item_text(0, buffer, 0) == 0);
+    WPP_CHECK(source.item_text(0, nullptr, 8) == 0);
+}
+
+WPP_TEST(function_source_calls_back) {
+    std::size_t asked = 0;
+    function_list_box_source<char> source(
+        [] { return std::size_t{ 2000000 }; },
+        [&](std::size_t item, char* buffer, std::size_t capacity) {
+            asked++;
+            return copy_text(std::string_view("symbol " + std::to_string(item)), buffer, capacity);
+        });
+    WPP_CHECK(source.item_count() == 2000000);
+    WPP_CHECK(text(source, 1999999) == "symbol 1999999");
+    WPP_CHECK(asked == 1);
+
+    function_list_box_source<char> empty(nullptr, nullptr);
+    WPP_CHECK(empty.item_count() == 0 && text(empty, 0).empty());
+}
+
+WPP_TEST(column_source_shows_one_column) {
+    auto rows = std::make_shared<table_list_source<char>>(2);
+    rows->add_row("main", "0x1000");
+    rows->add_row("printf", "0x2000");
+    column_list_box_source<char> source(rows, 1);
+    WPP_CHECK(source.item_count() == 2);
+    WPP_CHECK(text(source, 1) == "0x2000");
+    source.set_column(0);
+    WPP_CHECK(source.column() == 0 && text(source, 1) == "printf");
+    WPP_CHECK(text(source, 2).empty());
+
+    column_list_box_source<char> unbound(nullptr);
+    WPP_CHECK(unbound.item_count() == 0 && text(unbound, 0).empty());
+}
+
+WPP_TEST(sources_share_the_base_interface) {
+    std::vector<std::wstring> names{ L"alpha", L"beta" };
+    std::unique_ptr<basic_list_box_source<wchar_t>> source =
+        std::make_unique<vector_list_box_source<std::wstring, wchar_t>>(names, [](const std::wstring& s) { return std::wstring_view(s); });
+    wchar_t buffer[16];
+    std::size_t length = source->item_text(1, buffer, 16);
+    WPP_CHECK(std::wstring(buffer, length) == L"beta");
+    WPP_CHECK(source->item_count() == 2);
+}
+
+int main() { return wpp::test::run_tests(); }
@@ -0,0 +1,105 @@
+#include "check.hpp"
+#include "model/list_view_source.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wpp::model;
+
+namespace
+{
+    struct product {
+        std::string sku;
+        std::string name;
+    };
+
+    std::vector<product> sample() {
+        return { { "GN-00001", "Widget" }, { "GN-00002", "Gadget" }, { "GN-00003", "Gizmo" } };
+    }
+
+    template<typename Source>
+    std::string text(const Source& source, std::size_t row, int column, std::size_t capacity = 64) {
+        std::vector<char> buffer(capacity + 1, '#');
+        std::size_t length = source.cell_text(row, column, buffer.data(), capacity);
+        return std::string(buffer.data(), length);
+    }
+}
+
+WPP_TEST(copy_text_fits_exactly) {
+    char buffer[6] = { '#', '#', '#', '#', '#', '#' };
+    WPP_CHECK(copy_text(std::string_view("hello"), buffer, 6) == 5);
+    WPP_CHECK(std::string(buffer) == "hello" && buffer[5] == '\0');
+}
+
+WPP_TEST(copy_text_truncates_and_terminates) {
+    // Longer than cchTextMax: cut to capacity - 1 characters plus the terminator
+    char buffer[8] = { '#', '#', '#', '#', '#', '#', '#', '#' };
+    WPP_CHECK(copy_text(std::string_view("truncated text"), buffer, 5) == 4);
+    WPP_CHECK(std::string(buffer) == "trun" && buffer[5] == '#');
+
+    WPP_CHECK(copy_text(std::string_view("x"), buffer, 1) == 0);
+    WPP_CHECK(buffer[0] == '\0');
+}
+
+WPP_TEST(copy_text_ignores_empty_buffers) {
+    char buffer[2] = { '#', '#' };
+    WPP_CHECK(copy_text(std::string_view("text"), buffer, 0) == 0);
+    WPP_CHECK(buffer[0] == '#');
+    WPP_CHECK(copy_text(std::string_view("text"), static_cast<char*>(nullptr), 8) == 0);
+    WPP_CHECK(copy_text(std::string_view(), buffer, 2) == 0 && buffer[0] == '\0');
+
+    wchar_t wide[3];
+    WPP_CHECK(copy_text(std::wstring_view(L"wide"), wide, 3) == 2 && std::wstring(wide) == L"wi");
+}
+
+WPP_TEST(vector_source_reads_rows_by_column) {
+    std::vector<product> products = sample();
+    vector_list_source<product, char> source(products);
+    source.add_column([](const product& p) { return std::string_view(p.sku); })
+          .add_column([](const product& p) { return std::string_view(p.name); });
+    WPP_CHECK(source.row_count() == 3 && source.column_count() == 2);
+    WPP_CHECK(text(source, 0, 0) == "GN-00001" && text(source, 2, 1) == "Gizmo");
+    WPP_CHECK(text(source, 1, 1, 4) == "Gad");
+
+    // Out of range rows and columns are empty, and there are no images by default
+    WPP_CHECK(text(source, 3, 0).empty() && text(source, 0, 2).empty() && text(source, 0, -1).empty());
+    WPP_CHECK(source.image(0, 0) == basic_list_view_source<char>::no_image);
+    WPP_CHECK(source.state(0) == 0 && source.indent(0) == 0);
+
+    // The vector is referenced, not copied
+    products.push_back({ "GN-00004", "Doohickey" });
+    WPP_CHECK(source.row_count() == 4 && text(source, 3, 1) == "Doohickey");
+}
+
+WPP_TEST(function_source_calls_back_for_text_and_images) {
+    function_list_source<char> source(
+        [] { return std::size_t{ 1000000 }; },
+        [](std::size_t row, int column, char* buffer, std::size_t capacity) {
+            return copy_text(std::string_view(std::to_string(row) + ":" + std::to_string(column)), buffer, capacity);
+        },
+        [](std::size_t row, int column) { return column == 0 ? static_cast<int>(row % 3) : basic_list_view_source<char>::no_image; });
+    WPP_CHECK(source.row_count() == 1000000);
+    WPP_CHECK(text(source, 999999, 2) == "999999:2");
+    WPP_CHECK(source.image(4, 0) == 1 && source.image(4, 1) == basic_list_view_source<char>::no_image);
+
+    function_list_source<char> empty(nullptr, nullptr);
+    WPP_CHECK(empty.row_count() == 0 && text(empty, 0, 0).empty());
+    WPP_CHECK(empty.image(0, 0) == basic_list_view_source<char>::no_image);
+}
+
+WPP_TEST(table_source_stores_cells) {
+    table_list_source<char> source(2);
+    WPP_CHECK(source.add_row("a", "b") == 0);
+    WPP_CHECK(source.add_row("c") == 1);
+    WPP_CHECK(source.add_row("d", "e", "dropped") == 2);
+    WPP_CHECK(source.row_count() == 3);
+    WPP_CHECK(text(source, 1, 1).empty() && text(source, 2, 1) == "e");
+
+    source.set_cell(1, 1, "filled");
+    WPP_CHECK(text(source, 1, 1) == "filled");
+    source.erase_rows(0, 2);
+    WPP_CHECK(source.row_count() == 1 && text(source, 0, 0) == "d");
+}
+
+int main() { return wpp::test::run_tests(); }
@@ -0,0 +1,141 @@
+#include "check.hpp"
+#include "model/paged_list_source.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using wpp::thread_pool;
+using namespace wpp::model;
+
+namespace
+{
+    using source = paged_list_source<std::string, char>;
+
+    source::options small_pages() {
+        source::options settings;
+        settings.prefetch = { 10, 1, 1 };
+        settings.placeholder = "...";
+        return settings;
+    }
+
+    source make_source(thread_pool& pool, std::atomic<int>& fetches, std::size_t rows = 1000) {
+        return source(rows,
+            [&fetches](std::size_t first, std::size_t count) {
+                fetches++;
+                std::vector<std::string> result;
+                for (std::size_t i = 0; i < count; ++i)
+                    result.push_back("row " + std::to_string(first + i));
+                return result;
+            },
+            [](const std::string& row, int) { return std::string_view(row); },
+            small_pages(), pool);
+    }
+
+    // Wait until every task submitted so far has run: a one-worker pool takes outside submissions in order
+    void drain(thread_pool& pool) {
+        std::promise<void> done;
+        pool.submit([&done] { done.set_value(); });
+        done.get_future().wait();
+    }
+
+    std::string text(const source& rows, std::size_t row) {
+        char buffer[32];
+        rows.cell_text(row, 0, buffer, sizeof(buffer));
+        return buffer;
+    }
+}
+
+WPP_TEST(hinted_pages_load_and_report_rows_to_repaint) {
+    thread_pool pool(1);
+    std::atomic<int> fetches = 0;
+    auto rows = make_source(pool, fetches);
+    std::atomic<int> notified = 0;
+    rows.set_ready_notifier([&notified] { notified++; });
+
+    rows.cache_hint(20, 35);
+    WPP_CHECK(text(rows, 25) == "...");
+    drain(pool);
+    WPP_CHECK(notified >= 1);
+
+    std::size_t first = 0, last = 0;
+    WPP_CHECK(rows.take_ready_rows(first, last));
+    WPP_CHECK(first == 10 && last == 49);   // pages 2 and 3, one ahead and one behind
+    WPP_CHECK(text(rows, 25) == "row 25");
+    WPP_CHECK(rows.pending_pages() == 0);
+    WPP_CHECK(!rows.take_ready_rows(first, last));
+}
+
+WPP_TEST(rows_painted_outside_the_hint_are_fetched) {
+    thread_pool pool(1);
+    std::atomic<int> fetches = 0;
+    auto rows = make_source(pool, fetches);
+
+    rows.cache_hint(0, 9);
+    WPP_CHECK(text(rows, 505) == "...");    // painted with no hint covering it
+    drain(pool);
+
+    std::size_t first = 0, last = 0;
+    WPP_CHECK(rows.take_ready_rows(first, last));
+    WPP_CHECK(last >= 509);
+    WPP_CHECK(rows.is_row_loaded(505));
+    WPP_CHECK(text(rows, 505) == "row 505");
+    WPP_CHECK(rows.get_statistics().skipped == 0);
+}
+
+WPP_TEST(pages_skipped_while_scrolled_away_are_requested_again) {
+    thread_pool pool(1);
+    std::atomic<int> fetches = 0;
+    auto rows = make_source(pool, fetches);
+
+    // Hold the worker so the first hint's pages are still queued when the list scrolls away
+    std::promise<void> release;
+    pool.submit([gate = release.get_future().share()] { gate.wait(); });
+
+    rows.cache_hint(0, 9);
+    rows.cache_hint(800, 809);
+    release.set_value();
+    drain(pool);
+
+    // Back at the top before the skipped pages were taken: nothing new is queued for them yet
+    rows.cache_hint(0, 9);
+    std::size_t first = 0, last = 0;
+    rows.take_ready_rows(first, last);
+    WPP_CHECK(rows.get_statistics().skipped >= 1);
+    WPP_CHECK(!rows.is_row_loaded(5));
+
+    drain(pool);
+    WPP_CHECK(rows.take_ready_rows(first, last));
+    WPP_CHECK(first == 0);
+    WPP_CHECK(rows.is_row_loaded(5));
+    WPP_CHECK(text(rows, 5) == "row 5");
+}
+
+WPP_TEST(invalidate_drops_fetches_in_flight) {
+    thread_pool pool(1);
+    std::atomic<int> fetches = 0;
+    auto rows = make_source(pool, fetches);
+
+    std::promise<void> release;
+    pool.submit([gate = release.get_future().share()] { gate.wait(); });
+    rows.cache_hint(0, 9);
+    rows.invalidate(500);
+    release.set_value();
+    drain(pool);
+
+    std::size_t first = 0, last = 0;
+    WPP_CHECK(!rows.take_ready_rows(first, last));
+    WPP_CHECK(fetches == 0);
+    WPP_CHECK(rows.row_count() == 500);
+    WPP_CHECK(!rows.is_row_loaded(0));
+}
+
+WPP_TEST(blocking_sources_default_to_the_io_pool) {
+    WPP_CHECK(&thread_pool::io() != &thread_pool::shared());
+    WPP_CHECK(thread_pool::io().size() >= 1);
+}
+
+int main() { return wpp::test::run_tests(); }
@@ -0,0 +1,143 @@
+#include "check.hpp"
+#include "layout/resize_scheduler.hpp"
+
+using namespace wpp::layout;
+
+namespace
+{
+    // Virtual monotonic clock in microseconds
+    struct fake_clock {
+        resize_scheduler::time_point now = 1000000;
+
+        resize_scheduler::time_point advance(resize_scheduler::time_point us) { return now += us; }
+    };
+
+    constexpr resize_scheduler::time_point interval = 16667;
+}
+
+WPP_TEST(sizes_outside_a_resize_are_laid_out_immediately) {
+    resize_scheduler scheduler;
+    fake_clock clock;
+    WPP_CHECK(!scheduler.active());
+    WPP_CHECK(scheduler.size_changed(800, 600, clock.now));
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+    WPP_CHECK(scheduler.size_changed(801, 600, clock.now));
+    WPP_CHECK(scheduler.get_statistics().sizes == 0 && scheduler.get_statistics().frames == 0);
+    WPP_CHECK(!scheduler.end());
+}
+
+WPP_TEST(repeated_sizes_merge_into_one_frame) {
+    resize_scheduler scheduler;
+    fake_clock clock;
+    scheduler.begin();
+    WPP_CHECK(scheduler.size_changed(800, 600, clock.now));
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+
+    // WM_SIZE arrives every 2 ms; none of them may start a layout before the interval is up
+    for (int i = 1; i <= 5; ++i)
+        WPP_CHECK(!scheduler.size_changed(800 + i, 600 + i, clock.advance(2000)));
+    WPP_CHECK(scheduler.has_pending());
+    WPP_CHECK(scheduler.pending_width() == 805 && scheduler.pending_height() == 605);
+    WPP_CHECK(!scheduler.tick(clock.now));
+
+    // The next due tick lays out only the latest size
+    WPP_CHECK(scheduler.tick(clock.advance(interval)));
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+    WPP_CHECK(!scheduler.has_pending() && !scheduler.tick(clock.advance(interval)));
+
+    auto stats = scheduler.get_statistics();
+    WPP_CHECK(stats.sizes == 6 && stats.frames == 2 && stats.coalesced == 4);
+}
+
+WPP_TEST(frame_due_respects_the_refresh_interval) {
+    resize_scheduler scheduler(10000);
+    fake_clock clock;
+    WPP_CHECK(scheduler.frame_interval() == 10000);
+    scheduler.begin();
+    WPP_CHECK(scheduler.time_to_next_frame(clock.now) == 0);
+
+    scheduler.size_changed(640, 480, clock.now);
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+    WPP_CHECK(scheduler.time_to_next_frame(clock.advance(4000)) == 6000);
+    WPP_CHECK(!scheduler.size_changed(650, 480, clock.now));
+    WPP_CHECK(!scheduler.tick(clock.advance(5999)));
+    WPP_CHECK(scheduler.tick(clock.advance(1)));
+    WPP_CHECK(scheduler.time_to_next_frame(clock.now) == 0);
+
+    // A size arriving once the interval is up starts its frame directly
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+    WPP_CHECK(scheduler.size_changed(660, 480, clock.advance(10000)));
+
+    scheduler.set_frame_interval(0);
+    WPP_CHECK(scheduler.frame_interval() == 1);
+}
+
+WPP_TEST(busy_frames_are_skipped) {
+    resize_scheduler scheduler;
+    fake_clock clock;
+    scheduler.begin();
+    WPP_CHECK(scheduler.size_changed(800, 600, clock.now));
+    scheduler.frame_started(clock.now);
+    WPP_CHECK(scheduler.frame_in_flight());
+
+    // Due, but the previous frame is still committing: skipped, and the size stays pending
+    WPP_CHECK(!scheduler.size_changed(810, 600, clock.advance(interval)));
+    WPP_CHECK(!scheduler.tick(clock.advance(1000)));
+    WPP_CHECK(scheduler.get_statistics().busy_skips == 2);
+    WPP_CHECK(scheduler.has_pending() && scheduler.pending_width() == 810);
+
+    scheduler.frame_committed();
+    WPP_CHECK(scheduler.tick(clock.now));
+}
+
+WPP_TEST(recovers_after_a_stalled_frame) {
+    resize_scheduler scheduler;
+    fake_clock clock;
+    scheduler.set_stall_frames(3);
+    scheduler.begin();
+    scheduler.size_changed(800, 600, clock.now);
+    scheduler.frame_started(clock.now);
+
+    // The commit never arrives: after three intervals the frame counts as lost
+    scheduler.size_changed(820, 600, clock.advance(interval));
+    WPP_CHECK(!scheduler.tick(clock.advance(interval)));
+    WPP_CHECK(scheduler.tick(clock.advance(interval)));
+    WPP_CHECK(!scheduler.frame_in_flight());
+    scheduler.frame_started(clock.now);
+    WPP_CHECK(scheduler.frame_in_flight());
+    WPP_CHECK(scheduler.get_statistics().frames == 2);
+}
+
+WPP_TEST(end_reports_whether_a_final_layout_is_needed) {
+    resize_scheduler scheduler;
+    fake_clock clock;
+    scheduler.begin();
+    scheduler.size_changed(800, 600, clock.now);
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+    scheduler.size_changed(900, 700, clock.advance(1000));
+    WPP_CHECK(scheduler.end());
+    WPP_CHECK(!scheduler.active() && scheduler.pending_width() == 900);
+    WPP_CHECK(scheduler.get_statistics().final_layouts == 1);
+
+    // Every size already laid out: nothing left to do
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+    scheduler.begin();
+    scheduler.size_changed(900, 710, clock.advance(interval));
+    scheduler.frame_started(clock.now);
+    scheduler.frame_committed();
+    WPP_CHECK(!scheduler.end());
+    WPP_CHECK(!scheduler.end());
+    WPP_CHECK(scheduler.get_statistics().final_layouts == 1);
+
+    scheduler.reset_statistics();
+    WPP_CHECK(scheduler.get_statistics().sizes == 0);
+}
+
+int main() { return wpp::test::run_tests(); }
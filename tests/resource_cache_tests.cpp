@@ -0,0 +1,152 @@
+#include "check.hpp"
+#include "graphics/resource_cache.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace wpp::graphics;
+
+namespace
+{
+    // Handles are numbered in creation order; 0 plays the null handle
+    struct fake_handles {
+        int created = 0;
+        std::vector<int> deleted;
+
+        resource_cache<pen_key, int> cache(std::size_t max_idle = 64) {
+            return resource_cache<pen_key, int>([this](const pen_key&) { return ++created; },
+                                                [this](int handle) { deleted.push_back(handle); }, max_idle);
+        }
+    };
+
+    pen_key red(int width = 1) { return { 0, width, 0x0000ff }; }
+}
+
+WPP_TEST(equal_keys_share_one_handle) {
+    fake_handles handles;
+    auto cache = handles.cache();
+    auto first = cache.acquire(red());
+    auto second = cache.acquire(red());
+    auto wide = cache.acquire(red(2));
+    WPP_CHECK(first && first.get() == second.get());
+    WPP_CHECK(wide.get() != first.get());
+    WPP_CHECK(handles.created == 2);
+
+    auto copy = first;
+    WPP_CHECK(copy.get() == first.get());
+    auto stats = cache.get_statistics();
+    WPP_CHECK(stats.live == 2 && stats.in_use == 2 && stats.idle == 0);
+}
+
+WPP_TEST(last_release_leaves_the_handle_idle) {
+    fake_handles handles;
+    auto cache = handles.cache();
+    int value = 0;
+    {
+        auto first = cache.acquire(red());
+        auto second = first;
+        value = first.get();
+        first.reset();
+        WPP_CHECK(cache.get_statistics().in_use == 1);
+    }
+    auto stats = cache.get_statistics();
+    WPP_CHECK(stats.idle == 1 && stats.in_use == 0 && handles.deleted.empty());
+
+    // Acquiring again revives the idle handle instead of creating one
+    auto again = cache.acquire(red());
+    WPP_CHECK(again.get() == value && handles.created == 1);
+    WPP_CHECK(cache.get_statistics().idle == 0);
+}
+
+WPP_TEST(lru_trimming_deletes_the_oldest_idle_entries) {
+    fake_handles handles;
+    auto cache = handles.cache(2);
+    std::vector<int> values;
+    for (int width = 1; width <= 4; ++width)
+        values.push_back(cache.acquire(red(width)).get());
+
+    // Released in width order: the two released first are beyond max_idle
+    WPP_CHECK((handles.deleted == std::vector<int>{ values[0], values[1] }));
+    auto stats = cache.get_statistics();
+    WPP_CHECK(stats.idle == 2 && stats.live == 2 && stats.evictions == 2);
+
+    // Using an idle entry makes it the most recent; lowering the limit drops the other one
+    cache.acquire(red(3)).reset();
+    cache.set_max_idle(1);
+    WPP_CHECK(handles.deleted.back() == values[3]);
+    WPP_CHECK(cache.get_statistics().live == 1);
+
+    // Purge deletes every idle entry but leaves those in use
+    auto held = cache.acquire(red(5));
+    cache.purge();
+    WPP_CHECK(handles.deleted.back() == values[2]);
+    stats = cache.get_statistics();
+    WPP_CHECK(stats.live == 1 && stats.in_use == 1 && held);
+}
+
+WPP_TEST(statistics_count_hits_and_misses) {
+    fake_handles handles;
+    auto cache = handles.cache();
+    auto a = cache.acquire(red());
+    auto b = cache.acquire(red());
+    a.reset();
+    b.reset();
+    auto c = cache.acquire(red());
+    auto d = cache.acquire(red(3));
+    auto stats = cache.get_statistics();
+    WPP_CHECK(stats.misses == 2 && stats.hits == 2);
+    WPP_CHECK(stats.evictions == 0);
+}
+
+WPP_TEST(failed_creation_is_not_cached) {
+    int calls = 0;
+    resource_cache<brush_key, int> cache([&](const brush_key&) { calls++; return 0; }, nullptr);
+    WPP_CHECK(!cache.acquire({ 0xffffff, -1 }));
+    WPP_CHECK(!cache.acquire({ 0xffffff, -1 }));
+    WPP_CHECK(calls == 2 && cache.get_statistics().live == 0);
+}
+
+WPP_TEST(handles_outlive_the_cache) {
+    fake_handles handles;
+    resource_cache<pen_key, int>::handle kept;
+    {
+        auto cache = handles.cache();
+        kept = cache.acquire(red());
+    }
+    WPP_CHECK(kept && handles.deleted.empty());
+    kept.reset();
+    WPP_CHECK(handles.deleted.size() == 1);
+}
+
+WPP_TEST(font_keys_compare_every_field) {
+    basic_font_key<char> base;
+    base.face = "Segoe UI";
+    auto differs = [&](auto change) {
+        basic_font_key<char> other = base;
+        change(other);
+        return !(other == base);
+    };
+    WPP_CHECK(!differs([](auto&) {}));
+    WPP_CHECK(differs([](auto& k) { k.width = 7; }));
+    WPP_CHECK(differs([](auto& k) { k.escapement = 900; }));
+    WPP_CHECK(differs([](auto& k) { k.orientation = 900; }));
+    WPP_CHECK(differs([](auto& k) { k.charset = 0; }));
+    WPP_CHECK(differs([](auto& k) { k.out_precision = 4; }));
+    WPP_CHECK(differs([](auto& k) { k.clip_precision = 2; }));
+    WPP_CHECK(differs([](auto& k) { k.quality = 0; }));
+    WPP_CHECK(differs([](auto& k) { k.pitch_and_family = 1; }));
+    WPP_CHECK(differs([](auto& k) { k.dpi = 144; }));
+    WPP_CHECK(differs([](auto& k) { k.units_dpi = 144; }));
+    WPP_CHECK(differs([](auto& k) { k.face = "Consolas"; }));
+
+    // Two fonts that differ only in width get separate entries
+    int created = 0;
+    resource_cache<basic_font_key<char>, int> fonts([&](const basic_font_key<char>&) { return ++created; }, nullptr);
+    basic_font_key<char> narrow = base;
+    narrow.width = 5;
+    auto regular = fonts.acquire(base);
+    auto condensed = fonts.acquire(narrow);
+    WPP_CHECK(regular.get() != condensed.get() && created == 2);
+}
+
+int main() { return wpp::test::run_tests(); }
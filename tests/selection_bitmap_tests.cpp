@@ -0,0 +1,119 @@
+#include "check.hpp"
+#include "model/selection_bitmap.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+using namespace wpp::model;
+
+namespace
+{
+    std::vector<std::size_t> selected(const selection_bitmap& bits) {
+        std::vector<std::size_t> items;
+        bits.for_each([&](std::size_t item) { items.push_back(item); });
+        return items;
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> runs(const selection_bitmap& bits) {
+        std::vector<std::pair<std::size_t, std::size_t>> result;
+        bits.for_each_run([&](std::size_t first, std::size_t last) { result.emplace_back(first, last); });
+        return result;
+    }
+}
+
+WPP_TEST(set_and_test_keep_the_count) {
+    selection_bitmap bits(200);
+    WPP_CHECK(bits.size() == 200 && bits.count() == 0 && !bits.any());
+    bits.set(3);
+    bits.set(3);
+    bits.set(64);
+    bits.set(199);
+    bits.set(200);
+    WPP_CHECK(bits.count() == 3 && bits.any());
+    WPP_CHECK(bits.test(3) && bits.test(64) && bits.test(199));
+    WPP_CHECK(!bits.test(4) && !bits.test(200));
+    bits.set(64, false);
+    bits.set(64, false);
+    WPP_CHECK(bits.count() == 2 && !bits.test(64));
+    bits.clear();
+    WPP_CHECK(bits.count() == 0 && bits.first() == selection_bitmap::npos);
+}
+
+WPP_TEST(set_range_crosses_words_and_clamps) {
+    selection_bitmap bits(300);
+    bits.set_range(60, 130);
+    WPP_CHECK(bits.count() == 71);
+    WPP_CHECK(!bits.test(59) && bits.test(60) && bits.test(130) && !bits.test(131));
+
+    // Overlapping selections count each item once; deselecting counts only what was set
+    bits.set_range(100, 140);
+    WPP_CHECK(bits.count() == 81);
+    bits.set_range(0, 99, false);
+    WPP_CHECK(bits.count() == 41 && bits.first() == 100);
+
+    bits.set_range(250, 1000);
+    WPP_CHECK(bits.count() == 91 && bits.test(299));
+    bits.set_range(5, 4);
+    bits.set_range(300, 400);
+    WPP_CHECK(bits.count() == 91);
+}
+
+WPP_TEST(find_next_and_runs) {
+    selection_bitmap bits(1000);
+    bits.set_range(10, 12);
+    bits.set(63);
+    bits.set(64);
+    bits.set_range(500, 999);
+    WPP_CHECK(bits.first() == 10);
+    WPP_CHECK(bits.find_next(13) == 63);
+    WPP_CHECK(bits.find_next(65) == 500);
+    WPP_CHECK(bits.find_next(1000) == selection_bitmap::npos);
+    WPP_CHECK((runs(bits) == std::vector<std::pair<std::size_t, std::size_t>>{ { 10, 12 }, { 63, 64 }, { 500, 999 } }));
+    WPP_CHECK(selected(bits).size() == bits.count());
+}
+
+WPP_TEST(invert_stays_within_size) {
+    selection_bitmap bits(70);
+    bits.set_range(0, 9);
+    WPP_CHECK(bits.invert() == 60);
+    WPP_CHECK(!bits.test(9) && bits.test(10) && bits.test(69));
+    WPP_CHECK(selected(bits).back() == 69);
+
+    // Growing after an invert must not expose bits past the old end
+    bits.resize(128);
+    WPP_CHECK(bits.count() == 60 && !bits.test(70) && bits.find_next(70) == selection_bitmap::npos);
+}
+
+WPP_TEST(resize_drops_items_past_the_end) {
+    selection_bitmap bits(100);
+    bits.set_range(40, 99);
+    bits.resize(50);
+    WPP_CHECK(bits.size() == 50 && bits.count() == 10);
+    bits.resize(100);
+    WPP_CHECK(bits.count() == 10 && !bits.test(50) && !bits.test(99));
+    bits.resize(0);
+    WPP_CHECK(bits.count() == 0 && bits.first() == selection_bitmap::npos);
+}
+
+WPP_TEST(insert_and_erase_shift_the_selection) {
+    selection_bitmap bits(10);
+    bits.set(2);
+    bits.set(5);
+    bits.set(9);
+    bits.insert(5, 3);
+    WPP_CHECK(bits.size() == 13);
+    WPP_CHECK((selected(bits) == std::vector<std::size_t>{ 2, 8, 12 }));
+
+    bits.erase(1, 2);
+    WPP_CHECK(bits.size() == 11);
+    WPP_CHECK((selected(bits) == std::vector<std::size_t>{ 6, 10 }));
+
+    // Erasing past the end is clamped, inserting at the end adds deselected items
+    bits.erase(9, 50);
+    WPP_CHECK(bits.size() == 9 && (selected(bits) == std::vector<std::size_t>{ 6 }));
+    bits.insert(100, 2);
+    WPP_CHECK(bits.size() == 11 && bits.count() == 1);
+}
+
+int main() { return wpp::test::run_tests(); }
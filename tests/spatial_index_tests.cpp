@@ -0,0 +1,110 @@
+#include "check.hpp"
+#include "layout/spatial_index.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace wpp::layout;
+
+namespace
+{
+    bool contains_point(const rect_t& r, int x, int y) {
+        return x >= r.x && y >= r.y && x < r.x + r.width && y < r.y + r.height;
+    }
+
+    bool intersects(const rect_t& a, const rect_t& b) {
+        return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    std::vector<int> sorted(std::vector<int> ids) {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+}
+
+WPP_TEST(point_and_rect_queries_find_inserted_elements) {
+    spatial_grid grid(64);
+    grid.insert(0, { 0, 0, 50, 50 });
+    grid.insert(1, { 100, 100, 30, 30 });
+    grid.insert(2, { 40, 40, 100, 20 });
+
+    std::vector<int> hits;
+    grid.query_point(45, 45, hits);
+    WPP_CHECK(sorted(hits) == (std::vector<int>{ 0, 2 }));
+
+    hits.clear();
+    grid.query_rect({ 90, 90, 20, 20 }, hits);
+    WPP_CHECK(sorted(hits) == (std::vector<int>{ 1 }));
+    WPP_CHECK(grid.size() == 3);
+}
+
+WPP_TEST(move_and_remove_update_queries) {
+    spatial_grid grid(64);
+    grid.insert(0, { 0, 0, 10, 10 });
+    grid.update(0, { 500, 500, 10, 10 });
+
+    std::vector<int> hits;
+    grid.query_point(5, 5, hits);
+    WPP_CHECK(hits.empty());
+    grid.query_point(505, 505, hits);
+    WPP_CHECK(hits == (std::vector<int>{ 0 }));
+
+    grid.remove(0);
+    hits.clear();
+    grid.query_point(505, 505, hits);
+    WPP_CHECK(hits.empty());
+    WPP_CHECK(!grid.contains(0));
+    WPP_CHECK(grid.size() == 0);
+}
+
+WPP_TEST(large_elements_are_reported_once) {
+    spatial_grid grid(16);
+    grid.insert(7, { 0, 0, 4000, 4000 });
+    std::vector<int> hits;
+    grid.query_rect({ 100, 100, 500, 500 }, hits);
+    WPP_CHECK(hits == (std::vector<int>{ 7 }));
+}
+
+WPP_TEST(random_moves_match_linear_scan) {
+    std::mt19937 random(5);
+    std::uniform_int_distribution<int> position(-200, 3000), extent(1, 400);
+    spatial_grid grid(128);
+    std::vector<rect_t> bounds(500);
+    std::vector<bool> live(bounds.size(), false);
+
+    for (int step = 0; step < 5000; ++step) {
+        int id = static_cast<int>(random() % bounds.size());
+        if (random() % 10 == 0) {
+            grid.remove(id);
+            live[id] = false;
+        } else {
+            bounds[id] = { position(random), position(random), extent(random), extent(random) };
+            grid.update(id, bounds[id]);
+            live[id] = true;
+        }
+
+        if (step % 50 != 0)
+            continue;
+        rect_t area{ position(random), position(random), extent(random), extent(random) };
+        std::vector<int> hits, expected;
+        grid.query_rect(area, hits);
+        for (int i = 0; i < static_cast<int>(bounds.size()); ++i) {
+            if (live[i] && intersects(bounds[i], area))
+                expected.push_back(i);
+        }
+        WPP_CHECK(sorted(hits) == expected);
+
+        int x = position(random), y = position(random);
+        hits.clear();
+        expected.clear();
+        grid.query_point(x, y, hits);
+        for (int i = 0; i < static_cast<int>(bounds.size()); ++i) {
+            if (live[i] && contains_point(bounds[i], x, y))
+                expected.push_back(i);
+        }
+        WPP_CHECK(sorted(hits) == expected);
+    }
+}
+
+int main() { return wpp::test::run_tests(); }
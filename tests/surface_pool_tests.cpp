@@ -0,0 +1,121 @@
+#include "check.hpp"
+#include "graphics/surface_pool.hpp"
+
+#include <vector>
+
+using namespace wpp::graphics;
+
+namespace
+{
+    // Surfaces are numbered in creation order; 0 plays the null handle
+    struct fake_surfaces {
+        int created = 0;
+        std::vector<int> released;
+
+        surface_pool<int> pool(surface_pool<int>::options opts = {}) {
+            return surface_pool<int>([this](int, int) { return ++created; }, [this](int surface) { released.push_back(surface); }, opts);
+        }
+    };
+}
+
+WPP_TEST(requests_round_up_to_64_pixel_buckets) {
+    fake_surfaces surfaces;
+    auto pool = surfaces.pool();
+    WPP_CHECK(pool.bucket(1) == 64 && pool.bucket(64) == 64 && pool.bucket(65) == 128);
+
+    auto lease = pool.acquire(100, 30);
+    WPP_CHECK(lease && lease.width == 128 && lease.height == 64);
+    WPP_CHECK(pool.get_statistics().live_bytes == 128 * 64 * 4);
+    WPP_CHECK(!pool.acquire(0, 10) && !pool.acquire(10, -1));
+    WPP_CHECK(surfaces.created == 1);
+    pool.release(lease);
+}
+
+WPP_TEST(released_surface_is_reused_within_its_bucket) {
+    fake_surfaces surfaces;
+    auto pool = surfaces.pool();
+    auto first = pool.acquire(100, 100);
+    pool.release(first);
+    WPP_CHECK(pool.free_count() == 1 && pool.get_statistics().free_bytes == 128 * 128 * 4);
+
+    // A window a few pixels larger lands in the same bucket
+    auto second = pool.acquire(110, 120);
+    WPP_CHECK(second.surface == first.surface);
+    WPP_CHECK(pool.get_statistics().hits == 1 && pool.get_statistics().misses == 1);
+    WPP_CHECK(pool.free_count() == 0 && pool.get_statistics().free_bytes == 0);
+    pool.release(second);
+}
+
+WPP_TEST(best_fit_takes_the_smallest_large_enough_surface) {
+    fake_surfaces surfaces;
+    auto pool = surfaces.pool();
+    auto large = pool.acquire(256, 256);
+    auto small = pool.acquire(128, 128);
+    auto narrow = pool.acquire(64, 256);
+    pool.release(large);
+    pool.release(small);
+    pool.release(narrow);
+
+    auto lease = pool.acquire(100, 100);
+    WPP_CHECK(lease.surface == small.surface && lease.width == 128 && lease.height == 128);
+    pool.release(lease);
+}
+
+WPP_TEST(surface_wasting_more_than_four_times_is_not_reused) {
+    fake_surfaces surfaces;
+    auto pool = surfaces.pool();
+    auto large = pool.acquire(256, 256);
+    pool.release(large);
+
+    // 64x64 would use a sixteenth of it: a new surface is made instead
+    auto tiny = pool.acquire(64, 64);
+    WPP_CHECK(tiny.surface != large.surface && surfaces.created == 2);
+    pool.release(tiny);
+
+    // 128x128 is exactly a quarter: still reused
+    auto quarter = pool.acquire(128, 128);
+    WPP_CHECK(quarter.surface == large.surface && quarter.width == 256);
+    pool.release(quarter);
+}
+
+WPP_TEST(free_surfaces_are_trimmed_to_32_mb_oldest_first) {
+    fake_surfaces surfaces;
+    auto pool = surfaces.pool();
+    WPP_CHECK(pool.get_options().max_free_bytes == 32u << 20);
+
+    // Five 8 MB surfaces leased at once, then returned in order
+    std::vector<surface_pool<int>::lease> leases;
+    for (int i = 0; i < 5; ++i)
+        leases.push_back(pool.acquire(2048, 1024));
+    for (const auto& lease : leases)
+        pool.release(lease);
+
+    WPP_CHECK(pool.free_count() == 4);
+    WPP_CHECK(pool.get_statistics().free_bytes == 32u << 20);
+    WPP_CHECK(pool.get_statistics().live_bytes == 32u << 20);
+    WPP_CHECK(pool.get_statistics().evictions == 1);
+    WPP_CHECK(surfaces.released.size() == 1);
+
+    pool.clear();
+    WPP_CHECK(pool.free_count() == 0 && pool.get_statistics().live_bytes == 0 && surfaces.released.size() == 5);
+}
+
+WPP_TEST(idle_surfaces_are_evicted_after_the_timeout) {
+    fake_surfaces surfaces;
+    auto pool = surfaces.pool();
+    auto idle = pool.acquire(1024, 1024);
+    pool.release(idle);
+
+    // Small frames keep the pool busy; the large surface is too wasteful for them and sits unused
+    std::uint64_t timeout = pool.get_options().max_idle_acquires;
+    for (std::uint64_t i = 0; i < timeout; ++i)
+        pool.release(pool.acquire(64, 64));
+    WPP_CHECK(pool.free_count() == 2 && surfaces.released.empty());
+
+    pool.release(pool.acquire(64, 64));
+    WPP_CHECK(pool.free_count() == 1);
+    WPP_CHECK(surfaces.released.size() == 1 && surfaces.released[0] == idle.surface);
+    WPP_CHECK(pool.get_statistics().hits == timeout && pool.get_statistics().misses == 2);
+}
+
+int main() { return wpp::test::run_tests(); }
@@ -0,0 +1,110 @@
+#include "check.hpp"
+#include "graphics/text_extent_cache.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wpp::graphics;
+
+namespace
+{
+    using cache_type = basic_text_extent_cache<char>;
+
+    // Width is 10 per character, height the DPI divided by 4; every call and string is recorded
+    struct stub_measurer {
+        std::vector<std::vector<std::string>> batches;
+
+        cache_type::measurer bind() {
+            return [this](cache_type::font_id font, unsigned int dpi, const std::vector<std::string_view>& texts,
+                          std::vector<text_extent>& extents) {
+                batches.emplace_back(texts.begin(), texts.end());
+                for (std::size_t i = 0; i < texts.size(); ++i)
+                    extents[i] = { static_cast<int>(texts[i].size() * 10 + font), static_cast<int>(dpi / 4) };
+            };
+        }
+    };
+}
+
+WPP_TEST(second_measure_is_a_hit) {
+    stub_measurer stub;
+    cache_type cache(stub.bind());
+    WPP_CHECK(cache.measure(0, 96, "hello") == (text_extent{ 50, 24 }));
+    WPP_CHECK(cache.measure(0, 96, "hello") == (text_extent{ 50, 24 }));
+    WPP_CHECK(stub.batches.size() == 1);
+
+    auto stats = cache.get_statistics();
+    WPP_CHECK(stats.hits == 1);
+    WPP_CHECK(stats.misses == 1);
+    WPP_CHECK(stats.entries == 1);
+}
+
+WPP_TEST(font_and_dpi_are_part_of_the_key) {
+    stub_measurer stub;
+    cache_type cache(stub.bind());
+    WPP_CHECK(cache.measure(0, 96, "abc") == (text_extent{ 30, 24 }));
+    WPP_CHECK(cache.measure(1, 96, "abc") == (text_extent{ 31, 24 }));
+    WPP_CHECK(cache.measure(0, 144, "abc") == (text_extent{ 30, 36 }));
+    WPP_CHECK(stub.batches.size() == 3);
+}
+
+WPP_TEST(batch_sends_only_misses_in_one_call) {
+    stub_measurer stub;
+    cache_type cache(stub.bind());
+    cache.measure(0, 96, "cached");
+
+    std::vector<std::string_view> texts{ "a", "cached", "bb", "a" };
+    std::vector<text_extent> extents;
+    cache.measure(0, 96, texts, extents);
+    WPP_CHECK(stub.batches.size() == 2);
+    WPP_CHECK(stub.batches[1] == (std::vector<std::string>{ "a", "bb", "a" }));
+    WPP_CHECK(extents.size() == 4);
+    WPP_CHECK(extents[0] == (text_extent{ 10, 24 }));
+    WPP_CHECK(extents[1] == (text_extent{ 60, 24 }));
+    WPP_CHECK(extents[3] == (text_extent{ 10, 24 }));
+
+    // A string repeated in a batch is stored once
+    WPP_CHECK(cache.get_statistics().entries == 3);
+}
+
+WPP_TEST(least_recently_used_entry_is_evicted) {
+    stub_measurer stub;
+    cache_type cache(stub.bind(), 2);
+    cache.measure(0, 96, "a");
+    cache.measure(0, 96, "b");
+    cache.measure(0, 96, "a");
+    cache.measure(0, 96, "c");     // evicts b
+    WPP_CHECK(cache.get_statistics().evictions == 1);
+
+    std::size_t before = stub.batches.size();
+    cache.measure(0, 96, "a");
+    WPP_CHECK(stub.batches.size() == before);
+    cache.measure(0, 96, "b");
+    WPP_CHECK(stub.batches.size() == before + 1);
+}
+
+WPP_TEST(forget_font_and_set_capacity_drop_entries) {
+    stub_measurer stub;
+    cache_type cache(stub.bind());
+    cache.measure(1, 96, "x");
+    cache.measure(2, 96, "x");
+    cache.measure(2, 96, "y");
+    cache.forget_font(2);
+    WPP_CHECK(cache.get_statistics().entries == 1);
+
+    cache.measure(3, 96, "x");
+    cache.measure(3, 96, "y");
+    cache.set_capacity(1);
+    WPP_CHECK(cache.get_statistics().entries == 1);
+    cache.clear();
+    WPP_CHECK(cache.get_statistics().entries == 0);
+}
+
+WPP_TEST(max_width_is_widest_string) {
+    stub_measurer stub;
+    cache_type cache(stub.bind());
+    WPP_CHECK(cache.max_width(0, 96, { "ab", "abcd", "a" }) == 40);
+    WPP_CHECK(cache.max_width(0, 96, {}) == 0);
+}
+
+int main() { return wpp::test::run_tests(); }
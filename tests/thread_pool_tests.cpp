@@ -0,0 +1,165 @@
+#include "check.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using wpp::task_group;
+using wpp::thread_pool;
+
+namespace
+{
+    // Spin until the pool has handed out every task (pending_count() reaches zero) or a deadline passes
+    bool drain(thread_pool& pool) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (pool.pending_count() != 0) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+}
+
+WPP_TEST(runs_every_submitted_task) {
+    thread_pool pool(4);
+    std::atomic<int> done = 0;
+    const int count = 20000;
+    for (int i = 0; i < count; ++i)
+        pool.submit([&] { done.fetch_add(1, std::memory_order_relaxed); });
+    WPP_CHECK(drain(pool));
+    while (done.load() != count)
+        std::this_thread::yield();
+    WPP_CHECK(done.load() == count);
+}
+
+WPP_TEST(pending_count_never_underflows_under_concurrent_submit) {
+    // Several outside threads submit while workers drain; a task counted after it was published would let
+    // a worker decrement first, which shows up as a wrapped (huge) pending count
+    thread_pool pool(4);
+    std::atomic<bool> wrapped = false;
+    std::atomic<int> done = 0;
+    std::atomic<bool> stop = false;
+    std::thread watcher([&] {
+        while (!stop.load()) {
+            if (pool.pending_count() > 1000000)
+                wrapped = true;
+        }
+    });
+
+    const int producers = 4, per_producer = 20000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < per_producer; ++i)
+                pool.submit([&] { done.fetch_add(1, std::memory_order_relaxed); });
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    WPP_CHECK(drain(pool));
+    while (done.load() != producers * per_producer)
+        std::this_thread::yield();
+    stop = true;
+    watcher.join();
+
+    WPP_CHECK(!wrapped.load());
+    WPP_CHECK(pool.pending_count() == 0);
+}
+
+WPP_TEST(tasks_submitted_from_workers_run) {
+    thread_pool pool(3);
+    std::atomic<int> done = 0;
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&] {
+            for (int j = 0; j < 100; ++j)
+                pool.submit([&] { done.fetch_add(1, std::memory_order_relaxed); });
+        });
+    }
+    while (done.load() != 10000)
+        std::this_thread::yield();
+    WPP_CHECK(drain(pool));
+}
+
+namespace
+{
+    long long fork_join_sum(thread_pool* pool, int first, int last) {
+        if (last - first <= 64) {
+            long long sum = 0;
+            for (int i = first; i < last; ++i)
+                sum += i;
+            return sum;
+        }
+        int middle = first + (last - first) / 2;
+        long long left = 0, right = 0;
+        {
+            task_group group(pool);
+            group.run([&] { left = fork_join_sum(pool, first, middle); });
+            right = fork_join_sum(pool, middle, last);
+        }
+        return left + right;
+    }
+}
+
+WPP_TEST(nested_task_groups_do_not_deadlock) {
+    for (unsigned threads : { 1u, 2u, 4u }) {
+        thread_pool pool(threads);
+        const int n = 200000;
+        WPP_CHECK(fork_join_sum(&pool, 0, n) == static_cast<long long>(n) * (n - 1) / 2);
+        WPP_CHECK(drain(pool));
+    }
+}
+
+WPP_TEST(null_pool_runs_inline) {
+    int value = 0;
+    {
+        task_group group(nullptr);
+        group.run([&] { value = 42; });
+        WPP_CHECK(value == 42);
+    }
+    WPP_CHECK(fork_join_sum(nullptr, 0, 1000) == 499500);
+}
+
+WPP_TEST(destructor_runs_queued_tasks) {
+    std::atomic<int> done = 0;
+    {
+        thread_pool pool(2);
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&] { done.fetch_add(1, std::memory_order_relaxed); });
+    }
+    WPP_CHECK(done.load() == 1000);
+}
+
+WPP_TEST(throwing_task_does_not_hang_wait) {
+    thread_pool pool(2);
+    std::atomic<int> done = 0;
+    bool caught = false;
+    {
+        task_group group(&pool);
+        for (int i = 0; i < 100; ++i) {
+            group.run([&, i] {
+                if (i % 10 == 3)
+                    throw std::runtime_error("task failed");
+                done.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        try {
+            group.wait();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        WPP_CHECK(done.load() == 90);
+
+        // The error is reported once; the group stays usable and its destructor does not throw
+        group.run([&] { throw std::logic_error("left for the destructor"); });
+    }
+    WPP_CHECK(caught);
+    WPP_CHECK(drain(pool));
+}
+
+int main() {
+    return wpp::test::run_tests();
+}
@@ -0,0 +1,148 @@
+#include "check.hpp"
+#include "model/tree_diff.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace wpp::model;
+
+namespace
+{
+    using snapshot = basic_tree_snapshot<char>;
+    using node_id = snapshot::node_id;
+
+    // Two top-level folders with three files each, and an empty third folder
+    snapshot sample() {
+        snapshot tree;
+        for (std::uint64_t folder = 1; folder <= 2; ++folder) {
+            node_id parent = tree.add(snapshot::root, folder, "folder " + std::to_string(folder), folder);
+            for (std::uint64_t file = 1; file <= 3; ++file)
+                tree.add(parent, folder * 10 + file, "file " + std::to_string(folder * 10 + file));
+        }
+        tree.add(snapshot::root, 3, "empty");
+        return tree;
+    }
+
+    // Node under the root, then under that node, by key
+    node_id find(const snapshot& tree, std::uint64_t top, std::uint64_t child = 0) {
+        node_id node = tree.first_child(snapshot::root);
+        while (node != snapshot::npos && tree.key(node) != top)
+            node = tree.next_sibling(node);
+        if (child == 0 || node == snapshot::npos)
+            return node;
+        for (node_id c = tree.first_child(node); c != snapshot::npos; c = tree.next_sibling(c))
+            if (tree.key(c) == child)
+                return c;
+        return snapshot::npos;
+    }
+
+    auto everything = [](node_id) { return true; };
+}
+
+WPP_TEST(snapshot_links_children_in_order) {
+    snapshot tree = sample();
+    WPP_CHECK(tree.size() == 10);
+    std::vector<node_id> top;
+    tree.children(snapshot::root, top);
+    WPP_CHECK(top.size() == 3);
+    WPP_CHECK(tree.text(top[0]) == "folder 1" && tree.data(top[0]) == 1);
+    WPP_CHECK(tree.has_children(top[0]) && !tree.has_children(top[2]));
+
+    std::vector<node_id> files;
+    tree.children(top[1], files);
+    WPP_CHECK(files.size() == 3 && tree.key(files[2]) == 23 && tree.parent(files[2]) == top[1]);
+
+    tree.clear();
+    WPP_CHECK(tree.size() == 1 && !tree.has_children(snapshot::root));
+}
+
+WPP_TEST(subtree_hashes_follow_content_and_structure) {
+    snapshot a = sample(), b = sample();
+    WPP_CHECK(a.subtree_hashes() == b.subtree_hashes());
+
+    snapshot other;
+    other.add(snapshot::root, 1, "folder 1", 1);
+    WPP_CHECK(other.subtree_hashes()[0] != a.subtree_hashes()[0]);
+
+    // A node's own hash tells whether it has children, which a tree item shows as a button
+    snapshot leaf, parent;
+    node_id x = leaf.add(snapshot::root, 1, "x");
+    node_id y = parent.add(snapshot::root, 1, "x");
+    parent.add(y, 2, "child");
+    WPP_CHECK(leaf.node_hash(x) != parent.node_hash(y));
+}
+
+WPP_TEST(identical_trees_map_without_comparing) {
+    snapshot old = sample(), next = sample();
+    auto diff = diff_trees(old, next, everything);
+    WPP_CHECK(diff.empty());
+    WPP_CHECK(diff.compared == 0);
+    WPP_CHECK(diff.mapped == 9);
+    for (node_id n = 0; n < next.size(); ++n)
+        WPP_CHECK(diff.old_of[n] == n);
+}
+
+WPP_TEST(a_deep_rename_reports_only_its_level) {
+    snapshot old = sample();
+    snapshot next;
+    for (std::uint64_t folder = 1; folder <= 2; ++folder) {
+        node_id parent = next.add(snapshot::root, folder, "folder " + std::to_string(folder), folder);
+        for (std::uint64_t file = 1; file <= 3; ++file)
+            next.add(parent, folder * 10 + file, file == 2 && folder == 2 ? "renamed" : "file " + std::to_string(folder * 10 + file));
+    }
+    next.add(snapshot::root, 3, "empty");
+
+    auto diff = diff_trees(old, next, everything);
+    WPP_CHECK(diff.levels.size() == 1);
+    const auto& level = diff.levels[0];
+    WPP_CHECK(level.old_parent == find(old, 2) && level.new_parent == find(next, 2));
+    WPP_CHECK((level.children.updated == std::vector<std::size_t>{ 1 }));
+    WPP_CHECK(level.children.inserted.empty() && level.children.removed.empty());
+
+    // Folder 1 was identical and mapped wholesale; the root and folder 2 were compared
+    WPP_CHECK(diff.old_of[find(next, 1, 12)] == find(old, 1, 12));
+    WPP_CHECK(diff.old_of[find(next, 2, 22)] == find(old, 2, 22));
+    WPP_CHECK(diff.compared == 3 + 3);
+}
+
+WPP_TEST(unshown_subtrees_are_not_visited) {
+    snapshot old = sample();
+    snapshot next = sample();
+    next.add(find(next, 1), 14, "file 14");      // changes under folder 1
+
+    node_id folder1 = find(old, 1);
+    auto collapsed = [folder1](node_id node) { return node != folder1; };
+    auto diff = diff_trees(old, next, collapsed);
+    WPP_CHECK(diff.empty());
+    WPP_CHECK(diff.old_of[find(next, 1)] == folder1);
+    WPP_CHECK(diff.old_of[find(next, 1, 14)] == tree_diff::npos);
+
+    auto expanded = diff_trees(old, next, everything);
+    WPP_CHECK(expanded.levels.size() == 1);
+    WPP_CHECK((expanded.levels[0].children.inserted == std::vector<std::size_t>{ 3 }));
+}
+
+WPP_TEST(moved_nodes_are_reinserted_and_matched_by_key) {
+    snapshot old = sample();
+    snapshot next;
+    next.add(snapshot::root, 3, "empty");
+    for (std::uint64_t folder = 1; folder <= 2; ++folder) {
+        node_id parent = next.add(snapshot::root, folder, "folder " + std::to_string(folder), folder);
+        for (std::uint64_t file = 3; file >= 1; --file)
+            next.add(parent, folder * 10 + file, "file " + std::to_string(folder * 10 + file));
+    }
+
+    auto diff = diff_trees(old, next, everything);
+    WPP_CHECK(!diff.empty());
+    const auto& top = diff.levels.front();
+    WPP_CHECK(top.old_parent == snapshot::root);
+    WPP_CHECK(top.children.moved == 1);
+    WPP_CHECK(diff.old_of[find(next, 3)] == tree_diff::npos);     // re-inserted, so not kept in place
+
+    // The caller rebuilds moved nodes, carrying state over from the old children by key
+    auto matched = match_children(old, find(old, 2), next, find(next, 2));
+    WPP_CHECK(matched.size() == 3);
+    WPP_CHECK(matched[0] == find(old, 2, 23) && matched[2] == find(old, 2, 21));
+}
+
+int main() { return wpp::test::run_tests(); }
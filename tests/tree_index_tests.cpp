@@ -0,0 +1,138 @@
+#include "check.hpp"
+#include "model/tree_index.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace wpp::model;
+
+namespace
+{
+    // Handles are plain numbers here; 0 plays NULL as it does for HTREEITEM
+    using tree_index = basic_tree_index<std::uint32_t>;
+
+    // 1 { 11, 12, 13 }, 2 { 21 { 211 } }, 3; data is the handle times ten
+    tree_index sample() {
+        tree_index index;
+        for (std::uint32_t top : { 1u, 2u, 3u })
+            index.insert_last(top, 0, top * 10);
+        for (std::uint32_t child : { 11u, 12u, 13u })
+            index.insert_last(child, 1, child * 10);
+        index.insert_last(21, 2, 210);
+        index.insert_last(211, 21, 2110);
+        return index;
+    }
+
+    std::vector<std::uint32_t> visit(const tree_index& index, std::uint32_t first = 0) {
+        std::vector<std::uint32_t> items;
+        index.for_each(first, [&](std::uint32_t item) { items.push_back(item); });
+        return items;
+    }
+}
+
+WPP_TEST(insert_links_navigation) {
+    tree_index index = sample();
+    WPP_CHECK(index.size() == 8);
+    WPP_CHECK(index.first_child(0) == 1 && index.last_child(0) == 3);
+    WPP_CHECK(index.first_child(1) == 11 && index.last_child(1) == 13);
+    WPP_CHECK(index.next_sibling(11) == 12 && index.prev_sibling(12) == 11);
+    WPP_CHECK(index.prev_sibling(11) == 0 && index.next_sibling(13) == 0);
+    WPP_CHECK(index.parent(211) == 21 && index.parent(1) == 0);
+    WPP_CHECK(index.depth(211) == 2 && index.depth(3) == 0);
+    WPP_CHECK(index.is_ancestor(2, 211) && !index.is_ancestor(1, 211));
+
+    // Inserted after a sibling, first, and rejected when unknown or duplicated
+    WPP_CHECK(index.insert(14, 1, 11));
+    WPP_CHECK(index.next_sibling(11) == 14 && index.next_sibling(14) == 12);
+    WPP_CHECK(index.insert(10, 1, 0));
+    WPP_CHECK(index.first_child(1) == 10);
+    WPP_CHECK(!index.insert(11, 1, 0));
+    WPP_CHECK(!index.insert(99, 42, 0));
+    WPP_CHECK(!index.insert(99, 1, 21));
+    WPP_CHECK(index.size() == 10);
+}
+
+WPP_TEST(for_each_visits_in_display_order) {
+    tree_index index = sample();
+    WPP_CHECK((visit(index) == std::vector<std::uint32_t>{ 1, 11, 12, 13, 2, 21, 211, 3 }));
+    WPP_CHECK((visit(index, 12) == std::vector<std::uint32_t>{ 12, 13 }));
+    WPP_CHECK((visit(index, 2) == std::vector<std::uint32_t>{ 2, 21, 211, 3 }));
+    WPP_CHECK(index.count(0) == 8 && index.count(21) == 2);
+
+    std::size_t seen = 0;
+    index.for_each(0, [&](std::uint32_t) { return ++seen < 3; });
+    WPP_CHECK(seen == 3);
+}
+
+WPP_TEST(erase_removes_subtree_and_reuses_slots) {
+    tree_index index = sample();
+    index.set_expanded(21, true);
+    index.set_checked(211, true);
+    WPP_CHECK(index.erase(2) == 3);
+    WPP_CHECK(index.size() == 5);
+    WPP_CHECK(!index.contains(21) && !index.contains(211));
+    WPP_CHECK(index.next_sibling(1) == 3 && index.prev_sibling(3) == 1);
+    WPP_CHECK(index.expanded_count() == 0 && index.checked_count() == 0);
+    WPP_CHECK(index.find_by_data(2110) == 0);
+    WPP_CHECK(index.erase(2) == 0);
+
+    WPP_CHECK(index.insert_last(4, 0, 40));
+    WPP_CHECK(index.last_child(0) == 4 && index.find_by_data(40) == 4);
+
+    index.clear();
+    WPP_CHECK(index.size() == 0 && index.first_child(0) == 0);
+}
+
+WPP_TEST(find_by_data_respects_insert_order_and_scope) {
+    tree_index index = sample();
+    WPP_CHECK(index.find_by_data(120) == 12);
+    WPP_CHECK(index.find_by_data(7) == 0);
+
+    // Several items share a value: the earliest inserted wins, within the scope when given
+    index.set_data(13, 5);
+    index.set_data(211, 5);
+    index.set_data(3, 5);
+    WPP_CHECK(index.find_by_data(5) == 13);
+    WPP_CHECK(index.find_by_data(5, 2) == 211);
+    WPP_CHECK(index.find_by_data(5, 21) == 211);
+    WPP_CHECK(index.find_by_data(5, 3) == 3);
+    WPP_CHECK(index.find_by_data(5, 11) == 13);
+    WPP_CHECK(index.find_by_data(5, 12) == 13);
+
+    index.erase(13);
+    WPP_CHECK(index.find_by_data(5) == 211);
+    WPP_CHECK(index.data(211) == 5 && index.data(13) == 0);
+}
+
+WPP_TEST(expanded_and_checked_sets) {
+    tree_index index = sample();
+    index.set_expanded(1, true);
+    index.set_expanded(1, true);
+    index.set_expanded(2, true);
+    WPP_CHECK(index.expanded_count() == 2 && index.is_expanded(2));
+    index.set_expanded(2, false);
+    WPP_CHECK(index.expanded_count() == 1 && !index.is_expanded(2));
+
+    for (std::uint32_t item : { 11u, 12u, 13u })
+        index.set_checked(item, true);
+    index.set_checked(12, false);
+    std::vector<std::uint32_t> checked;
+    index.for_each_checked([&](std::uint32_t item) { checked.push_back(item); });
+    WPP_CHECK((checked == std::vector<std::uint32_t>{ 13, 11 }));
+    WPP_CHECK(index.checked_count() == 2 && index.is_checked(11) && !index.is_checked(12));
+
+    WPP_CHECK(index.insert_last(4, 0, 40, true, true));
+    WPP_CHECK(index.expanded_count() == 2 && index.checked_count() == 3);
+}
+
+WPP_TEST(reorder_children_relinks_siblings) {
+    tree_index index = sample();
+    WPP_CHECK(index.reorder_children(1, { 13, 11, 12 }));
+    WPP_CHECK((visit(index, 1) == std::vector<std::uint32_t>{ 1, 13, 11, 12, 2, 21, 211, 3 }));
+    WPP_CHECK(index.prev_sibling(13) == 0 && index.last_child(1) == 12);
+    WPP_CHECK(index.reorder_children(0, { 3, 2, 1 }));
+    WPP_CHECK(index.first_child(0) == 3 && index.next_sibling(1) == 0);
+    WPP_CHECK(!index.reorder_children(1, { 13, 21 }));
+}
+
+int main() { return wpp::test::run_tests(); }
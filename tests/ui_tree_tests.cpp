@@ -0,0 +1,106 @@
+#include "check.hpp"
+#include "layout/ui_tree.hpp"
+
+#include <memory>
+#include <string_view>
+#include <tuple>
+
+using namespace wpp::layout;
+
+namespace
+{
+    struct fake_control {};
+
+    struct settings_window {
+        std::shared_ptr<fake_control> m_name;
+        std::shared_ptr<fake_control> m_ok;
+        std::shared_ptr<fake_control> m_buttons;
+    };
+
+    constexpr auto buttons = ui::stack(orientation::horizontal,
+                                       ui::button("OK", 90, 28).bind(&settings_window::m_ok),
+                                       ui::button("Cancel", 90, 28))
+                                 .spacing(6)
+                                 .align(alignment::end)
+                                 .bind(&settings_window::m_buttons);
+
+    constexpr auto settings = ui::grid(ui::rows(ui::px(28), ui::star(), ui::auto_size()), ui::columns(ui::px(80), ui::star(2)),
+                                       ui::cell(0, 0, ui::static_text("Name", 80, 24)),
+                                       ui::cell(0, 1, ui::edit("").bind(&settings_window::m_name)).align(alignment::stretch, alignment::center),
+                                       ui::cell(1, 0, ui::list_view(), 1, 2),
+                                       ui::cell(2, 0, buttons, 1, 2))
+                                  .padding(8)
+                                  .spacing(6);
+
+    constexpr auto shell = ui::dock(ui::docked(dock_position::top, ui::progress(-1, 4)),
+                                    ui::docked(dock_position::fill, ui::canvas(ui::placed(10, 20, ui::link("Help"), 3))))
+                               .fill_last(false)
+                               .margin(1, 2, 3, 4);
+}
+
+WPP_TEST(element_counts_are_compile_time_constants) {
+    static_assert(ui::control_count<decltype(settings)> == 5);
+    static_assert(ui::panel_count<decltype(settings)> == 2);
+    static_assert(ui::control_count<decltype(shell)> == 2);
+    static_assert(ui::panel_count<decltype(shell)> == 2);
+    static_assert(std::tuple_size_v<decltype(settings.children)> == 4);
+    WPP_CHECK(ui::control_count<decltype(buttons)> == 2);
+}
+
+WPP_TEST(grid_keeps_its_definitions_and_cells) {
+    static_assert(settings.rows.size() == 3 && settings.columns.size() == 2);
+    WPP_CHECK(settings.rows[0].type == grid_length_type::pixel && settings.rows[0].value == 28.0);
+    WPP_CHECK(settings.rows[2].type == grid_length_type::auto_size);
+    WPP_CHECK(settings.columns[1].type == grid_length_type::star && settings.columns[1].value == 2.0);
+    WPP_CHECK(settings.options.has_padding && settings.options.padding.left == 8 && settings.options.padding.bottom == 8);
+    WPP_CHECK(settings.options.has_spacing && settings.options.spacing == 6);
+    WPP_CHECK(!settings.options.has_margin);
+
+    const auto& list = std::get<2>(settings.children);
+    WPP_CHECK(list.position.row == 1 && list.position.column == 0 && list.position.column_span == 2);
+    WPP_CHECK(!list.has_alignment);
+
+    const auto& name = std::get<1>(settings.children);
+    WPP_CHECK(name.has_alignment && name.cell_alignment.vertical == alignment::center);
+}
+
+WPP_TEST(controls_keep_their_text_and_size) {
+    const auto& label = std::get<0>(settings.children).child;
+    static_assert(std::remove_cvref_t<decltype(label)>::kind == control_kind::static_text);
+    WPP_CHECK(std::string_view(label.text) == "Name");
+    WPP_CHECK(label.width == 80 && label.height == 24);
+
+    const auto& list = std::get<2>(settings.children).child;
+    static_assert(std::remove_cvref_t<decltype(list)>::kind == control_kind::list_view);
+    WPP_CHECK(list.text == nullptr);
+    WPP_CHECK(list.width == -1 && list.height == -1);
+}
+
+WPP_TEST(bind_records_the_owner_member) {
+    const auto& name = std::get<1>(settings.children).child;
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(name.binding)>,
+                                 ui::member_binding<settings_window, std::shared_ptr<fake_control>>>);
+    WPP_CHECK(name.binding.member == &settings_window::m_name);
+
+    // Binding a panel keeps everything set on it before
+    WPP_CHECK(buttons.binding.member == &settings_window::m_buttons);
+    WPP_CHECK(buttons.direction == orientation::horizontal);
+    WPP_CHECK(buttons.has_alignment && buttons.align_children == alignment::end);
+    WPP_CHECK(buttons.options.has_spacing && buttons.options.spacing == 6);
+    WPP_CHECK(std::get<0>(buttons.children).binding.member == &settings_window::m_ok);
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(std::get<1>(buttons.children).binding)>, ui::no_binding>);
+}
+
+WPP_TEST(dock_and_canvas_children_keep_their_placement) {
+    WPP_CHECK(!shell.last_child_fill);
+    WPP_CHECK(shell.options.has_margin && shell.options.margin.left == 1 && shell.options.margin.bottom == 4);
+
+    const auto& top = std::get<0>(shell.children);
+    WPP_CHECK(top.side == dock_position::top && top.child.height == 4);
+
+    const auto& help = std::get<0>(std::get<1>(shell.children).child.children);
+    WPP_CHECK(help.x == 10 && help.y == 20 && help.z == 3);
+    WPP_CHECK(std::string_view(help.child.text) == "Help");
+}
+
+int main() { return wpp::test::run_tests(); }
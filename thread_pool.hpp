@@ -0,0 +1,243 @@
+#ifndef WPP_THREAD_POOL_HPP
+#define WPP_THREAD_POOL_HPP
+
+// Portable work-stealing pool used for background layout and data work.
+// Intentionally free of Win32 so it can be shared with the portable layout engine.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace wpp
+{
+	/// <summary>
+	/// A fixed-size thread pool with one task deque per worker. Workers pop their own deque LIFO and steal FIFO
+	/// from the others, which keeps fork/join recursion (e.g. nested layout subtrees) cache friendly.
+	/// </summary>
+	class thread_pool {
+	public:
+		using task = std::function<void()>;
+
+		/// <summary>
+		/// Creates the pool and starts its worker threads.
+		/// </summary>
+		/// <param name="thread_count">Number of workers. Zero selects the hardware concurrency.</param>
+		explicit thread_pool(unsigned thread_count = 0) {
+			if (thread_count == 0)
+				thread_count = (std::max)(1u, std::thread::hardware_concurrency());
+
+			m_queues.reserve(thread_count + 1);
+			for (unsigned i = 0; i < thread_count + 1; ++i) // last queue receives submissions from outside the pool
+				m_queues.emplace_back(std::make_unique<task_queue>());
+
+			m_threads.reserve(thread_count);
+			for (unsigned i = 0; i < thread_count; ++i)
+				m_threads.emplace_back([this, i] { worker_main(i); });
+		}
+
+		~thread_pool() {
+			{
+				std::scoped_lock lock(m_wake_mutex);
+				m_stopping = true;
+			}
+			m_wake.notify_all();
+			for (auto& thread : m_threads)
+				if (thread.joinable())
+					thread.join();
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		/// <summary>
+		/// Queues a task. Tasks submitted from a worker go to that worker's own deque.
+		/// </summary>
+		void submit(task fn) {
+			// Count the task before publishing it, so a worker that takes it at once never drives the count below zero
+			{
+				std::scoped_lock lock(m_wake_mutex); // pairs with the predicate check in worker_main, avoids a lost wakeup
+				m_pending.fetch_add(1, std::memory_order_release);
+			}
+			auto& queue = *m_queues[current_queue_index()];
+			{
+				std::scoped_lock lock(queue.mutex);
+				queue.tasks.push_back(std::move(fn));
+			}
+			m_wake.notify_one();
+		}
+
+		/// <summary>
+		/// Runs one queued task on the calling thread, if any is available. Used by waiters to help instead of blocking.
+		/// </summary>
+		/// <returns>true if a task was executed.</returns>
+		bool run_pending_task() {
+			task fn;
+			if (!try_take(current_queue_index(), fn))
+				return false;
+			fn();
+			return true;
+		}
+
+		/// <summary>
+		/// Gets the number of worker threads.
+		/// </summary>
+		unsigned size() const { return static_cast<unsigned>(m_threads.size()); }
+
+		/// <summary>
+		/// Gets the number of tasks submitted but not yet taken by a worker or waiter.
+		/// </summary>
+		size_t pending_count() const { return m_pending.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Gets the process-wide pool, created on first use.
+		/// </summary>
+		static thread_pool& shared() {
+			static thread_pool pool;
+			return pool;
+		}
+
+		/// <summary>
+		/// Gets the process-wide pool for blocking work (database, network and file fetches), created on first use.
+		/// Kept apart from shared() so that blocked fetches never hold up layout workers, and so that a task_group
+		/// waiting on the shared pool never picks up a fetch and runs it on the waiting (often UI) thread.
+		/// </summary>
+		static thread_pool& io() {
+			static thread_pool pool(io_thread_count);
+			return pool;
+		}
+
+	private:
+		static constexpr unsigned io_thread_count = 4;
+
+		struct task_queue {
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+		size_t current_queue_index() const {
+			return (t_owner == this) ? t_worker_index : m_queues.size() - 1;
+		}
+
+		bool try_take(size_t own_index, task& out) {
+			{
+				auto& own = *m_queues[own_index];
+				std::scoped_lock lock(own.mutex);
+				if (!own.tasks.empty()) {
+					out = std::move(own.tasks.back());
+					own.tasks.pop_back();
+					m_pending.fetch_sub(1, std::memory_order_acq_rel);
+					return true;
+				}
+			}
+
+			for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+				auto& victim = *m_queues[(own_index + offset) % m_queues.size()];
+				std::scoped_lock lock(victim.mutex);
+				if (!victim.tasks.empty()) {
+					out = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+					m_pending.fetch_sub(1, std::memory_order_acq_rel);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void worker_main(size_t index) {
+			t_owner = this;
+			t_worker_index = index;
+
+			for (;;) {
+				task fn;
+				if (try_take(index, fn)) {
+					fn();
+					continue;
+				}
+
+				std::unique_lock lock(m_wake_mutex);
+				m_wake.wait(lock, [this] { return m_stopping || m_pending.load(std::memory_order_acquire) > 0; });
+				if (m_stopping && m_pending.load(std::memory_order_acquire) == 0)
+					return;
+			}
+		}
+
+		std::vector<std::unique_ptr<task_queue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::mutex m_wake_mutex;
+		std::condition_variable m_wake;
+		std::atomic<size_t> m_pending = 0;
+		bool m_stopping = false;
+
+		static inline thread_local const thread_pool* t_owner = nullptr;
+		static inline thread_local size_t t_worker_index = 0;
+	};
+
+	/// <summary>
+	/// Fork/join helper on top of thread_pool. wait() executes queued tasks while children are outstanding,
+	/// so nested groups never deadlock the pool. With a null pool every task runs inline. A task that throws
+	/// still counts as finished; the first exception is rethrown from wait() once every task is done.
+	/// </summary>
+	class task_group {
+	public:
+		explicit task_group(thread_pool* pool) : m_pool(pool) {}
+
+		~task_group() { join(); }
+
+		task_group(const task_group&) = delete;
+		task_group& operator=(const task_group&) = delete;
+
+		template<typename Fn>
+		void run(Fn&& fn) {
+			if (!m_pool) {
+				fn();
+				return;
+			}
+
+			m_outstanding.fetch_add(1, std::memory_order_relaxed);
+			m_pool->submit([this, fn = std::forward<Fn>(fn)]() mutable {
+				try {
+					fn();
+				} catch (...) {
+					std::lock_guard lock(m_error_mutex);
+					if (!m_error)
+						m_error = std::current_exception();
+				}
+				m_outstanding.fetch_sub(1, std::memory_order_release);
+			});
+		}
+
+		void wait() {
+			join();
+			std::exception_ptr error;
+			{
+				std::lock_guard lock(m_error_mutex);
+				error = std::exchange(m_error, nullptr);
+			}
+			if (error)
+				std::rethrow_exception(error);
+		}
+
+	private:
+		void join() {
+			while (m_outstanding.load(std::memory_order_acquire) > 0) {
+				if (!m_pool || !m_pool->run_pending_task())
+					std::this_thread::yield();
+			}
+		}
+
+		thread_pool* m_pool;
+		std::atomic<int> m_outstanding = 0;
+		std::mutex m_error_mutex;
+		std::exception_ptr m_error;
+	};
+}
+
+#endif // WPP_THREAD_POOL_HPP
@@ -0,0 +1,179 @@
+#ifndef WPP_UI_BUILDER_HPP
+#define WPP_UI_BUILDER_HPP
+
+#include "window.hpp"
+#include "layout\ui_tree.hpp"
+
+namespace wpp::layout::ui
+{
+	namespace detail
+	{
+		template<typename Spec> struct is_panel_spec : std::false_type {};
+		template<std::size_t R, std::size_t C, typename B, typename... Ch> struct is_panel_spec<grid_spec<R, C, B, Ch...>> : std::true_type {};
+		template<typename B, typename... Ch> struct is_panel_spec<stack_spec<B, Ch...>> : std::true_type {};
+		template<typename B, typename... Ch> struct is_panel_spec<dock_spec<B, Ch...>> : std::true_type {};
+		template<typename B, typename... Ch> struct is_panel_spec<canvas_spec<B, Ch...>> : std::true_type {};
+
+		inline int size_or(int value, int fallback) { return value >= 0 ? value : fallback; }
+
+		template<typename Owner, typename Binding, typename Element>
+		void bind(Owner& owner, const Binding& binding, const Element& element) {
+			if constexpr (!std::is_same_v<Binding, no_binding>) {
+				using member_type = std::remove_cvref_t<decltype(static_cast<Owner&>(owner).*binding.member)>;
+				owner.*binding.member = std::static_pointer_cast<typename member_type::element_type>(element);
+			}
+		}
+
+		template<typename Owner, control_kind Kind, typename CharT, typename Binding>
+		auto create(Owner& owner, HWND, const control_spec<Kind, CharT, Binding>& spec) {
+			static_assert(std::is_same_v<CharT, TCHAR> || (Kind >= control_kind::list_box && Kind <= control_kind::track_bar),
+						  "control texts must be TCHAR literals (_T)");
+
+			auto text = [&spec]() -> tstring {
+				if constexpr (std::is_same_v<CharT, TCHAR>)
+					return spec.text ? tstring(spec.text) : tstring();
+				else
+					return tstring();
+			};
+
+			auto element = [&]() {
+				if constexpr (Kind == control_kind::static_text) return owner.create_static_control(text(), size_or(spec.width, 200), size_or(spec.height, 20));
+				else if constexpr (Kind == control_kind::button) return owner.create_button(text(), size_or(spec.width, 80), size_or(spec.height, 25));
+				else if constexpr (Kind == control_kind::check_box) return owner.create_check_box(text(), size_or(spec.width, 100), size_or(spec.height, 25));
+				else if constexpr (Kind == control_kind::edit) return owner.create_edit_text(text(), size_or(spec.width, 200), size_or(spec.height, 25));
+				else if constexpr (Kind == control_kind::rich_edit) return owner.create_rich_edit(text(), size_or(spec.width, 300), size_or(spec.height, 200));
+				else if constexpr (Kind == control_kind::list_box) return owner.create_list_box(size_or(spec.width, 200), size_or(spec.height, 150));
+				else if constexpr (Kind == control_kind::list_view) return owner.create_list_view(size_or(spec.width, 300), size_or(spec.height, 200));
+				else if constexpr (Kind == control_kind::combo_box) return owner.create_combo_box(size_or(spec.width, 200), size_or(spec.height, 200));
+				else if constexpr (Kind == control_kind::tree_view) return owner.create_tree_view(size_or(spec.width, 250), size_or(spec.height, 200));
+				else if constexpr (Kind == control_kind::tab) return owner.create_tab_control(size_or(spec.width, 300), size_or(spec.height, 200));
+				else if constexpr (Kind == control_kind::progress) return owner.create_progress_bar(size_or(spec.width, 200), size_or(spec.height, 20));
+				else if constexpr (Kind == control_kind::track_bar) return owner.create_track_bar(size_or(spec.width, 200), size_or(spec.height, 30));
+				else if constexpr (Kind == control_kind::group_box) return owner.create_group_box(text(), size_or(spec.width, 200), size_or(spec.height, 100));
+				else {
+					static_assert(Kind == control_kind::link, "unsupported control kind");
+					return owner.create_link_control(text(), size_or(spec.width, 200), size_or(spec.height, 20));
+				}
+			}();
+
+			bind(owner, spec.binding, element);
+			return element;
+		}
+
+		template<typename Owner, typename Child>
+		void add_child(Owner& owner, HWND hwnd, panel& container, const Child& child);
+
+		template<typename Spec>
+		void apply_options(panel& target, const Spec& spec) {
+			const panel_options& options = spec.options;
+			if (options.has_margin)
+				target.set_margin(options.margin.left, options.margin.top, options.margin.right, options.margin.bottom);
+			if (options.has_padding)
+				target.set_padding(options.padding.left, options.padding.top, options.padding.right, options.padding.bottom);
+		}
+
+		template<typename Owner, typename Spec>
+		void create_children(Owner& owner, HWND hwnd, panel& target, const Spec& spec) {
+			target.reserve_children(std::tuple_size_v<decltype(spec.children)>);
+			std::apply([&](const auto&... children) { (add_child(owner, hwnd, target, children), ...); }, spec.children);
+		}
+
+		template<typename Owner, std::size_t Rows, std::size_t Columns, typename Binding, typename... Children>
+		auto create(Owner& owner, HWND hwnd, const grid_spec<Rows, Columns, Binding, Children...>& spec) {
+			auto grid = std::make_shared<grid_panel>(hwnd);
+			grid->set_row_definitions(std::vector<grid_length>(spec.rows.begin(), spec.rows.end()));
+			grid->set_column_definitions(std::vector<grid_length>(spec.columns.begin(), spec.columns.end()));
+			if (spec.options.has_spacing)
+				grid->set_spacing(spec.options.spacing);
+			apply_options(*grid, spec);
+			create_children(owner, hwnd, *grid, spec);
+			bind(owner, spec.binding, grid);
+			return grid;
+		}
+
+		template<typename Owner, typename Binding, typename... Children>
+		auto create(Owner& owner, HWND hwnd, const stack_spec<Binding, Children...>& spec) {
+			auto stack = std::make_shared<stack_panel>(spec.direction, hwnd);
+			if (spec.options.has_spacing)
+				stack->set_spacing(spec.options.spacing);
+			if (spec.has_alignment)
+				stack->set_alignment(spec.align_children);
+			apply_options(*stack, spec);
+			create_children(owner, hwnd, *stack, spec);
+			bind(owner, spec.binding, stack);
+			return stack;
+		}
+
+		template<typename Owner, typename Binding, typename... Children>
+		auto create(Owner& owner, HWND hwnd, const dock_spec<Binding, Children...>& spec) {
+			auto dock = std::make_shared<dock_panel>(hwnd);
+			dock->set_last_child_fill(spec.last_child_fill);
+			apply_options(*dock, spec);
+			create_children(owner, hwnd, *dock, spec);
+			bind(owner, spec.binding, dock);
+			return dock;
+		}
+
+		template<typename Owner, typename Binding, typename... Children>
+		auto create(Owner& owner, HWND hwnd, const canvas_spec<Binding, Children...>& spec) {
+			auto canvas = std::make_shared<canvas_panel>(hwnd);
+			apply_options(*canvas, spec);
+			create_children(owner, hwnd, *canvas, spec);
+			bind(owner, spec.binding, canvas);
+			return canvas;
+		}
+
+		// Creates an unplaced child and adds it to its panel
+		template<typename Owner, typename Spec>
+		control_ptr<> create_in(Owner& owner, HWND hwnd, panel& container, const Spec& spec) {
+			auto element = create(owner, hwnd, spec);
+			if constexpr (is_panel_spec<Spec>::value)
+				container.add_panel(element);
+			else
+				container.add(element);
+			return element;
+		}
+
+		template<typename Owner, typename Child>
+		void add_child(Owner& owner, HWND hwnd, panel& container, const Child& child) {
+			if constexpr (is_cell<Child>::value) {
+				auto& grid = static_cast<grid_panel&>(container);
+				auto element = create_in(owner, hwnd, container, child.child);
+				grid.set_grid_position(element, child.position);
+				if (child.has_alignment)
+					grid.set_alignment(element, child.cell_alignment);
+			} else if constexpr (is_dock_child<Child>::value) {
+				auto element = create_in(owner, hwnd, container, child.child);
+				static_cast<dock_panel&>(container).set_dock_position(element, child.side);
+			} else if constexpr (is_canvas_child<Child>::value) {
+				auto& canvas = static_cast<canvas_panel&>(container);
+				auto element = create_in(owner, hwnd, container, child.child);
+				canvas.set_position(element, child.x, child.y);
+				canvas.set_z_index(element, child.z);
+			} else {
+				create_in(owner, hwnd, container, child);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Creates the panels and controls of a compile-time tree on a window, in declaration order, and stores
+	/// bound elements in the owner's members. The window's control list and every panel's child list are
+	/// reserved to their exact final size first; the tree itself is walked without any intermediate storage.
+	/// Controls get consecutive IDs starting from the window's next control ID.
+	/// </summary>
+	/// <typeparam name="Tree">A panel built with ui::grid, ui::stack, ui::dock or ui::canvas.</typeparam>
+	/// <param name="tree">The tree, usually a static constexpr value.</param>
+	/// <param name="owner">The window to create the controls on; the class whose members the tree binds.</param>
+	/// <returns>The root panel, ready to become the window's root panel.</returns>
+	template<typename Tree, typename Owner>
+	auto build(const Tree& tree, Owner& owner) {
+		static_assert(detail::is_panel_spec<Tree>::value, "the root of a ui tree must be a panel");
+		static_assert(std::is_base_of_v<window, Owner>, "ui trees are built on a window");
+
+		owner.reserve_controls(Tree::control_count);
+		return detail::create(owner, owner.get_handle(), tree);
+	}
+}
+
+#endif // WPP_UI_BUILDER_HPP
@@ -161,6 +161,7 @@ namespace wpp
 	public:
 		using menu_callback = std::function<void(WPARAM, LPARAM)>;
 		using window_message_callback = std::function<LRESULT(HWND, WPARAM, LPARAM)>;
+		using paint_callback = std::function<void(HDC, const RECT&)>;
 		using message_handler = LRESULT(HWND hWnd, WPARAM wParam, LPARAM lParam);
 
 		/// <summary>
@@ -234,7 +235,10 @@ namespace wpp
 		virtual message_handler on_move;
 		virtual message_handler on_menu_command;
 		virtual message_handler on_paint;
+		virtual message_handler on_erase_background;
 		virtual message_handler on_size;
+		virtual message_handler on_enter_size_move;
+		virtual message_handler on_exit_size_move;
 		virtual message_handler on_key_down;
 		virtual message_handler on_key_up;
 		virtual message_handler on_h_scroll;
@@ -480,12 +484,122 @@ namespace wpp
 				m_menu_command_events.erase(menu_id);
 		}
 
+		/// <summary>
+		/// Builds the panels and controls of a compiled layout in one pass and makes its root the root panel.
+		/// The layout records are read in place, so the data can come straight from a mapped file or a resource.
+		/// Named elements can be looked up afterwards with find_layout_control.
+		/// </summary>
+		/// <param name="view">The compiled layout.</param>
+		/// <returns>True if every element was created.</returns>
+		bool load_layout(const layout::layout_view& view);
+
+		/// <summary>
+		/// Compiles a layout from its text form and loads it. Prefer precompiled layouts for startup time.
+		/// </summary>
+		/// <param name="text">The layout text (UTF-8).</param>
+		/// <param name="error">Receives the parse error, if any.</param>
+		/// <returns>True if the layout was parsed and loaded.</returns>
+		bool load_layout(std::string_view text, std::string* error = nullptr);
+
+		/// <summary>
+		/// Loads a compiled layout embedded as an RCDATA resource of the window class's module.
+		/// </summary>
+		/// <param name="resource_id">The resource identifier.</param>
+		/// <returns>True if the resource was found, valid and loaded.</returns>
+		bool load_layout_resource(int resource_id);
+
+		/// <summary>
+		/// Finds a control or panel created by load_layout through its name attribute.
+		/// </summary>
+		/// <typeparam name="T">The expected control type.</typeparam>
+		/// <param name="name">The element name.</param>
+		/// <returns>The control, or nullptr if there is none with that name and type.</returns>
+		template<typename T = control>
+		control_ptr<T> find_layout_control(const tstring& name) const {
+			auto it = m_layout_names.find(name);
+			return it != m_layout_names.end() ? std::dynamic_pointer_cast<T>(it->second) : nullptr;
+		}
+
 		/// <summary>
 		/// Gets a read-only reference to the layout panel.
 		/// </summary>
 		/// <returns>A const reference to the layout panel.</returns>
 		inline const auto& get_root_panel() const { return m_root_panel; }
 		
+		/// <summary>
+		/// Enables or disables asynchronous layout. When enabled, WM_SIZE captures a snapshot of the panel tree,
+		/// measures and arranges it on the shared thread pool (independent subtrees in parallel), and only the
+		/// resulting rectangles are committed back on the UI thread. Results for superseded sizes are dropped.
+		/// </summary>
+		/// <param name="enabled">True to compute layout off the UI thread, false to lay out synchronously.</param>
+		inline void set_async_layout(bool enabled) {
+			if (enabled && !m_async_layout)
+				m_async_layout = std::make_shared<async_layout_state>();
+			else if (!enabled && m_async_layout) {
+				m_async_layout->latest_generation++;
+				m_async_layout.reset();
+			}
+		}
+
+		/// <summary>
+		/// Attaches profiling counters to the root panel. Every subsequent measure, arrange, snapshot and window commit
+		/// (synchronous or asynchronous) is accumulated into them; pass nullptr to stop collecting.
+		/// </summary>
+		/// <param name="statistics">The counters to accumulate into.</param>
+		inline void set_layout_statistics(std::shared_ptr<layout::layout_statistics> statistics) {
+			if (m_root_panel)
+				m_root_panel->set_layout_statistics(std::move(statistics));
+		}
+
+		/// <summary>
+		/// Gets whether layout is computed off the UI thread.
+		/// </summary>
+		/// <returns>True if asynchronous layout is enabled.</returns>
+		inline bool get_async_layout() const { return m_async_layout != nullptr; }
+
+		/// <summary>
+		/// Enables or disables pacing layout to the display refresh while the user drags the window border.
+		/// When enabled (the default), sizes between WM_ENTERSIZEMOVE and WM_EXITSIZEMOVE are laid out at most once
+		/// per frame, only the latest one is kept, and the final size gets an exact layout when the drag ends.
+		/// </summary>
+		/// <param name="enabled">True to throttle live resize layout, false to lay out every WM_SIZE.</param>
+		inline void set_live_resize_throttling(bool enabled) {
+			m_live_resize_throttling = enabled;
+		}
+
+		/// <summary>
+		/// Gets the live resize counters (sizes received, frames laid out, sizes coalesced, busy frames skipped).
+		/// </summary>
+		/// <returns>A const reference to the counters.</returns>
+		inline const layout::resize_scheduler::statistics& get_resize_statistics() const { return m_resize_scheduler.get_statistics(); }
+
+		/// <summary>
+		/// Animates a value on this thread's frame clock, ticking together with every other animation.
+		/// When the animation moves or resizes controls, the window is laid out once per frame after all values of
+		/// that frame have been applied instead of once per animation. Animations stop when the window is destroyed.
+		/// </summary>
+		/// <param name="spec">The animation; durations are in microseconds and the owner is set to this window.</param>
+		/// <param name="affects_layout">True if apply changes panel geometry (margins, sizes, visibility).</param>
+		/// <returns>An id for graphics::frame_clock::cancel.</returns>
+		graphics::frame_clock::animation_id animate(graphics::animation_spec spec, bool affects_layout = false);
+
+		/// <summary>
+		/// Stops every animation started through animate.
+		/// </summary>
+		inline void stop_animations() {
+			graphics::frame_clock::current().cancel_owner(this);
+		}
+
+		/// <summary>
+		/// Paints the client area through a handler. Painting is scoped to BeginPaint/EndPaint, goes to a pooled
+		/// back buffer already filled with the class background and is presented in one blit, so it does not flicker.
+		/// The DC uses client coordinates and is clipped to the update rectangle passed alongside it.
+		/// </summary>
+		/// <param name="handler">The paint handler, or nullptr to let the default window procedure paint.</param>
+		inline void set_paint_handler(paint_callback handler) {
+			m_paint_handler = std::move(handler);
+		}
+
 		/// <summary>
 		/// Sets whether the window should keep its minimum size when resized.
 		/// </summary>
@@ -552,11 +666,60 @@ namespace wpp
 		/// <returns>A const reference to the vector of controls.</returns>
 		inline const controls_vec& get_controls() const override { return m_controls; }
 
+		/// <summary>
+		/// Reserves room for a number of controls about to be created, so creating them does not grow the collection.
+		/// </summary>
+		/// <param name="count">The number of controls that will be added.</param>
+		inline void reserve_controls(size_t count) { m_controls.reserve(m_controls.size() + count); }
+
+		/// <summary>
+		/// Destroys a control created by this window and stops tracking it (e.g. when a lazily created tab page is unloaded).
+		/// </summary>
+		/// <param name="handle">The window handle of the control.</param>
+		/// <returns>True if the control belonged to this window.</returns>
+		bool destroy_control(HWND handle);
+
 	private:
+		/// <summary>
+		/// State shared between the window and in-flight layout jobs. Outlives the window if a job is still running.
+		/// </summary>
+		struct async_layout_state {
+			std::atomic<std::uint64_t> latest_generation = 0; ///< Generation of the most recent size request.
+			std::mutex mutex; ///< Guards the completed result.
+			std::optional<layout::layout_tree> completed; ///< Latest finished layout waiting for commit.
+			std::uint64_t completed_generation = 0; ///< Generation the completed layout was computed for.
+		};
+
 		void init_message_events();
 		void cleanup();
 		void update_layout();
-		void refresh_layout_visuals();
+		void request_async_layout(int width, int height);
+		LRESULT on_layout_ready(HWND hWnd, WPARAM wParam, LPARAM lParam);
+		LRESULT on_control_async_ready(HWND hWnd, WPARAM wParam, LPARAM lParam);
+		LRESULT on_control_draw_item(HWND hWnd, WPARAM wParam, LPARAM lParam);
+		void refresh_layout_visuals(const layout::damage_region& damage);
+		void layout_frame(int width, int height);
+		void on_resize_frame();
+
+		/// <summary>
+		/// Gets the window font variant for the current DPI, created once per DPI and then reused.
+		/// </summary>
+		HFONT get_dpi_font() {
+			if (!m_font || m_dpi == m_font_dpi)
+				return m_font;
+
+			// The default font is shared per DPI with every other window through the GDI cache
+			if (m_default_font) {
+				if (!m_default_font_variant || m_default_font_variant_dpi != m_dpi) {
+					m_default_font_variant = graphics::gdi_cache::shared().font(graphics::default_font_key(m_dpi));
+					m_default_font_variant_dpi = m_dpi;
+				}
+				return m_default_font_variant ? m_default_font_variant.get() : m_font;
+			}
+
+			HFONT variant = m_font_variants.get(m_dpi);
+			return variant ? variant : m_font;
+		}
 		bool handle_scroll_message(scroll_orientation orientation, WPARAM wParam, LPARAM lParam);
 
 		template<typename CtrlType>
@@ -574,14 +737,21 @@ namespace wpp
 				return nullptr;
 			}
 
-			if (m_font)
-				control->set_font(m_font);
+			if (HFONT font = get_dpi_font())
+				control->set_font(font);
 
 			m_controls.emplace_back(control);
+			if constexpr (std::is_base_of_v<tab_control, CtrlType>)
+				m_top_controls.emplace_back(control); //tab controls must be kept above other controls to prevent occlusion issues in complex nested layouts
 			return control;
 		}
 		
 		std::shared_ptr<layout::panel> m_root_panel; ///< Layout panel for automatic control arrangement.
+		std::shared_ptr<async_layout_state> m_async_layout; ///< Non-null when layout runs off the UI thread.
+		std::vector<control_ptr<>> m_async_layout_targets; ///< Commit targets of the most recent async snapshot.
+		layout::resize_scheduler m_resize_scheduler; ///< Paces layout during a live resize.
+		UINT_PTR m_resize_timer = 0; ///< Frame clock timer, alive only during a live resize.
+		bool m_live_resize_throttling = true; ///< Whether live resize layout is paced to the display refresh.
 
 	protected:
 		auto& root_panel() { return m_root_panel; }
@@ -594,7 +764,12 @@ namespace wpp
 		HMENU m_menu_handle; ///< Menu handle.
 		HFONT m_font; ///< Font handle.
 		bool m_owns_menu = false; ///< Indicates if the menu handle should be destroyed by this window.
-		bool m_owns_font = false; ///< Indicates if the font handle should be destroyed by this window.
+		UINT m_dpi = USER_DEFAULT_SCREEN_DPI; ///< DPI of the monitor the window is currently on.
+		UINT m_font_dpi = USER_DEFAULT_SCREEN_DPI; ///< DPI the window font was created for.
+		dpi_cache<HFONT> m_font_variants; ///< Window font scaled for other DPIs.
+		graphics::shared_font m_default_font; ///< Shared default font, used when no font was supplied.
+		graphics::shared_font m_default_font_variant; ///< Shared default font for the current DPI when it differs from m_font_dpi.
+		UINT m_default_font_variant_dpi = 0; ///< DPI of m_default_font_variant.
 		int m_menu_id; ///< Menu ID.
 		bool m_keep_minimum_size = false; ///< Flag to keep minimum size when window is resized.
 		DWORD m_style, m_style_ex; ///< Window styles.
@@ -603,7 +778,10 @@ namespace wpp
 		std::atomic_bool m_window_running = false; ///< Window running flag.
 		std::map<INT, window_message_callback> m_message_events; ///< Message events.
 		std::map<UINT_PTR, menu_callback> m_menu_command_events; ///< Menu command events.
+		paint_callback m_paint_handler; ///< Custom client area painting, drawn double buffered.
 		controls_vec m_controls; ///< Controls container.
+		controls_vec m_top_controls; ///< Controls raised to the top of the z-order after a layout commit.
+		std::unordered_map<tstring, control_ptr<>> m_layout_names; ///< Named elements of the loaded layout.
 	};
 }
 